@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "BenchUtils.hpp"
+
+#include "opendxf/write.hpp"
+
+#include <fmt/format.h>
+
+#include <map>
+#include <stdexcept>
+
+const odxf::Document& syntheticDocument(std::size_t megabytes)
+{
+    static std::map<std::size_t, odxf::Document> documents;
+
+    auto iter{ documents.find(megabytes) };
+    if (iter == documents.end()) {
+        odxf::GeneratorOptions options;
+        options.entityCount = odxf::entityCountForSize(options, megabytes << 20);
+        iter = documents.emplace(megabytes, odxf::generateDocument(options)).first;
+    }
+
+    return iter->second;
+}
+
+std::filesystem::path syntheticFile(std::size_t megabytes)
+{
+    const std::filesystem::path filePath{ std::filesystem::temp_directory_path()
+                                          / fmt::format("opendxf-bench-{}mb.dxf", megabytes) };
+    if (std::filesystem::exists(filePath)) {
+        return filePath;
+    }
+
+    // renamed when complete, an interrupted run must not leave a truncated file behind
+    std::filesystem::path temporaryPath{ filePath };
+    temporaryPath += ".tmp";
+
+    if (!odxf::writeDxf(syntheticDocument(megabytes), temporaryPath)) {
+        throw std::runtime_error{ fmt::format("unable to write {}", temporaryPath.string()) };
+    }
+
+    std::filesystem::rename(temporaryPath, filePath);
+
+    return filePath;
+}
+
+void setThroughput(benchmark::State& state, std::size_t bytes, std::size_t entities)
+{
+    state.counters["MB"] = benchmark::Counter{
+        static_cast<double>(bytes) / 1.0e6,
+        benchmark::Counter::kIsIterationInvariantRate,
+    };
+    state.counters["entities"] = benchmark::Counter{
+        static_cast<double>(entities),
+        benchmark::Counter::kIsIterationInvariantRate,
+    };
+}
+
+void setAllocations(benchmark::State& state, std::uint64_t allocations, std::size_t entities)
+{
+    state.counters["allocs/entity"] = benchmark::Counter{
+        static_cast<double>(allocations)
+            / static_cast<double>(static_cast<std::size_t>(state.iterations()) * entities),
+    };
+}
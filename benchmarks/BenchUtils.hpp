@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/document.hpp"
+#include "opendxf/generator.hpp"
+
+#include "DocumentUtils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// The synthetic data comes from the deterministic generator, so the benchmarks run
+// offline and compare across runs.
+
+// The synthetic document of the given size, created once.
+const odxf::Document& syntheticDocument(std::size_t megabytes);
+
+// Writes the synthetic document of the given size to the temporary directory once
+// and returns its path.
+std::filesystem::path syntheticFile(std::size_t megabytes);
+
+// Reports MB/s and entities/s for the bytes and entities processed per iteration.
+void setThroughput(benchmark::State& state, std::size_t bytes, std::size_t entities);
+
+// Reports the heap allocations per entity, allocations counted over all iterations.
+void setAllocations(benchmark::State& state, std::uint64_t allocations, std::size_t entities);
@@ -0,0 +1,452 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/extents.hpp"
+#include "opendxf/incremental.hpp"
+#include "opendxf/ireadstream.hpp"
+#include "opendxf/outputsink.hpp"
+#include "opendxf/read.hpp"
+#include "opendxf/sidecar.hpp"
+#include "opendxf/snapshot.hpp"
+#include "opendxf/spatialindex.hpp"
+#include "opendxf/tessellate.hpp"
+#include "opendxf/transform.hpp"
+#include "opendxf/write.hpp"
+
+#include "BenchUtils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <random>
+#include <vector>
+
+// Arguments are the document size in MB and, where applicable, the thread count with
+// 0 meaning one thread per hardware thread.
+
+namespace {
+
+class CountingReadStream final : public odxf::IReadStream
+{
+public:
+    std::size_t count() const { return m_count; }
+
+private:
+    void arc(const odxf::Arc&) override { ++m_count; }
+    void circle(const odxf::Circle&) override { ++m_count; }
+    void line(const odxf::Line&) override { ++m_count; }
+    void lwPolyline(const odxf::LWPolyline&) override { ++m_count; }
+
+    std::size_t m_count{ 0 };
+};
+
+void BM_read(benchmark::State& state)
+{
+    const std::filesystem::path filePath{ syntheticFile(static_cast<std::size_t>(state.range(0))) };
+
+    std::size_t count{ 0 };
+    for (auto _ : state) {
+        CountingReadStream stream;
+        if (!odxf::read(stream, filePath)) {
+            state.SkipWithError("unable to read file");
+            return;
+        }
+
+        count = stream.count();
+    }
+
+    setThroughput(state, std::filesystem::file_size(filePath), count);
+}
+BENCHMARK(BM_read)->ArgName("MB")->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+void BM_readDocument(benchmark::State& state)
+{
+    const std::filesystem::path filePath{ syntheticFile(static_cast<std::size_t>(state.range(0))) };
+    const odxf::ReadOptions options{ .threadCount = static_cast<unsigned int>(state.range(1)) };
+
+    std::size_t count{ 0 };
+    for (auto _ : state) {
+        const tl::expected<odxf::Document, odxf::Error> maybeDocument{
+            odxf::readDocument(filePath, options)
+        };
+        if (!maybeDocument) {
+            state.SkipWithError("unable to read file");
+            return;
+        }
+
+        count = entityCount(*maybeDocument);
+    }
+
+    setThroughput(state, std::filesystem::file_size(filePath), count);
+}
+BENCHMARK(BM_readDocument)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100, 1000 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// re-reading a document after a single line changed, compare with BM_readDocument
+void BM_incrementalRead(benchmark::State& state)
+{
+    odxf::Document document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const std::string original{ formatDxf(document) };
+    document.entities.lines[document.entities.lines.size() / 2].start.x += 1.0;
+    const std::string edited{ formatDxf(document) };
+
+    odxf::IncrementalReader reader{ odxf::IncrementalOptions{
+        .threadCount = static_cast<unsigned int>(state.range(1)) } };
+    if (!reader.readContent(original)) {
+        state.SkipWithError("unable to read document");
+        return;
+    }
+
+    bool isEdited{ false };
+    std::uint64_t parsedBytes{ 0 };
+    for (auto _ : state) {
+        isEdited = !isEdited;
+        const tl::expected<odxf::DocumentDelta, odxf::Error> delta{ reader.readContent(
+            isEdited ? edited : original) };
+        if (!delta) {
+            state.SkipWithError("unable to read document");
+            return;
+        }
+
+        parsedBytes = delta->parsedBytes;
+    }
+
+    setThroughput(state, original.size(), entityCount(document));
+    state.counters["parsedBytes"] = static_cast<double>(parsedBytes);
+}
+BENCHMARK(BM_incrementalRead)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100, 1000 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// opening a snapshot of the document and materializing it, compare with BM_readDocument
+void BM_readSnapshot(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const std::filesystem::path filePath{ std::filesystem::temp_directory_path()
+                                          / "opendxf-bench-snapshot.odxfsnap" };
+    if (!odxf::writeSnapshot(document, filePath)) {
+        state.SkipWithError("unable to write snapshot");
+        return;
+    }
+
+    for (auto _ : state) {
+        const tl::expected<odxf::Snapshot, odxf::Error> snapshot{
+            odxf::Snapshot::open(filePath)
+        };
+        if (!snapshot) {
+            state.SkipWithError("unable to open snapshot");
+            return;
+        }
+
+        benchmark::DoNotOptimize(snapshot->toDocument());
+    }
+
+    setThroughput(state, std::filesystem::file_size(filePath), entityCount(document));
+    std::filesystem::remove(filePath);
+}
+BENCHMARK(BM_readSnapshot)
+    ->ArgName("MB")
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_writeDxf(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const std::filesystem::path filePath{ std::filesystem::temp_directory_path()
+                                          / "opendxf-bench-write.dxf" };
+    const odxf::WriteOptions options{
+        .threadCount = static_cast<unsigned int>(state.range(1)),
+        .asyncOutput = state.range(2) != 0,
+    };
+
+    for (auto _ : state) {
+        if (!odxf::writeDxf(document, filePath, options)) {
+            state.SkipWithError("unable to write file");
+            return;
+        }
+    }
+
+    setThroughput(state, std::filesystem::file_size(filePath), entityCount(document));
+    std::filesystem::remove(filePath);
+}
+BENCHMARK(BM_writeDxf)
+    ->ArgNames({ "MB", "threads", "async" })
+    ->ArgsProduct({ { 10, 100, 1000 }, { 1, 0 }, { 0, 1 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// formatting only, the output is discarded
+void BM_formatDxf(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const odxf::WriteOptions options{ .threadCount = static_cast<unsigned int>(state.range(1)) };
+
+    std::size_t bytes{ 0 };
+    for (auto _ : state) {
+        bytes = 0;
+        odxf::CallbackSink sink{ [&bytes](std::string_view block) {
+            bytes += block.size();
+            return true;
+        } };
+
+        if (!odxf::writeDxf(document, sink, options)) {
+            state.SkipWithError("unable to format document");
+            return;
+        }
+    }
+
+    setThroughput(state, bytes, entityCount(document));
+}
+BENCHMARK(BM_formatDxf)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100, 1000 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// arcs, circles and lw polylines of the synthetic document, with a chord tolerance of a
+// thousandth of the largest radii
+void BM_tessellate(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const odxf::TessellateOptions options{
+        .chordTolerance = 0.1,
+        .threadCount = static_cast<unsigned int>(state.range(1)),
+    };
+
+    std::size_t vertices{ 0 };
+    for (auto _ : state) {
+        const odxf::Tessellation arcs{ odxf::tessellate(document.entities.arcs, options) };
+        const odxf::Tessellation circles{ odxf::tessellate(document.entities.circles, options) };
+        const odxf::Tessellation lwPolylines{
+            odxf::tessellate(document.entities.lwPolylines, options)
+        };
+        vertices = arcs.vertices.size() + circles.vertices.size() + lwPolylines.vertices.size();
+        benchmark::DoNotOptimize(vertices);
+    }
+
+    state.counters["vertices"] = static_cast<double>(vertices);
+    setThroughput(
+        state,
+        vertices * sizeof(odxf::Coordinate3d),
+        document.entities.arcs.size() + document.entities.circles.size()
+            + document.entities.lwPolylines.size());
+}
+BENCHMARK(BM_tessellate)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// rotates and scales a copy of the synthetic document, copying is not measured
+void BM_transform(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const odxf::Affine2d affine{ odxf::Affine2d::rotate(30.0) * odxf::Affine2d::scale(25.4) };
+    const odxf::TransformOptions options{
+        .threadCount = static_cast<unsigned int>(state.range(1)),
+    };
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        odxf::Entities entities{ document.entities };
+        state.ResumeTiming();
+
+        odxf::transform(entities, affine, options);
+        benchmark::DoNotOptimize(entities);
+    }
+
+    state.counters["entities"] = benchmark::Counter{
+        static_cast<double>(entityCount(document)),
+        benchmark::Counter::kIsIterationInvariantRate,
+    };
+}
+BENCHMARK(BM_transform)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// bounds the entities of the synthetic document
+void BM_computeExtents(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const odxf::ExtentsOptions options{
+        .threadCount = static_cast<unsigned int>(state.range(1)),
+    };
+
+    for (auto _ : state) {
+        odxf::Extents extents{ odxf::computeExtents(document.entities, options) };
+        benchmark::DoNotOptimize(extents);
+    }
+
+    state.counters["entities"] = benchmark::Counter{
+        static_cast<double>(entityCount(document)),
+        benchmark::Counter::kIsIterationInvariantRate,
+    };
+}
+BENCHMARK(BM_computeExtents)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_buildSpatialIndex(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const odxf::SpatialIndexOptions options{
+        .threadCount = static_cast<unsigned int>(state.range(1)),
+    };
+
+    for (auto _ : state) {
+        tl::expected<odxf::SpatialIndex, odxf::Error> index{
+            odxf::SpatialIndex::build(document.entities, options)
+        };
+        benchmark::DoNotOptimize(index);
+    }
+
+    state.counters["entities"] = benchmark::Counter{
+        static_cast<double>(entityCount(document)),
+        benchmark::Counter::kIsIterationInvariantRate,
+    };
+}
+BENCHMARK(BM_buildSpatialIndex)
+    ->ArgNames({ "MB", "threads" })
+    ->ArgsProduct({ { 10, 100 }, { 1, 0 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// random points of the synthetic document, whose entities cover [0, 10000]^2
+std::vector<odxf::Coordinate2d> queryPoints()
+{
+    std::mt19937 random{ 42 };
+    std::uniform_real_distribution<double> coordinate{ 0.0, 10000.0 };
+
+    std::vector<odxf::Coordinate2d> points(1024);
+    for (odxf::Coordinate2d& point : points) {
+        point = odxf::Coordinate2d{ coordinate(random), coordinate(random) };
+    }
+
+    return points;
+}
+
+// windows of a hundredth of the drawing's width, like a zoomed in viewport
+void BM_querySpatialIndex(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const tl::expected<odxf::SpatialIndex, odxf::Error> built{
+        odxf::SpatialIndex::build(document.entities)
+    };
+    if (!built) {
+        state.SkipWithError("unable to build spatial index");
+        return;
+    }
+
+    const odxf::SpatialIndex& index{ *built };
+    const std::vector<odxf::Coordinate2d> points{ queryPoints() };
+
+    std::vector<odxf::EntityRef> result;
+    std::size_t found{ 0 };
+    std::size_t next{ 0 };
+    for (auto _ : state) {
+        const odxf::Coordinate2d& point{ points[next++ % points.size()] };
+        result.clear();
+        index.query(
+            odxf::Box2d{ .min = point, .max = { point.x + 100.0, point.y + 100.0 } }, result);
+        found += result.size();
+    }
+
+    state.counters["found"] = benchmark::Counter{
+        static_cast<double>(found), benchmark::Counter::kAvgIterations
+    };
+}
+BENCHMARK(BM_querySpatialIndex)
+    ->ArgName("MB")
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_nearestInSpatialIndex(benchmark::State& state)
+{
+    const odxf::Document& document{ syntheticDocument(static_cast<std::size_t>(state.range(0))) };
+    const tl::expected<odxf::SpatialIndex, odxf::Error> built{
+        odxf::SpatialIndex::build(document.entities)
+    };
+    if (!built) {
+        state.SkipWithError("unable to build spatial index");
+        return;
+    }
+
+    const odxf::SpatialIndex& index{ *built };
+    const std::vector<odxf::Coordinate2d> points{ queryPoints() };
+
+    std::size_t next{ 0 };
+    for (auto _ : state) {
+        const std::optional<odxf::EntityRef> nearest{
+            index.nearest(document.entities, points[next++ % points.size()])
+        };
+        benchmark::DoNotOptimize(nearest);
+    }
+}
+BENCHMARK(BM_nearestInSpatialIndex)
+    ->ArgName("MB")
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+
+// opening the sidecar index of a file and parsing the entities of a viewport, compare with
+// BM_readDocument
+void BM_readSidecarViewport(benchmark::State& state)
+{
+    const std::filesystem::path filePath{ syntheticFile(static_cast<std::size_t>(state.range(0))) };
+    const std::filesystem::path indexPath{ std::filesystem::temp_directory_path()
+                                           / "opendxf-bench-sidecar.odxfidx" };
+    if (!odxf::readDocument(filePath, odxf::ReadOptions{ .sidecarPath = indexPath })) {
+        state.SkipWithError("unable to write sidecar index");
+        return;
+    }
+
+    const odxf::SidecarOptions options{ .verifyContent = state.range(1) != 0 };
+    const std::vector<odxf::Coordinate2d> points{ queryPoints() };
+
+    std::size_t found{ 0 };
+    std::size_t next{ 0 };
+    for (auto _ : state) {
+        const tl::expected<odxf::SidecarIndex, odxf::Error> index{
+            odxf::SidecarIndex::open(filePath, indexPath, options)
+        };
+        if (!index) {
+            state.SkipWithError("unable to open sidecar index");
+            return;
+        }
+
+        const odxf::Coordinate2d& point{ points[next++ % points.size()] };
+        const tl::expected<odxf::Entities, odxf::Error> entities{
+            index->read(odxf::Box2d{ .min = point, .max = { point.x + 100.0, point.y + 100.0 } })
+        };
+        if (!entities) {
+            state.SkipWithError("unable to read entities");
+            return;
+        }
+
+        found += entities->arcs.size() + entities->circles.size() + entities->lines.size()
+                 + entities->lwPolylines.size();
+    }
+
+    state.counters["found"] = benchmark::Counter{
+        static_cast<double>(found), benchmark::Counter::kAvgIterations
+    };
+}
+BENCHMARK(BM_readSidecarViewport)
+    ->ArgNames({ "MB", "verify" })
+    ->ArgsProduct({ { 10, 100 }, { 0, 1 } })
+    ->Unit(benchmark::kMillisecond);
+
+}   // namespace
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/outputsink.hpp"
+
+#include "AllocationCounter.hpp"
+#include "BenchUtils.hpp"
+
+#include "dxfformat.hpp"
+#include "linescanner.hpp"
+#include "outputbuffer.hpp"
+#include "reader.hpp"
+#include "readersink.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <charconv>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t benchEntityCount{ 100000 };
+
+void BM_tokenize(benchmark::State& state)
+{
+    const std::string content{
+        formatDxf(singleTypeDocument(benchEntityCount, &odxf::EntityMix::lines))
+    };
+
+    std::size_t groupCodeCount{ 0 };
+    for (auto _ : state) {
+        odxf::LineScanner scanner{ content };
+        std::string_view groupCode;
+        std::string_view value;
+        groupCodeCount = 0;
+        while (scanner.next(groupCode) && scanner.next(value)) {
+            benchmark::DoNotOptimize(odxf::parseAs<int>(odxf::trimGroupCode(groupCode)));
+            benchmark::DoNotOptimize(value);
+            ++groupCodeCount;
+        }
+    }
+
+    state.counters["group codes"] = benchmark::Counter{
+        static_cast<double>(groupCodeCount),
+        benchmark::Counter::kIsIterationInvariantRate,
+    };
+    setThroughput(state, content.size(), benchEntityCount);
+}
+BENCHMARK(BM_tokenize)->Unit(benchmark::kMillisecond);
+
+void BM_parseDouble(benchmark::State& state)
+{
+    std::mt19937_64 engine{ 1 };
+    std::uniform_real_distribution<double> distribution{ -10000.0, 10000.0 };
+
+    std::vector<std::string> values(4096);
+    std::size_t bytes{ 0 };
+    for (std::string& value : values) {
+        std::array<char, 32> buffer;
+        const auto [last, _]{
+            std::to_chars(buffer.data(), buffer.data() + buffer.size(), distribution(engine))
+        };
+        value.assign(buffer.data(), last);
+        bytes += value.size();
+    }
+
+    for (auto _ : state) {
+        for (const std::string& value : values) {
+            benchmark::DoNotOptimize(odxf::parseAs<double>(value));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_parseDouble);
+
+// Reads a document consisting of entities of a single type.
+void readEntities(benchmark::State& state, std::size_t count, double odxf::EntityMix::*type)
+{
+    const std::string content{ formatDxf(singleTypeDocument(count, type)) };
+
+    const AllocationCounter counter;
+    for (auto _ : state) {
+        odxf::Document document;
+        odxf::DocumentSink sink{ document };
+        odxf::Reader reader{ sink };
+        if (!reader.readContent(content)) {
+            state.SkipWithError("unable to read document");
+            return;
+        }
+
+        benchmark::DoNotOptimize(document);
+    }
+
+    setAllocations(state, counter.count(), count);
+    setThroughput(state, content.size(), count);
+}
+
+void BM_readLines(benchmark::State& state)
+{
+    readEntities(state, benchEntityCount, &odxf::EntityMix::lines);
+}
+BENCHMARK(BM_readLines)->Unit(benchmark::kMillisecond);
+
+void BM_readCircles(benchmark::State& state)
+{
+    readEntities(state, benchEntityCount, &odxf::EntityMix::circles);
+}
+BENCHMARK(BM_readCircles)->Unit(benchmark::kMillisecond);
+
+void BM_readArcs(benchmark::State& state)
+{
+    readEntities(state, benchEntityCount, &odxf::EntityMix::arcs);
+}
+BENCHMARK(BM_readArcs)->Unit(benchmark::kMillisecond);
+
+void BM_readLWPolylines(benchmark::State& state)
+{
+    readEntities(state, benchEntityCount / 10, &odxf::EntityMix::lwPolylines);
+}
+BENCHMARK(BM_readLWPolylines)->Unit(benchmark::kMillisecond);
+
+void BM_readHeader(benchmark::State& state)
+{
+    const odxf::Document headerDocument{ odxf::generateDocument({ .entityCount = 0 }) };
+    const std::string content{ formatDxf(headerDocument) };
+
+    for (auto _ : state) {
+        odxf::Document document;
+        odxf::DocumentSink sink{ document };
+        odxf::Reader reader{ sink };
+        if (!reader.readContent(content)) {
+            state.SkipWithError("unable to read document");
+            return;
+        }
+
+        benchmark::DoNotOptimize(document);
+    }
+
+    state.SetItemsProcessed(
+        static_cast<std::int64_t>(state.iterations() * headerDocument.header.entries.size()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * content.size()));
+}
+BENCHMARK(BM_readHeader);
+
+// Formats the items into a buffer whose sink discards the output.
+template <typename T, typename WriteItem>
+void writeItems(benchmark::State& state, const std::vector<T>& items, WriteItem writeItem)
+{
+    std::size_t bytes{ 0 };
+    odxf::CallbackSink sink{ [&bytes](std::string_view block) {
+        bytes += block.size();
+        return true;
+    } };
+
+    odxf::OutputBuffer buffer{ sink };
+    const AllocationCounter counter;
+    for (auto _ : state) {
+        for (const T& item : items) {
+            writeItem(buffer, item);
+        }
+        buffer.flush();
+    }
+
+    setAllocations(state, counter.count(), items.size());
+    setThroughput(state, bytes / static_cast<std::size_t>(state.iterations()), items.size());
+}
+
+void BM_writeLines(benchmark::State& state)
+{
+    const odxf::Document document{ singleTypeDocument(benchEntityCount, &odxf::EntityMix::lines) };
+    writeItems(state, document.entities.lines, odxf::writeLine);
+}
+BENCHMARK(BM_writeLines)->Unit(benchmark::kMillisecond);
+
+void BM_writeCircles(benchmark::State& state)
+{
+    const odxf::Document document{
+        singleTypeDocument(benchEntityCount, &odxf::EntityMix::circles)
+    };
+    writeItems(state, document.entities.circles, odxf::writeCircle);
+}
+BENCHMARK(BM_writeCircles)->Unit(benchmark::kMillisecond);
+
+void BM_writeArcs(benchmark::State& state)
+{
+    const odxf::Document document{ singleTypeDocument(benchEntityCount, &odxf::EntityMix::arcs) };
+    writeItems(state, document.entities.arcs, odxf::writeArc);
+}
+BENCHMARK(BM_writeArcs)->Unit(benchmark::kMillisecond);
+
+void BM_writeLWPolylines(benchmark::State& state)
+{
+    const odxf::Document document{
+        singleTypeDocument(benchEntityCount / 10, &odxf::EntityMix::lwPolylines)
+    };
+    writeItems(state, document.entities.lwPolylines, odxf::writeLWPolyline);
+}
+BENCHMARK(BM_writeLWPolylines)->Unit(benchmark::kMillisecond);
+
+}   // namespace
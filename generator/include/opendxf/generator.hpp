@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/document.hpp"
+#include "opendxf/error.hpp"
+#include "opendxf/outputsink.hpp"
+#include "opendxf/write.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace odxf {
+
+// Relative weights of the entity types. The counts of the generated entities are
+// proportional to the weights and add up to GeneratorOptions::entityCount.
+struct EntityMix final
+{
+    double points{ 0.0 };
+    double rays{ 0.0 };
+    double lines{ 0.4 };
+    double circles{ 0.15 };
+    double arcs{ 0.2 };
+    double ellipses{ 0.0 };
+    double lwPolylines{ 0.25 };
+};
+
+struct VertexCounts final
+{
+    enum class Distribution
+    {
+        // always min vertices
+        Fixed,
+        // uniform in [min, max]
+        Uniform,
+        // geometric with the given mean, clamped to [min, max], i.e. many small and few
+        // large polylines
+        Geometric
+    };
+
+    Distribution distribution{ Distribution::Uniform };
+    std::size_t min{ 2 };
+    std::size_t max{ 16 };
+    double mean{ 8.0 };
+};
+
+enum class Padding
+{
+    None,
+    // group codes right-aligned to three characters, as many CAD programs write them
+    GroupCodes
+};
+
+struct GeneratorOptions final
+{
+    // The same seed and options always generate the same document.
+    std::uint64_t seed{ 1 };
+    std::size_t entityCount{ 10000 };
+    EntityMix mix;
+    // layers named "Layer 0" to "Layer n-1", the entities are spread uniformly
+    std::size_t layerCount{ 16 };
+    VertexCounts vertexCounts;
+    // fraction of the lw polyline vertices with a bulge
+    double bulgeFraction{ 0.1 };
+    // The entities are placed in the square [0, extent]^2, their sizes are at most
+    // a hundredth of the extent.
+    double extent{ 10000.0 };
+    // applied by generateDxf
+    Padding padding{ Padding::None };
+};
+
+Document generateDocument(const GeneratorOptions& options);
+
+// Streams the generated document to the sink without holding it in memory. Without
+// padding the output is identical to writeDxf(generateDocument(options), ...).
+tl::expected<void, Error> generateDxf(
+    const GeneratorOptions& options, IOutputSink& sink, const WriteOptions& writeOptions = {});
+tl::expected<void, Error> generateDxf(
+    const GeneratorOptions& options,
+    const std::filesystem::path& filePath,
+    const WriteOptions& writeOptions = {});
+
+// The entity count for which the generated DXF output has about the given size.
+std::size_t entityCountForSize(const GeneratorOptions& options, std::uintmax_t size);
+
+}   // namespace odxf
@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+
+#include "opendxf/dxfwriter.hpp"
+
+#include "groupcodepaddingsink.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// entity types in the order of the writers
+enum TypeIndex : std::size_t
+{
+    PointIndex,
+    RayIndex,
+    LineIndex,
+    CircleIndex,
+    ArcIndex,
+    EllipseIndex,
+    LWPolylineIndex,
+    TypeCount
+};
+
+using TypeCounts = std::array<std::size_t, TypeCount>;
+
+// Distributes the count proportionally to the weights with the largest remainder
+// method, so the counts add up exactly.
+TypeCounts distributeCounts(std::size_t count, const odxf::EntityMix& mix)
+{
+    std::array<double, TypeCount> weights{
+        mix.points, mix.rays, mix.lines, mix.circles, mix.arcs, mix.ellipses, mix.lwPolylines,
+    };
+    for (double& weight : weights) {
+        weight = std::max(weight, 0.0);
+    }
+
+    TypeCounts counts{};
+    double totalWeight{ 0.0 };
+    for (double weight : weights) {
+        totalWeight += weight;
+    }
+
+    if (!(totalWeight > 0.0)) {
+        return counts;
+    }
+
+    std::array<double, TypeCount> remainders{};
+    std::size_t assigned{ 0 };
+    for (std::size_t i{ 0 }; i < TypeCount; ++i) {
+        const double share{ static_cast<double>(count) * weights[i] / totalWeight };
+        counts[i] = static_cast<std::size_t>(share);
+        remainders[i] = share - static_cast<double>(counts[i]);
+        assigned += counts[i];
+    }
+
+    while (assigned < count) {
+        const auto largest{ static_cast<std::size_t>(
+            std::max_element(remainders.begin(), remainders.end()) - remainders.begin()) };
+        ++counts[largest];
+        remainders[largest] = -1.0;
+        ++assigned;
+    }
+
+    return counts;
+}
+
+std::uint64_t splitMix64(std::uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+
+    return value ^ (value >> 31);
+}
+
+// Generates the entities of one type. Every type has its own random sequence, so
+// changing the count of one type leaves the entities of the others unchanged.
+//
+// The doubles are derived from the raw bits of std::mt19937_64, whose sequence is fully
+// specified, instead of the implementation defined standard distributions.
+class EntityGenerator final
+{
+public:
+    EntityGenerator(const odxf::GeneratorOptions& options, TypeIndex type)
+        : m_options{ options }
+        , m_engine{ splitMix64(options.seed ^ splitMix64(type)) }
+        , m_size{ options.extent / 100.0 }
+    {
+        m_layerNames.reserve(options.layerCount);
+        for (std::size_t i{ 0 }; i < options.layerCount; ++i) {
+            m_layerNames.push_back(fmt::format("Layer {}", i));
+        }
+        if (m_layerNames.empty()) {
+            m_layerNames.emplace_back("0");
+        }
+    }
+
+    void fill(odxf::Point& point)
+    {
+        entity(point);
+        point.coordinate = position();
+    }
+
+    void fill(odxf::Ray& ray)
+    {
+        entity(ray);
+        ray.startPoint = position();
+
+        const double angle{ uniform(0.0, 2.0 * std::numbers::pi) };
+        ray.direction = { std::cos(angle), std::sin(angle), 0.0 };
+    }
+
+    void fill(odxf::Line& line)
+    {
+        entity(line);
+        line.start = position();
+        line.end = {
+            clamp(line.start.x + uniform(-m_size, m_size)),
+            clamp(line.start.y + uniform(-m_size, m_size)),
+            0.0,
+        };
+    }
+
+    void fill(odxf::Circle& circle)
+    {
+        entity(circle);
+        circle.center = position();
+        circle.radius = uniform(m_size / 100.0, m_size);
+    }
+
+    void fill(odxf::Arc& arc)
+    {
+        entity(arc);
+        arc.center = position();
+        arc.radius = uniform(m_size / 100.0, m_size);
+        arc.startAngle = uniform(0.0, 360.0);
+        arc.endAngle = uniform(0.0, 360.0);
+    }
+
+    void fill(odxf::Ellipse& ellipse)
+    {
+        entity(ellipse);
+        ellipse.center = position();
+
+        const double angle{ uniform(0.0, 2.0 * std::numbers::pi) };
+        const double length{ uniform(m_size / 100.0, m_size) };
+        ellipse.endPointMajor = { length * std::cos(angle), length * std::sin(angle), 0.0 };
+        ellipse.axisRatio = uniform(0.1, 1.0);
+    }
+
+    void fill(odxf::LWPolyline& lwPolyline)
+    {
+        entity(lwPolyline);
+        lwPolyline.isClosed = uniform() < 0.5;
+
+        // random walk with steps of at most a hundredth of the extent
+        odxf::Coordinate3d current{ position() };
+        lwPolyline.vertices.resize(vertexCount());
+        for (odxf::Vertex& vertex : lwPolyline.vertices) {
+            vertex.position = { current.x, current.y };
+            vertex.bulge = uniform() < m_options.bulgeFraction
+                             ? std::optional<double>{ uniform(-1.0, 1.0) }
+                             : std::optional<double>{};
+
+            current.x = clamp(current.x + uniform(-m_size, m_size));
+            current.y = clamp(current.y + uniform(-m_size, m_size));
+        }
+    }
+
+private:
+    // uniform in [0, 1)
+    double uniform() { return static_cast<double>(m_engine() >> 11) * 0x1.0p-53; }
+
+    double uniform(double min, double max) { return min + (max - min) * uniform(); }
+
+    // uniform in [0, count)
+    std::size_t index(std::size_t count)
+    {
+        return static_cast<std::size_t>(uniform() * static_cast<double>(count));
+    }
+
+    double clamp(double value) const { return std::clamp(value, 0.0, m_options.extent); }
+
+    // inside the extent with room for the size of the entity
+    odxf::Coordinate3d position()
+    {
+        return { uniform(m_size, m_options.extent - m_size),
+                 uniform(m_size, m_options.extent - m_size),
+                 0.0 };
+    }
+
+    void entity(odxf::Entity& entity)
+    {
+        entity.layer = m_layerNames[index(m_layerNames.size())];
+        entity.color = 256;
+    }
+
+    std::size_t vertexCount()
+    {
+        const odxf::VertexCounts& vertexCounts{ m_options.vertexCounts };
+        const std::size_t min{ vertexCounts.min };
+        const std::size_t max{ std::max(vertexCounts.max, min) };
+
+        switch (vertexCounts.distribution) {
+        case odxf::VertexCounts::Distribution::Fixed: return min;
+
+        case odxf::VertexCounts::Distribution::Uniform: return min + index(max - min + 1);
+
+        case odxf::VertexCounts::Distribution::Geometric: {
+            if (!(vertexCounts.mean > 1.0)) {
+                return std::clamp<std::size_t>(1, min, max);
+            }
+
+            // number of trials until the first success with probability 1 / mean
+            const double trials{ std::floor(
+                std::log1p(-uniform()) / std::log1p(-1.0 / vertexCounts.mean)) };
+            const double count{ std::min(trials + 1.0, static_cast<double>(max)) };
+
+            return std::clamp(static_cast<std::size_t>(count), min, max);
+        }
+        }
+
+        return min;
+    }
+
+    const odxf::GeneratorOptions& m_options;
+    std::mt19937_64 m_engine;
+    double m_size{ 0.0 };
+    std::vector<std::string> m_layerNames;
+};
+
+template <typename T>
+std::vector<T>
+generateEntities(const odxf::GeneratorOptions& options, TypeIndex type, std::size_t count)
+{
+    EntityGenerator generator{ options, type };
+
+    std::vector<T> entities(count);
+    for (T& entity : entities) {
+        generator.fill(entity);
+    }
+
+    return entities;
+}
+
+// Writes the entities one at a time, reusing the memory of a single entity.
+template <typename T, typename WriteEntity>
+tl::expected<void, odxf::Error> streamEntities(
+    const odxf::GeneratorOptions& options,
+    TypeIndex type,
+    std::size_t count,
+    WriteEntity writeEntity)
+{
+    EntityGenerator generator{ options, type };
+
+    T entity;
+    for (std::size_t i{ 0 }; i < count; ++i) {
+        generator.fill(entity);
+        if (tl::expected<void, odxf::Error> result = writeEntity(entity); !result) {
+            return result;
+        }
+    }
+
+    return {};
+}
+
+odxf::Header generateHeader(const odxf::GeneratorOptions& options)
+{
+    odxf::Header header;
+    auto& entries{ header.entries };
+    entries.try_emplace("$ACADVER", "AC1032");
+    entries.try_emplace("$INSBASE", odxf::Coordinate3d{});
+    entries.try_emplace("$EXTMIN", odxf::Coordinate3d{});
+    entries.try_emplace("$EXTMAX", odxf::Coordinate3d{ options.extent, options.extent, 0.0 });
+    entries.try_emplace("$LIMMIN", odxf::Coordinate2d{});
+    entries.try_emplace("$LIMMAX", odxf::Coordinate2d{ options.extent, options.extent });
+    entries.try_emplace("$TEXTSIZE", 2.5);
+    entries.try_emplace("$CLAYER", options.layerCount == 0 ? std::string{ "0" } : "Layer 0");
+
+    return header;
+}
+
+odxf::Tables generateTables(const odxf::GeneratorOptions& options)
+{
+    odxf::Tables tables;
+    tables.lineTypes.push_back(odxf::LineType{
+        .name = "CONTINUOUS",
+        .displayName = "Solid line",
+    });
+
+    tables.layers.reserve(options.layerCount);
+    for (std::size_t i{ 0 }; i < options.layerCount; ++i) {
+        tables.layers.push_back(odxf::Layer{ .name = fmt::format("Layer {}", i) });
+    }
+
+    return tables;
+}
+
+tl::expected<void, odxf::Error> streamDocument(
+    const odxf::GeneratorOptions& options, odxf::DxfWriter& writer)
+{
+    if (tl::expected<void, odxf::Error> maybeError = writer.beginHeader(); !maybeError) {
+        return maybeError;
+    }
+
+    for (const auto& [key, value] : generateHeader(options).entries) {
+        if (tl::expected<void, odxf::Error> maybeError = writer.headerVariable(key, value);
+            !maybeError) {
+            return maybeError;
+        }
+    }
+
+    if (tl::expected<void, odxf::Error> maybeError = writer.beginTables(); !maybeError) {
+        return maybeError;
+    }
+
+    const odxf::Tables tables{ generateTables(options) };
+    for (const odxf::LineType& lineType : tables.lineTypes) {
+        if (tl::expected<void, odxf::Error> maybeError = writer.lineType(lineType); !maybeError) {
+            return maybeError;
+        }
+    }
+
+    for (const odxf::Layer& layer : tables.layers) {
+        if (tl::expected<void, odxf::Error> maybeError = writer.layer(layer); !maybeError) {
+            return maybeError;
+        }
+    }
+
+    if (tl::expected<void, odxf::Error> maybeError = writer.beginEntities(); !maybeError) {
+        return maybeError;
+    }
+
+    const TypeCounts counts{ distributeCounts(options.entityCount, options.mix) };
+
+    return streamEntities<odxf::Point>(
+               options,
+               PointIndex,
+               counts[PointIndex],
+               [&](const odxf::Point& point) { return writer.point(point); })
+        .and_then([&] {
+            return streamEntities<odxf::Ray>(
+                options, RayIndex, counts[RayIndex], [&](const odxf::Ray& ray) {
+                    return writer.ray(ray);
+                });
+        })
+        .and_then([&] {
+            return streamEntities<odxf::Line>(
+                options, LineIndex, counts[LineIndex], [&](const odxf::Line& line) {
+                    return writer.line(line);
+                });
+        })
+        .and_then([&] {
+            return streamEntities<odxf::Circle>(
+                options, CircleIndex, counts[CircleIndex], [&](const odxf::Circle& circle) {
+                    return writer.circle(circle);
+                });
+        })
+        .and_then([&] {
+            return streamEntities<odxf::Arc>(
+                options, ArcIndex, counts[ArcIndex], [&](const odxf::Arc& arc) {
+                    return writer.arc(arc);
+                });
+        })
+        .and_then([&] {
+            return streamEntities<odxf::Ellipse>(
+                options, EllipseIndex, counts[EllipseIndex], [&](const odxf::Ellipse& ellipse) {
+                    return writer.ellipse(ellipse);
+                });
+        })
+        .and_then([&] {
+            return streamEntities<odxf::LWPolyline>(
+                options,
+                LWPolylineIndex,
+                counts[LWPolylineIndex],
+                [&](const odxf::LWPolyline& lwPolyline) { return writer.lwPolyline(lwPolyline); });
+        })
+        .and_then([&] { return writer.finish(); });
+}
+
+}   // namespace
+
+namespace odxf {
+
+Document generateDocument(const GeneratorOptions& options)
+{
+    const TypeCounts counts{ distributeCounts(options.entityCount, options.mix) };
+
+    Document document;
+    document.header = generateHeader(options);
+    document.tables = generateTables(options);
+
+    Entities& entities{ document.entities };
+    entities.points = generateEntities<Point>(options, PointIndex, counts[PointIndex]);
+    entities.rays = generateEntities<Ray>(options, RayIndex, counts[RayIndex]);
+    entities.lines = generateEntities<Line>(options, LineIndex, counts[LineIndex]);
+    entities.circles = generateEntities<Circle>(options, CircleIndex, counts[CircleIndex]);
+    entities.arcs = generateEntities<Arc>(options, ArcIndex, counts[ArcIndex]);
+    entities.ellipses = generateEntities<Ellipse>(options, EllipseIndex, counts[EllipseIndex]);
+    entities.lwPolylines =
+        generateEntities<LWPolyline>(options, LWPolylineIndex, counts[LWPolylineIndex]);
+
+    return document;
+}
+
+tl::expected<void, Error>
+generateDxf(const GeneratorOptions& options, IOutputSink& sink, const WriteOptions& writeOptions)
+{
+    GroupCodePaddingSink paddingSink{ sink };
+    IOutputSink& outputSink{ options.padding == Padding::GroupCodes ? paddingSink : sink };
+
+    DxfWriter writer{ outputSink, writeOptions };
+
+    return streamDocument(options, writer);
+}
+
+tl::expected<void, Error> generateDxf(
+    const GeneratorOptions& options,
+    const std::filesystem::path& filePath,
+    const WriteOptions& writeOptions)
+{
+    FileSink sink{ filePath };
+    if (tl::expected<void, Error> openResult = sink.openError(); !openResult) {
+        return openResult;
+    }
+
+    return generateDxf(options, sink, writeOptions);
+}
+
+std::size_t entityCountForSize(const GeneratorOptions& options, std::uintmax_t size)
+{
+    constexpr std::size_t sampleCount{ 4096 };
+
+    const auto outputSize{ [&options](std::size_t entityCount) {
+        GeneratorOptions sampleOptions{ options };
+        sampleOptions.entityCount = entityCount;
+
+        std::uintmax_t bytes{ 0 };
+        CallbackSink sink{ [&bytes](std::string_view block) {
+            bytes += block.size();
+            return true;
+        } };
+        generateDxf(sampleOptions, sink);
+
+        return bytes;
+    } };
+
+    const std::uintmax_t baseSize{ outputSize(0) };
+    const std::uintmax_t sampleSize{ outputSize(sampleCount) };
+    if (size <= baseSize || sampleSize <= baseSize) {
+        return 0;
+    }
+
+    return static_cast<std::size_t>((size - baseSize) * sampleCount / (sampleSize - baseSize));
+}
+
+}   // namespace odxf
@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+
+#include "parsenumber.hpp"
+
+#include <fmt/core.h>
+#include <tl/expected.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using odxf::parseNumber;
+
+constexpr std::string_view usage{
+    R"(usage: opendxf-generate [options] <output file, - for stdout>
+
+options:
+  --count <n>          number of entities, default 10000
+  --size <bytes>       approximate output size, e.g. 500K, 100M or 2G, overrides --count
+  --mix <type=weight>  comma separated weights of points, rays, lines, circles, arcs,
+                       ellipses and lwpolylines, e.g. lines=3,arcs=1
+  --layers <n>         number of layers, default 16
+  --vertices <spec>    lw polyline vertex counts: fixed:<n>, uniform:<min>:<max> or
+                       geometric:<mean>:<min>:<max>, default uniform:2:16
+  --bulges <fraction>  fraction of vertices with a bulge, default 0.1
+  --extent <size>      size of the drawing area, default 10000
+  --padding <style>    none or groupcodes, default none
+  --seed <n>           random seed, default 1
+  --async              write on a background thread
+)"
+};
+
+struct Arguments final
+{
+    odxf::GeneratorOptions options;
+    std::optional<std::uintmax_t> size;
+    bool asyncOutput{ false };
+    std::string output;
+};
+
+std::vector<std::string_view> split(std::string_view text, char separator)
+{
+    std::vector<std::string_view> parts;
+    while (true) {
+        const std::size_t position{ text.find(separator) };
+        parts.push_back(text.substr(0, position));
+        if (position == std::string_view::npos) {
+            return parts;
+        }
+        text.remove_prefix(position + 1);
+    }
+}
+
+std::optional<std::uintmax_t> parseSize(std::string_view text)
+{
+    std::uintmax_t factor{ 1 };
+    if (!text.empty()) {
+        switch (text.back()) {
+        case 'K': factor = std::uintmax_t{ 1 } << 10; break;
+        case 'M': factor = std::uintmax_t{ 1 } << 20; break;
+        case 'G': factor = std::uintmax_t{ 1 } << 30; break;
+        default: break;
+        }
+    }
+    if (factor != 1) {
+        text.remove_suffix(1);
+    }
+
+    const std::optional<std::uintmax_t> value{ parseNumber<std::uintmax_t>(text) };
+
+    return value ? std::optional<std::uintmax_t>{ *value * factor } : std::nullopt;
+}
+
+tl::expected<odxf::EntityMix, std::string> parseMix(std::string_view text)
+{
+    odxf::EntityMix mix{
+        .lines = 0.0,
+        .circles = 0.0,
+        .arcs = 0.0,
+        .lwPolylines = 0.0,
+    };
+
+    for (std::string_view item : split(text, ',')) {
+        const std::vector<std::string_view> parts{ split(item, '=') };
+        const std::optional<double> weight{
+            parts.size() == 2 ? parseNumber<double>(parts[1]) : std::nullopt
+        };
+        if (!weight) {
+            return tl::make_unexpected(fmt::format("invalid mix entry '{}'", item));
+        }
+
+        const std::string_view type{ parts[0] };
+        if (type == "points") {
+            mix.points = *weight;
+        } else if (type == "rays") {
+            mix.rays = *weight;
+        } else if (type == "lines") {
+            mix.lines = *weight;
+        } else if (type == "circles") {
+            mix.circles = *weight;
+        } else if (type == "arcs") {
+            mix.arcs = *weight;
+        } else if (type == "ellipses") {
+            mix.ellipses = *weight;
+        } else if (type == "lwpolylines") {
+            mix.lwPolylines = *weight;
+        } else {
+            return tl::make_unexpected(fmt::format("unknown entity type '{}'", type));
+        }
+    }
+
+    return mix;
+}
+
+tl::expected<odxf::VertexCounts, std::string> parseVertexCounts(std::string_view text)
+{
+    const std::vector<std::string_view> parts{ split(text, ':') };
+    const auto sizeAt{ [&parts](std::size_t index) {
+        return index < parts.size() ? parseNumber<std::size_t>(parts[index]) : std::nullopt;
+    } };
+
+    if (parts[0] == "fixed" && parts.size() == 2 && sizeAt(1)) {
+        return odxf::VertexCounts{
+            .distribution = odxf::VertexCounts::Distribution::Fixed,
+            .min = *sizeAt(1),
+            .max = *sizeAt(1),
+        };
+    }
+
+    if (parts[0] == "uniform" && parts.size() == 3 && sizeAt(1) && sizeAt(2)) {
+        return odxf::VertexCounts{
+            .distribution = odxf::VertexCounts::Distribution::Uniform,
+            .min = *sizeAt(1),
+            .max = *sizeAt(2),
+        };
+    }
+
+    const std::optional<double> mean{
+        parts.size() == 4 ? parseNumber<double>(parts[1]) : std::nullopt
+    };
+    if (parts[0] == "geometric" && mean && sizeAt(2) && sizeAt(3)) {
+        return odxf::VertexCounts{
+            .distribution = odxf::VertexCounts::Distribution::Geometric,
+            .min = *sizeAt(2),
+            .max = *sizeAt(3),
+            .mean = *mean,
+        };
+    }
+
+    return tl::make_unexpected(fmt::format("invalid vertex count specification '{}'", text));
+}
+
+tl::expected<Arguments, std::string> parseArguments(int argc, char** argv)
+{
+    Arguments arguments;
+
+    for (int i{ 1 }; i < argc; ++i) {
+        const std::string_view argument{ argv[i] };
+
+        if (argument == "--async") {
+            arguments.asyncOutput = true;
+
+            continue;
+        }
+
+        if (!argument.starts_with("--") || argument == "-") {
+            if (!arguments.output.empty()) {
+                return tl::make_unexpected("more than one output file");
+            }
+            arguments.output = argument;
+
+            continue;
+        }
+
+        if (i + 1 == argc) {
+            return tl::make_unexpected(fmt::format("missing value for {}", argument));
+        }
+
+        const std::string_view value{ argv[++i] };
+        const auto invalidValue{ [&] {
+            return tl::make_unexpected(fmt::format("invalid value '{}' for {}", value, argument));
+        } };
+
+        if (argument == "--count") {
+            const std::optional<std::size_t> count{ parseNumber<std::size_t>(value) };
+            if (!count) {
+                return invalidValue();
+            }
+            arguments.options.entityCount = *count;
+        } else if (argument == "--size") {
+            arguments.size = parseSize(value);
+            if (!arguments.size) {
+                return invalidValue();
+            }
+        } else if (argument == "--mix") {
+            tl::expected<odxf::EntityMix, std::string> mix{ parseMix(value) };
+            if (!mix) {
+                return tl::make_unexpected(mix.error());
+            }
+            arguments.options.mix = *mix;
+        } else if (argument == "--layers") {
+            const std::optional<std::size_t> layerCount{ parseNumber<std::size_t>(value) };
+            if (!layerCount) {
+                return invalidValue();
+            }
+            arguments.options.layerCount = *layerCount;
+        } else if (argument == "--vertices") {
+            tl::expected<odxf::VertexCounts, std::string> vertexCounts{
+                parseVertexCounts(value)
+            };
+            if (!vertexCounts) {
+                return tl::make_unexpected(vertexCounts.error());
+            }
+            arguments.options.vertexCounts = *vertexCounts;
+        } else if (argument == "--bulges") {
+            const std::optional<double> bulgeFraction{ parseNumber<double>(value) };
+            if (!bulgeFraction) {
+                return invalidValue();
+            }
+            arguments.options.bulgeFraction = *bulgeFraction;
+        } else if (argument == "--extent") {
+            const std::optional<double> extent{ parseNumber<double>(value) };
+            if (!extent || !(*extent > 0.0)) {
+                return invalidValue();
+            }
+            arguments.options.extent = *extent;
+        } else if (argument == "--padding") {
+            if (value == "none") {
+                arguments.options.padding = odxf::Padding::None;
+            } else if (value == "groupcodes") {
+                arguments.options.padding = odxf::Padding::GroupCodes;
+            } else {
+                return invalidValue();
+            }
+        } else if (argument == "--seed") {
+            const std::optional<std::uint64_t> seed{ parseNumber<std::uint64_t>(value) };
+            if (!seed) {
+                return invalidValue();
+            }
+            arguments.options.seed = *seed;
+        } else {
+            return tl::make_unexpected(fmt::format("unknown option {}", argument));
+        }
+    }
+
+    if (arguments.output.empty()) {
+        return tl::make_unexpected("missing output file");
+    }
+
+    return arguments;
+}
+
+}   // namespace
+
+int main(int argc, char** argv)
+{
+    tl::expected<Arguments, std::string> arguments{ parseArguments(argc, argv) };
+    if (!arguments) {
+        fmt::print(stderr, "error: {}\n\n{}", arguments.error(), usage);
+
+        return EXIT_FAILURE;
+    }
+
+    odxf::GeneratorOptions& options{ arguments->options };
+    if (arguments->size) {
+        options.entityCount = odxf::entityCountForSize(options, *arguments->size);
+    }
+
+    const odxf::WriteOptions writeOptions{ .asyncOutput = arguments->asyncOutput };
+
+    tl::expected<void, odxf::Error> result;
+    if (arguments->output == "-") {
+        odxf::OStreamSink sink{ std::cout };
+        result = odxf::generateDxf(options, sink, writeOptions);
+    } else {
+        const std::filesystem::path filePath{ reinterpret_cast<const char8_t*>(
+            arguments->output.c_str()) };
+        result = odxf::generateDxf(options, filePath, writeOptions);
+    }
+
+    if (!result) {
+        fmt::print(stderr, "error: {}\n", result.error().what);
+
+        return EXIT_FAILURE;
+    }
+
+    fmt::print(stderr, "generated {} entities\n", options.entityCount);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "entities.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace odxf {
+
+struct DeduplicateOptions final
+{
+    // Entities are equal if their values differ by at most the tolerance, see
+    // DiffOptions::tolerance. 0 removes exact duplicates only.
+    double tolerance{ 0.0 };
+    // Merges collinear lines which overlap or touch into a single line. The points of their
+    // infinite lines closest to the origin are compared with the tolerance.
+    bool mergeCollinearLines{ false };
+    // Largest angle in radians between the directions of collinear lines.
+    double angularTolerance{ 1.0e-9 };
+    // Number of threads processing the entity types, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// The indices of the removed entities in ascending order, counted before deduplication.
+struct DeduplicateReport final
+{
+    std::vector<std::size_t> removedArcs;
+    std::vector<std::size_t> removedCircles;
+    // removed duplicates, the lines merged away are listed by mergedLines
+    std::vector<std::size_t> removedLines;
+    std::vector<std::size_t> mergedLines;
+};
+
+// Removes the arcs, circles and lines equal to an earlier one on the same layer with the
+// same color, keeping the order of the remaining ones. A line equals a line with swapped
+// end points. An entity equal to several earlier ones is a duplicate of the first of them.
+DeduplicateReport deduplicate(Entities& entities, const DeduplicateOptions& options = {});
+
+}   // namespace odxf
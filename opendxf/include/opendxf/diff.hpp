@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "document.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace odxf {
+
+struct DiffOptions final
+{
+    // Values are rounded to multiples of the tolerance before they are compared, so values
+    // closer than the tolerance still differ if they round to different multiples. 0
+    // compares exactly.
+    double tolerance{ 0.0 };
+    // Number of threads comparing the entity types, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// Entities of one type, compared regardless of their order. Of the entities without an
+// equal counterpart, those on the same layer are paired in order as changed.
+template <typename T>
+struct EntityDiff final
+{
+    // indices into the entities of the first document
+    std::vector<std::size_t> removed;
+    // indices into the entities of the second document
+    std::vector<std::size_t> added;
+    // indices into the entities of the first and the second document
+    std::vector<std::pair<std::size_t, std::size_t>> changed;
+
+    bool empty() const { return removed.empty() && added.empty() && changed.empty(); }
+};
+
+// Differences between two documents, the names are sorted.
+struct DocumentDiff final
+{
+    std::vector<std::string> addedHeaderEntries;
+    std::vector<std::string> removedHeaderEntries;
+    std::vector<std::string> changedHeaderEntries;
+
+    std::vector<std::string> addedLineTypes;
+    std::vector<std::string> removedLineTypes;
+    std::vector<std::string> changedLineTypes;
+
+    // layers are compared by the names of their line types
+    std::vector<std::string> addedLayers;
+    std::vector<std::string> removedLayers;
+    std::vector<std::string> changedLayers;
+
+    EntityDiff<Arc> arcs;
+    EntityDiff<Circle> circles;
+    EntityDiff<Ellipse> ellipses;
+    EntityDiff<Line> lines;
+    EntityDiff<Point> points;
+    EntityDiff<LWPolyline> lwPolylines;
+    EntityDiff<Ray> rays;
+
+    bool empty() const;
+};
+
+// Compares the documents in time linear in their size.
+DocumentDiff diff(const Document& first, const Document& second, const DiffOptions& options = {});
+
+}   // namespace odxf
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "entities.hpp"
+#include "error.hpp"
+#include "header.hpp"
+#include "outputsink.hpp"
+#include "tables.hpp"
+#include "write.hpp"
+
+#include <tl/expected.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <ranges>
+
+namespace odxf {
+
+// Writes a DXF file incrementally, section by section, without a Document in memory.
+//
+// The sections must be written in the order HEADER, TABLES, ENTITIES; sections which
+// are skipped are written empty. Calls out of order fail with Error::Type::InvalidOrder
+// and leave the writer unchanged. Only the records of the TABLES section and the
+// vertices of the lw polyline being written are buffered, so memory stays bounded for
+// any number of entities. finish() must be called to complete the file.
+//
+// Errors of the output, e.g. a file which cannot be opened, are reported by the call
+// which encounters them and by every call after that.
+class DxfWriter final
+{
+public:
+    explicit DxfWriter(const std::filesystem::path& filePath, const WriteOptions& options = {});
+    // The sink must outlive the writer.
+    explicit DxfWriter(IOutputSink& sink, const WriteOptions& options = {});
+    ~DxfWriter();
+
+    DxfWriter(const DxfWriter&) = delete;
+    DxfWriter(DxfWriter&&) noexcept;
+    DxfWriter& operator=(const DxfWriter&) = delete;
+    DxfWriter& operator=(DxfWriter&&) noexcept;
+
+    tl::expected<void, Error> beginHeader();
+    tl::expected<void, Error> headerVariable(const HeaderKey& key, const HeaderValue& value);
+
+    tl::expected<void, Error> beginTables();
+    tl::expected<void, Error> lineType(const LineType& lineType);
+    // Layer::lineType indexes the line types written before, fails with
+    // Error::Type::InvalidReference otherwise.
+    tl::expected<void, Error> layer(const Layer& layer);
+
+    tl::expected<void, Error> beginEntities();
+    tl::expected<void, Error> point(const Point& point);
+    tl::expected<void, Error> ray(const Ray& ray);
+    tl::expected<void, Error> line(const Line& line);
+    tl::expected<void, Error> circle(const Circle& circle);
+    tl::expected<void, Error> arc(const Arc& arc);
+    tl::expected<void, Error> ellipse(const Ellipse& ellipse);
+    tl::expected<void, Error> lwPolyline(const LWPolyline& lwPolyline);
+
+    // Writes an lw polyline whose vertices are produced by any input range, e.g. a lazily
+    // evaluated view. The vertex count need not be known in advance.
+    template <std::ranges::input_range R>
+    tl::expected<void, Error> lwPolyline(const Entity& entity, bool isClosed, R&& vertices)
+    {
+        if (tl::expected<void, Error> maybeError = beginLWPolyline(entity, isClosed);
+            !maybeError) {
+            return maybeError;
+        }
+
+        for (const Vertex& vertex : vertices) {
+            lwPolylineVertex(vertex);
+        }
+
+        return endLWPolyline();
+    }
+
+    tl::expected<void, Error> beginLWPolyline(const Entity& entity, bool isClosed);
+    tl::expected<void, Error> lwPolylineVertex(const Vertex& vertex);
+    tl::expected<void, Error> endLWPolyline();
+
+    // Writes all entities at once, in parallel if requested by the WriteOptions.
+    tl::expected<void, Error> entities(const Entities& entities);
+
+    tl::expected<void, Error> finish();
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> m_impl;
+};
+
+}   // namespace odxf
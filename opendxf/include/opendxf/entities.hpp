@@ -5,6 +5,8 @@
 
 #include "opendxf/coordinate.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <numbers>
 #include <optional>
 #include <string>
@@ -113,4 +115,18 @@ struct Entities final
     Rays rays;
 };
 
+// The types of entities, in the order of the members of Entities.
+enum class EntityType : std::uint8_t
+{
+    Arc,
+    Circle,
+    Ellipse,
+    Line,
+    Point,
+    LWPolyline,
+    Ray
+};
+
+inline constexpr std::size_t entityTypeCount{ static_cast<std::size_t>(EntityType::Ray) + 1 };
+
 }   // namespace odxf
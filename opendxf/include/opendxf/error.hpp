@@ -13,7 +13,11 @@ struct Error final
     enum class Type
     {
         FileOpenError,
-        InvalidFile
+        FileWriteError,
+        InvalidFile,
+        InvalidOrder,
+        InvalidReference,
+        TooManyEntities
     };
 
     Type type{ Type::InvalidFile };
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "coordinate.hpp"
+#include "entities.hpp"
+
+#include <limits>
+
+namespace odxf {
+
+// Axis aligned bounding box in world coordinates, empty until the first coordinate is added.
+struct Extents final
+{
+    Coordinate3d min{
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(),
+    };
+    Coordinate3d max{
+        -std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(),
+    };
+
+    bool isEmpty() const { return min.x > max.x; }
+
+    // NaN coordinates are ignored.
+    void add(const Coordinate3d& coordinate)
+    {
+        min.x = coordinate.x < min.x ? coordinate.x : min.x;
+        min.y = coordinate.y < min.y ? coordinate.y : min.y;
+        min.z = coordinate.z < min.z ? coordinate.z : min.z;
+        max.x = coordinate.x > max.x ? coordinate.x : max.x;
+        max.y = coordinate.y > max.y ? coordinate.y : max.y;
+        max.z = coordinate.z > max.z ? coordinate.z : max.z;
+    }
+
+    void add(const Extents& other)
+    {
+        min.x = other.min.x < min.x ? other.min.x : min.x;
+        min.y = other.min.y < min.y ? other.min.y : min.y;
+        min.z = other.min.z < min.z ? other.min.z : min.z;
+        max.x = other.max.x > max.x ? other.max.x : max.x;
+        max.y = other.max.y > max.y ? other.max.y : max.y;
+        max.z = other.max.z > max.z ? other.max.z : max.z;
+    }
+};
+
+// Exact extents of an entity in world coordinates. Circles, arcs and ellipses are bounded
+// by the extreme points they pass, not by their control points, and lw polylines by their
+// bulged segments. Rays contribute their start point only, thicknesses are ignored.
+Extents extents(const Arc& arc);
+Extents extents(const Circle& circle);
+Extents extents(const Ellipse& ellipse);
+Extents extents(const Line& line);
+Extents extents(const LWPolyline& lwPolyline);
+Extents extents(const Point& point);
+Extents extents(const Ray& ray);
+
+struct ExtentsOptions final
+{
+    // Number of threads bounding ranges of entities, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// The union of the extents of all entities, empty if there are none.
+Extents computeExtents(const Entities& entities, const ExtentsOptions& options = {});
+
+}   // namespace odxf
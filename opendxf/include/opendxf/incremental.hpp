@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "document.hpp"
+#include "entities.hpp"
+#include "error.hpp"
+#include "header.hpp"
+#include "tables.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace odxf {
+
+// Replaces removedCount entities of one type, starting at index in the previous document,
+// by the inserted ones. The first min(removedCount, inserted.size()) entities count as
+// modified, the remaining ones as added or removed.
+template <typename T>
+struct EntitySplice final
+{
+    std::size_t index{ 0 };
+    std::size_t removedCount{ 0 };
+    std::vector<T> inserted;
+};
+
+template <typename T>
+using EntitySplices = std::vector<EntitySplice<T>>;
+
+struct DeltaCounts final
+{
+    std::size_t added{ 0 };
+    std::size_t removed{ 0 };
+    std::size_t modified{ 0 };
+};
+
+// Changes between two consecutive reads of an IncrementalReader. The splices of each type
+// are ordered by index and do not overlap.
+struct DocumentDelta final
+{
+    // set if the sections before the entities changed
+    std::optional<Header> header;
+    std::optional<Tables> tables;
+
+    EntitySplices<Arc> arcs;
+    EntitySplices<Circle> circles;
+    EntitySplices<Ellipse> ellipses;
+    EntitySplices<Line> lines;
+    EntitySplices<Point> points;
+    EntitySplices<LWPolyline> lwPolylines;
+    EntitySplices<Ray> rays;
+
+    // size of the entity records parsed to compute the delta
+    std::uint64_t parsedBytes{ 0 };
+
+    DeltaCounts counts() const;
+    bool empty() const;
+};
+
+// Updates the document of the previous read to the one of the read the delta came from.
+void applyDelta(Document& document, DocumentDelta&& delta);
+
+struct IncrementalOptions final
+{
+    // Number of threads hashing and parsing the entities, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// Reads successive versions of a file and reports the changes between them. Only hashes of
+// the entity records are kept from the previous read, the entities of unchanged records
+// are neither parsed nor reported again. Entities have no identity of their own, so an
+// entity whose records changed counts as modified if it stays in place and as removed
+// and added if entities before it changed as well.
+class IncrementalReader final
+{
+public:
+    explicit IncrementalReader(IncrementalOptions options = {});
+    ~IncrementalReader();
+
+    IncrementalReader(const IncrementalReader&) = delete;
+    IncrementalReader(IncrementalReader&&) noexcept;
+    IncrementalReader& operator=(const IncrementalReader&) = delete;
+    IncrementalReader& operator=(IncrementalReader&&) noexcept;
+
+    // The first read reports the whole document as inserted. A failed read keeps the
+    // state of the previous one.
+    tl::expected<DocumentDelta, Error> read(const std::filesystem::path& filePath);
+    tl::expected<DocumentDelta, Error> readContent(std::string_view content);
+
+    // Forgets the previous read, the next one reports the whole document again.
+    void reset();
+
+private:
+    struct State;
+
+    IncrementalOptions m_options;
+    std::unique_ptr<State> m_state;
+};
+
+}   // namespace odxf
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "document.hpp"
+
+#include <cstddef>
+
+namespace odxf {
+
+// Heap bytes of a container: used by its elements and reserved in total.
+struct MemoryUsage final
+{
+    std::size_t used{ 0 };
+    std::size_t reserved{ 0 };
+
+    MemoryUsage& operator+=(const MemoryUsage& other)
+    {
+        used += other.used;
+        reserved += other.reserved;
+
+        return *this;
+    }
+};
+
+// Heap memory owned by a Document, excluding the Document object itself. The hash
+// map nodes of the header are estimated from the standard library's node layout,
+// allocator overhead is not included.
+struct DocumentMemoryUsage final
+{
+    // nodes and bucket array of the header entries
+    MemoryUsage header;
+
+    MemoryUsage lineTypes;
+    MemoryUsage layers;
+
+    MemoryUsage arcs;
+    MemoryUsage circles;
+    MemoryUsage ellipses;
+    MemoryUsage lines;
+    MemoryUsage points;
+    MemoryUsage lwPolylines;
+    MemoryUsage rays;
+
+    // vertex arrays of all lw polylines
+    MemoryUsage vertices;
+
+    // heap buffers of all strings, i.e. names and values too long for the small
+    // string buffer
+    MemoryUsage strings;
+
+    MemoryUsage total() const;
+};
+
+DocumentMemoryUsage memoryUsage(const Document& document);
+
+// Releases the reserved but unused memory of every container and string.
+void shrinkToFit(Document& document);
+
+}   // namespace odxf
@@ -4,12 +4,28 @@
 #pragma once
 
 #include "coordinate.hpp"
+#include "deduplicate.hpp"
+#include "diff.hpp"
 #include "document.hpp"
+#include "dxfwriter.hpp"
 #include "entities.hpp"
 #include "error.hpp"
+#include "extents.hpp"
 #include "header.hpp"
+#include "incremental.hpp"
 #include "ireadstream.hpp"
 #include "layer.hpp"
+#include "memoryusage.hpp"
+#include "outputsink.hpp"
+#include "parsecache.hpp"
+#include "prescan.hpp"
 #include "read.hpp"
+#include "readstats.hpp"
+#include "sidecar.hpp"
+#include "snapshot.hpp"
+#include "spatialindex.hpp"
 #include "tables.hpp"
+#include "tessellate.hpp"
+#include "trace.hpp"
+#include "transform.hpp"
 #include "write.hpp"
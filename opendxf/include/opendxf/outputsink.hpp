@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "error.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace odxf {
+
+// Destination of the bytes produced by the writers. The writers collect their output
+// in a large buffer and pass it on in blocks of typically 1 MiB.
+class IOutputSink
+{
+public:
+    IOutputSink() = default;
+    virtual ~IOutputSink() = 0;
+
+    virtual tl::expected<void, Error> write(std::string_view block) = 0;
+
+    // Hint about the total size of the output, given before the first block. Sinks may
+    // preallocate memory or disk space.
+    virtual tl::expected<void, Error> reserve(std::uintmax_t size);
+
+    // Called once after the last block was written.
+    virtual tl::expected<void, Error> close();
+
+protected:
+    IOutputSink(const IOutputSink&) = default;
+    IOutputSink(IOutputSink&&) = default;
+    IOutputSink& operator=(const IOutputSink&) = default;
+    IOutputSink& operator=(IOutputSink&&) = default;
+};
+
+// Collects the output in a growable memory buffer.
+class MemorySink final : public IOutputSink
+{
+public:
+    tl::expected<void, Error> write(std::string_view block) override;
+    tl::expected<void, Error> reserve(std::uintmax_t size) override;
+
+    const std::string& content() const& { return m_content; }
+    std::string takeContent() { return std::move(m_content); }
+
+private:
+    std::string m_content;
+};
+
+class OStreamSink final : public IOutputSink
+{
+public:
+    explicit OStreamSink(std::ostream& stream);
+
+    tl::expected<void, Error> write(std::string_view block) override;
+    tl::expected<void, Error> close() override;
+
+private:
+    std::ostream& m_stream;
+};
+
+// Passes every block to a user callback, which returns false to abort writing.
+class CallbackSink final : public IOutputSink
+{
+public:
+    using Callback = std::function<bool(std::string_view block)>;
+
+    explicit CallbackSink(Callback callback);
+
+    tl::expected<void, Error> write(std::string_view block) override;
+
+private:
+    Callback m_callback;
+};
+
+// Writes to a file which is created or truncated. Errors opening the file are
+// reported by the first write.
+//
+// On POSIX systems the file is written with unbuffered system calls and reserve()
+// preallocates the disk space, the part not written is released on close().
+class FileSink final : public IOutputSink
+{
+public:
+    explicit FileSink(const std::filesystem::path& filePath);
+    ~FileSink() override;
+
+    FileSink(const FileSink&) = delete;
+    FileSink(FileSink&&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+    FileSink& operator=(FileSink&&) = delete;
+
+    bool isOpen() const;
+    tl::expected<void, Error> openError() const;
+
+    tl::expected<void, Error> write(std::string_view block) override;
+    tl::expected<void, Error> reserve(std::uintmax_t size) override;
+    tl::expected<void, Error> close() override;
+
+private:
+    std::filesystem::path m_filePath;
+    bool m_isOpen{ false };
+    int m_fileDescriptor{ -1 };
+    std::uintmax_t m_reserved{ 0 };
+    std::uintmax_t m_written{ 0 };
+    // used where POSIX file descriptors are not available
+    std::ofstream m_stream;
+};
+
+// Writes to a raw POSIX file descriptor, e.g. a socket or pipe. The descriptor is
+// not closed by the sink.
+class FileDescriptorSink final : public IOutputSink
+{
+public:
+    explicit FileDescriptorSink(int fileDescriptor);
+
+    tl::expected<void, Error> write(std::string_view block) override;
+
+private:
+    int m_fileDescriptor{ -1 };
+};
+
+}   // namespace odxf
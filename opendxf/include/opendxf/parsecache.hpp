@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "document.hpp"
+#include "error.hpp"
+#include "read.hpp"
+
+#include <tl/expected.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+namespace odxf {
+
+class IReadStream;
+
+struct ParseCacheOptions final
+{
+    enum class Key
+    {
+        // hash of the file content, the file is still loaded but not parsed on a hit
+        ContentHash,
+        // path, size, modification time and inode, a hit does not touch the file at all
+        // but a file rewritten within the timestamp resolution may be missed
+        FileMetadata
+    };
+
+    // created on the first store
+    std::filesystem::path directory;
+    // The least recently used entries are evicted once the entries exceed the budget.
+    std::uintmax_t maxSize{ std::uintmax_t{ 1 } << 30 };
+    Key key{ Key::ContentHash };
+};
+
+struct ParseCacheStats final
+{
+    std::uint64_t hits{ 0 };
+    std::uint64_t misses{ 0 };
+    // entries written after a miss and entries which could not be written
+    std::uint64_t stores{ 0 };
+    std::uint64_t storeFailures{ 0 };
+    std::uint64_t evictions{ 0 };
+};
+
+// Caches parsed files as snapshots, see snapshot.hpp, in a local directory. Failing to
+// write to the cache never fails a read, it is counted in ParseCacheStats instead.
+// Several threads and processes may share a cache directory.
+class ParseCache final
+{
+public:
+    explicit ParseCache(ParseCacheOptions options);
+
+    // As odxf::readDocument, the sidecar index of ReadOptions::sidecarPath being written on
+    // hits as well. On a hit only the durations of ReadOptions::stats are filled.
+    tl::expected<Document, Error>
+    readDocument(const std::filesystem::path& filePath, const ReadOptions& options = {});
+
+    // As odxf::read, but on a hit the entities are passed to the stream grouped by type
+    // instead of in file order.
+    tl::expected<void, Error> read(IReadStream& stream, const std::filesystem::path& filePath);
+
+    ParseCacheStats stats() const;
+
+    // Removes all entries of the cache directory. Temporary files left by interrupted
+    // stores are removed here and when evicting, once they are an hour old.
+    void clear();
+
+private:
+    struct Entry;
+
+    tl::expected<Entry, Error> lookup(const std::filesystem::path& filePath) const;
+    void store(const Entry& entry, const Document& document);
+    void evict(const std::filesystem::path& storedPath);
+
+    ParseCacheOptions m_options;
+
+    std::atomic<std::uint64_t> m_hits{ 0 };
+    std::atomic<std::uint64_t> m_misses{ 0 };
+    std::atomic<std::uint64_t> m_stores{ 0 };
+    std::atomic<std::uint64_t> m_storeFailures{ 0 };
+    std::atomic<std::uint64_t> m_evictions{ 0 };
+};
+
+}   // namespace odxf
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "error.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <filesystem>
+
+namespace odxf {
+
+struct EntityCounts final
+{
+    std::size_t arcs{ 0 };
+    std::size_t circles{ 0 };
+    std::size_t ellipses{ 0 };
+    std::size_t lines{ 0 };
+    std::size_t points{ 0 };
+    std::size_t lwPolylines{ 0 };
+    std::size_t rays{ 0 };
+    std::size_t other{ 0 };
+
+    // sum of the vertices of all LWPOLYLINE entities, e.g. to estimate the memory of a read
+    std::size_t lwPolylineVertices{ 0 };
+};
+
+struct DocumentCounts final
+{
+    std::size_t headerEntries{ 0 };
+    std::size_t lineTypes{ 0 };
+    std::size_t layers{ 0 };
+    EntityCounts entities;
+};
+
+// Counts the records of a DXF file by looking at group codes and type names only.
+// No values are parsed, so this is considerably cheaper than a full read and
+// intended to size containers up front.
+tl::expected<DocumentCounts, Error> prescan(const std::filesystem::path& filePath);
+
+}   // namespace odxf
@@ -3,16 +3,49 @@
 
 #pragma once
 
+#include "document.hpp"
 #include "error.hpp"
+#include "readstats.hpp"
 
 #include <tl/expected.hpp>
 
 #include <filesystem>
+#include <optional>
 
 namespace odxf {
 
 class IReadStream;
 
-tl::expected<void, Error> read(IReadStream& stream, const std::filesystem::path& filePath);
+struct ReadOptions final
+{
+    // Count the records first, so the header, table and entity containers of the Document
+    // are allocated once. Each thread parsing entities still grows its own containers,
+    // which are moved into the reserved ones. Lw polylines reserve their vertices from
+    // their vertex count either way.
+    bool prescan{ true };
+
+    // Number of threads parsing the ENTITIES section, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+
+    // filled with the statistics of the read if set
+    ReadStats* stats{ nullptr };
+
+    // If not empty, a sidecar index of the file is written to this path after a
+    // successful read, see SidecarIndex.
+    std::filesystem::path sidecarPath;
+
+    // The read succeeds even if the sidecar index cannot be written. If set, this is
+    // reset by the read and then holds the error of writing the index, if any.
+    std::optional<Error>* sidecarError{ nullptr };
+};
+
+// The statistics are filled if stats is not null, also when reading fails.
+tl::expected<void, Error>
+read(IReadStream& stream, const std::filesystem::path& filePath, ReadStats* stats = nullptr);
+
+// Reads the whole file into a Document. Records are constructed in place inside the
+// containers of the Document, no intermediate copies are made.
+tl::expected<Document, Error>
+readDocument(const std::filesystem::path& filePath, const ReadOptions& options = {});
 
 }   // namespace odxf
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace odxf {
+
+struct SectionStats final
+{
+    std::uint64_t bytes{ 0 };
+    std::uint64_t groupCodes{ 0 };
+    std::chrono::nanoseconds duration{ 0 };
+};
+
+// Statistics of a single read, filled when passed to read() or readDocument(). Without
+// it the reader does not measure anything.
+struct ReadStats final
+{
+    // loading the file into memory
+    std::chrono::nanoseconds loadDuration{ 0 };
+    std::chrono::nanoseconds totalDuration{ 0 };
+
+    SectionStats header;
+    SectionStats tables;
+    SectionStats blocks;
+    SectionStats entities;
+
+    // entity counts by type name, e.g. "LINE"
+    std::map<std::string, std::uint64_t, std::less<>> parsedEntities;
+    std::map<std::string, std::uint64_t, std::less<>> skippedEntities;
+
+    // Records which failed to parse. Reading stops at the first failure, except that
+    // every chunk read in parallel may fail on its own.
+    std::uint64_t parseFailures{ 0 };
+
+    // the largest amount of input held in memory at once
+    std::uint64_t peakBufferedBytes{ 0 };
+};
+
+}   // namespace odxf
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "document.hpp"
+#include "entities.hpp"
+#include "error.hpp"
+#include "header.hpp"
+#include "spatialindex.hpp"
+#include "tables.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Sidecar indices of DXF files, written next to a DXF file while reading it, see
+// ReadOptions::sidecarPath.
+//
+// A sidecar index stores the byte range, type, layer and xy extents of every entity
+// record the reader parses, i.e. of every arc, circle, line and lw polyline, together
+// with the offsets of the ENTITIES section and hashes of the DXF file. Later opens
+// validate the DXF file against the hashes, read the sections preceding the entities
+// and then parse only the records of the entities a query selects, seeking to their
+// byte ranges in the DXF file.
+
+namespace odxf {
+
+struct SidecarOptions final
+{
+    // Hash the whole DXF file on open. Otherwise only its size and the sections preceding
+    // the entities are compared, which misses edits of the entities keeping the size.
+    bool verifyContent{ true };
+
+    // Number of threads parsing the selected entities, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// Selects the entities whose extents intersect the window and which lie on one of the
+// layers, both criteria being optional.
+struct SidecarQuery final
+{
+    std::optional<Box2d> window;
+    // all layers if empty
+    std::vector<std::string> layers;
+};
+
+class SidecarIndex final
+{
+public:
+    // Opens the sidecar index of the DXF file. Fails with Error::Type::InvalidFile if the
+    // index is damaged or of another version, or if it does not match the DXF file.
+    static tl::expected<SidecarIndex, Error> open(
+        const std::filesystem::path& dxfPath,
+        const std::filesystem::path& indexPath,
+        const SidecarOptions& options = {});
+
+    const Header& header() const { return m_document.header; }
+    const Tables& tables() const { return m_document.tables; }
+
+    // number of indexed entities
+    std::size_t size() const { return m_records.size(); }
+
+    // the names of the layers of the indexed entities
+    const std::vector<std::string>& layers() const { return m_layers; }
+
+    // Parses the selected entities from the DXF file, in the order of the file within
+    // each type. The DXF file must not have changed since the index was opened.
+    tl::expected<Entities, Error> read(const SidecarQuery& query) const;
+
+    // Parses all entities with the given extents intersecting the window.
+    tl::expected<Entities, Error> read(const Box2d& window) const;
+
+private:
+    struct Record final
+    {
+        // byte range of the entity's records followed by the group code 0 record of the
+        // next entity, which terminates it for the reader
+        std::uint64_t offset{ 0 };
+        std::uint32_t size{ 0 };
+        std::int32_t lineOffset{ 0 };
+        Box2d box;
+        std::uint32_t layer{ 0 };
+        EntityType type{ EntityType::Line };
+    };
+
+    SidecarIndex() = default;
+
+    std::filesystem::path m_dxfPath;
+    SidecarOptions m_options;
+    // header and tables of the DXF file, without entities
+    Document m_document;
+    std::vector<std::string> m_layers;
+    std::vector<Record> m_records;
+};
+
+}   // namespace odxf
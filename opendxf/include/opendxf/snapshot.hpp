@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "document.hpp"
+#include "entities.hpp"
+#include "error.hpp"
+#include "header.hpp"
+#include "tables.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+// Native binary snapshots of a Document, meant to be memory-mapped and used in place
+// instead of parsing the DXF file again.
+//
+// A snapshot starts with a versioned header carrying the byte order of the machine
+// which wrote it, followed by a table of sections. Strings are stored once in a string
+// table, the entities of each type as columns, one array per member, so a view over a
+// range of entities touches only the pages it reads. Snapshots are only opened on
+// machines with the byte order they were written with.
+
+namespace odxf {
+
+class IOutputSink;
+
+tl::expected<void, Error> writeSnapshot(const Document& document, IOutputSink& sink);
+tl::expected<void, Error>
+writeSnapshot(const Document& document, const std::filesystem::path& filePath);
+
+template <typename T>
+class EntityView;
+
+class Snapshot final
+{
+public:
+    // Maps the file into memory, where supported, and validates its structure. Fails
+    // with Error::Type::InvalidFile for files of another version or byte order.
+    static tl::expected<Snapshot, Error> open(const std::filesystem::path& filePath);
+
+    ~Snapshot();
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot(Snapshot&&) noexcept;
+    Snapshot& operator=(const Snapshot&) = delete;
+    Snapshot& operator=(Snapshot&&) noexcept;
+
+    Header header() const;
+    Tables tables() const;
+
+    EntityView<Arc> arcs() const;
+    EntityView<Circle> circles() const;
+    EntityView<Ellipse> ellipses() const;
+    EntityView<Line> lines() const;
+    EntityView<Point> points() const;
+    EntityView<LWPolyline> lwPolylines() const;
+    EntityView<Ray> rays() const;
+
+    // Copies the whole snapshot into a Document.
+    Document toDocument() const;
+
+private:
+    template <typename T>
+    friend class EntityView;
+
+    struct Impl;
+
+    explicit Snapshot(std::unique_ptr<Impl> impl);
+
+    std::unique_ptr<Impl> m_impl;
+};
+
+// Read-only view over a range of the entities of one type inside a Snapshot. Only the
+// entity accessed is assembled from the columns, strings are views into the snapshot.
+// Views stay valid when the Snapshot is moved, but must not outlive it.
+template <typename T>
+class EntityView final
+{
+public:
+    EntityView() = default;
+
+    std::size_t size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+
+    T operator[](std::size_t index) const;
+
+    std::string_view layer(std::size_t index) const;
+    int color(std::size_t index) const;
+
+    // the entities [begin, end) of this view
+    EntityView subrange(std::size_t begin, std::size_t end) const;
+
+private:
+    friend class Snapshot;
+
+    EntityView(const Snapshot::Impl& snapshot, std::size_t begin, std::size_t end)
+        : m_snapshot{ &snapshot }
+        , m_begin{ begin }
+        , m_end{ end }
+    {
+    }
+
+    const Snapshot::Impl* m_snapshot{ nullptr };
+    std::size_t m_begin{ 0 };
+    std::size_t m_end{ 0 };
+};
+
+}   // namespace odxf
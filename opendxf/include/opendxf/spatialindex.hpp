@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "coordinate.hpp"
+#include "entities.hpp"
+#include "error.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace odxf {
+
+// The entity at an index into the vector of its type.
+struct EntityRef final
+{
+    EntityType type{ EntityType::Line };
+    std::uint32_t index{ 0 };
+
+    friend bool operator==(const EntityRef& lhs, const EntityRef& rhs) = default;
+};
+
+struct Box2d final
+{
+    Coordinate2d min;
+    Coordinate2d max;
+};
+
+struct SpatialIndexOptions final
+{
+    // Maximum number of children per node.
+    std::size_t nodeCapacity{ 16 };
+    // Number of threads bounding and sorting the entities, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// Distance in the xy plane between a point and an entity projected onto it. Exact for
+// points, rays, lines and circular curves parallel to the plane, numerically minimized
+// for other curves.
+double distance(const Entities& entities, EntityRef entity, const Coordinate2d& point);
+
+// Packed R-tree over the extents of the entities projected onto the xy plane, bulk loaded
+// by sort tile recursive packing. Rays are unbounded, they are kept aside and tested on
+// every query. The index refers to the entities by type and index only, the queries
+// measuring distances take the entities the index was built from. Entities without
+// extents, e.g. lw polylines without vertices, are not indexed.
+class SpatialIndex final
+{
+public:
+    SpatialIndex() = default;
+
+    // Builds the index of the entities. Fails with Error::Type::TooManyEntities if there are
+    // more than 2^32 entities of a type, which EntityRef cannot refer to.
+    static tl::expected<SpatialIndex, Error>
+    build(const Entities& entities, const SpatialIndexOptions& options = {});
+
+    // number of indexed entities
+    std::size_t size() const { return m_items.size() + m_rays.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Appends the entities whose extents intersect the window to the result, in no
+    // particular order.
+    void query(const Box2d& window, std::vector<EntityRef>& result) const;
+    std::vector<EntityRef> query(const Box2d& window) const;
+
+    // The entity closest to the point if it is at most the tolerance away.
+    std::optional<EntityRef> nearest(
+        const Entities& entities,
+        const Coordinate2d& point,
+        double tolerance = std::numeric_limits<double>::infinity()) const;
+
+    // All entities at most the tolerance away from the point, the closest first.
+    std::vector<EntityRef>
+    pick(const Entities& entities, const Coordinate2d& point, double tolerance) const;
+
+private:
+    SpatialIndex(const Entities& entities, const SpatialIndexOptions& options);
+
+    // rays projected onto the xy plane
+    struct IndexedRay final
+    {
+        Coordinate2d start;
+        Coordinate2d direction;
+        std::uint32_t index{ 0 };
+    };
+
+    std::size_t m_nodeCapacity{ 16 };
+    // the boxes of the items followed by those of the nodes level by level, the root last
+    std::vector<Box2d> m_boxes;
+    // offsets of the levels into the boxes, the items being level 0, and the total count
+    std::vector<std::size_t> m_levelOffsets;
+    // the entities of the item boxes
+    std::vector<EntityRef> m_items;
+    std::vector<IndexedRay> m_rays;
+};
+
+}   // namespace odxf
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "coordinate.hpp"
+#include "entities.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace odxf {
+
+struct TessellateOptions final
+{
+    // Maximum distance between a curve and the chords replacing it, in drawing units.
+    double chordTolerance{ 0.01 };
+    // Upper bound of the chords per curve, limiting the vertices of tolerances tiny compared
+    // to the radius.
+    std::size_t maxSegments{ 4096 };
+    // Number of threads tessellating ranges of entities, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+};
+
+// Number of vertices tessellate writes for an entity. Arcs and circles are tessellated in
+// their object coordinate system, i.e. their extrusions are ignored.
+std::size_t vertexCount(const Arc& arc, const TessellateOptions& options);
+std::size_t vertexCount(const Circle& circle, const TessellateOptions& options);
+std::size_t vertexCount(const Ellipse& ellipse, const TessellateOptions& options);
+std::size_t vertexCount(const LWPolyline& lwPolyline, const TessellateOptions& options);
+
+// Writes the vertexCount vertices of an entity to the beginning of vertices, which must be
+// large enough. Closed curves repeat their first vertex at the end, lw polylines get the
+// elevation as z coordinate.
+void tessellate(
+    const Arc& arc, const TessellateOptions& options, std::span<Coordinate3d> vertices);
+void tessellate(
+    const Circle& circle, const TessellateOptions& options, std::span<Coordinate3d> vertices);
+void tessellate(
+    const Ellipse& ellipse, const TessellateOptions& options, std::span<Coordinate3d> vertices);
+void tessellate(
+    const LWPolyline& lwPolyline,
+    const TessellateOptions& options,
+    std::span<Coordinate3d> vertices);
+
+// Vertices of many entities, stored contiguously. The vertices of entity i are those in
+// [offsets[i], offsets[i + 1]).
+struct Tessellation final
+{
+    std::vector<Coordinate3d> vertices;
+    std::vector<std::size_t> offsets;
+
+    std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    std::span<const Coordinate3d> operator[](std::size_t index) const
+    {
+        return std::span<const Coordinate3d>{ vertices }.subspan(
+            offsets[index], offsets[index + 1] - offsets[index]);
+    }
+};
+
+// Tessellates all entities into a single allocation, counting the vertices first.
+Tessellation tessellate(const Arcs& arcs, const TessellateOptions& options = {});
+Tessellation tessellate(const Circles& circles, const TessellateOptions& options = {});
+Tessellation tessellate(const Ellipses& ellipses, const TessellateOptions& options = {});
+Tessellation tessellate(const LWPolylines& lwPolylines, const TessellateOptions& options = {});
+
+}   // namespace odxf
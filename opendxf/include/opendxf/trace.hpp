@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "error.hpp"
+
+#include <tl/expected.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace odxf {
+
+class IOutputSink;
+
+struct TraceEvent final
+{
+    std::string_view name;
+    std::string_view category;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::time_point end;
+    // small number identifying the thread, assigned in order of the first traced scope
+    std::uint32_t threadId{ 0 };
+};
+
+// Receives the completed trace scopes. Events arrive from every thread doing work, so
+// implementations must be thread safe.
+class ITraceSink
+{
+public:
+    ITraceSink() = default;
+    virtual ~ITraceSink() = 0;
+
+    virtual void event(const TraceEvent& event) = 0;
+
+protected:
+    ITraceSink(const ITraceSink&) = default;
+    ITraceSink(ITraceSink&&) = default;
+    ITraceSink& operator=(const ITraceSink&) = default;
+    ITraceSink& operator=(ITraceSink&&) = default;
+};
+
+// Writes the events in the Chrome trace event format, which chrome://tracing and
+// Perfetto (ui.perfetto.dev) open directly.
+class ChromeTraceSink final : public ITraceSink
+{
+public:
+    explicit ChromeTraceSink(IOutputSink& sink);
+    ~ChromeTraceSink() override;
+
+    ChromeTraceSink(const ChromeTraceSink&) = delete;
+    ChromeTraceSink& operator=(const ChromeTraceSink&) = delete;
+
+    void event(const TraceEvent& event) override;
+
+    // Completes the JSON document and closes the output sink. Returns the first error
+    // of the output sink, also from writing earlier events.
+    tl::expected<void, Error> close();
+
+private:
+    std::mutex m_mutex;
+    IOutputSink& m_sink;
+    std::string m_record;
+    bool m_isFirst{ true };
+    bool m_isClosed{ false };
+    std::optional<Error> m_error;
+};
+
+// Installs the sink receiving the trace events of all threads, nullptr stops tracing.
+// The sink must outlive every read or write started while it is installed.
+void setTraceSink(ITraceSink* sink);
+
+// Whether the library was built with OPENDXF_ENABLE_TRACING. Without it the library
+// emits no events of its own, but TraceScope still works for user code.
+bool isTracingEnabled();
+
+// Emits an event covering its lifetime, if a sink is installed when it is constructed.
+// The name and category must outlive the scope.
+class TraceScope final
+{
+public:
+    explicit TraceScope(std::string_view name, std::string_view category = "user");
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    ITraceSink* m_sink;
+    std::string_view m_name;
+    std::string_view m_category;
+    std::chrono::steady_clock::time_point m_begin;
+};
+
+}   // namespace odxf
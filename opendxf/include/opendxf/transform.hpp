@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "coordinate.hpp"
+#include "entities.hpp"
+
+#include <array>
+
+namespace odxf {
+
+// Maps a point p to linear * p + translation, linear being stored row by row.
+struct Affine2d final
+{
+    std::array<double, 4> linear{ 1.0, 0.0, 0.0, 1.0 };
+    Coordinate2d translation;
+
+    static Affine2d translate(double x, double y);
+    static Affine2d scale(double factor);
+    static Affine2d scale(double x, double y);
+    // counterclockwise, in degrees like the angles of arcs
+    static Affine2d rotate(double angle);
+};
+
+// The transform applying rhs first and lhs second.
+Affine2d operator*(const Affine2d& lhs, const Affine2d& rhs);
+
+// Maps a point p to linear * p + translation, linear being stored row by row.
+struct Affine3d final
+{
+    std::array<double, 9> linear{ 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+    Coordinate3d translation;
+
+    static Affine3d translate(double x, double y, double z);
+    static Affine3d scale(double factor);
+    static Affine3d scale(double x, double y, double z);
+    // the transform in the xy plane, keeping z
+    static Affine3d fromAffine2d(const Affine2d& affine);
+};
+
+// The transform applying rhs first and lhs second.
+Affine3d operator*(const Affine3d& lhs, const Affine3d& rhs);
+
+struct TransformOptions final
+{
+    // Number of threads transforming ranges of entities, 0 meaning one per hardware thread.
+    unsigned int threadCount{ 1 };
+    // Chord tolerance for the bulged segments of lw polylines which the transform does not
+    // map to circular arcs, see below.
+    double chordTolerance{ 0.01 };
+};
+
+// Transforms all entities, the linear part of the transform must be invertible.
+//
+// Circles and arcs remain circles and arcs if the transform maps their plane conformally,
+// i.e. scales it uniformly, otherwise they are replaced by ellipses appended to the
+// ellipses. Mirrored arcs keep their extrusion and run in the opposite direction. In the
+// same way, bulged segments of lw polylines are tessellated with the chord tolerance if
+// their plane is not mapped conformally. Lw polylines have no extrusion and stay parallel to
+// the xy plane, their mapped vertices are projected onto it. Thicknesses are scaled along
+// their extrusions.
+void transform(Entities& entities, const Affine2d& affine, const TransformOptions& options = {});
+void transform(Entities& entities, const Affine3d& affine, const TransformOptions& options = {});
+
+}   // namespace odxf
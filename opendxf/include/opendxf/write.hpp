@@ -4,11 +4,66 @@
 #pragma once
 
 #include "document.hpp"
+#include "error.hpp"
 
+#include <tl/expected.hpp>
+
+#include <cstdint>
 #include <filesystem>
 
 namespace odxf {
 
-void writeDxf(const Document& document, const std::filesystem::path& file_path);
+struct NumberFormat final
+{
+    enum class Type
+    {
+        // shortest representation which reads back to the identical double
+        Shortest,
+        // fixed number of decimals
+        Fixed,
+        // fewest decimals keeping the rounding error below the tolerance
+        Tolerance
+    };
+
+    Type type{ Type::Shortest };
+    int decimals{ 6 };
+    double tolerance{ 1.0e-9 };
+};
+
+struct WriteOptions final
+{
+    // applied to every floating point value, header variables included
+    NumberFormat numberFormat;
+
+    // Number of threads formatting the ENTITIES section, 0 meaning one per hardware thread.
+    // The output is identical for every thread count.
+    unsigned int threadCount{ 1 };
+
+    // Passes the output to the sink on a background thread while the next block is
+    // formatted. The sink is then called from that thread.
+    bool asyncOutput{ false };
+
+    // Expected size of the output in bytes, e.g. from estimateDxfSize(), 0 for none.
+    // File sinks preallocate the disk space up front.
+    std::uintmax_t preallocateSize{ 0 };
+
+    // Replaces the header variables $EXTMIN and $EXTMAX by the extents computed from the
+    // entities, see computeExtents(). Documents without entities keep their variables.
+    bool updateExtents{ false };
+};
+
+class IOutputSink;
+
+// Estimates the size of the DXF output of the document by formatting a sample of its
+// entities. Usually accurate to a few percent.
+std::uintmax_t estimateDxfSize(const Document& document, const WriteOptions& options = {});
+
+tl::expected<void, Error> writeDxf(
+    const Document& document,
+    const std::filesystem::path& file_path,
+    const WriteOptions& options = {});
+
+tl::expected<void, Error>
+writeDxf(const Document& document, IOutputSink& sink, const WriteOptions& options = {});
 
-}
+}   // namespace odxf
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "asyncwriter.hpp"
+
+#include "tracescope.hpp"
+
+namespace odxf {
+
+AsyncWriter::AsyncWriter(IOutputSink& sink)
+    : m_sink{ sink }
+    , m_thread{ [this] { run(); } }
+{
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    m_idle.acquire();
+    m_stop = true;
+    m_ready.release();
+}
+
+tl::expected<void, Error> AsyncWriter::write(std::string_view block)
+{
+    {
+        OPENDXF_TRACE_SCOPE("waitForWriter");
+        m_idle.acquire();
+    }
+
+    if (m_error) {
+        m_idle.release();
+
+        return tl::make_unexpected(*m_error);
+    }
+
+    m_block = block;
+    m_ready.release();
+
+    return {};
+}
+
+tl::expected<void, Error> AsyncWriter::wait()
+{
+    m_idle.acquire();
+    const std::optional<Error> maybeError{ m_error };
+    m_idle.release();
+
+    if (maybeError) {
+        return tl::make_unexpected(*maybeError);
+    }
+
+    return {};
+}
+
+void AsyncWriter::run()
+{
+    while (true) {
+        m_ready.acquire();
+        if (m_stop) {
+            return;
+        }
+
+        {
+            OPENDXF_TRACE_SCOPE("writeBlock");
+            if (tl::expected<void, Error> result = m_sink.write(m_block); !result) {
+                m_error = std::move(result.error());
+            }
+        }
+
+        m_idle.release();
+    }
+}
+
+}   // namespace odxf
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/error.hpp"
+#include "opendxf/outputsink.hpp"
+
+#include <tl/expected.hpp>
+
+#include <optional>
+#include <semaphore>
+#include <string_view>
+#include <thread>
+
+namespace odxf {
+
+// Passes blocks to a sink on a background thread, one block at a time, so the caller
+// can fill its next buffer while the previous one is written.
+class AsyncWriter final
+{
+public:
+    explicit AsyncWriter(IOutputSink& sink);
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter(AsyncWriter&&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(AsyncWriter&&) = delete;
+
+    // Waits until the previous block is written and starts writing block. The memory of
+    // block must stay valid until the next call of write() or wait().
+    tl::expected<void, Error> write(std::string_view block);
+
+    // Waits until the pending block is written. Returns the first error of the sink.
+    tl::expected<void, Error> wait();
+
+private:
+    void run();
+
+    IOutputSink& m_sink;
+    // available while no block is being written
+    std::binary_semaphore m_idle{ 1 };
+    // released when m_block is to be written or m_stop is set
+    std::binary_semaphore m_ready{ 0 };
+    std::string_view m_block;
+    bool m_stop{ false };
+    std::optional<Error> m_error;
+    std::jthread m_thread;
+};
+
+}   // namespace odxf
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/error.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace odxf {
+
+// Shared by the binary files written next to DXF files, i.e. snapshots and sidecar
+// indices. Written in native byte order, a reader compares the mark to detect files
+// written on a machine with a different one.
+inline constexpr std::uint32_t byteOrderMark{ 0x01020304 };
+// sections of the files begin at multiples of this, so their values can be mapped
+inline constexpr std::size_t sectionAlignment{ 8 };
+
+inline std::uint64_t alignUp(std::uint64_t offset)
+{
+    return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+}
+
+inline Error makeInvalidFile(std::string what)
+{
+    return Error{
+        .type = Error::Type::InvalidFile,
+        .what = std::move(what),
+    };
+}
+
+}   // namespace odxf
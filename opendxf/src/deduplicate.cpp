@@ -0,0 +1,524 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/deduplicate.hpp"
+
+#include "geometry.hpp"
+#include "hash.hpp"
+#include "parallel.hpp"
+#include "quantizer.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t noIndex{ std::numeric_limits<std::size_t>::max() };
+
+// Maps every index in [0, count) to the first index equal to it.
+template <typename Hash, typename Equal>
+std::vector<std::size_t> firstEqualIndices(std::size_t count, Hash hash, Equal equal)
+{
+    // The distinct indices with equal hashes are chained, the latest one being the head.
+    std::unordered_map<std::uint64_t, std::size_t> heads;
+    heads.reserve(count);
+    std::vector<std::size_t> next(count, noIndex);
+    std::vector<std::size_t> result(count);
+
+    for (std::size_t i{ 0 }; i < count; ++i) {
+        const auto [iter, isNew]{ heads.try_emplace(hash(i), i) };
+        if (isNew) {
+            result[i] = i;
+            continue;
+        }
+
+        // usually the head itself, unless the hashes collide
+        std::size_t match{ iter->second };
+        while (match != noIndex && !equal(match, i)) {
+            match = next[match];
+        }
+
+        if (match == noIndex) {
+            next[i] = iter->second;
+            iter->second = i;
+            match = i;
+        }
+        result[i] = match;
+    }
+
+    return result;
+}
+
+template <typename T>
+void eraseRemoved(std::vector<T>& entities, const std::vector<bool>& isRemoved)
+{
+    std::size_t count{ 0 };
+    for (std::size_t i{ 0 }; i < entities.size(); ++i) {
+        if (isRemoved[i]) {
+            continue;
+        }
+        if (count != i) {
+            entities[count] = std::move(entities[i]);
+        }
+        ++count;
+    }
+
+    entities.erase(entities.begin() + static_cast<std::ptrdiff_t>(count), entities.end());
+}
+
+// The index of a cell of a grid with cells of the size of the tolerance. Values which differ
+// by at most the tolerance are in the same or in neighbouring cells.
+std::uint64_t cellIndex(double value, double tolerance)
+{
+    // -0.0 and 0.0 are equal
+    value = value == 0.0 ? 0.0 : value;
+
+    if (tolerance > 0.0) {
+        const double scaled{ std::floor(value / tolerance) };
+        if (std::abs(scaled) < 9.0e18) {
+            return static_cast<std::uint64_t>(static_cast<std::int64_t>(scaled));
+        }
+    }
+
+    return std::bit_cast<std::uint64_t>(value);
+}
+
+// The place of an entity in the grid, the hash of its layer and color and a point which
+// differs by at most the tolerance for entities near each other.
+struct GridKey final
+{
+    std::uint64_t hash{ 0 };
+    odxf::Coordinate2d point;
+};
+
+// Maps every index in [0, count) to the first earlier index near it which is mapped to
+// itself, or to itself if there is none. near must hold only for indices whose keys have
+// equal hashes and points which differ by at most the tolerance.
+template <typename Key, typename Near>
+std::vector<std::size_t>
+firstNearIndices(std::size_t count, double tolerance, Key key, Near near)
+{
+    // The indices mapped to themselves are chained by cell, the latest one being the head.
+    std::unordered_map<std::uint64_t, std::size_t> heads;
+    heads.reserve(count);
+    std::vector<std::size_t> next(count, noIndex);
+    std::vector<std::size_t> result(count);
+
+    const auto cellHash{ [](std::uint64_t hash, std::uint64_t x, std::uint64_t y) {
+        const std::array<std::uint64_t, 3> values{ hash, x, y };
+
+        return odxf::hash64(std::string_view{ reinterpret_cast<const char*>(values.data()),
+                                              sizeof(values) });
+    } };
+    // exact values are in the same cell
+    const int reach{ tolerance > 0.0 ? 1 : 0 };
+
+    for (std::size_t i{ 0 }; i < count; ++i) {
+        const GridKey gridKey{ key(i) };
+        const std::uint64_t x{ cellIndex(gridKey.point.x, tolerance) };
+        const std::uint64_t y{ cellIndex(gridKey.point.y, tolerance) };
+
+        std::size_t match{ noIndex };
+        for (int dx{ -reach }; dx <= reach; ++dx) {
+            for (int dy{ -reach }; dy <= reach; ++dy) {
+                const auto iter{ heads.find(cellHash(
+                    gridKey.hash,
+                    x + static_cast<std::uint64_t>(dx),
+                    y + static_cast<std::uint64_t>(dy))) };
+                if (iter == heads.end()) {
+                    continue;
+                }
+
+                for (std::size_t j{ iter->second }; j != noIndex; j = next[j]) {
+                    if (j < match && near(j, i)) {
+                        match = j;
+                    }
+                }
+            }
+        }
+
+        if (match == noIndex) {
+            const auto [iter, isNew]{ heads.try_emplace(cellHash(gridKey.hash, x, y), i) };
+            if (!isNew) {
+                next[i] = iter->second;
+                iter->second = i;
+            }
+            match = i;
+        }
+        result[i] = match;
+    }
+
+    return result;
+}
+
+template <typename T>
+std::uint64_t attributeHash(const T& entity)
+{
+    return odxf::hash64(entity.layer) ^ static_cast<std::uint64_t>(entity.color);
+}
+
+GridKey gridKey(const odxf::Arc& arc)
+{
+    return GridKey{ attributeHash(arc), { arc.center.x, arc.center.y } };
+}
+
+GridKey gridKey(const odxf::Circle& circle)
+{
+    return GridKey{ attributeHash(circle), { circle.center.x, circle.center.y } };
+}
+
+// independent of the direction of the line
+GridKey gridKey(const odxf::Line& line)
+{
+    return GridKey{ attributeHash(line),
+                    { std::min(line.start.x, line.end.x), std::min(line.start.y, line.end.y) } };
+}
+
+void quantizeUndirected(const odxf::Line& line, odxf::Quantizer& quantizer)
+{
+    quantizer.addUnordered(line.start, line.end);
+    quantizer.add(line.extrusion);
+    quantizer.add(line.thickness);
+}
+
+void collectReversed(const odxf::Line& line, odxf::ValueCollector& collector)
+{
+    collector.add(line.end);
+    collector.add(line.start);
+    collector.add(line.extrusion);
+    collector.add(line.thickness);
+}
+
+// Maps every entity to the first one equal to it, exact duplicates are found by their hashes
+// and near ones in the cells around them.
+std::vector<std::size_t> firstEqualEntities(const odxf::Lines& lines, double tolerance)
+{
+    if (tolerance == 0.0) {
+        odxf::EntityComparer<odxf::Line, &quantizeUndirected> comparer{ tolerance };
+
+        return firstEqualIndices(
+            lines.size(),
+            [&](std::size_t i) { return comparer.hash(lines[i]); },
+            [&](std::size_t lhs, std::size_t rhs) {
+                return comparer.equal(lines[lhs], lines[rhs]);
+            });
+    }
+
+    odxf::NearComparer<odxf::Line> directed{ tolerance };
+    odxf::NearComparer<odxf::Line, &odxf::quantize, &collectReversed> reversed{ tolerance };
+
+    return firstNearIndices(
+        lines.size(),
+        tolerance,
+        [&](std::size_t i) { return gridKey(lines[i]); },
+        [&](std::size_t lhs, std::size_t rhs) {
+            return directed.near(lines[lhs], lines[rhs])
+                   || reversed.near(lines[lhs], lines[rhs]);
+        });
+}
+
+template <typename T>
+std::vector<std::size_t> firstEqualEntities(const std::vector<T>& entities, double tolerance)
+{
+    if (tolerance == 0.0) {
+        odxf::EntityComparer<T> comparer{ tolerance };
+
+        return firstEqualIndices(
+            entities.size(),
+            [&](std::size_t i) { return comparer.hash(entities[i]); },
+            [&](std::size_t lhs, std::size_t rhs) {
+                return comparer.equal(entities[lhs], entities[rhs]);
+            });
+    }
+
+    odxf::NearComparer<T> comparer{ tolerance };
+
+    return firstNearIndices(
+        entities.size(),
+        tolerance,
+        [&](std::size_t i) { return gridKey(entities[i]); },
+        [&](std::size_t lhs, std::size_t rhs) {
+            return comparer.near(entities[lhs], entities[rhs]);
+        });
+}
+
+// Returns the indices of the removed entities.
+template <typename T>
+std::vector<std::size_t> removeDuplicates(std::vector<T>& entities, double tolerance)
+{
+    OPENDXF_TRACE_SCOPE("removeDuplicates");
+
+    const std::vector<std::size_t> firstEqual{ firstEqualEntities(entities, tolerance) };
+
+    std::vector<bool> isRemoved(entities.size(), false);
+    std::vector<std::size_t> removed;
+    for (std::size_t i{ 0 }; i < entities.size(); ++i) {
+        if (firstEqual[i] != i) {
+            isRemoved[i] = true;
+            removed.push_back(i);
+        }
+    }
+
+    if (!removed.empty()) {
+        eraseRemoved(entities, isRemoved);
+    }
+
+    return removed;
+}
+
+// Maps ascending indices into the entities left after removing the entities at the
+// ascending indices removed to indices into the entities before.
+std::vector<std::size_t>
+originalIndices(std::vector<std::size_t> indices, const std::vector<std::size_t>& removed)
+{
+    std::size_t skipped{ 0 };
+    for (std::size_t& index : indices) {
+        while (skipped < removed.size() && removed[skipped] <= index + skipped) {
+            ++skipped;
+        }
+        index += skipped;
+    }
+
+    return indices;
+}
+
+double dot(const odxf::Coordinate3d& coordinate, const odxf::Vector3d& vector)
+{
+    return coordinate.x * vector.x + coordinate.y * vector.y + coordinate.z * vector.z;
+}
+
+std::optional<odxf::Vector3d> unitDirection(const odxf::Line& line)
+{
+    const odxf::Vector3d direction{ line.end.x - line.start.x,
+                                    line.end.y - line.start.y,
+                                    line.end.z - line.start.z };
+    const double length{ std::hypot(direction.x, direction.y, direction.z) };
+    if (length == 0.0 || !std::isfinite(length)) {
+        return std::nullopt;
+    }
+
+    return odxf::Vector3d{ direction.x / length, direction.y / length, direction.z / length };
+}
+
+// The infinite line through a line, given by its direction up to the sign and by the point
+// closest to the origin.
+struct Carrier final
+{
+    odxf::Vector3d direction;
+    odxf::Coordinate3d offset;
+};
+
+Carrier carrier(const odxf::Line& line, const odxf::Vector3d& direction)
+{
+    const double distance{ dot(line.start, direction) };
+
+    return Carrier{ .direction = direction,
+                    .offset = { line.start.x - distance * direction.x,
+                                line.start.y - distance * direction.y,
+                                line.start.z - distance * direction.z } };
+}
+
+// angle between the directions of the carriers in [0, pi / 2]
+double angleBetween(const Carrier& lhs, const Carrier& rhs)
+{
+    return std::atan2(
+        odxf::length(odxf::cross(lhs.direction, rhs.direction)),
+        std::abs(odxf::dot(lhs.direction, rhs.direction)));
+}
+
+bool isNear(const odxf::Coordinate3d& lhs, const odxf::Coordinate3d& rhs, double tolerance)
+{
+    return std::abs(lhs.x - rhs.x) <= tolerance && std::abs(lhs.y - rhs.y) <= tolerance
+           && std::abs(lhs.z - rhs.z) <= tolerance;
+}
+
+void collectAttributes(const odxf::Line& line, odxf::ValueCollector& collector)
+{
+    collector.add(line.extrusion);
+    collector.add(line.thickness);
+}
+
+// An end point of a line and its position along the carrier of its group.
+struct Projection final
+{
+    double position{ 0.0 };
+    odxf::Coordinate3d point;
+};
+
+struct Segment final
+{
+    std::size_t group{ 0 };
+    std::size_t index{ 0 };
+    odxf::Vector3d direction;
+    Projection low;
+    Projection high;
+};
+
+// Replaces the lines of a run of overlapping segments by the one with the smallest index,
+// spanning all of them in its original direction.
+std::size_t mergeRun(
+    odxf::Lines& lines,
+    std::vector<bool>& isRemoved,
+    const std::vector<Segment>& segments,
+    std::size_t begin,
+    std::size_t end)
+{
+    if (end - begin < 2) {
+        return 0;
+    }
+
+    std::size_t keptIndex{ segments[begin].index };
+    Projection low{ segments[begin].low };
+    Projection high{ segments[begin].high };
+    for (std::size_t i{ begin + 1 }; i < end; ++i) {
+        keptIndex = std::min(keptIndex, segments[i].index);
+        if (segments[i].high.position > high.position) {
+            high = segments[i].high;
+        }
+    }
+
+    for (std::size_t i{ begin }; i < end; ++i) {
+        isRemoved[segments[i].index] = segments[i].index != keptIndex;
+    }
+
+    const odxf::Vector3d& direction{ segments[begin].direction };
+    odxf::Line& line{ lines[keptIndex] };
+    if (dot(line.start, direction) <= dot(line.end, direction)) {
+        line.start = low.point;
+        line.end = high.point;
+    } else {
+        line.start = high.point;
+        line.end = low.point;
+    }
+
+    return end - begin - 1;
+}
+
+// Returns the indices of the lines merged into others.
+std::vector<std::size_t>
+mergeCollinearLines(odxf::Lines& lines, double tolerance, double angularTolerance)
+{
+    OPENDXF_TRACE_SCOPE("mergeCollinearLines");
+
+    std::vector<std::size_t> candidates;
+    std::vector<Carrier> carriers;
+    candidates.reserve(lines.size());
+    carriers.reserve(lines.size());
+    for (std::size_t i{ 0 }; i < lines.size(); ++i) {
+        if (const std::optional<odxf::Vector3d> direction{ unitDirection(lines[i]) }) {
+            candidates.push_back(i);
+            carriers.push_back(carrier(lines[i], *direction));
+        }
+    }
+
+    odxf::NearComparer<odxf::Line, &collectAttributes> comparer{ tolerance };
+    const std::vector<std::size_t> groups{ firstNearIndices(
+        candidates.size(),
+        tolerance,
+        [&](std::size_t i) {
+            return GridKey{ attributeHash(lines[candidates[i]]),
+                            { carriers[i].offset.x, carriers[i].offset.y } };
+        },
+        [&](std::size_t lhs, std::size_t rhs) {
+            return isNear(carriers[lhs].offset, carriers[rhs].offset, tolerance)
+                   && angleBetween(carriers[lhs], carriers[rhs]) <= angularTolerance
+                   && comparer.near(lines[candidates[lhs]], lines[candidates[rhs]]);
+        }) };
+
+    // The segments are projected onto the direction of the first line of their group.
+    std::vector<Segment> segments;
+    segments.reserve(candidates.size());
+    for (std::size_t i{ 0 }; i < candidates.size(); ++i) {
+        const odxf::Line& line{ lines[candidates[i]] };
+        const odxf::Vector3d& direction{ carriers[groups[i]].direction };
+
+        Projection start{ dot(line.start, direction), line.start };
+        Projection end{ dot(line.end, direction), line.end };
+        if (end.position < start.position) {
+            std::swap(start, end);
+        }
+        segments.push_back(Segment{ groups[i], candidates[i], direction, start, end });
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const Segment& lhs, const Segment& rhs) {
+        return lhs.group != rhs.group ? lhs.group < rhs.group
+                                      : lhs.low.position < rhs.low.position;
+    });
+
+    std::vector<bool> isRemoved(lines.size(), false);
+    std::size_t mergedCount{ 0 };
+    std::size_t runBegin{ 0 };
+    double runHigh{ 0.0 };
+    for (std::size_t i{ 0 }; i <= segments.size(); ++i) {
+        if (i < segments.size() && i != runBegin && segments[i].group == segments[runBegin].group
+            && segments[i].low.position <= runHigh + tolerance) {
+            runHigh = std::max(runHigh, segments[i].high.position);
+            continue;
+        }
+
+        if (i != runBegin) {
+            mergedCount += mergeRun(lines, isRemoved, segments, runBegin, i);
+        }
+
+        if (i < segments.size()) {
+            runBegin = i;
+            runHigh = segments[i].high.position;
+        }
+    }
+
+    std::vector<std::size_t> merged;
+    merged.reserve(mergedCount);
+    for (std::size_t i{ 0 }; i < lines.size(); ++i) {
+        if (isRemoved[i]) {
+            merged.push_back(i);
+        }
+    }
+
+    if (!merged.empty()) {
+        eraseRemoved(lines, isRemoved);
+    }
+
+    return merged;
+}
+
+}   // namespace
+
+namespace odxf {
+
+DeduplicateReport deduplicate(Entities& entities, const DeduplicateOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("deduplicate");
+
+    const double tolerance{ options.tolerance };
+    DeduplicateReport report;
+
+    parallelFor(3, options.threadCount, [&](std::size_t index) {
+        switch (index) {
+        case 0: report.removedArcs = removeDuplicates(entities.arcs, tolerance); break;
+        case 1: report.removedCircles = removeDuplicates(entities.circles, tolerance); break;
+        case 2:
+            report.removedLines = removeDuplicates(entities.lines, tolerance);
+            if (options.mergeCollinearLines) {
+                report.mergedLines = originalIndices(
+                    mergeCollinearLines(entities.lines, tolerance, options.angularTolerance),
+                    report.removedLines);
+            }
+            break;
+        default: break;
+        }
+    });
+
+    return report;
+}
+
+}   // namespace odxf
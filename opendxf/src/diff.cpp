@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/diff.hpp"
+
+#include "parallel.hpp"
+#include "quantizer.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+namespace {
+
+constexpr std::size_t noIndex{ std::numeric_limits<std::size_t>::max() };
+
+template <typename T>
+odxf::EntityDiff<T>
+diffEntities(const std::vector<T>& first, const std::vector<T>& second, double tolerance)
+{
+    OPENDXF_TRACE_SCOPE("diffEntities");
+
+    odxf::EntityComparer<T> comparer{ tolerance };
+
+    // Entities of the second document with equal hashes are chained in index order, the
+    // head of a chain is the first one not matched yet.
+    std::unordered_map<std::uint64_t, std::size_t> heads;
+    heads.reserve(second.size());
+    std::vector<std::size_t> next(second.size(), noIndex);
+    for (std::size_t i{ second.size() }; i-- > 0;) {
+        const auto [iter, isNew]{ heads.try_emplace(comparer.hash(second[i]), i) };
+        if (!isNew) {
+            next[i] = iter->second;
+            iter->second = i;
+        }
+    }
+
+    std::vector<bool> isMatched(second.size(), false);
+    std::vector<std::size_t> unmatchedFirst;
+
+    for (std::size_t i{ 0 }; i < first.size(); ++i) {
+        const auto iter{ heads.find(comparer.hash(first[i])) };
+        if (iter == heads.end()) {
+            unmatchedFirst.push_back(i);
+            continue;
+        }
+
+        // usually the head itself, unless the hashes collide
+        std::size_t match{ iter->second };
+        while (match != noIndex
+               && (isMatched[match] || !comparer.equal(first[i], second[match]))) {
+            match = next[match];
+        }
+
+        if (match == noIndex) {
+            unmatchedFirst.push_back(i);
+            continue;
+        }
+
+        isMatched[match] = true;
+        while (iter->second != noIndex && isMatched[iter->second]) {
+            iter->second = next[iter->second];
+        }
+    }
+
+    // pairs the remaining entities layer by layer
+    std::unordered_map<std::string_view, std::deque<std::size_t>> unmatchedSecond;
+    for (std::size_t i{ 0 }; i < second.size(); ++i) {
+        if (!isMatched[i]) {
+            unmatchedSecond[second[i].layer].push_back(i);
+        }
+    }
+
+    odxf::EntityDiff<T> result;
+    for (std::size_t i : unmatchedFirst) {
+        const auto iter{ unmatchedSecond.find(first[i].layer) };
+        if (iter == unmatchedSecond.end() || iter->second.empty()) {
+            result.removed.push_back(i);
+            continue;
+        }
+
+        result.changed.emplace_back(i, iter->second.front());
+        iter->second.pop_front();
+    }
+
+    for (const auto& [layer, indices] : unmatchedSecond) {
+        result.added.insert(result.added.end(), indices.begin(), indices.end());
+    }
+    std::sort(result.added.begin(), result.added.end());
+
+    return result;
+}
+
+bool equalHeaderValues(
+    const odxf::HeaderValue& lhs, const odxf::HeaderValue& rhs, double tolerance)
+{
+    if (lhs.index() != rhs.index()) {
+        return false;
+    }
+
+    std::vector<std::int64_t> lhsValues;
+    std::vector<std::int64_t> rhsValues;
+
+    return std::visit(
+        [&](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            const T& other{ std::get<T>(rhs) };
+
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, int>
+                          || std::is_same_v<T, bool>) {
+                return value == other;
+            } else {
+                odxf::Quantizer lhsQuantizer{ lhsValues, tolerance };
+                lhsQuantizer.add(value);
+                odxf::Quantizer rhsQuantizer{ rhsValues, tolerance };
+                rhsQuantizer.add(other);
+
+                return lhsValues == rhsValues;
+            }
+        },
+        lhs);
+}
+
+template <typename Map, typename Equal>
+void diffByName(
+    const Map& first,
+    const Map& second,
+    Equal equal,
+    std::vector<std::string>& added,
+    std::vector<std::string>& removed,
+    std::vector<std::string>& changed)
+{
+    for (const auto& [name, value] : first) {
+        const auto iter{ second.find(name) };
+        if (iter == second.end()) {
+            removed.emplace_back(name);
+        } else if (!equal(value, iter->second)) {
+            changed.emplace_back(name);
+        }
+    }
+
+    for (const auto& [name, value] : second) {
+        if (!first.contains(name)) {
+            added.emplace_back(name);
+        }
+    }
+
+    std::sort(added.begin(), added.end());
+    std::sort(removed.begin(), removed.end());
+    std::sort(changed.begin(), changed.end());
+}
+
+template <typename T>
+std::unordered_map<std::string_view, const T*> byName(const std::vector<T>& values)
+{
+    std::unordered_map<std::string_view, const T*> result;
+    result.reserve(values.size());
+    for (const T& value : values) {
+        result.try_emplace(value.name, &value);
+    }
+
+    return result;
+}
+
+// The name of the line type of a layer, empty if the index is invalid.
+std::string_view lineTypeName(const odxf::LineTypes& lineTypes, const odxf::Layer& layer)
+{
+    if (layer.lineType < 0 || static_cast<std::size_t>(layer.lineType) >= lineTypes.size()) {
+        return {};
+    }
+
+    return lineTypes[static_cast<std::size_t>(layer.lineType)].name;
+}
+
+}   // namespace
+
+namespace odxf {
+
+bool DocumentDiff::empty() const
+{
+    return addedHeaderEntries.empty() && removedHeaderEntries.empty()
+           && changedHeaderEntries.empty() && addedLineTypes.empty() && removedLineTypes.empty()
+           && changedLineTypes.empty() && addedLayers.empty() && removedLayers.empty()
+           && changedLayers.empty() && arcs.empty() && circles.empty() && ellipses.empty()
+           && lines.empty() && points.empty() && lwPolylines.empty() && rays.empty();
+}
+
+DocumentDiff diff(const Document& first, const Document& second, const DiffOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("diff");
+
+    const double tolerance{ options.tolerance };
+    DocumentDiff result;
+
+    diffByName(
+        first.header.entries,
+        second.header.entries,
+        [tolerance](const HeaderValue& lhs, const HeaderValue& rhs) {
+            return equalHeaderValues(lhs, rhs, tolerance);
+        },
+        result.addedHeaderEntries,
+        result.removedHeaderEntries,
+        result.changedHeaderEntries);
+
+    diffByName(
+        byName(first.tables.lineTypes),
+        byName(second.tables.lineTypes),
+        [](const LineType* lhs, const LineType* rhs) {
+            return lhs->displayName == rhs->displayName && lhs->flags == rhs->flags;
+        },
+        result.addedLineTypes,
+        result.removedLineTypes,
+        result.changedLineTypes);
+
+    diffByName(
+        byName(first.tables.layers),
+        byName(second.tables.layers),
+        [&](const Layer* lhs, const Layer* rhs) {
+            return lhs->color == rhs->color && lhs->flags == rhs->flags
+                   && lineTypeName(first.tables.lineTypes, *lhs)
+                          == lineTypeName(second.tables.lineTypes, *rhs);
+        },
+        result.addedLayers,
+        result.removedLayers,
+        result.changedLayers);
+
+    const Entities& lhs{ first.entities };
+    const Entities& rhs{ second.entities };
+    parallelFor(entityTypeCount, options.threadCount, [&](std::size_t index) {
+        switch (static_cast<EntityType>(index)) {
+        case EntityType::Arc: result.arcs = diffEntities(lhs.arcs, rhs.arcs, tolerance); break;
+        case EntityType::Circle:
+            result.circles = diffEntities(lhs.circles, rhs.circles, tolerance);
+            break;
+        case EntityType::Ellipse:
+            result.ellipses = diffEntities(lhs.ellipses, rhs.ellipses, tolerance);
+            break;
+        case EntityType::Line: result.lines = diffEntities(lhs.lines, rhs.lines, tolerance); break;
+        case EntityType::Point:
+            result.points = diffEntities(lhs.points, rhs.points, tolerance);
+            break;
+        case EntityType::LWPolyline:
+            result.lwPolylines = diffEntities(lhs.lwPolylines, rhs.lwPolylines, tolerance);
+            break;
+        case EntityType::Ray: result.rays = diffEntities(lhs.rays, rhs.rays, tolerance); break;
+        }
+    });
+
+    return result;
+}
+
+}   // namespace odxf
@@ -0,0 +1,345 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "dxfformat.hpp"
+
+#include "parallel.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <variant>
+#include <vector>
+
+namespace {
+
+template <typename... Ts>
+struct overload : Ts...
+{
+    using Ts::operator()...;
+};
+
+template <typename... Ts>
+overload(Ts...) -> overload<Ts...>;
+
+void writeString(odxf::OutputBuffer& buffer, std::string_view groupCode, std::string_view value)
+{
+    buffer.append(groupCode);
+    buffer.append(value);
+}
+
+template <std::integral T>
+void writeInt(odxf::OutputBuffer& buffer, std::string_view groupCode, T value)
+{
+    buffer.append(groupCode);
+    buffer.append(value);
+}
+
+void writeDouble(odxf::OutputBuffer& buffer, std::string_view groupCode, double value)
+{
+    buffer.append(groupCode);
+    buffer.append(value);
+}
+
+void writeEntity(odxf::OutputBuffer& buffer, const odxf::Entity& entity)
+{
+    writeString(buffer, "\n8\n", entity.layer);
+    writeInt(buffer, "\n62\n", entity.color);
+}
+
+void writeCoordinate(odxf::OutputBuffer& buffer, const odxf::Coordinate3d& coordinate)
+{
+    writeDouble(buffer, "\n10\n", coordinate.x);
+    writeDouble(buffer, "\n20\n", coordinate.y);
+    writeDouble(buffer, "\n30\n", coordinate.z);
+}
+
+void writeSecondCoordinate(odxf::OutputBuffer& buffer, const odxf::Coordinate3d& coordinate)
+{
+    writeDouble(buffer, "\n11\n", coordinate.x);
+    writeDouble(buffer, "\n21\n", coordinate.y);
+    writeDouble(buffer, "\n31\n", coordinate.z);
+}
+
+void writeThickness(odxf::OutputBuffer& buffer, const std::optional<double>& maybeThickness)
+{
+    if (maybeThickness) {
+        writeDouble(buffer, "\n39\n", *maybeThickness);
+    }
+}
+
+void writeExtrusion(
+    odxf::OutputBuffer& buffer, const std::optional<odxf::Vector3d>& maybeExtrusion)
+{
+    if (maybeExtrusion) {
+        const odxf::Vector3d& extrusion{ *maybeExtrusion };
+        writeDouble(buffer, "\n210\n", extrusion.x);
+        writeDouble(buffer, "\n220\n", extrusion.y);
+        writeDouble(buffer, "\n230\n", extrusion.z);
+    }
+}
+
+}   // namespace
+
+namespace odxf {
+
+void writeHeaderVariable(OutputBuffer& buffer, const HeaderKey& key, const HeaderValue& value)
+{
+    writeString(buffer, "\n9\n", key);
+    std::visit(
+        overload{ [&buffer](bool element) { writeInt(buffer, "\n290\n", element ? 1 : 0); },
+                  [&buffer, &key](int element) {
+                      if (key == "$CECOLOR" || key == "$INTERFERECOLOR") {
+                          buffer.append("\n62\n");
+                      } else if (
+                          key == "$ENDCAPS" || key == "$JOINSTYLE" || key == "$SORTENTS"
+                          || key == "$INDEXCTL" || key == "$HIDETEXT" || key == "$HALOGAP"
+                          || key == "$OBSLTYPE" || key == "$INTERSECTIONDISPLAY"
+                          || key == "$DIMASSOC" || key == "$LOFTNORMALS"
+                          || key == "$LIGHTGLYPHDISPLAY" || key == "$TILEMODELIGHTSYNCH"
+                          || key == "$SOLIDHIST" || key == "$SHOWHIST" || key == "$DWFFRAME"
+                          || key == "$DGNFRAME" || key == "$CSHADOW") {
+                          buffer.append("\n280\n");
+                      } else if (key == "$CELWEIGHT") {
+                          buffer.append("\n370\n");
+                      } else if (key == "$CEPSNTYPE") {
+                          buffer.append("\n380\n");
+                      } else {
+                          buffer.append("\n70\n");
+                      }
+                      buffer.append(element);
+                  },
+                  [&buffer, &key](double element) {
+                      if (key == "$ANGBASE") {
+                          writeDouble(buffer, "\n50\n", element);
+                      } else {
+                          writeDouble(buffer, "\n40\n", element);
+                      }
+                  },
+                  [&buffer, &key](const std::string& element) {
+                      if (key == "$DIMSTYLE") {
+                          buffer.append("\n2\n");
+                      } else if (key == "$HANDSEED") {
+                          buffer.append("\n5\n");
+                      } else if (
+                          key == "$CELTYPE" || key == "$DIMLTYPE" || key == "$DIMLTEX1"
+                          || key == "$DIMLTEX2") {
+                          buffer.append("\n6\n");
+                      } else if (key == "$TEXTSTYLE" || key == "$DIMTXSTY") {
+                          buffer.append("\n7\n");
+                      } else if (key == "$CLAYER") {
+                          buffer.append("\n8\n");
+                      } else {
+                          buffer.append("\n1\n");
+                      }
+                      buffer.append(element);
+                  },
+                  [&buffer](const Coordinate2d& coord) {
+                      writeDouble(buffer, "\n10\n", coord.x);
+                      writeDouble(buffer, "\n20\n", coord.y);
+                  },
+                  [&buffer](const Coordinate3d& coord) {
+                      writeDouble(buffer, "\n10\n", coord.x);
+                      writeDouble(buffer, "\n20\n", coord.y);
+                      writeDouble(buffer, "\n30\n", coord.z);
+                  } },
+        value);
+}
+
+void writeLineType(OutputBuffer& buffer, const LineType& lineType)
+{
+    buffer.append("\n0\nLTYPE");
+    writeString(buffer, "\n2\n", lineType.name);
+    writeInt(buffer, "\n70\n", lineType.flags);
+    writeString(buffer, "\n3\n", lineType.displayName);
+    buffer.append("\n72\n65");
+    buffer.append("\n73\n0");
+    buffer.append("\n40\n0");
+}
+
+void writeLayer(OutputBuffer& buffer, const Layer& layer, std::string_view lineTypeName)
+{
+    buffer.append("\n0\nLAYER");
+    writeString(buffer, "\n2\n", layer.name);
+    writeInt(buffer, "\n70\n", static_cast<int>(layer.flags));
+    writeInt(buffer, "\n62\n", layer.color);
+    writeString(buffer, "\n6\n", lineTypeName);
+}
+
+void writePoint(OutputBuffer& buffer, const Point& point)
+{
+    buffer.append("\n0\nPOINT\n100\nAcDbPoint");
+    writeEntity(buffer, point);
+    writeThickness(buffer, point.thickness);
+    writeCoordinate(buffer, point.coordinate);
+    writeExtrusion(buffer, point.extrusion);
+}
+
+void writeRay(OutputBuffer& buffer, const Ray& ray)
+{
+    buffer.append("\n0\nRAY\n100\nAcDbRay");
+    writeEntity(buffer, ray);
+    writeCoordinate(buffer, ray.startPoint);
+    writeDouble(buffer, "\n11\n", ray.direction.x);
+    writeDouble(buffer, "\n21\n", ray.direction.y);
+    writeDouble(buffer, "\n31\n", ray.direction.z);
+}
+
+void writeLine(OutputBuffer& buffer, const Line& line)
+{
+    buffer.append("\n0\nLINE\n100\nAcDbLine");
+    writeEntity(buffer, line);
+    writeThickness(buffer, line.thickness);
+    writeCoordinate(buffer, line.start);
+    writeSecondCoordinate(buffer, line.end);
+    writeExtrusion(buffer, line.extrusion);
+}
+
+void writeCircle(OutputBuffer& buffer, const Circle& circle)
+{
+    buffer.append("\n0\nCIRCLE\n100\nAcDbCircle");
+    writeEntity(buffer, circle);
+    writeThickness(buffer, circle.thickness);
+    writeCoordinate(buffer, circle.center);
+    writeDouble(buffer, "\n40\n", circle.radius);
+    writeExtrusion(buffer, circle.extrusion);
+}
+
+void writeArc(OutputBuffer& buffer, const Arc& arc)
+{
+    buffer.append("\n0\nARC\n100\nAcDbCircle");
+    writeEntity(buffer, arc);
+    writeThickness(buffer, arc.thickness);
+    writeCoordinate(buffer, arc.center);
+    writeDouble(buffer, "\n40\n", arc.radius);
+    buffer.append("\n100\nAcDbArc");
+    writeDouble(buffer, "\n50\n", arc.startAngle);
+    writeDouble(buffer, "\n51\n", arc.endAngle);
+    writeExtrusion(buffer, arc.extrusion);
+}
+
+void writeEllipse(OutputBuffer& buffer, const Ellipse& ellipse)
+{
+    buffer.append("\n0\nELLIPSE\n100\nAcDbEllipse");
+    writeEntity(buffer, ellipse);
+    writeCoordinate(buffer, ellipse.center);
+    writeSecondCoordinate(buffer, ellipse.endPointMajor);
+    writeDouble(buffer, "\n40\n", ellipse.axisRatio);
+    writeDouble(buffer, "\n41\n", ellipse.startParameter);
+    writeDouble(buffer, "\n42\n", ellipse.endParameter);
+    writeExtrusion(buffer, ellipse.extrusion);
+}
+
+void writeLWPolylineBegin(
+    OutputBuffer& buffer, const Entity& entity, std::size_t vertexCount, bool isClosed)
+{
+    buffer.append("\n0\nLWPOLYLINE\n100\nAcDbPolyline");
+    writeEntity(buffer, entity);
+    writeInt(buffer, "\n90\n", vertexCount);
+    writeInt(buffer, "\n70\n", isClosed ? 1 : 0);
+}
+
+void writeVertex(OutputBuffer& buffer, const Vertex& vertex)
+{
+    writeDouble(buffer, "\n10\n", vertex.position.x);
+    writeDouble(buffer, "\n20\n", vertex.position.y);
+    if (vertex.bulge.has_value()) {
+        writeDouble(buffer, "\n42\n", *vertex.bulge);
+    }
+}
+
+void writeLWPolyline(OutputBuffer& buffer, const LWPolyline& lwPolyline)
+{
+    writeLWPolylineBegin(buffer, lwPolyline, lwPolyline.vertices.size(), lwPolyline.isClosed);
+
+    for (const Vertex& vertex : lwPolyline.vertices) {
+        writeVertex(buffer, vertex);
+    }
+}
+
+}   // namespace odxf
+
+namespace {
+
+std::size_t entityCount(const odxf::Entities& entities)
+{
+    return entities.points.size() + entities.rays.size() + entities.lines.size()
+         + entities.circles.size() + entities.arcs.size() + entities.ellipses.size()
+         + entities.lwPolylines.size();
+}
+
+// Writes the entities [begin, end) of the sequence points, rays, lines, circles, arcs,
+// ellipses and lw polylines.
+void writeEntityRange(
+    odxf::OutputBuffer& buffer, const odxf::Entities& entities, std::size_t begin, std::size_t end)
+{
+    const auto writeItems{ [&](const auto& items, auto writeItem) {
+        const std::size_t first{ std::min(begin, items.size()) };
+        const std::size_t last{ std::min(end, items.size()) };
+        for (std::size_t i{ first }; i < last; ++i) {
+            writeItem(buffer, items[i]);
+        }
+
+        begin -= first;
+        end -= last;
+    } };
+
+    writeItems(entities.points, odxf::writePoint);
+    writeItems(entities.rays, odxf::writeRay);
+    writeItems(entities.lines, odxf::writeLine);
+    writeItems(entities.circles, odxf::writeCircle);
+    writeItems(entities.arcs, odxf::writeArc);
+    writeItems(entities.ellipses, odxf::writeEllipse);
+    writeItems(entities.lwPolylines, odxf::writeLWPolyline);
+}
+
+// Formats consecutive runs of entities into one buffer per thread and appends the
+// buffers in order, so memory stays bounded by threadCount * chunkSize entities.
+void writeEntityRangeParallel(
+    odxf::OutputBuffer& buffer,
+    const odxf::Entities& entities,
+    const odxf::WriteOptions& options,
+    unsigned int threadCount)
+{
+    constexpr std::size_t chunkSize{ 16384 };
+
+    std::vector<std::unique_ptr<odxf::OutputBuffer>> chunkBuffers;
+    chunkBuffers.reserve(threadCount);
+    for (unsigned int i{ 0 }; i < threadCount; ++i) {
+        chunkBuffers.push_back(std::make_unique<odxf::OutputBuffer>(options.numberFormat));
+    }
+
+    const std::size_t count{ entityCount(entities) };
+    for (std::size_t waveBegin{ 0 }; waveBegin < count; waveBegin += threadCount * chunkSize) {
+        odxf::parallelFor(threadCount, threadCount, [&](std::size_t index) {
+            const std::size_t begin{ std::min(waveBegin + index * chunkSize, count) };
+            const std::size_t end{ std::min(begin + chunkSize, count) };
+
+            OPENDXF_TRACE_SCOPE("formatEntityChunk");
+
+            chunkBuffers[index]->clear();
+            writeEntityRange(*chunkBuffers[index], entities, begin, end);
+        });
+
+        for (const std::unique_ptr<odxf::OutputBuffer>& chunkBuffer : chunkBuffers) {
+            buffer.append(chunkBuffer->content());
+        }
+    }
+}
+
+}   // namespace
+
+namespace odxf {
+
+void writeEntityRecords(
+    OutputBuffer& buffer, const Entities& entities, const WriteOptions& options)
+{
+    const unsigned int threadCount{ resolveThreadCount(options.threadCount) };
+    if (threadCount > 1) {
+        writeEntityRangeParallel(buffer, entities, options, threadCount);
+    } else {
+        writeEntityRange(buffer, entities, 0, entityCount(entities));
+    }
+}
+
+}   // namespace odxf
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/entities.hpp"
+#include "opendxf/header.hpp"
+#include "opendxf/tables.hpp"
+#include "opendxf/write.hpp"
+
+#include "outputbuffer.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace odxf {
+
+void writeHeaderVariable(OutputBuffer& buffer, const HeaderKey& key, const HeaderValue& value);
+
+void writeLineType(OutputBuffer& buffer, const LineType& lineType);
+void writeLayer(OutputBuffer& buffer, const Layer& layer, std::string_view lineTypeName);
+
+void writePoint(OutputBuffer& buffer, const Point& point);
+void writeRay(OutputBuffer& buffer, const Ray& ray);
+void writeLine(OutputBuffer& buffer, const Line& line);
+void writeCircle(OutputBuffer& buffer, const Circle& circle);
+void writeArc(OutputBuffer& buffer, const Arc& arc);
+void writeEllipse(OutputBuffer& buffer, const Ellipse& ellipse);
+void writeLWPolyline(OutputBuffer& buffer, const LWPolyline& lwPolyline);
+
+void writeLWPolylineBegin(
+    OutputBuffer& buffer, const Entity& entity, std::size_t vertexCount, bool isClosed);
+void writeVertex(OutputBuffer& buffer, const Vertex& vertex);
+
+// Writes all entities in the order points, rays, lines, circles, arcs, ellipses and
+// lw polylines, in parallel if requested by the options.
+void writeEntityRecords(
+    OutputBuffer& buffer, const Entities& entities, const WriteOptions& options);
+
+}   // namespace odxf
@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/dxfwriter.hpp"
+
+#include "dxfformat.hpp"
+#include "outputbuffer.hpp"
+#include "tracescope.hpp"
+
+#include <fmt/format.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// initial capacity of the buffers collecting table records and vertices
+constexpr std::size_t recordBufferCapacity{ 4096 };
+
+enum class State
+{
+    Initial,
+    Header,
+    Tables,
+    Entities,
+    LWPolyline,
+    Finished
+};
+
+std::string_view sectionName(State state)
+{
+    switch (state) {
+    case State::Initial: return "no section";
+    case State::Header: return "HEADER";
+    case State::Tables: return "TABLES";
+    case State::Entities: return "ENTITIES";
+    case State::LWPolyline: return "LWPOLYLINE";
+    case State::Finished: return "finished file";
+    }
+
+    return {};
+}
+
+tl::expected<void, odxf::Error> makeOrderError(std::string_view call, State state)
+{
+    return tl::make_unexpected(odxf::Error{
+        .type = odxf::Error::Type::InvalidOrder,
+        .what = fmt::format("{} is not allowed in {}", call, sectionName(state)),
+    });
+}
+
+}   // namespace
+
+namespace odxf {
+
+struct DxfWriter::Impl
+{
+    Impl(const std::filesystem::path& filePath, const WriteOptions& writeOptions)
+        : Impl{ std::make_unique<FileSink>(filePath), writeOptions }
+    {
+    }
+
+    Impl(IOutputSink& outputSink, const WriteOptions& writeOptions)
+        : options{ writeOptions }
+        , sink{ outputSink }
+        , buffer{ sink, options.numberFormat, OutputBuffer::defaultCapacity, options.asyncOutput }
+        , lineTypeRecords{ options.numberFormat, recordBufferCapacity }
+        , layerRecords{ options.numberFormat, recordBufferCapacity }
+        , vertexRecords{ options.numberFormat, recordBufferCapacity }
+    {
+        if (options.preallocateSize != 0) {
+            if (tl::expected<void, Error> reserveResult = sink.reserve(options.preallocateSize);
+                !reserveResult) {
+                error = reserveResult.error();
+            }
+        }
+    }
+
+    Impl(std::unique_ptr<FileSink> fileSink, const WriteOptions& writeOptions)
+        : Impl{ *fileSink, writeOptions }
+    {
+        if (tl::expected<void, Error> openResult = fileSink->openError(); !openResult) {
+            error = openResult.error();
+        }
+
+        ownedSink = std::move(fileSink);
+    }
+
+    const std::optional<Error>& firstError() const { return error ? error : buffer.error(); }
+
+    tl::expected<void, Error> checkState(std::string_view call, State expected) const
+    {
+        if (const std::optional<Error>& maybeError = firstError(); maybeError) {
+            return tl::make_unexpected(*maybeError);
+        }
+
+        if (state != expected) {
+            return makeOrderError(call, state);
+        }
+
+        return {};
+    }
+
+    // Closes the current section and opens the following ones up to target.
+    tl::expected<void, Error> advanceTo(std::string_view call, State target)
+    {
+        if (const std::optional<Error>& maybeError = firstError(); maybeError) {
+            return tl::make_unexpected(*maybeError);
+        }
+
+        if (state >= target || state == State::LWPolyline) {
+            return makeOrderError(call, state);
+        }
+
+        while (state < target) {
+            switch (state) {
+            case State::Initial: {
+                buffer.append("999\nopendxf");
+                buffer.append("\n0\nSECTION\n2\nHEADER");
+                state = State::Header;
+
+                break;
+            }
+
+            case State::Header: {
+                buffer.append("\n0\nENDSEC");
+                state = State::Tables;
+
+                break;
+            }
+
+            case State::Tables: {
+                OPENDXF_TRACE_SCOPE("writeTables");
+                writeTables();
+                writeBlocks();
+                buffer.append("\n0\nSECTION\n2\nENTITIES");
+                state = State::Entities;
+
+                break;
+            }
+
+            case State::Entities: {
+                OPENDXF_TRACE_SCOPE("finish");
+                buffer.append("\n0\nENDSEC");
+                buffer.append("\n0\nEOF");
+                buffer.sync();
+                state = State::Finished;
+
+                if (buffer.error()) {
+                    return tl::make_unexpected(*buffer.error());
+                }
+
+                return sink.close();
+            }
+
+            case State::LWPolyline:
+            case State::Finished: break;
+            }
+        }
+
+        return {};
+    }
+
+    void writeTables()
+    {
+        buffer.append("\n0\nSECTION");
+        buffer.append("\n2\nTABLES");
+
+        buffer.append("\n0\nTABLE");
+        buffer.append("\n2\nLTYPE");
+        buffer.append("\n70\n");
+        buffer.append(lineTypeNames.size());
+        buffer.append(lineTypeRecords.content());
+        buffer.append("\n0\nENDTAB");
+
+        buffer.append("\n0\nTABLE");
+        buffer.append("\n2\nLAYER");
+        buffer.append("\n70\n");
+        buffer.append(layerCount);
+        buffer.append(layerRecords.content());
+        buffer.append("\n0\nENDTAB");
+
+        buffer.append("\n0\nENDSEC");
+
+        lineTypeRecords.clear();
+        layerRecords.clear();
+    }
+
+    void writeBlocks()
+    {
+        buffer.append("\n0\nSECTION");
+        buffer.append("\n2\nBLOCKS");
+        buffer.append("\n0\nENDSEC");
+    }
+
+    WriteOptions options;
+    std::unique_ptr<FileSink> ownedSink;
+    IOutputSink& sink;
+    std::optional<Error> error;
+    State state{ State::Initial };
+
+    OutputBuffer buffer;
+
+    OutputBuffer lineTypeRecords;
+    OutputBuffer layerRecords;
+    std::vector<std::string> lineTypeNames;
+    std::size_t layerCount{ 0 };
+
+    OutputBuffer vertexRecords;
+    std::size_t vertexCount{ 0 };
+    Entity lwPolylineEntity;
+    bool lwPolylineIsClosed{ false };
+};
+
+DxfWriter::DxfWriter(const std::filesystem::path& filePath, const WriteOptions& options)
+    : m_impl{ std::make_unique<Impl>(filePath, options) }
+{
+}
+
+DxfWriter::DxfWriter(IOutputSink& sink, const WriteOptions& options)
+    : m_impl{ std::make_unique<Impl>(sink, options) }
+{
+}
+
+DxfWriter::~DxfWriter() = default;
+
+DxfWriter::DxfWriter(DxfWriter&&) noexcept = default;
+
+DxfWriter& DxfWriter::operator=(DxfWriter&&) noexcept = default;
+
+tl::expected<void, Error> DxfWriter::beginHeader()
+{
+    return m_impl->advanceTo("beginHeader()", State::Header);
+}
+
+tl::expected<void, Error> DxfWriter::headerVariable(const HeaderKey& key, const HeaderValue& value)
+{
+    return m_impl->checkState("headerVariable()", State::Header).map([&] {
+        writeHeaderVariable(m_impl->buffer, key, value);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::beginTables()
+{
+    return m_impl->advanceTo("beginTables()", State::Tables);
+}
+
+tl::expected<void, Error> DxfWriter::lineType(const LineType& lineType)
+{
+    return m_impl->checkState("lineType()", State::Tables).map([&] {
+        writeLineType(m_impl->lineTypeRecords, lineType);
+        m_impl->lineTypeNames.push_back(lineType.name);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::layer(const Layer& layer)
+{
+    const auto writeLayerRecord{ [&]() -> tl::expected<void, Error> {
+        if (layer.lineType < 0
+            || static_cast<std::size_t>(layer.lineType) >= m_impl->lineTypeNames.size()) {
+            return tl::make_unexpected(Error{
+                .type = Error::Type::InvalidReference,
+                .what = fmt::format(
+                    "layer {} references line type {} which was not written before",
+                    layer.name,
+                    layer.lineType),
+            });
+        }
+
+        writeLayer(
+            m_impl->layerRecords,
+            layer,
+            m_impl->lineTypeNames[static_cast<std::size_t>(layer.lineType)]);
+        m_impl->layerCount++;
+
+        return {};
+    } };
+
+    return m_impl->checkState("layer()", State::Tables).and_then(writeLayerRecord);
+}
+
+tl::expected<void, Error> DxfWriter::beginEntities()
+{
+    return m_impl->advanceTo("beginEntities()", State::Entities);
+}
+
+tl::expected<void, Error> DxfWriter::point(const Point& point)
+{
+    return m_impl->checkState("point()", State::Entities).map([&] {
+        writePoint(m_impl->buffer, point);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::ray(const Ray& ray)
+{
+    return m_impl->checkState("ray()", State::Entities).map([&] {
+        writeRay(m_impl->buffer, ray);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::line(const Line& line)
+{
+    return m_impl->checkState("line()", State::Entities).map([&] {
+        writeLine(m_impl->buffer, line);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::circle(const Circle& circle)
+{
+    return m_impl->checkState("circle()", State::Entities).map([&] {
+        writeCircle(m_impl->buffer, circle);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::arc(const Arc& arc)
+{
+    return m_impl->checkState("arc()", State::Entities).map([&] {
+        writeArc(m_impl->buffer, arc);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::ellipse(const Ellipse& ellipse)
+{
+    return m_impl->checkState("ellipse()", State::Entities).map([&] {
+        writeEllipse(m_impl->buffer, ellipse);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::lwPolyline(const LWPolyline& lwPolyline)
+{
+    return m_impl->checkState("lwPolyline()", State::Entities).map([&] {
+        writeLWPolyline(m_impl->buffer, lwPolyline);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::beginLWPolyline(const Entity& entity, bool isClosed)
+{
+    return m_impl->checkState("beginLWPolyline()", State::Entities).map([&] {
+        m_impl->lwPolylineEntity = entity;
+        m_impl->lwPolylineIsClosed = isClosed;
+        m_impl->vertexCount = 0;
+        m_impl->vertexRecords.clear();
+        m_impl->state = State::LWPolyline;
+    });
+}
+
+tl::expected<void, Error> DxfWriter::lwPolylineVertex(const Vertex& vertex)
+{
+    return m_impl->checkState("lwPolylineVertex()", State::LWPolyline).map([&] {
+        writeVertex(m_impl->vertexRecords, vertex);
+        m_impl->vertexCount++;
+    });
+}
+
+tl::expected<void, Error> DxfWriter::endLWPolyline()
+{
+    return m_impl->checkState("endLWPolyline()", State::LWPolyline).map([&] {
+        writeLWPolylineBegin(
+            m_impl->buffer,
+            m_impl->lwPolylineEntity,
+            m_impl->vertexCount,
+            m_impl->lwPolylineIsClosed);
+        m_impl->buffer.append(m_impl->vertexRecords.content());
+        m_impl->state = State::Entities;
+    });
+}
+
+tl::expected<void, Error> DxfWriter::entities(const Entities& entities)
+{
+    return m_impl->checkState("entities()", State::Entities).map([&] {
+        OPENDXF_TRACE_SCOPE("writeEntities");
+        writeEntityRecords(m_impl->buffer, entities, m_impl->options);
+    });
+}
+
+tl::expected<void, Error> DxfWriter::finish()
+{
+    return m_impl->advanceTo("finish()", State::Finished);
+}
+
+}   // namespace odxf
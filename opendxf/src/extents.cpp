@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/extents.hpp"
+
+#include "geometry.hpp"
+#include "parallel.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <optional>
+#include <vector>
+
+namespace {
+
+using odxf::Coordinate3d;
+using odxf::Curve;
+using odxf::fullTurn;
+using odxf::Vector3d;
+
+// A point (cos(t), sin(t)) of the unit circle, or a positive multiple of it.
+struct Direction final
+{
+    double cosine{ 1.0 };
+    double sine{ 0.0 };
+};
+
+double cross(const Direction& lhs, const Direction& rhs)
+{
+    return lhs.cosine * rhs.sine - lhs.sine * rhs.cosine;
+}
+
+// The directions a curve sweeps counterclockwise from the start to the end direction, or
+// all of them for closed curves.
+struct DirectionSweep final
+{
+    bool isClosed{ true };
+    // whether the sweep exceeds half a turn
+    bool isMajor{ true };
+    Direction start;
+    Direction end;
+};
+
+// Whether the curve passes the direction, tested by the orientation of the direction
+// towards the start and end directions instead of comparing angles.
+bool passes(const DirectionSweep& sweep, const Direction& direction)
+{
+    if (sweep.isClosed) {
+        return true;
+    }
+
+    if (!sweep.isMajor) {
+        return cross(sweep.start, direction) >= 0.0 && cross(direction, sweep.end) >= 0.0;
+    }
+
+    return !(cross(sweep.end, direction) > 0.0 && cross(direction, sweep.start) > 0.0);
+}
+
+// Adds the extreme coordinates of the curve, its end points excluded. The coordinate
+// u_i * cos(t) + v_i * sin(t) has its maximum sqrt(u_i^2 + v_i^2) in the direction
+// (u_i, v_i) and its minimum in the opposite one.
+void addExtremes(odxf::Extents& extents, const Curve& curve, const DirectionSweep& sweep)
+{
+    const std::array<double, 3> center{ curve.center.x, curve.center.y, curve.center.z };
+    const std::array<double, 3> u{ curve.u.x, curve.u.y, curve.u.z };
+    const std::array<double, 3> v{ curve.v.x, curve.v.y, curve.v.z };
+    const std::array<double*, 3> min{ &extents.min.x, &extents.min.y, &extents.min.z };
+    const std::array<double*, 3> max{ &extents.max.x, &extents.max.y, &extents.max.z };
+
+    for (std::size_t axis{ 0 }; axis < center.size(); ++axis) {
+        if (u[axis] == 0.0 && v[axis] == 0.0) {
+            continue;
+        }
+
+        const double radius{ std::sqrt(u[axis] * u[axis] + v[axis] * v[axis]) };
+        if (passes(sweep, Direction{ u[axis], v[axis] })) {
+            *max[axis] = std::max(*max[axis], center[axis] + radius);
+        }
+        if (passes(sweep, Direction{ -u[axis], -v[axis] })) {
+            *min[axis] = std::min(*min[axis], center[axis] - radius);
+        }
+    }
+}
+
+// The extents of the curve over its sweep.
+odxf::Extents curveExtents(const Curve& curve)
+{
+    DirectionSweep sweep{
+        .isClosed = curve.sweep >= fullTurn,
+        .isMajor = curve.sweep > std::numbers::pi,
+    };
+
+    odxf::Extents result;
+    if (!sweep.isClosed) {
+        const double end{ curve.start + curve.sweep };
+        sweep.start = Direction{ std::cos(curve.start), std::sin(curve.start) };
+        sweep.end = Direction{ std::cos(end), std::sin(end) };
+
+        for (const Direction& direction : { sweep.start, sweep.end }) {
+            result.add(toCoordinate(
+                curve.center + direction.cosine * curve.u + direction.sine * curve.v));
+        }
+    } else {
+        // the center, a point the extremes are added to
+        result.add(toCoordinate(curve.center));
+    }
+    addExtremes(result, curve, sweep);
+
+    return result;
+}
+
+// Bounds the entities in the index-th of chunkCount ranges.
+template <typename T>
+void addChunk(
+    odxf::Extents& extents,
+    const std::vector<T>& entities,
+    std::size_t chunkCount,
+    std::size_t index)
+{
+    const odxf::ChunkRange range{ odxf::chunkRange(entities.size(), chunkCount, index) };
+    for (std::size_t i{ range.begin }; i < range.end; ++i) {
+        extents.add(odxf::extents(entities[i]));
+    }
+}
+
+}   // namespace
+
+namespace odxf {
+
+Extents extents(const Arc& arc)
+{
+    return curveExtents(arcCurve(arc));
+}
+
+Extents extents(const Circle& circle)
+{
+    if (!circle.extrusion) {
+        const Coordinate3d& center{ circle.center };
+        const double radius{ std::abs(circle.radius) };
+
+        Extents result;
+        result.add(Coordinate3d{ center.x - radius, center.y - radius, center.z });
+        result.add(Coordinate3d{ center.x + radius, center.y + radius, center.z });
+
+        return result;
+    }
+
+    return curveExtents(circularCurve(circle.center, circle.radius, circle.extrusion));
+}
+
+Extents extents(const Ellipse& ellipse)
+{
+    return curveExtents(ellipseCurve(ellipse));
+}
+
+Extents extents(const Line& line)
+{
+    Extents result;
+    result.add(line.start);
+    result.add(line.end);
+
+    return result;
+}
+
+Extents extents(const LWPolyline& lwPolyline)
+{
+    const Vertices& vertices{ lwPolyline.vertices };
+    if (vertices.empty()) {
+        return Extents{};
+    }
+
+    const double elevation{ lwPolyline.elevation.value_or(0.0) };
+
+    Extents result;
+    result.min.z = elevation;
+    result.max.z = elevation;
+    for (const Vertex& vertex : vertices) {
+        result.min.x = vertex.position.x < result.min.x ? vertex.position.x : result.min.x;
+        result.min.y = vertex.position.y < result.min.y ? vertex.position.y : result.min.y;
+        result.max.x = vertex.position.x > result.max.x ? vertex.position.x : result.max.x;
+        result.max.y = vertex.position.y > result.max.y ? vertex.position.y : result.max.y;
+    }
+
+    const std::size_t segmentCount{ lwPolyline.isClosed ? vertices.size() : vertices.size() - 1 };
+    for (std::size_t i{ 0 }; i < segmentCount; ++i) {
+        const std::optional<double>& bulge{ vertices[i].bulge };
+        if (!bulge || *bulge == 0.0 || !std::isfinite(*bulge)) {
+            continue;
+        }
+
+        const Coordinate2d& start{ vertices[i].position };
+        const Coordinate2d& end{ vertices[(i + 1) % vertices.size()].position };
+        const Coordinate2d center{ bulgeCenter(start, end, *bulge) };
+
+        // the directions from the center to the vertices, clockwise arcs are bounded like
+        // the counterclockwise arc from the end. Arcs of bulges beyond 1 sweep more than half
+        // a turn.
+        const Direction startDirection{ start.x - center.x, start.y - center.y };
+        const Direction endDirection{ end.x - center.x, end.y - center.y };
+        const double radius{ std::sqrt(
+            startDirection.cosine * startDirection.cosine
+            + startDirection.sine * startDirection.sine) };
+        const bool isClockwise{ *bulge < 0.0 };
+        addExtremes(
+            result,
+            Curve{
+                .center = Vector3d{ center.x, center.y, elevation },
+                .u = Vector3d{ radius, 0.0, 0.0 },
+                .v = Vector3d{ 0.0, radius, 0.0 },
+            },
+            DirectionSweep{
+                .isClosed = false,
+                .isMajor = std::abs(*bulge) > 1.0,
+                .start = isClockwise ? endDirection : startDirection,
+                .end = isClockwise ? startDirection : endDirection,
+            });
+    }
+
+    return result;
+}
+
+Extents extents(const Point& point)
+{
+    Extents result;
+    result.add(point.coordinate);
+
+    return result;
+}
+
+Extents extents(const Ray& ray)
+{
+    Extents result;
+    result.add(ray.startPoint);
+
+    return result;
+}
+
+Extents computeExtents(const Entities& entities, const ExtentsOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("computeExtents");
+
+    // every thread bounds a range of each entity type, publishing its extents when done
+    const unsigned int threadCount{ resolveThreadCount(options.threadCount) };
+    std::vector<Extents> chunkExtents(threadCount);
+    parallelFor(threadCount, threadCount, [&](std::size_t index) {
+        Extents chunk;
+        addChunk(chunk, entities.points, threadCount, index);
+        addChunk(chunk, entities.rays, threadCount, index);
+        addChunk(chunk, entities.lines, threadCount, index);
+        addChunk(chunk, entities.circles, threadCount, index);
+        addChunk(chunk, entities.arcs, threadCount, index);
+        addChunk(chunk, entities.ellipses, threadCount, index);
+        addChunk(chunk, entities.lwPolylines, threadCount, index);
+        chunkExtents[index] = chunk;
+    });
+
+    Extents result;
+    for (const Extents& chunk : chunkExtents) {
+        result.add(chunk);
+    }
+
+    return result;
+}
+
+}   // namespace odxf
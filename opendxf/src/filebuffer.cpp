@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "filebuffer.hpp"
+
+#include "pathstring.hpp"
+#include "tracescope.hpp"
+
+#include <fmt/format.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace odxf {
+
+tl::expected<std::string, Error> readFileContent(const std::filesystem::path& filePath)
+{
+    OPENDXF_TRACE_SCOPE("loadFile");
+
+    std::ifstream stream{ filePath, std::ios::binary };
+    if (!stream.is_open()) {
+        return tl::make_unexpected(Error{
+            .type = Error::Type::FileOpenError,
+            .what = fmt::format("unable to open file {}", pathToString(filePath)),
+        });
+    }
+
+    std::error_code errorCode;
+    const std::uintmax_t fileSize{ std::filesystem::file_size(filePath, errorCode) };
+
+    std::string content;
+    if (!errorCode) {
+        content.resize(static_cast<std::size_t>(fileSize));
+        stream.read(content.data(), static_cast<std::streamsize>(content.size()));
+        content.resize(static_cast<std::size_t>(stream.gcount()));
+    } else {
+        content.assign(std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{});
+    }
+
+    return content;
+}
+
+}   // namespace odxf
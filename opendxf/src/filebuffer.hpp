@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/error.hpp"
+
+#include <tl/expected.hpp>
+
+#include <filesystem>
+#include <string>
+
+namespace odxf {
+
+tl::expected<std::string, Error> readFileContent(const std::filesystem::path& filePath);
+
+}   // namespace odxf
@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/coordinate.hpp"
+#include "opendxf/entities.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <optional>
+
+namespace odxf {
+
+inline constexpr Vector3d zAxis{ 0.0, 0.0, 1.0 };
+inline constexpr double fullTurn{ 2.0 * std::numbers::pi };
+
+inline Vector3d toVector(const Coordinate3d& coordinate)
+{
+    return Vector3d{ coordinate.x, coordinate.y, coordinate.z };
+}
+
+inline Coordinate3d toCoordinate(const Vector3d& vector)
+{
+    return Coordinate3d{ vector.x, vector.y, vector.z };
+}
+
+inline Vector3d operator+(const Vector3d& lhs, const Vector3d& rhs)
+{
+    return Vector3d{ lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z };
+}
+
+inline Vector3d operator-(const Vector3d& vector)
+{
+    return Vector3d{ -vector.x, -vector.y, -vector.z };
+}
+
+inline Vector3d operator*(double factor, const Vector3d& vector)
+{
+    return Vector3d{ factor * vector.x, factor * vector.y, factor * vector.z };
+}
+
+inline double dot(const Vector3d& lhs, const Vector3d& rhs)
+{
+    return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+}
+
+inline Vector3d cross(const Vector3d& lhs, const Vector3d& rhs)
+{
+    return Vector3d{ lhs.y * rhs.z - lhs.z * rhs.y,
+                     lhs.z * rhs.x - lhs.x * rhs.z,
+                     lhs.x * rhs.y - lhs.y * rhs.x };
+}
+
+inline double length(const Vector3d& vector)
+{
+    return std::hypot(vector.x, vector.y, vector.z);
+}
+
+inline Vector3d normalized(const Vector3d& vector)
+{
+    const double vectorLength{ length(vector) };
+
+    return vectorLength > 0.0 ? (1.0 / vectorLength) * vector : vector;
+}
+
+inline bool operator==(const Vector3d& lhs, const Vector3d& rhs)
+{
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+}
+
+// The axes of the object coordinate system of an extrusion, following the arbitrary axis
+// algorithm of the DXF reference.
+struct Ocs final
+{
+    explicit Ocs(const Vector3d& extrusion)
+        : z{ normalized(extrusion) }
+    {
+        constexpr double limit{ 1.0 / 64.0 };
+        const Vector3d worldAxis{ std::abs(z.x) < limit && std::abs(z.y) < limit
+                                      ? Vector3d{ 0.0, 1.0, 0.0 }
+                                      : zAxis };
+        x = normalized(cross(worldAxis, z));
+        y = normalized(cross(z, x));
+    }
+
+    Vector3d toWorld(const Coordinate3d& coordinate) const
+    {
+        return coordinate.x * x + coordinate.y * y + coordinate.z * z;
+    }
+
+    Coordinate3d toObject(const Vector3d& vector) const
+    {
+        return Coordinate3d{ dot(vector, x), dot(vector, y), dot(vector, z) };
+    }
+
+    // angle of a direction in the xy plane, in [0, 360)
+    double angle(const Vector3d& direction) const
+    {
+        const double degrees{ std::atan2(dot(direction, y), dot(direction, x)) * 180.0
+                              / std::numbers::pi };
+
+        return degrees < 0.0 ? degrees + 360.0 : degrees;
+    }
+
+    Vector3d x;
+    Vector3d y;
+    Vector3d z;
+};
+
+// Counterclockwise sweep from the start to the end, a full turn if they are equal.
+inline double sweepAngle(double start, double end, double turn)
+{
+    const double sweep{ std::fmod(end - start, turn) };
+
+    return sweep > 0.0 ? sweep : sweep + turn;
+}
+
+// The points center + u * cos(t) + v * sin(t) for t sweeping counterclockwise from the start,
+// a closed curve for sweeps of a full turn.
+struct Curve final
+{
+    Vector3d center;
+    Vector3d u;
+    Vector3d v;
+    double start{ 0.0 };
+    double sweep{ fullTurn };
+
+    Vector3d point(double parameter) const
+    {
+        return center + std::cos(parameter) * u + std::sin(parameter) * v;
+    }
+};
+
+// The circle of an arc or a circle in world coordinates, whose parameter is the angle in
+// radians in its object coordinate system.
+inline Curve circularCurve(
+    const Coordinate3d& center, double radius, const std::optional<Vector3d>& extrusion)
+{
+    if (!extrusion) {
+        return Curve{
+            .center = toVector(center),
+            .u = Vector3d{ radius, 0.0, 0.0 },
+            .v = Vector3d{ 0.0, radius, 0.0 },
+        };
+    }
+
+    const Ocs ocs{ *extrusion };
+
+    return Curve{
+        .center = ocs.toWorld(center),
+        .u = radius * ocs.x,
+        .v = radius * ocs.y,
+    };
+}
+
+// The major axis rotated by 90 degrees around the extrusion and scaled by the axis ratio.
+inline Vector3d ellipseMinorAxis(const Ellipse& ellipse)
+{
+    const Vector3d normal{ normalized(ellipse.extrusion.value_or(zAxis)) };
+
+    return ellipse.axisRatio * cross(normal, toVector(ellipse.endPointMajor));
+}
+
+inline Curve arcCurve(const Arc& arc)
+{
+    const double sweep{ sweepAngle(arc.startAngle, arc.endAngle, 360.0) };
+
+    Curve curve{ circularCurve(arc.center, arc.radius, arc.extrusion) };
+    curve.start = arc.startAngle * std::numbers::pi / 180.0;
+    curve.sweep = sweep == 360.0 ? fullTurn : sweep * std::numbers::pi / 180.0;
+
+    return curve;
+}
+
+inline Curve ellipseCurve(const Ellipse& ellipse)
+{
+    return Curve{
+        .center = toVector(ellipse.center),
+        .u = toVector(ellipse.endPointMajor),
+        .v = ellipseMinorAxis(ellipse),
+        .start = ellipse.startParameter,
+        .sweep = sweepAngle(ellipse.startParameter, ellipse.endParameter, fullTurn),
+    };
+}
+
+// A bulged segment between two lw polyline vertices, as arc of a circle.
+struct BulgeArc final
+{
+    Coordinate3d center;
+    double radius{ 0.0 };
+    double startAngle{ 0.0 };
+    // negative for clockwise arcs
+    double sweep{ 0.0 };
+};
+
+// The center of the arc of a bulged segment, it lies on the bisector of the chord, left of
+// it for positive bulges.
+inline Coordinate2d bulgeCenter(const Coordinate2d& start, const Coordinate2d& end, double bulge)
+{
+    const double offset{ (1.0 - bulge * bulge) / (4.0 * bulge) };
+
+    return Coordinate2d{ (start.x + end.x) / 2.0 - (end.y - start.y) * offset,
+                         (start.y + end.y) / 2.0 + (end.x - start.x) * offset };
+}
+
+inline std::optional<BulgeArc> bulgeArc(
+    const Coordinate2d& start,
+    const Coordinate2d& end,
+    std::optional<double> bulge,
+    double elevation)
+{
+    if (!bulge || *bulge == 0.0 || !std::isfinite(*bulge)) {
+        return std::nullopt;
+    }
+
+    const double chord{ std::hypot(end.x - start.x, end.y - start.y) };
+    if (chord == 0.0) {
+        return std::nullopt;
+    }
+
+    const double b{ *bulge };
+    const Coordinate2d center{ bulgeCenter(start, end, b) };
+
+    return BulgeArc{
+        .center = Coordinate3d{ center.x, center.y, elevation },
+        .radius = chord * (1.0 + b * b) / (4.0 * std::abs(b)),
+        .startAngle = std::atan2(start.y - center.y, start.x - center.x),
+        .sweep = 4.0 * std::atan(b),
+    };
+}
+
+}   // namespace odxf
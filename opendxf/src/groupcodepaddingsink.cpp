@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "groupcodepaddingsink.hpp"
+
+namespace odxf {
+
+GroupCodePaddingSink::GroupCodePaddingSink(IOutputSink& sink)
+    : m_sink{ sink }
+{
+}
+
+tl::expected<void, Error> GroupCodePaddingSink::write(std::string_view block)
+{
+    m_output.clear();
+
+    while (!block.empty()) {
+        const std::size_t newline{ block.find('\n') };
+        if (newline == std::string_view::npos) {
+            if (m_isGroupCodeLine) {
+                m_groupCode.append(block);
+            } else {
+                m_output.append(block);
+            }
+
+            break;
+        }
+
+        if (m_isGroupCodeLine) {
+            m_groupCode.append(block.substr(0, newline));
+            appendGroupCode(m_groupCode);
+            m_output.push_back('\n');
+            m_groupCode.clear();
+        } else {
+            m_output.append(block.substr(0, newline + 1));
+        }
+
+        m_isGroupCodeLine = !m_isGroupCodeLine;
+        block.remove_prefix(newline + 1);
+    }
+
+    return m_sink.write(m_output);
+}
+
+tl::expected<void, Error> GroupCodePaddingSink::reserve(std::uintmax_t size)
+{
+    // padding adds at most two characters per group code, usually far less in total
+    return m_sink.reserve(size + size / 8);
+}
+
+tl::expected<void, Error> GroupCodePaddingSink::close()
+{
+    if (!m_groupCode.empty()) {
+        m_output.clear();
+        appendGroupCode(m_groupCode);
+        m_groupCode.clear();
+
+        if (tl::expected<void, Error> result = m_sink.write(m_output); !result) {
+            return result;
+        }
+    }
+
+    return m_sink.close();
+}
+
+void GroupCodePaddingSink::appendGroupCode(std::string_view groupCode)
+{
+    constexpr std::size_t width{ 3 };
+
+    if (groupCode.size() < width) {
+        m_output.append(width - groupCode.size(), ' ');
+    }
+    m_output.append(groupCode);
+}
+
+}   // namespace odxf
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/error.hpp"
+#include "opendxf/outputsink.hpp"
+
+#include <tl/expected.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace odxf {
+
+// Right-aligns the group codes to a width of three characters, as many CAD programs
+// write them, and passes the result on to another sink.
+class GroupCodePaddingSink final : public IOutputSink
+{
+public:
+    // The sink must outlive this sink.
+    explicit GroupCodePaddingSink(IOutputSink& sink);
+
+    tl::expected<void, Error> write(std::string_view block) override;
+    tl::expected<void, Error> reserve(std::uintmax_t size) override;
+    tl::expected<void, Error> close() override;
+
+private:
+    void appendGroupCode(std::string_view groupCode);
+
+    IOutputSink& m_sink;
+    std::string m_output;
+    // start of a group code split across blocks
+    std::string m_groupCode;
+    bool m_isGroupCodeLine{ true };
+};
+
+}   // namespace odxf
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace odxf {
+
+namespace detail {
+
+constexpr std::uint64_t prime1{ 0x9E3779B185EBCA87 };
+constexpr std::uint64_t prime2{ 0xC2B2AE3D27D4EB4F };
+constexpr std::uint64_t prime3{ 0x165667B19E3779F9 };
+constexpr std::uint64_t prime4{ 0x85EBCA77C2B2AE63 };
+constexpr std::uint64_t prime5{ 0x27D4EB2F165667C5 };
+
+inline std::uint64_t round(std::uint64_t accumulator, std::uint64_t input)
+{
+    accumulator += input * prime2;
+
+    return std::rotl(accumulator, 31) * prime1;
+}
+
+inline std::uint64_t load64(const char* data)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+inline std::uint64_t load32(const char* data)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+}   // namespace detail
+
+// XXH64 by Yann Collet, fast enough to hash a file at memory bandwidth.
+inline std::uint64_t hash64(std::string_view data, std::uint64_t seed = 0)
+{
+    const char* input{ data.data() };
+    const char* const end{ input + data.size() };
+    std::uint64_t result{ 0 };
+
+    if (data.size() >= 32) {
+        std::array<std::uint64_t, 4> lanes{ seed + detail::prime1 + detail::prime2,
+                                            seed + detail::prime2,
+                                            seed,
+                                            seed - detail::prime1 };
+        for (; input + 32 <= end; input += 32) {
+            for (std::size_t i{ 0 }; i < lanes.size(); ++i) {
+                lanes[i] = detail::round(lanes[i], detail::load64(input + 8 * i));
+            }
+        }
+
+        result = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12)
+                 + std::rotl(lanes[3], 18);
+        for (std::uint64_t lane : lanes) {
+            result = (result ^ detail::round(0, lane)) * detail::prime1 + detail::prime4;
+        }
+    } else {
+        result = seed + detail::prime5;
+    }
+
+    result += data.size();
+
+    for (; input + 8 <= end; input += 8) {
+        result ^= detail::round(0, detail::load64(input));
+        result = std::rotl(result, 27) * detail::prime1 + detail::prime4;
+    }
+    if (input + 4 <= end) {
+        result ^= detail::load32(input) * detail::prime1;
+        result = std::rotl(result, 23) * detail::prime2 + detail::prime3;
+        input += 4;
+    }
+    for (; input < end; ++input) {
+        result ^= static_cast<std::uint8_t>(*input) * detail::prime5;
+        result = std::rotl(result, 11) * detail::prime1;
+    }
+
+    result ^= result >> 33;
+    result *= detail::prime2;
+    result ^= result >> 29;
+    result *= detail::prime3;
+    result ^= result >> 32;
+
+    return result;
+}
+
+}   // namespace odxf
@@ -0,0 +1,510 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/incremental.hpp"
+
+#include "filebuffer.hpp"
+#include "hash.hpp"
+#include "moveappend.hpp"
+#include "parallel.hpp"
+#include "prescanner.hpp"
+#include "reader.hpp"
+#include "readersink.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+using odxf::EntityType;
+using odxf::moveAppend;
+
+// Type of the records the Reader does not parse, e.g. POINT. They are hashed but never
+// take part in splices.
+constexpr std::uint8_t otherType{ odxf::entityTypeCount };
+
+// counts indexed by the type of a record, an EntityType or otherType
+class TypeCounts final
+{
+public:
+    std::size_t& operator[](std::uint8_t type) { return m_counts[type]; }
+    std::size_t& operator[](EntityType type) { return (*this)[static_cast<std::uint8_t>(type)]; }
+
+    TypeCounts& operator+=(const TypeCounts& other)
+    {
+        for (std::size_t i{ 0 }; i < m_counts.size(); ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+
+        return *this;
+    }
+
+private:
+    std::array<std::size_t, otherType + 1> m_counts{};
+};
+
+// Chunks end after an entity whose hash has these bits cleared, i.e. after 32 entities on
+// average. Derived from the content, an edit changes the boundaries of its chunk only.
+constexpr std::uint64_t chunkBoundaryMask{ 31 };
+constexpr std::size_t maxChunkEntities{ 256 };
+
+// smallest number of entities parsed by a thread
+constexpr std::size_t minJobEntities{ 4096 };
+
+std::uint8_t recordType(std::string_view name)
+{
+    const std::optional<EntityType> type{ odxf::parsedEntityType(name) };
+
+    return type ? static_cast<std::uint8_t>(*type) : otherType;
+}
+
+struct Chunk final
+{
+    std::size_t begin{ 0 };
+    std::size_t end{ 0 };
+    std::uint64_t hash{ 0 };
+};
+
+std::vector<Chunk> splitChunks(const std::vector<std::uint64_t>& entityHashes)
+{
+    std::vector<Chunk> chunks;
+    std::size_t begin{ 0 };
+
+    for (std::size_t i{ 0 }; i < entityHashes.size(); ++i) {
+        const bool isBoundary{ (entityHashes[i] & chunkBoundaryMask) == 0
+                               || i + 1 - begin == maxChunkEntities
+                               || i + 1 == entityHashes.size() };
+        if (!isBoundary) {
+            continue;
+        }
+
+        const std::string_view bytes{ reinterpret_cast<const char*>(&entityHashes[begin]),
+                                      (i + 1 - begin) * sizeof(std::uint64_t) };
+        chunks.push_back(Chunk{ .begin = begin, .end = i + 1, .hash = odxf::hash64(bytes) });
+        begin = i + 1;
+    }
+
+    return chunks;
+}
+
+// Entities [oldBegin, oldEnd) of the previous read replaced by [newBegin, newEnd).
+struct Region final
+{
+    std::size_t oldBegin{ 0 };
+    std::size_t oldEnd{ 0 };
+    std::size_t newBegin{ 0 };
+    std::size_t newEnd{ 0 };
+};
+
+// Aligns the chunks of both reads greedily in order and returns the entities between
+// matching chunks, without the entities equal at their start and end.
+std::vector<Region> changedRegions(
+    const std::vector<std::uint64_t>& oldHashes, const std::vector<std::uint64_t>& newHashes)
+{
+    const std::vector<Chunk> oldChunks{ splitChunks(oldHashes) };
+    const std::vector<Chunk> newChunks{ splitChunks(newHashes) };
+
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> oldPositions;
+    oldPositions.reserve(oldChunks.size());
+    for (std::size_t i{ 0 }; i < oldChunks.size(); ++i) {
+        oldPositions[oldChunks[i].hash].push_back(i);
+    }
+
+    const auto oldStart{ [&](std::size_t chunk) {
+        return chunk < oldChunks.size() ? oldChunks[chunk].begin : oldHashes.size();
+    } };
+    const auto newStart{ [&](std::size_t chunk) {
+        return chunk < newChunks.size() ? newChunks[chunk].begin : newHashes.size();
+    } };
+
+    std::vector<Region> regions;
+    const auto addRegion{ [&](Region region) {
+        while (region.oldBegin < region.oldEnd && region.newBegin < region.newEnd
+               && oldHashes[region.oldBegin] == newHashes[region.newBegin]) {
+            ++region.oldBegin;
+            ++region.newBegin;
+        }
+        while (region.oldBegin < region.oldEnd && region.newBegin < region.newEnd
+               && oldHashes[region.oldEnd - 1] == newHashes[region.newEnd - 1]) {
+            --region.oldEnd;
+            --region.newEnd;
+        }
+
+        if (region.oldBegin < region.oldEnd || region.newBegin < region.newEnd) {
+            regions.push_back(region);
+        }
+    } };
+
+    std::size_t oldChunk{ 0 };
+    std::size_t unmatchedNewChunk{ 0 };
+    for (std::size_t newChunk{ 0 }; newChunk < newChunks.size(); ++newChunk) {
+        const auto iter{ oldPositions.find(newChunks[newChunk].hash) };
+        if (iter == oldPositions.end()) {
+            continue;
+        }
+
+        const std::vector<std::size_t>& positions{ iter->second };
+        const auto position{ std::lower_bound(positions.begin(), positions.end(), oldChunk) };
+        if (position == positions.end()) {
+            continue;
+        }
+
+        addRegion(Region{
+            .oldBegin = oldStart(oldChunk),
+            .oldEnd = oldStart(*position),
+            .newBegin = newStart(unmatchedNewChunk),
+            .newEnd = newStart(newChunk),
+        });
+
+        oldChunk = *position + 1;
+        unmatchedNewChunk = newChunk + 1;
+    }
+
+    addRegion(Region{
+        .oldBegin = oldStart(oldChunk),
+        .oldEnd = oldHashes.size(),
+        .newBegin = newStart(unmatchedNewChunk),
+        .newEnd = newHashes.size(),
+    });
+
+    return regions;
+}
+
+// A run of new entities parsed by one thread.
+struct ParseJob final
+{
+    std::size_t region{ 0 };
+    std::size_t begin{ 0 };
+    std::size_t end{ 0 };
+};
+
+template <typename T>
+void addSplice(
+    odxf::EntitySplices<T>& splices,
+    std::size_t index,
+    std::size_t removedCount,
+    std::vector<T>& inserted)
+{
+    if (removedCount == 0 && inserted.empty()) {
+        return;
+    }
+
+    splices.push_back(odxf::EntitySplice<T>{
+        .index = index,
+        .removedCount = removedCount,
+        .inserted = std::move(inserted),
+    });
+}
+
+template <typename T>
+void addCounts(odxf::DeltaCounts& counts, const odxf::EntitySplices<T>& splices)
+{
+    for (const odxf::EntitySplice<T>& splice : splices) {
+        const std::size_t modified{ std::min(splice.removedCount, splice.inserted.size()) };
+        counts.modified += modified;
+        counts.added += splice.inserted.size() - modified;
+        counts.removed += splice.removedCount - modified;
+    }
+}
+
+template <typename T>
+void applySplices(std::vector<T>& entities, odxf::EntitySplices<T>&& splices)
+{
+    // modifications keep the positions of all other entities, they are assigned in place
+    const bool isInPlace{ std::all_of(
+        splices.begin(), splices.end(), [](const odxf::EntitySplice<T>& splice) {
+            return splice.removedCount == splice.inserted.size();
+        }) };
+
+    if (isInPlace) {
+        for (odxf::EntitySplice<T>& splice : splices) {
+            std::move(
+                splice.inserted.begin(),
+                splice.inserted.end(),
+                entities.begin() + splice.index);
+        }
+
+        return;
+    }
+
+    std::size_t size{ entities.size() };
+    for (const odxf::EntitySplice<T>& splice : splices) {
+        size += splice.inserted.size() - splice.removedCount;
+    }
+
+    std::vector<T> result;
+    result.reserve(size);
+
+    std::size_t position{ 0 };
+    for (odxf::EntitySplice<T>& splice : splices) {
+        std::move(
+            entities.begin() + position,
+            entities.begin() + splice.index,
+            std::back_inserter(result));
+        moveAppend(result, splice.inserted);
+        position = splice.index + splice.removedCount;
+    }
+    std::move(entities.begin() + position, entities.end(), std::back_inserter(result));
+
+    entities = std::move(result);
+}
+
+}   // namespace
+
+namespace odxf {
+
+struct IncrementalReader::State final
+{
+    // content up to and including the name of the ENTITIES section
+    std::size_t entitiesOffset{ 0 };
+    int entitiesLineOffset{ 0 };
+    std::uint64_t prefixHash{ 0 };
+    // content from the end of the ENTITIES section
+    std::uint64_t trailerHash{ 0 };
+
+    std::vector<std::uint64_t> entityHashes;
+    std::vector<std::uint8_t> entityTypes;
+};
+
+DeltaCounts DocumentDelta::counts() const
+{
+    DeltaCounts result;
+    addCounts(result, arcs);
+    addCounts(result, circles);
+    addCounts(result, ellipses);
+    addCounts(result, lines);
+    addCounts(result, points);
+    addCounts(result, lwPolylines);
+    addCounts(result, rays);
+
+    return result;
+}
+
+bool DocumentDelta::empty() const
+{
+    return !header && !tables && arcs.empty() && circles.empty() && ellipses.empty()
+           && lines.empty() && points.empty() && lwPolylines.empty() && rays.empty();
+}
+
+void applyDelta(Document& document, DocumentDelta&& delta)
+{
+    if (delta.header) {
+        document.header = std::move(*delta.header);
+    }
+    if (delta.tables) {
+        document.tables = std::move(*delta.tables);
+    }
+
+    Entities& entities{ document.entities };
+    applySplices(entities.arcs, std::move(delta.arcs));
+    applySplices(entities.circles, std::move(delta.circles));
+    applySplices(entities.ellipses, std::move(delta.ellipses));
+    applySplices(entities.lines, std::move(delta.lines));
+    applySplices(entities.points, std::move(delta.points));
+    applySplices(entities.lwPolylines, std::move(delta.lwPolylines));
+    applySplices(entities.rays, std::move(delta.rays));
+}
+
+IncrementalReader::IncrementalReader(IncrementalOptions options)
+    : m_options{ options }
+{
+}
+
+IncrementalReader::~IncrementalReader() = default;
+
+IncrementalReader::IncrementalReader(IncrementalReader&&) noexcept = default;
+
+IncrementalReader& IncrementalReader::operator=(IncrementalReader&&) noexcept = default;
+
+tl::expected<DocumentDelta, Error> IncrementalReader::read(const std::filesystem::path& filePath)
+{
+    const tl::expected<std::string, Error> maybeContent{ readFileContent(filePath) };
+    if (!maybeContent) {
+        return tl::make_unexpected(maybeContent.error());
+    }
+
+    return readContent(*maybeContent);
+}
+
+tl::expected<DocumentDelta, Error> IncrementalReader::readContent(std::string_view content)
+{
+    OPENDXF_TRACE_SCOPE("incrementalRead");
+
+    const State* const previous{ m_state.get() };
+    auto state{ std::make_unique<State>() };
+    DocumentDelta delta;
+
+    const bool isPrefixUnchanged{ previous != nullptr
+                                  && content.size() >= previous->entitiesOffset
+                                  && hash64(content.substr(0, previous->entitiesOffset))
+                                         == previous->prefixHash };
+
+    // The sections around the entities are read whenever they changed, also to validate
+    // them as readDocument() would.
+    Document prefixDocument;
+    DocumentSink prefixSink{ prefixDocument };
+    Reader prefixReader{ prefixSink };
+    bool isPrefixRead{ false };
+    const auto readPrefix{ [&]() -> tl::expected<void, Error> {
+        isPrefixRead = true;
+
+        return prefixReader.readUntilEntities(content);
+    } };
+
+    if (isPrefixUnchanged) {
+        state->entitiesOffset = previous->entitiesOffset;
+        state->entitiesLineOffset = previous->entitiesLineOffset;
+        state->prefixHash = previous->prefixHash;
+    } else {
+        if (tl::expected<void, Error> result = readPrefix(); !result) {
+            return tl::make_unexpected(result.error());
+        }
+
+        state->entitiesOffset = prefixReader.position();
+        state->entitiesLineOffset = prefixReader.currentLine();
+        state->prefixHash = hash64(content.substr(0, state->entitiesOffset));
+    }
+
+    const std::optional<std::vector<EntityRecord>> maybeRecords{
+        scanEntityRecords(content, state->entitiesOffset, state->entitiesLineOffset)
+    };
+    if (!maybeRecords) {
+        return tl::make_unexpected(Error{
+            .type = Error::Type::InvalidFile,
+            .what = "unsupported layout of the ENTITIES section",
+        });
+    }
+
+    const std::vector<EntityRecord>& records{ *maybeRecords };
+    const EntityRecord& sectionEnd{ records.back() };
+    const std::size_t entityCount{ records.size() - 1 };
+
+    state->trailerHash = hash64(content.substr(sectionEnd.begin));
+    if (!isPrefixUnchanged || state->trailerHash != previous->trailerHash) {
+        if (!isPrefixRead) {
+            if (tl::expected<void, Error> result = readPrefix(); !result) {
+                return tl::make_unexpected(result.error());
+            }
+        }
+
+        if (tl::expected<void, Error> result =
+                prefixReader.readFromEntitiesEnd(sectionEnd.begin, sectionEnd.lineOffset);
+            !result) {
+            return tl::make_unexpected(result.error());
+        }
+    }
+
+    if (!isPrefixUnchanged) {
+        delta.header = std::move(prefixDocument.header);
+        delta.tables = std::move(prefixDocument.tables);
+    }
+
+    state->entityHashes.resize(entityCount);
+    state->entityTypes.resize(entityCount);
+    {
+        OPENDXF_TRACE_SCOPE("hashEntities");
+
+        const unsigned int threadCount{ resolveThreadCount(m_options.threadCount) };
+        parallelFor(threadCount, threadCount, [&](std::size_t index) {
+            const ChunkRange range{ chunkRange(entityCount, threadCount, index) };
+            for (std::size_t i{ range.begin }; i < range.end; ++i) {
+                state->entityHashes[i] = hash64(
+                    content.substr(records[i].begin, records[i + 1].begin - records[i].begin));
+                state->entityTypes[i] = recordType(records[i].type);
+            }
+        });
+    }
+
+    static const std::vector<std::uint64_t> noHashes;
+    const std::vector<Region> regions{
+        changedRegions(previous != nullptr ? previous->entityHashes : noHashes, state->entityHashes)
+    };
+
+    // large regions, e.g. the whole document of the first read, are parsed in parallel
+    const unsigned int threadCount{ resolveThreadCount(m_options.threadCount) };
+    std::size_t changedEntities{ 0 };
+    for (const Region& region : regions) {
+        changedEntities += region.newEnd - region.newBegin;
+    }
+    const std::size_t jobEntities{ std::max(minJobEntities, changedEntities / threadCount + 1) };
+
+    std::vector<ParseJob> jobs;
+    for (std::size_t i{ 0 }; i < regions.size(); ++i) {
+        for (std::size_t begin{ regions[i].newBegin }; begin < regions[i].newEnd;
+             begin += jobEntities) {
+            jobs.push_back(ParseJob{
+                .region = i,
+                .begin = begin,
+                .end = std::min(begin + jobEntities, regions[i].newEnd),
+            });
+        }
+    }
+
+    std::vector<Document> jobDocuments(jobs.size());
+    std::vector<tl::expected<void, Error>> jobResults(jobs.size());
+    parallelFor(jobs.size(), threadCount, [&](std::size_t index) {
+        const ParseJob& job{ jobs[index] };
+        const std::size_t begin{ records[job.begin].begin };
+
+        DocumentSink sink{ jobDocuments[index] };
+        Reader reader{ sink };
+        jobResults[index] = reader.readEntityChunk(
+            content.substr(begin, records[job.end].typeEnd - begin), records[job.begin].lineOffset);
+    });
+
+    for (std::size_t i{ 0 }; i < jobs.size(); ++i) {
+        if (!jobResults[i]) {
+            return tl::make_unexpected(jobResults[i].error());
+        }
+
+        delta.parsedBytes += records[jobs[i].end].begin - records[jobs[i].begin].begin;
+    }
+
+    // The indices of the splices count the entities of each type in the previous read.
+    TypeCounts oldIndices;
+    std::size_t oldPosition{ 0 };
+    std::size_t job{ 0 };
+    for (std::size_t i{ 0 }; i < regions.size(); ++i) {
+        const Region& region{ regions[i] };
+
+        for (; oldPosition < region.oldBegin; ++oldPosition) {
+            ++oldIndices[previous->entityTypes[oldPosition]];
+        }
+
+        TypeCounts removedCounts;
+        for (; oldPosition < region.oldEnd; ++oldPosition) {
+            ++removedCounts[previous->entityTypes[oldPosition]];
+        }
+
+        Entities inserted;
+        for (; job < jobs.size() && jobs[job].region == i; ++job) {
+            moveAppend(inserted, jobDocuments[job].entities);
+        }
+
+        const auto splice{ [&](auto& splices, EntityType type, auto& entities) {
+            addSplice(splices, oldIndices[type], removedCounts[type], entities);
+        } };
+        splice(delta.arcs, EntityType::Arc, inserted.arcs);
+        splice(delta.circles, EntityType::Circle, inserted.circles);
+        splice(delta.ellipses, EntityType::Ellipse, inserted.ellipses);
+        splice(delta.lines, EntityType::Line, inserted.lines);
+        splice(delta.points, EntityType::Point, inserted.points);
+        splice(delta.lwPolylines, EntityType::LWPolyline, inserted.lwPolylines);
+        splice(delta.rays, EntityType::Ray, inserted.rays);
+
+        oldIndices += removedCounts;
+    }
+
+    m_state = std::move(state);
+
+    return delta;
+}
+
+void IncrementalReader::reset() { m_state.reset(); }
+
+}   // namespace odxf
@@ -4,6 +4,7 @@
 #include "opendxf/ireadstream.hpp"
 
 #include "opendxf/entities.hpp"
+#include "opendxf/tables.hpp"
 
 namespace odxf {
 
@@ -11,6 +12,8 @@ IReadStream::~IReadStream() = default;
 
 void IReadStream::header(const Header& /* header */) {}
 
+void IReadStream::lineType(const LineType& /* lineType */) {}
+
 void IReadStream::layer(const Layer& /* layer */) {}
 
 void IReadStream::arc(const Arc& /* arc */) {}
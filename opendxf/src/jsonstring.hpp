@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace odxf {
+
+// Appends the text as a JSON string, escaping quotes, backslashes and control characters.
+inline void appendJsonString(std::string& target, std::string_view text)
+{
+    target.push_back('"');
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            target.push_back('\\');
+            target.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            fmt::format_to(std::back_inserter(target), "\\u{:04x}", static_cast<int>(c));
+        } else {
+            target.push_back(c);
+        }
+    }
+    target.push_back('"');
+}
+
+}   // namespace odxf
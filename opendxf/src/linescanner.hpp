@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace odxf {
+
+// Splits an in-memory buffer into lines with the same semantics as std::getline,
+// i.e. a trailing line without a newline character is still reported.
+class LineScanner final
+{
+public:
+    explicit LineScanner(std::string_view content)
+        : m_content{ content }
+    {
+    }
+
+    bool next(std::string_view& line)
+    {
+        if (m_position >= m_content.size()) {
+            return false;
+        }
+
+        const char* first{ m_content.data() + m_position };
+        const std::size_t remaining{ m_content.size() - m_position };
+        const auto* newline{ static_cast<const char*>(std::memchr(first, '\n', remaining)) };
+
+        if (newline == nullptr) {
+            line = std::string_view{ first, remaining };
+            m_position = m_content.size();
+        } else {
+            const auto length{ static_cast<std::size_t>(newline - first) };
+            line = std::string_view{ first, length };
+            m_position += length + 1;
+        }
+
+        return true;
+    }
+
+    std::size_t position() const { return m_position; }
+
+    void seek(std::size_t position) { m_position = position; }
+
+private:
+    std::string_view m_content;
+    std::size_t m_position{ 0 };
+};
+
+// Strips the leading and trailing blanks used to pad group codes, e.g. "  0" or " 10".
+inline std::string_view trimGroupCode(std::string_view line)
+{
+    while (!line.empty() && line.front() == ' ') {
+        line.remove_prefix(1);
+    }
+
+    while (!line.empty() && (line.back() == ' ' || line.back() == '\r')) {
+        line.remove_suffix(1);
+    }
+
+    return line;
+}
+
+// Parses a group code or value, tolerating the leading blanks of padded files.
+template <typename T>
+std::optional<T> parseAs(std::string_view value)
+{
+    const char* first{ value.data() };
+    const char* last{ value.data() + value.size() };
+    while (first != last && *first == ' ') {
+        ++first;
+    }
+
+    T result;
+    const auto [_, errorCode]{ std::from_chars(first, last, result) };
+
+    return errorCode == std::errc() ? result : std::optional<T>{};
+}
+
+}   // namespace odxf
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/memoryusage.hpp"
+
+#include <cmath>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// Node of std::unordered_map: next pointer, value and the cached hash of string keys.
+constexpr std::size_t headerNodeSize{
+    sizeof(void*) + sizeof(odxf::HeaderEntry) + sizeof(std::size_t)
+};
+
+template <typename T>
+odxf::MemoryUsage vectorUsage(const std::vector<T>& items)
+{
+    return odxf::MemoryUsage{
+        .used = items.size() * sizeof(T),
+        .reserved = items.capacity() * sizeof(T),
+    };
+}
+
+odxf::MemoryUsage stringUsage(const std::string& text)
+{
+    static const std::size_t smallCapacity{ std::string{}.capacity() };
+    if (text.capacity() <= smallCapacity) {
+        return {};
+    }
+
+    return odxf::MemoryUsage{
+        .used = text.size() + 1,
+        .reserved = text.capacity() + 1,
+    };
+}
+
+odxf::MemoryUsage headerUsage(const odxf::Header& header)
+{
+    const std::size_t nodes{ header.entries.size() * headerNodeSize };
+    const auto neededBuckets{ static_cast<std::size_t>(std::ceil(
+        static_cast<float>(header.entries.size()) / header.entries.max_load_factor())) };
+
+    return odxf::MemoryUsage{
+        .used = nodes + neededBuckets * sizeof(void*),
+        .reserved = nodes + header.entries.bucket_count() * sizeof(void*),
+    };
+}
+
+template <typename T>
+void addLayerStrings(odxf::MemoryUsage& usage, const std::vector<T>& entities)
+{
+    for (const T& entity : entities) {
+        usage += stringUsage(entity.layer);
+    }
+}
+
+template <typename T>
+void shrinkEntities(std::vector<T>& entities)
+{
+    entities.shrink_to_fit();
+    for (T& entity : entities) {
+        entity.layer.shrink_to_fit();
+    }
+}
+
+}   // namespace
+
+namespace odxf {
+
+MemoryUsage DocumentMemoryUsage::total() const
+{
+    MemoryUsage result;
+    for (const MemoryUsage& usage :
+         { header, lineTypes, layers, arcs, circles, ellipses, lines, points, lwPolylines, rays,
+           vertices, strings }) {
+        result += usage;
+    }
+
+    return result;
+}
+
+DocumentMemoryUsage memoryUsage(const Document& document)
+{
+    DocumentMemoryUsage usage;
+
+    usage.header = headerUsage(document.header);
+    for (const auto& [key, value] : document.header.entries) {
+        usage.strings += stringUsage(key);
+        if (const std::string* text = std::get_if<std::string>(&value)) {
+            usage.strings += stringUsage(*text);
+        }
+    }
+
+    const Tables& tables{ document.tables };
+    usage.lineTypes = vectorUsage(tables.lineTypes);
+    for (const LineType& lineType : tables.lineTypes) {
+        usage.strings += stringUsage(lineType.name);
+        usage.strings += stringUsage(lineType.displayName);
+    }
+
+    usage.layers = vectorUsage(tables.layers);
+    for (const Layer& layer : tables.layers) {
+        usage.strings += stringUsage(layer.name);
+    }
+
+    const Entities& entities{ document.entities };
+    usage.arcs = vectorUsage(entities.arcs);
+    usage.circles = vectorUsage(entities.circles);
+    usage.ellipses = vectorUsage(entities.ellipses);
+    usage.lines = vectorUsage(entities.lines);
+    usage.points = vectorUsage(entities.points);
+    usage.lwPolylines = vectorUsage(entities.lwPolylines);
+    usage.rays = vectorUsage(entities.rays);
+
+    for (const LWPolyline& lwPolyline : entities.lwPolylines) {
+        usage.vertices += vectorUsage(lwPolyline.vertices);
+    }
+
+    addLayerStrings(usage.strings, entities.arcs);
+    addLayerStrings(usage.strings, entities.circles);
+    addLayerStrings(usage.strings, entities.ellipses);
+    addLayerStrings(usage.strings, entities.lines);
+    addLayerStrings(usage.strings, entities.points);
+    addLayerStrings(usage.strings, entities.lwPolylines);
+    addLayerStrings(usage.strings, entities.rays);
+
+    return usage;
+}
+
+void shrinkToFit(Document& document)
+{
+    // the keys are const inside the map, only the values can be compacted
+    for (auto& [key, value] : document.header.entries) {
+        if (std::string* text = std::get_if<std::string>(&value)) {
+            text->shrink_to_fit();
+        }
+    }
+    document.header.entries.rehash(0);
+
+    Tables& tables{ document.tables };
+    tables.lineTypes.shrink_to_fit();
+    for (LineType& lineType : tables.lineTypes) {
+        lineType.name.shrink_to_fit();
+        lineType.displayName.shrink_to_fit();
+    }
+
+    tables.layers.shrink_to_fit();
+    for (Layer& layer : tables.layers) {
+        layer.name.shrink_to_fit();
+    }
+
+    Entities& entities{ document.entities };
+    shrinkEntities(entities.arcs);
+    shrinkEntities(entities.circles);
+    shrinkEntities(entities.ellipses);
+    shrinkEntities(entities.lines);
+    shrinkEntities(entities.points);
+    shrinkEntities(entities.lwPolylines);
+    shrinkEntities(entities.rays);
+
+    for (LWPolyline& lwPolyline : entities.lwPolylines) {
+        lwPolyline.vertices.shrink_to_fit();
+    }
+}
+
+}   // namespace odxf
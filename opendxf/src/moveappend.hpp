@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/entities.hpp"
+
+#include <iterator>
+#include <vector>
+
+namespace odxf {
+
+// Moves the elements of source to the end of target, leaving moved-from elements.
+template <typename T>
+void moveAppend(std::vector<T>& target, std::vector<T>& source)
+{
+    target.insert(
+        target.end(),
+        std::make_move_iterator(source.begin()),
+        std::make_move_iterator(source.end()));
+}
+
+inline void moveAppend(Entities& target, Entities& source)
+{
+    moveAppend(target.arcs, source.arcs);
+    moveAppend(target.circles, source.circles);
+    moveAppend(target.ellipses, source.ellipses);
+    moveAppend(target.lines, source.lines);
+    moveAppend(target.points, source.points);
+    moveAppend(target.lwPolylines, source.lwPolylines);
+    moveAppend(target.rays, source.rays);
+}
+
+}   // namespace odxf
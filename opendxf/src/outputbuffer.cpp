@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "outputbuffer.hpp"
+
+#include "asyncwriter.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+int decimalsForTolerance(double tolerance)
+{
+    if (!(tolerance > 0.0)) {
+        return 17;
+    }
+
+    // rounding to d decimals introduces an error of at most 0.5 * 10^-d
+    return static_cast<int>(std::ceil(-std::log10(2.0 * tolerance)));
+}
+
+}   // namespace
+
+namespace odxf {
+
+OutputBuffer::OutputBuffer(
+    IOutputSink& sink, const NumberFormat& numberFormat, std::size_t capacity, bool asyncOutput)
+    : OutputBuffer{ numberFormat, capacity }
+{
+    m_sink = &sink;
+
+    if (asyncOutput) {
+        m_backData = std::make_unique_for_overwrite<char[]>(m_capacity);
+        m_asyncWriter = std::make_unique<AsyncWriter>(sink);
+    }
+}
+
+OutputBuffer::OutputBuffer(const NumberFormat& numberFormat, std::size_t capacity)
+    : m_numberFormat{ numberFormat.type }
+    , m_decimals{ std::clamp(
+          numberFormat.type == NumberFormat::Type::Tolerance
+              ? decimalsForTolerance(numberFormat.tolerance)
+              : numberFormat.decimals,
+          0,
+          maxDecimals) }
+    , m_data{ std::make_unique_for_overwrite<char[]>(std::max(capacity, maxNumberLength)) }
+    , m_capacity{ std::max(capacity, maxNumberLength) }
+{
+}
+
+OutputBuffer::~OutputBuffer() { sync(); }
+
+void OutputBuffer::append(std::string_view text)
+{
+    if (m_asyncWriter) {
+        // copy large text in pieces, writing it directly would block until it is written
+        while (text.size() > m_capacity - m_size) {
+            const std::size_t size{ m_capacity - m_size };
+            std::memcpy(m_data.get() + m_size, text.data(), size);
+            m_size += size;
+            text.remove_prefix(size);
+
+            flush();
+        }
+    } else if (m_sink != nullptr && text.size() > m_capacity - m_size) {
+        flush();
+
+        if (text.size() > m_capacity) {
+            write(text);
+
+            return;
+        }
+    }
+
+    ensureSpace(text.size());
+
+    std::memcpy(m_data.get() + m_size, text.data(), text.size());
+    m_size += text.size();
+}
+
+void OutputBuffer::append(double value)
+{
+    ensureSpace(maxNumberLength);
+
+    char* const first{ m_data.get() + m_size };
+    char* const end{ first + maxNumberLength };
+
+    switch (m_numberFormat) {
+    case NumberFormat::Type::Shortest: {
+        m_size += static_cast<std::size_t>(std::to_chars(first, end, value).ptr - first);
+
+        break;
+    }
+
+    case NumberFormat::Type::Fixed: {
+        const auto [last, _]{
+            std::to_chars(first, end, value, std::chars_format::fixed, m_decimals)
+        };
+        m_size += static_cast<std::size_t>(last - first);
+
+        break;
+    }
+
+    case NumberFormat::Type::Tolerance: {
+        const auto [last, _]{
+            std::to_chars(first, end, value, std::chars_format::fixed, m_decimals)
+        };
+
+        // drop the trailing zeros which do not contribute to the precision
+        std::string_view digits{ first, static_cast<std::size_t>(last - first) };
+        if (digits.find('.') != std::string_view::npos) {
+            digits = digits.substr(0, digits.find_last_not_of('0') + 1);
+            if (digits.back() == '.') {
+                digits.remove_suffix(1);
+            }
+        }
+
+        if (digits == "-0") {
+            *first = '0';
+            digits = std::string_view{ first, 1 };
+        }
+
+        m_size += digits.size();
+
+        break;
+    }
+    }
+}
+
+void OutputBuffer::flush()
+{
+    if (m_sink == nullptr || m_size == 0) {
+        return;
+    }
+
+    if (m_asyncWriter) {
+        recordError(m_asyncWriter->write(std::string_view{ m_data.get(), m_size }));
+        std::swap(m_data, m_backData);
+    } else {
+        write(std::string_view{ m_data.get(), m_size });
+    }
+
+    m_size = 0;
+}
+
+void OutputBuffer::sync()
+{
+    flush();
+
+    if (m_asyncWriter) {
+        recordError(m_asyncWriter->wait());
+    }
+}
+
+const std::optional<Error>& OutputBuffer::error() const { return m_error; }
+
+std::string_view OutputBuffer::content() const { return std::string_view{ m_data.get(), m_size }; }
+
+void OutputBuffer::clear() { m_size = 0; }
+
+void OutputBuffer::write(std::string_view block)
+{
+    if (m_error) {
+        return;
+    }
+
+    OPENDXF_TRACE_SCOPE("writeBlock");
+    recordError(m_sink->write(block));
+}
+
+void OutputBuffer::recordError(tl::expected<void, Error> result)
+{
+    if (!result && !m_error) {
+        m_error = std::move(result.error());
+    }
+}
+
+void OutputBuffer::ensureSpace(std::size_t size)
+{
+    if (size <= m_capacity - m_size) {
+        return;
+    }
+
+    if (m_sink != nullptr) {
+        flush();
+
+        return;
+    }
+
+    const std::size_t capacity{ std::max(2 * m_capacity, m_size + size) };
+    auto data{ std::make_unique_for_overwrite<char[]>(capacity) };
+    std::memcpy(data.get(), m_data.get(), m_size);
+
+    m_data = std::move(data);
+    m_capacity = capacity;
+}
+
+}   // namespace odxf
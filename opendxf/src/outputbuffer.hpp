@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/error.hpp"
+#include "opendxf/outputsink.hpp"
+#include "opendxf/write.hpp"
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace odxf {
+
+class AsyncWriter;
+
+// Contiguous output buffer which formats numbers in place with std::to_chars and
+// hands the content to the sink in large blocks. Without a sink the buffer grows
+// instead and its content is retrieved with content().
+//
+// With asynchronous output a second buffer is filled while the first one is written
+// to the sink by a background thread.
+class OutputBuffer final
+{
+public:
+    static constexpr std::size_t defaultCapacity{ std::size_t{ 1 } << 20 };
+
+    explicit OutputBuffer(
+        IOutputSink& sink,
+        const NumberFormat& numberFormat = {},
+        std::size_t capacity = defaultCapacity,
+        bool asyncOutput = false);
+    explicit OutputBuffer(const NumberFormat& numberFormat, std::size_t capacity = defaultCapacity);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer(OutputBuffer&&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(OutputBuffer&&) = delete;
+
+    void append(std::string_view text);
+
+    template <std::integral T>
+    void append(T value)
+    {
+        ensureSpace(maxNumberLength);
+
+        char* const first{ m_data.get() + m_size };
+        const auto [last, _]{ std::to_chars(first, first + maxNumberLength, value) };
+        m_size += static_cast<std::size_t>(last - first);
+    }
+
+    // formats according to the NumberFormat of the buffer
+    void append(double value);
+
+    // Passes the content to the sink. After the sink failed, the content is discarded.
+    void flush();
+
+    // Flushes and waits until all content was written by the sink.
+    void sync();
+
+    // The first error reported by the sink. With asynchronous output errors are only
+    // known after the following flush() or sync().
+    const std::optional<Error>& error() const;
+
+    std::string_view content() const;
+    void clear();
+
+private:
+    // large enough for any double in fixed notation with up to maxDecimals decimals
+    static constexpr std::size_t maxNumberLength{ 512 };
+    static constexpr int maxDecimals{ 100 };
+
+    void ensureSpace(std::size_t size);
+    void write(std::string_view block);
+    void recordError(tl::expected<void, Error> result);
+
+    IOutputSink* m_sink{ nullptr };
+    std::optional<Error> m_error;
+    NumberFormat::Type m_numberFormat{ NumberFormat::Type::Shortest };
+    int m_decimals{ 0 };
+    std::unique_ptr<char[]> m_data;
+    std::size_t m_capacity{ 0 };
+    std::size_t m_size{ 0 };
+
+    // the buffer being written by m_asyncWriter
+    std::unique_ptr<char[]> m_backData;
+    std::unique_ptr<AsyncWriter> m_asyncWriter;
+};
+
+}   // namespace odxf
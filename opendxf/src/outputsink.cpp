@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/outputsink.hpp"
+
+#include "pathstring.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if __has_include(<unistd.h>)
+#    include <fcntl.h>
+#    include <unistd.h>
+#    define OPENDXF_HAS_UNISTD 1
+#endif
+
+namespace {
+
+tl::expected<void, odxf::Error> makeWriteError(std::string what)
+{
+    return tl::make_unexpected(odxf::Error{
+        .type = odxf::Error::Type::FileWriteError,
+        .what = std::move(what),
+    });
+}
+
+#ifdef OPENDXF_HAS_UNISTD
+// Writes the whole block, returns 0 or the errno of the failed call.
+int writeAll(int fileDescriptor, std::string_view block)
+{
+    while (!block.empty()) {
+        const ssize_t written{ ::write(fileDescriptor, block.data(), block.size()) };
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return errno;
+        }
+
+        block.remove_prefix(static_cast<std::size_t>(written));
+    }
+
+    return 0;
+}
+
+// Returns 0 or the error number, file systems without support are no error.
+int preallocate(int fileDescriptor, std::uintmax_t size)
+{
+#    ifdef __linux__
+    const int result{
+        ::fallocate(fileDescriptor, 0, 0, static_cast<off_t>(size)) == 0 ? 0 : errno
+    };
+#    else
+    const int result{ ::posix_fallocate(fileDescriptor, 0, static_cast<off_t>(size)) };
+#    endif
+
+    return result == EOPNOTSUPP || result == EINVAL ? 0 : result;
+}
+#endif
+
+}   // namespace
+
+namespace odxf {
+
+IOutputSink::~IOutputSink() = default;
+
+tl::expected<void, Error> IOutputSink::reserve(std::uintmax_t) { return {}; }
+
+tl::expected<void, Error> IOutputSink::close() { return {}; }
+
+tl::expected<void, Error> MemorySink::write(std::string_view block)
+{
+    m_content.append(block);
+
+    return {};
+}
+
+tl::expected<void, Error> MemorySink::reserve(std::uintmax_t size)
+{
+    m_content.reserve(
+        static_cast<std::size_t>(std::min<std::uintmax_t>(size, m_content.max_size())));
+
+    return {};
+}
+
+OStreamSink::OStreamSink(std::ostream& stream)
+    : m_stream{ stream }
+{
+}
+
+tl::expected<void, Error> OStreamSink::write(std::string_view block)
+{
+    if (!m_stream.write(block.data(), static_cast<std::streamsize>(block.size()))) {
+        return makeWriteError("unable to write to output stream");
+    }
+
+    return {};
+}
+
+tl::expected<void, Error> OStreamSink::close()
+{
+    if (!m_stream.flush()) {
+        return makeWriteError("unable to flush output stream");
+    }
+
+    return {};
+}
+
+CallbackSink::CallbackSink(Callback callback)
+    : m_callback{ std::move(callback) }
+{
+}
+
+tl::expected<void, Error> CallbackSink::write(std::string_view block)
+{
+    if (!m_callback(block)) {
+        return makeWriteError("writing aborted by callback");
+    }
+
+    return {};
+}
+
+FileSink::FileSink(const std::filesystem::path& filePath)
+    : m_filePath{ filePath }
+{
+#ifdef OPENDXF_HAS_UNISTD
+    m_fileDescriptor = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    m_isOpen = m_fileDescriptor >= 0;
+#else
+    // the writers already pass large blocks, bypass the stream's own buffering
+    m_stream.rdbuf()->pubsetbuf(nullptr, 0);
+    m_stream.open(filePath, std::ios::binary);
+    m_isOpen = m_stream.is_open();
+#endif
+}
+
+FileSink::~FileSink()
+{
+#ifdef OPENDXF_HAS_UNISTD
+    if (m_fileDescriptor >= 0) {
+        // without close(), e.g. after a failed write, the preallocated space is released
+        // here, nothing can be reported from a destructor
+        if (m_reserved > m_written) {
+            [[maybe_unused]] const int result{
+                ::ftruncate(m_fileDescriptor, static_cast<off_t>(m_written))
+            };
+        }
+        ::close(m_fileDescriptor);
+    }
+#endif
+}
+
+bool FileSink::isOpen() const { return m_isOpen; }
+
+tl::expected<void, Error> FileSink::openError() const
+{
+    if (isOpen()) {
+        return {};
+    }
+
+    return tl::make_unexpected(Error{
+        .type = Error::Type::FileOpenError,
+        .what = fmt::format("unable to open file {}", pathToString(m_filePath)),
+    });
+}
+
+tl::expected<void, Error> FileSink::write(std::string_view block)
+{
+    if (!isOpen()) {
+        return openError();
+    }
+
+#ifdef OPENDXF_HAS_UNISTD
+    if (const int errorNumber = writeAll(m_fileDescriptor, block); errorNumber != 0) {
+        return makeWriteError(fmt::format(
+            "unable to write file {}: {}", pathToString(m_filePath), std::strerror(errorNumber)));
+    }
+#else
+    if (!m_stream.write(block.data(), static_cast<std::streamsize>(block.size()))) {
+        return makeWriteError(fmt::format("unable to write file {}", pathToString(m_filePath)));
+    }
+#endif
+
+    m_written += block.size();
+
+    return {};
+}
+
+tl::expected<void, Error> FileSink::reserve(std::uintmax_t size)
+{
+    if (!isOpen()) {
+        return openError();
+    }
+
+#ifdef OPENDXF_HAS_UNISTD
+    if (size <= m_written) {
+        return {};
+    }
+
+    if (const int errorNumber = preallocate(m_fileDescriptor, size); errorNumber != 0) {
+        return makeWriteError(fmt::format(
+            "unable to preallocate {} bytes for file {}: {}",
+            size,
+            pathToString(m_filePath),
+            std::strerror(errorNumber)));
+    }
+
+    m_reserved = std::max(m_reserved, size);
+#endif
+
+    return {};
+}
+
+tl::expected<void, Error> FileSink::close()
+{
+    if (!isOpen()) {
+        return openError();
+    }
+
+#ifdef OPENDXF_HAS_UNISTD
+    if (m_fileDescriptor < 0) {
+        return {};
+    }
+
+    // release the preallocated space which was not written
+    const bool truncated{ m_reserved <= m_written
+                          || ::ftruncate(m_fileDescriptor, static_cast<off_t>(m_written)) == 0 };
+    const int closeResult{ ::close(m_fileDescriptor) };
+    m_fileDescriptor = -1;
+
+    if (!truncated || closeResult != 0) {
+        return makeWriteError(fmt::format("unable to close file {}", pathToString(m_filePath)));
+    }
+#else
+    m_stream.close();
+    if (m_stream.fail()) {
+        return makeWriteError(fmt::format("unable to close file {}", pathToString(m_filePath)));
+    }
+#endif
+
+    return {};
+}
+
+FileDescriptorSink::FileDescriptorSink(int fileDescriptor)
+    : m_fileDescriptor{ fileDescriptor }
+{
+}
+
+tl::expected<void, Error> FileDescriptorSink::write(std::string_view block)
+{
+#ifdef OPENDXF_HAS_UNISTD
+    if (const int errorNumber = writeAll(m_fileDescriptor, block); errorNumber != 0) {
+        return makeWriteError(fmt::format(
+            "unable to write file descriptor {}: {}",
+            m_fileDescriptor,
+            std::strerror(errorNumber)));
+    }
+
+    return {};
+#else
+    return makeWriteError("file descriptors are not supported on this platform");
+#endif
+}
+
+}   // namespace odxf
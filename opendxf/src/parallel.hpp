@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace odxf {
+
+// Maps a requested thread count to an actual one, 0 meaning "one per hardware thread".
+inline unsigned int resolveThreadCount(unsigned int requested)
+{
+    if (requested != 0) {
+        return requested;
+    }
+
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Invokes function(index) for every index in [0, count). The indices are handed out
+// dynamically to at most threadCount threads, the calling thread being one of them.
+template <typename Function>
+void parallelFor(std::size_t count, unsigned int threadCount, Function&& function)
+{
+    const std::size_t workerCount{ std::min<std::size_t>(resolveThreadCount(threadCount), count) };
+
+    if (workerCount <= 1) {
+        for (std::size_t index{ 0 }; index < count; ++index) {
+            function(index);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> nextIndex{ 0 };
+    const auto work{ [&] {
+        for (std::size_t index{ nextIndex++ }; index < count; index = nextIndex++) {
+            function(index);
+        }
+    } };
+
+    std::vector<std::jthread> threads;
+    threads.reserve(workerCount - 1);
+    for (std::size_t i{ 1 }; i < workerCount; ++i) {
+        threads.emplace_back(work);
+    }
+
+    work();
+}
+
+// Splits [0, count) into chunkCount contiguous ranges of nearly equal size.
+struct ChunkRange final
+{
+    std::size_t begin{ 0 };
+    std::size_t end{ 0 };
+};
+
+inline ChunkRange chunkRange(std::size_t count, std::size_t chunkCount, std::size_t chunkIndex)
+{
+    return ChunkRange{
+        .begin = count * chunkIndex / chunkCount,
+        .end = count * (chunkIndex + 1) / chunkCount,
+    };
+}
+
+// Sorts the range by sorting chunkCount chunks in parallel and merging neighbouring chunks
+// pairwise, the merges of each round in parallel as well.
+template <typename Iterator, typename Compare>
+void parallelSort(Iterator first, Iterator last, Compare compare, unsigned int threadCount)
+{
+    const auto count{ static_cast<std::size_t>(last - first) };
+    const std::size_t chunkCount{ std::min<std::size_t>(resolveThreadCount(threadCount), count) };
+
+    if (chunkCount <= 1) {
+        std::sort(first, last, compare);
+        return;
+    }
+
+    parallelFor(chunkCount, threadCount, [&](std::size_t index) {
+        const ChunkRange range{ chunkRange(count, chunkCount, index) };
+        std::sort(first + range.begin, first + range.end, compare);
+    });
+
+    for (std::size_t width{ 1 }; width < chunkCount; width *= 2) {
+        const std::size_t mergeCount{ (chunkCount + 2 * width - 1) / (2 * width) };
+        parallelFor(mergeCount, threadCount, [&](std::size_t index) {
+            const std::size_t begin{ index * 2 * width };
+            const std::size_t middle{ std::min(begin + width, chunkCount) };
+            const std::size_t end{ std::min(begin + 2 * width, chunkCount) };
+            if (middle < end) {
+                std::inplace_merge(
+                    first + chunkRange(count, chunkCount, begin).begin,
+                    first + chunkRange(count, chunkCount, middle).begin,
+                    first + chunkRange(count, chunkCount, end).begin,
+                    compare);
+            }
+        });
+    }
+}
+
+}   // namespace odxf
@@ -0,0 +1,430 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/parsecache.hpp"
+
+#include "opendxf/ireadstream.hpp"
+#include "opendxf/snapshot.hpp"
+#include "filebuffer.hpp"
+#include "hash.hpp"
+#include "pathstring.hpp"
+#include "readcontent.hpp"
+#include "tracescope.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#if __has_include(<sys/stat.h>)
+#    include <sys/stat.h>
+#    define OPENDXF_HAS_STAT 1
+#endif
+
+namespace {
+
+constexpr std::string_view entryExtension{ ".odxfsnap" };
+
+// temporary files of stores which were interrupted, younger ones may still be written
+constexpr std::chrono::hours staleTemporaryAge{ 1 };
+
+std::optional<std::string> fileMetadataKey(const std::filesystem::path& filePath)
+{
+    std::error_code error;
+    const std::filesystem::path canonicalPath{ std::filesystem::canonical(filePath, error) };
+    if (error) {
+        return std::nullopt;
+    }
+
+    const std::uintmax_t size{ std::filesystem::file_size(canonicalPath, error) };
+    if (error) {
+        return std::nullopt;
+    }
+
+    const std::filesystem::file_time_type modified{
+        std::filesystem::last_write_time(canonicalPath, error)
+    };
+    if (error) {
+        return std::nullopt;
+    }
+
+    std::uint64_t inode{ 0 };
+#ifdef OPENDXF_HAS_STAT
+    struct stat status{};
+    if (::stat(canonicalPath.c_str(), &status) == 0) {
+        inode = static_cast<std::uint64_t>(status.st_ino);
+    }
+#endif
+
+    return fmt::format(
+        "{}\n{}\n{}\n{}",
+        canonicalPath.string(),
+        size,
+        modified.time_since_epoch().count(),
+        inode);
+}
+
+void replay(odxf::IReadStream& stream, const odxf::Document& document)
+{
+    stream.header(document.header);
+    for (const odxf::LineType& lineType : document.tables.lineTypes) {
+        stream.lineType(lineType);
+    }
+    for (const odxf::Layer& layer : document.tables.layers) {
+        stream.layer(layer);
+    }
+
+    const odxf::Entities& entities{ document.entities };
+    for (const odxf::Arc& arc : entities.arcs) {
+        stream.arc(arc);
+    }
+    for (const odxf::Circle& circle : entities.circles) {
+        stream.circle(circle);
+    }
+    for (const odxf::Line& line : entities.lines) {
+        stream.line(line);
+    }
+    for (const odxf::LWPolyline& lwPolyline : entities.lwPolylines) {
+        stream.lwPolyline(lwPolyline);
+    }
+}
+
+void replay(odxf::IReadStream& stream, const odxf::Snapshot& snapshot)
+{
+    stream.header(snapshot.header());
+
+    const odxf::Tables tables{ snapshot.tables() };
+    for (const odxf::LineType& lineType : tables.lineTypes) {
+        stream.lineType(lineType);
+    }
+    for (const odxf::Layer& layer : tables.layers) {
+        stream.layer(layer);
+    }
+
+    const auto replayView{ [](const auto& view, const auto& callback) {
+        for (std::size_t i{ 0 }; i < view.size(); ++i) {
+            callback(view[i]);
+        }
+    } };
+    replayView(snapshot.arcs(), [&stream](const odxf::Arc& arc) { stream.arc(arc); });
+    replayView(snapshot.circles(), [&stream](const odxf::Circle& circle) {
+        stream.circle(circle);
+    });
+    replayView(snapshot.lines(), [&stream](const odxf::Line& line) { stream.line(line); });
+    replayView(snapshot.lwPolylines(), [&stream](const odxf::LWPolyline& lwPolyline) {
+        stream.lwPolyline(lwPolyline);
+    });
+}
+
+bool isEntryFile(const std::filesystem::directory_entry& entry)
+{
+    std::error_code error;
+
+    return entry.is_regular_file(error) && entry.path().extension() == entryExtension;
+}
+
+// An entry being stored is named <entry>.<random>.tmp until it is complete.
+bool isStaleTemporaryFile(const std::filesystem::directory_entry& entry)
+{
+    std::error_code error;
+    if (!entry.is_regular_file(error) || entry.path().extension() != ".tmp"
+        || entry.path().stem().stem().extension() != entryExtension) {
+        return false;
+    }
+
+    const std::filesystem::file_time_type modified{ entry.last_write_time(error) };
+
+    return !error && std::filesystem::file_time_type::clock::now() - modified > staleTemporaryAge;
+}
+
+}   // namespace
+
+namespace odxf {
+
+struct ParseCache::Entry final
+{
+    std::filesystem::path path;
+    // the loaded file, not loaded yet with Key::FileMetadata
+    std::optional<std::string> content;
+
+    // Loads the content of the file unless it was loaded by the lookup.
+    tl::expected<void, Error> load(const std::filesystem::path& filePath)
+    {
+        if (content) {
+            return {};
+        }
+
+        tl::expected<std::string, Error> fileContent{ readFileContent(filePath) };
+        if (!fileContent) {
+            return tl::make_unexpected(fileContent.error());
+        }
+        content = std::move(*fileContent);
+
+        return {};
+    }
+};
+
+ParseCache::ParseCache(ParseCacheOptions options)
+    : m_options{ std::move(options) }
+{
+}
+
+tl::expected<ParseCache::Entry, Error>
+ParseCache::lookup(const std::filesystem::path& filePath) const
+{
+    Entry entry;
+    std::string fileName;
+
+    if (m_options.key == ParseCacheOptions::Key::FileMetadata) {
+        const std::optional<std::string> metadata{ fileMetadataKey(filePath) };
+        if (!metadata) {
+            return tl::make_unexpected(Error{
+                .type = Error::Type::FileOpenError,
+                .what = fmt::format("unable to open file {}", pathToString(filePath)),
+            });
+        }
+
+        fileName = fmt::format("m{:016x}", hash64(*metadata));
+    } else {
+        tl::expected<std::string, Error> content{ readFileContent(filePath) };
+        if (!content) {
+            return tl::make_unexpected(content.error());
+        }
+
+        // the size makes a hash collision even less likely
+        fileName = fmt::format("c{:016x}-{:x}", hash64(*content), content->size());
+        entry.content = std::move(*content);
+    }
+
+    entry.path = m_options.directory / (fileName + std::string{ entryExtension });
+
+    return entry;
+}
+
+tl::expected<Document, Error>
+ParseCache::readDocument(const std::filesystem::path& filePath, const ReadOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("cachedReadDocument");
+
+    ReadStats* const stats{ options.stats };
+    const auto begin{ std::chrono::steady_clock::now() };
+    if (stats != nullptr) {
+        *stats = ReadStats{};
+    }
+    if (options.sidecarError != nullptr) {
+        options.sidecarError->reset();
+    }
+
+    tl::expected<Entry, Error> entry{ lookup(filePath) };
+    if (!entry) {
+        return tl::make_unexpected(entry.error());
+    }
+
+    if (const tl::expected<Snapshot, Error> snapshot{ Snapshot::open(entry->path) }) {
+        ++m_hits;
+        std::error_code error;
+        std::filesystem::last_write_time(
+            entry->path, std::filesystem::file_time_type::clock::now(), error);
+
+        Document document{ snapshot->toDocument() };
+        if (stats != nullptr) {
+            stats->loadDuration = std::chrono::steady_clock::now() - begin;
+            stats->totalDuration = stats->loadDuration;
+        }
+
+        // the sidecar index refers to the byte ranges of the file, so it needs its content
+        if (!options.sidecarPath.empty()) {
+            if (tl::expected<void, Error> loaded = entry->load(filePath); loaded) {
+                writeRequestedSidecar(*entry->content, document, options);
+            } else {
+                reportSidecarError(std::move(loaded.error()), options);
+            }
+        }
+
+        return document;
+    }
+
+    ++m_misses;
+
+    if (tl::expected<void, Error> loaded = entry->load(filePath); !loaded) {
+        return tl::make_unexpected(loaded.error());
+    }
+
+    if (stats != nullptr) {
+        stats->loadDuration = std::chrono::steady_clock::now() - begin;
+    }
+
+    tl::expected<Document, Error> document{ readDocumentContent(*entry->content, options, begin) };
+    if (document) {
+        store(*entry, *document);
+    }
+
+    return document;
+}
+
+tl::expected<void, Error>
+ParseCache::read(IReadStream& stream, const std::filesystem::path& filePath)
+{
+    tl::expected<Entry, Error> entry{ lookup(filePath) };
+    if (!entry) {
+        return tl::make_unexpected(entry.error());
+    }
+
+    if (const tl::expected<Snapshot, Error> snapshot{ Snapshot::open(entry->path) }) {
+        ++m_hits;
+        std::error_code error;
+        std::filesystem::last_write_time(
+            entry->path, std::filesystem::file_time_type::clock::now(), error);
+
+        replay(stream, *snapshot);
+
+        return {};
+    }
+
+    // the Document is needed to store the entry
+    ++m_misses;
+
+    if (tl::expected<void, Error> loaded = entry->load(filePath); !loaded) {
+        return loaded;
+    }
+
+    const tl::expected<Document, Error> document{
+        readDocumentContent(*entry->content, ReadOptions{}, std::chrono::steady_clock::now())
+    };
+    if (!document) {
+        return tl::make_unexpected(document.error());
+    }
+
+    store(*entry, *document);
+    replay(stream, *document);
+
+    return {};
+}
+
+void ParseCache::store(const Entry& entry, const Document& document)
+{
+    OPENDXF_TRACE_SCOPE("storeCacheEntry");
+
+    std::error_code error;
+    std::filesystem::create_directories(m_options.directory, error);
+    if (error) {
+        ++m_storeFailures;
+        return;
+    }
+
+    // renamed when complete, so that concurrent readers never open a partial entry
+    std::filesystem::path temporaryPath{ entry.path };
+    temporaryPath += fmt::format(".{:08x}.tmp", std::random_device{}());
+
+    if (!writeSnapshot(document, temporaryPath)) {
+        std::filesystem::remove(temporaryPath, error);
+        ++m_storeFailures;
+        return;
+    }
+
+    std::filesystem::rename(temporaryPath, entry.path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        ++m_storeFailures;
+        return;
+    }
+
+    ++m_stores;
+    evict(entry.path);
+}
+
+void ParseCache::evict(const std::filesystem::path& storedPath)
+{
+    struct CachedFile final
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUsed;
+        std::uintmax_t size;
+    };
+
+    std::vector<CachedFile> files;
+    std::uintmax_t totalSize{ 0 };
+
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator{ m_options.directory, error }) {
+        if (isStaleTemporaryFile(entry)) {
+            std::filesystem::remove(entry.path(), error);
+            continue;
+        }
+
+        if (!isEntryFile(entry)) {
+            continue;
+        }
+
+        std::error_code sizeError;
+        const std::uintmax_t size{ entry.file_size(sizeError) };
+
+        // never the entry just stored, timestamps may be too coarse to order it last
+        if (entry.path() == storedPath) {
+            totalSize += sizeError ? 0 : size;
+            continue;
+        }
+
+        std::error_code timeError;
+        CachedFile file{
+            .path = entry.path(),
+            .lastUsed = entry.last_write_time(timeError),
+            .size = size,
+        };
+        if (!sizeError && !timeError) {
+            totalSize += file.size;
+            files.push_back(std::move(file));
+        }
+    }
+
+    if (totalSize <= m_options.maxSize) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const CachedFile& lhs, const CachedFile& rhs) {
+        return lhs.lastUsed < rhs.lastUsed;
+    });
+
+    for (const CachedFile& file : files) {
+        if (totalSize <= m_options.maxSize) {
+            break;
+        }
+
+        // another process may have evicted it already
+        if (std::filesystem::remove(file.path, error)) {
+            ++m_evictions;
+        }
+        totalSize -= file.size;
+    }
+}
+
+ParseCacheStats ParseCache::stats() const
+{
+    return ParseCacheStats{
+        .hits = m_hits.load(),
+        .misses = m_misses.load(),
+        .stores = m_stores.load(),
+        .storeFailures = m_storeFailures.load(),
+        .evictions = m_evictions.load(),
+    };
+}
+
+void ParseCache::clear()
+{
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator{ m_options.directory, error }) {
+        if (isEntryFile(entry) || isStaleTemporaryFile(entry)) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+}
+
+}   // namespace odxf
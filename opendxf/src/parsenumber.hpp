@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+namespace odxf {
+
+// The number if the whole text is one, for command line arguments.
+template <typename T>
+std::optional<T> parseNumber(std::string_view text)
+{
+    T value;
+    const auto [last, errorCode]{ std::from_chars(text.data(), text.data() + text.size(), value) };
+    if (errorCode != std::errc() || last != text.data() + text.size()) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+}   // namespace odxf
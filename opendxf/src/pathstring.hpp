@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace odxf {
+
+// The path encoded as UTF-8, for error messages.
+inline std::string pathToString(const std::filesystem::path& filePath)
+{
+    return reinterpret_cast<const char*>(filePath.u8string().c_str());
+}
+
+}   // namespace odxf
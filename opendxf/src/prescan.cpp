@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/prescan.hpp"
+
+#include "filebuffer.hpp"
+#include "linescanner.hpp"
+#include "prescanner.hpp"
+
+namespace odxf {
+
+DocumentCounts prescanContent(std::string_view content)
+{
+    enum class Section
+    {
+        None,
+        Header,
+        Tables,
+        Entities,
+        Other
+    };
+
+    DocumentCounts counts;
+    EntityCounts& entityCounts{ counts.entities };
+
+    LineScanner scanner{ content };
+    std::string_view groupCode;
+    std::string_view value;
+
+    Section section{ Section::None };
+    bool isSectionName{ false };
+    bool isLWPolyline{ false };
+
+    while (scanner.next(groupCode) && scanner.next(value)) {
+        groupCode = trimGroupCode(groupCode);
+
+        if (groupCode == "0") {
+            isLWPolyline = false;
+
+            if (value == "SECTION") {
+                isSectionName = true;
+                continue;
+            }
+
+            if (value == "ENDSEC") {
+                section = Section::None;
+                continue;
+            }
+
+            switch (section) {
+            case Section::Tables: {
+                if (value == "LAYER") {
+                    ++counts.layers;
+                } else if (value == "LTYPE") {
+                    ++counts.lineTypes;
+                }
+
+                break;
+            }
+
+            case Section::Entities: {
+                if (value == "LINE") {
+                    ++entityCounts.lines;
+                } else if (value == "LWPOLYLINE") {
+                    ++entityCounts.lwPolylines;
+                    isLWPolyline = true;
+                } else if (value == "CIRCLE") {
+                    ++entityCounts.circles;
+                } else if (value == "ARC") {
+                    ++entityCounts.arcs;
+                } else if (value == "POINT") {
+                    ++entityCounts.points;
+                } else if (value == "ELLIPSE") {
+                    ++entityCounts.ellipses;
+                } else if (value == "RAY") {
+                    ++entityCounts.rays;
+                } else {
+                    ++entityCounts.other;
+                }
+
+                break;
+            }
+
+            default: break;
+            }
+        } else if (groupCode == "2" && isSectionName) {
+            isSectionName = false;
+
+            if (value == "HEADER") {
+                section = Section::Header;
+            } else if (value == "TABLES") {
+                section = Section::Tables;
+            } else if (value == "ENTITIES") {
+                section = Section::Entities;
+            } else {
+                section = Section::Other;
+            }
+        } else if (groupCode == "9" && section == Section::Header) {
+            ++counts.headerEntries;
+        } else if (groupCode == "10" && isLWPolyline) {
+            ++entityCounts.lwPolylineVertices;
+        }
+    }
+
+    return counts;
+}
+
+std::optional<EntitySplit> splitEntities(
+    std::string_view content, std::size_t offset, int lineOffset, std::size_t chunkCount)
+{
+    struct Boundary
+    {
+        std::size_t begin{ 0 };
+        std::size_t end{ 0 };
+        int lineOffset{ 0 };
+    };
+
+    std::vector<Boundary> boundaries;
+    boundaries.reserve(chunkCount + 1);
+
+    const std::size_t sectionSize{ content.size() - offset };
+    std::size_t nextThreshold{ offset };
+
+    LineScanner scanner{ content.substr(offset) };
+    std::string_view groupCode;
+    std::string_view value;
+    int currentLine{ lineOffset };
+
+    while (true) {
+        const std::size_t begin{ offset + scanner.position() };
+        if (!scanner.next(groupCode) || !scanner.next(value)) {
+            return {};
+        }
+
+        currentLine += 2;
+
+        if (trimGroupCode(groupCode) != "0") {
+            if (boundaries.empty()) {
+                return {};
+            }
+
+            continue;
+        }
+
+        const Boundary boundary{
+            .begin = begin,
+            .end = offset + scanner.position(),
+            .lineOffset = currentLine - 2,
+        };
+
+        if (value == "ENDSEC") {
+            boundaries.push_back(boundary);
+            break;
+        }
+
+        if (begin >= nextThreshold) {
+            boundaries.push_back(boundary);
+            nextThreshold = offset + sectionSize * boundaries.size() / chunkCount;
+        }
+    }
+
+    EntitySplit split;
+    split.sectionEndOffset = boundaries.back().begin;
+    split.sectionEndLineOffset = boundaries.back().lineOffset;
+
+    split.chunks.reserve(boundaries.size() - 1);
+    for (std::size_t i{ 0 }; i + 1 < boundaries.size(); ++i) {
+        split.chunks.push_back(EntityChunk{
+            .content = content.substr(
+                boundaries[i].begin, boundaries[i + 1].end - boundaries[i].begin),
+            .lineOffset = boundaries[i].lineOffset,
+        });
+    }
+
+    return split;
+}
+
+std::optional<std::vector<EntityRecord>>
+scanEntityRecords(std::string_view content, std::size_t offset, int lineOffset)
+{
+    std::vector<EntityRecord> records;
+
+    LineScanner scanner{ content.substr(offset) };
+    std::string_view groupCode;
+    std::string_view value;
+    int currentLine{ lineOffset };
+
+    while (true) {
+        const std::size_t begin{ offset + scanner.position() };
+        if (!scanner.next(groupCode) || !scanner.next(value)) {
+            return {};
+        }
+
+        currentLine += 2;
+
+        if (trimGroupCode(groupCode) != "0") {
+            if (records.empty()) {
+                return {};
+            }
+
+            continue;
+        }
+
+        records.push_back(EntityRecord{
+            .begin = begin,
+            .typeEnd = offset + scanner.position(),
+            .lineOffset = currentLine - 2,
+            .type = value,
+        });
+
+        if (value == "ENDSEC") {
+            return records;
+        }
+    }
+}
+
+std::optional<EntityType> parsedEntityType(std::string_view name)
+{
+    if (name == "LINE") {
+        return EntityType::Line;
+    }
+    if (name == "LWPOLYLINE") {
+        return EntityType::LWPolyline;
+    }
+    if (name == "CIRCLE") {
+        return EntityType::Circle;
+    }
+    if (name == "ARC") {
+        return EntityType::Arc;
+    }
+
+    return std::nullopt;
+}
+
+tl::expected<DocumentCounts, Error> prescan(const std::filesystem::path& filePath)
+{
+    return readFileContent(filePath).map(
+        [](const std::string& content) { return prescanContent(content); });
+}
+
+}   // namespace odxf
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/entities.hpp"
+#include "opendxf/prescan.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace odxf {
+
+DocumentCounts prescanContent(std::string_view content);
+
+// A run of complete entities. The content ends with the group code 0 record which
+// follows the last entity, so a Reader can detect the end of the chunk.
+struct EntityChunk final
+{
+    std::string_view content;
+    int lineOffset{ 0 };
+};
+
+struct EntitySplit final
+{
+    std::vector<EntityChunk> chunks;
+    std::size_t sectionEndOffset{ 0 };
+    int sectionEndLineOffset{ 0 };
+};
+
+// Splits the records of an ENTITIES section, beginning at offset in content, into at
+// most chunkCount chunks of similar size. lineOffset is the number of lines before offset.
+// Returns an empty optional if the section is not terminated properly.
+std::optional<EntitySplit> splitEntities(
+    std::string_view content, std::size_t offset, int lineOffset, std::size_t chunkCount);
+
+// The group code 0 record starting an entity, or ending the section for the last record
+// returned by scanEntityRecords.
+struct EntityRecord final
+{
+    std::size_t begin{ 0 };
+    // end of the group code 0 record, i.e. where the entity's other records begin
+    std::size_t typeEnd{ 0 };
+    int lineOffset{ 0 };
+    std::string_view type;
+};
+
+// Finds the entities of an ENTITIES section beginning at offset in content, without
+// parsing them. The last record is the end of the section. Returns an empty optional
+// if the section is not terminated properly.
+std::optional<std::vector<EntityRecord>>
+scanEntityRecords(std::string_view content, std::size_t offset, int lineOffset);
+
+// The type of an entity record named name if the Reader parses it, e.g. not for POINT.
+std::optional<EntityType> parsedEntityType(std::string_view name);
+
+}   // namespace odxf
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/coordinate.hpp"
+#include "opendxf/entities.hpp"
+
+#include "hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace odxf {
+
+// Collects the values of an entity, see Quantizer and ValueCollector.
+template <typename Value>
+class BasicQuantizer final
+{
+public:
+    BasicQuantizer(std::vector<Value>& values, double tolerance)
+        : m_values{ values }
+        , m_tolerance{ tolerance }
+    {
+        m_values.clear();
+    }
+
+    void add(double value) { m_values.push_back(quantize(value)); }
+
+    void add(bool value) { m_values.push_back(value ? 1 : 0); }
+
+    void add(const Coordinate2d& coordinate)
+    {
+        add(coordinate.x);
+        add(coordinate.y);
+    }
+
+    void add(const Coordinate3d& coordinate)
+    {
+        add(coordinate.x);
+        add(coordinate.y);
+        add(coordinate.z);
+    }
+
+    void add(const Vector3d& vector)
+    {
+        add(vector.x);
+        add(vector.y);
+        add(vector.z);
+    }
+
+    template <typename T>
+    void add(const std::optional<T>& value)
+    {
+        add(value.has_value());
+        if (value) {
+            add(*value);
+        }
+    }
+
+    // Adds both values, the one with the lexicographically smaller quantized values first.
+    template <typename T>
+    void addUnordered(const T& first, const T& second)
+    {
+        const std::size_t begin{ m_values.size() };
+        add(first);
+        const std::size_t middle{ m_values.size() };
+        add(second);
+
+        if (std::lexicographical_compare(
+                m_values.begin() + middle,
+                m_values.end(),
+                m_values.begin() + begin,
+                m_values.begin() + middle)) {
+            std::rotate(m_values.begin() + begin, m_values.begin() + middle, m_values.end());
+        }
+    }
+
+private:
+    Value quantize(double value) const
+    {
+        // -0.0 and 0.0 are equal
+        value = value == 0.0 ? 0.0 : value;
+
+        if constexpr (std::is_floating_point_v<Value>) {
+            return value;
+        } else {
+            if (m_tolerance > 0.0) {
+                const double scaled{ value / m_tolerance };
+                if (std::abs(scaled) < 9.0e18) {
+                    return std::llround(scaled);
+                }
+            }
+
+            return std::bit_cast<std::int64_t>(value);
+        }
+    }
+
+    std::vector<Value>& m_values;
+    double m_tolerance;
+};
+
+// Collects the values of an entity rounded to multiples of the tolerance, a tolerance of 0
+// keeps the exact values.
+using Quantizer = BasicQuantizer<std::int64_t>;
+// Collects the exact values of an entity, whose distances are compared with the tolerance.
+using ValueCollector = BasicQuantizer<double>;
+
+template <typename Value>
+void quantize(const Arc& arc, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(arc.center);
+    quantizer.add(arc.radius);
+    quantizer.add(arc.startAngle);
+    quantizer.add(arc.endAngle);
+    quantizer.add(arc.extrusion);
+    quantizer.add(arc.thickness);
+}
+
+template <typename Value>
+void quantize(const Circle& circle, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(circle.center);
+    quantizer.add(circle.radius);
+    quantizer.add(circle.extrusion);
+    quantizer.add(circle.thickness);
+}
+
+template <typename Value>
+void quantize(const Ellipse& ellipse, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(ellipse.center);
+    quantizer.add(ellipse.endPointMajor);
+    quantizer.add(ellipse.axisRatio);
+    quantizer.add(ellipse.startParameter);
+    quantizer.add(ellipse.endParameter);
+    quantizer.add(ellipse.extrusion);
+}
+
+template <typename Value>
+void quantize(const Line& line, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(line.start);
+    quantizer.add(line.end);
+    quantizer.add(line.extrusion);
+    quantizer.add(line.thickness);
+}
+
+template <typename Value>
+void quantize(const Point& point, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(point.coordinate);
+    quantizer.add(point.extrusion);
+    quantizer.add(point.thickness);
+}
+
+template <typename Value>
+void quantize(const LWPolyline& lwPolyline, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(lwPolyline.elevation);
+    quantizer.add(lwPolyline.isClosed);
+    for (const Vertex& vertex : lwPolyline.vertices) {
+        quantizer.add(vertex.position);
+        quantizer.add(vertex.bulge);
+    }
+}
+
+template <typename Value>
+void quantize(const Ray& ray, BasicQuantizer<Value>& quantizer)
+{
+    quantizer.add(ray.startPoint);
+    quantizer.add(ray.direction);
+}
+
+// Hashes and compares entities by layer, color and the values added by quantizeEntity.
+template <typename T, void (*quantizeEntity)(const T&, Quantizer&) = &quantize>
+class EntityComparer final
+{
+public:
+    explicit EntityComparer(double tolerance)
+        : m_tolerance{ tolerance }
+    {
+    }
+
+    std::uint64_t hash(const T& entity)
+    {
+        Quantizer quantizer{ m_first, m_tolerance };
+        quantizeEntity(entity, quantizer);
+
+        const std::string_view values{ reinterpret_cast<const char*>(m_first.data()),
+                                       m_first.size() * sizeof(std::int64_t) };
+        const std::uint64_t layerHash{ hash64(entity.layer) };
+
+        return hash64(values, layerHash ^ static_cast<std::uint64_t>(entity.color));
+    }
+
+    bool equal(const T& lhs, const T& rhs)
+    {
+        if (lhs.layer != rhs.layer || lhs.color != rhs.color) {
+            return false;
+        }
+
+        Quantizer lhsQuantizer{ m_first, m_tolerance };
+        quantizeEntity(lhs, lhsQuantizer);
+        Quantizer rhsQuantizer{ m_second, m_tolerance };
+        quantizeEntity(rhs, rhsQuantizer);
+
+        return m_first == m_second;
+    }
+
+private:
+    double m_tolerance;
+    // reused for every entity
+    std::vector<std::int64_t> m_first;
+    std::vector<std::int64_t> m_second;
+};
+
+// Compares entities by layer, color and the distances of their values. Two entities are
+// near if the values added by collectFirst for the first one and by collectSecond for the
+// second one differ by at most the tolerance.
+template <
+    typename T,
+    void (*collectFirst)(const T&, ValueCollector&) = &quantize,
+    void (*collectSecond)(const T&, ValueCollector&) = collectFirst>
+class NearComparer final
+{
+public:
+    explicit NearComparer(double tolerance)
+        : m_tolerance{ tolerance }
+    {
+    }
+
+    bool near(const T& first, const T& second)
+    {
+        if (first.layer != second.layer || first.color != second.color) {
+            return false;
+        }
+
+        ValueCollector firstCollector{ m_first, m_tolerance };
+        collectFirst(first, firstCollector);
+        ValueCollector secondCollector{ m_second, m_tolerance };
+        collectSecond(second, secondCollector);
+
+        return std::equal(
+            m_first.begin(),
+            m_first.end(),
+            m_second.begin(),
+            m_second.end(),
+            [&](double lhs, double rhs) {
+                return lhs == rhs || std::abs(lhs - rhs) <= m_tolerance;
+            });
+    }
+
+private:
+    double m_tolerance;
+    // reused for every entity
+    std::vector<double> m_first;
+    std::vector<double> m_second;
+};
+
+}   // namespace odxf
@@ -3,16 +3,234 @@
 
 #include "opendxf/read.hpp"
 
-#include "opendxf/ireadstream.hpp"
+#include "opendxf/prescan.hpp"
+#include "filebuffer.hpp"
+#include "moveappend.hpp"
+#include "parallel.hpp"
+#include "prescanner.hpp"
+#include "readcontent.hpp"
 #include "reader.hpp"
+#include "readersink.hpp"
+#include "sidecarwriter.hpp"
+#include "tracescope.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+void reserve(odxf::Document& document, const odxf::DocumentCounts& counts)
+{
+    odxf::Entities& entities{ document.entities };
+    entities.arcs.reserve(counts.entities.arcs);
+    entities.circles.reserve(counts.entities.circles);
+    entities.lines.reserve(counts.entities.lines);
+    entities.lwPolylines.reserve(counts.entities.lwPolylines);
+
+    document.header.entries.reserve(counts.headerEntries);
+    document.tables.lineTypes.reserve(counts.lineTypes);
+    document.tables.layers.reserve(counts.layers);
+}
+
+void addCounts(
+    std::map<std::string, std::uint64_t, std::less<>>& target,
+    const std::map<std::string, std::uint64_t, std::less<>>& source)
+{
+    for (const auto& [name, count] : source) {
+        target[name] += count;
+    }
+}
+
+void finishStats(
+    odxf::ReadStats& stats,
+    const tl::expected<void, odxf::Error>& result,
+    std::chrono::steady_clock::time_point begin)
+{
+    stats.totalDuration = std::chrono::steady_clock::now() - begin;
+
+    // chunks read in parallel have counted their failures already
+    if (!result && stats.parseFailures == 0) {
+        stats.parseFailures = 1;
+    }
+}
+
+tl::expected<void, odxf::Error> readParallel(
+    odxf::Reader& reader,
+    odxf::Document& document,
+    std::string_view content,
+    unsigned int threadCount,
+    odxf::ReadStats* stats)
+{
+    if (tl::expected<void, odxf::Error> maybeError = reader.readUntilEntities(content);
+        !maybeError) {
+        return maybeError;
+    }
+
+    std::optional<odxf::EntitySplit> maybeSplit{ odxf::splitEntities(
+        content, reader.position(), reader.currentLine(), threadCount) };
+    if (!maybeSplit) {
+        // unusual layout, e.g. a comment before the first entity
+        return reader.readRemaining();
+    }
+
+    const std::vector<odxf::EntityChunk>& chunks{ maybeSplit->chunks };
+    std::vector<odxf::Document> chunkDocuments(chunks.size());
+    std::vector<tl::expected<void, odxf::Error>> chunkResults(chunks.size());
+    std::vector<odxf::ReadStats> chunkStats(stats != nullptr ? chunks.size() : 0);
+
+    odxf::parallelFor(chunks.size(), threadCount, [&](std::size_t index) {
+        odxf::DocumentSink chunkSink{ chunkDocuments[index] };
+        odxf::Reader chunkReader{ chunkSink };
+
+        chunkReader.setStats(stats != nullptr ? &chunkStats[index] : nullptr);
+        chunkResults[index] =
+            chunkReader.readEntityChunk(chunks[index].content, chunks[index].lineOffset);
+        chunkReader.finishStats();
+    });
+
+    if (stats != nullptr) {
+        for (std::size_t i{ 0 }; i < chunks.size(); ++i) {
+            addCounts(stats->parsedEntities, chunkStats[i].parsedEntities);
+            addCounts(stats->skippedEntities, chunkStats[i].skippedEntities);
+            stats->parseFailures += chunkResults[i] ? 0 : 1;
+        }
+    }
+
+    OPENDXF_TRACE_SCOPE("mergeEntityChunks");
+
+    for (std::size_t i{ 0 }; i < chunks.size(); ++i) {
+        if (!chunkResults[i]) {
+            return chunkResults[i];
+        }
+
+        odxf::moveAppend(document.entities, chunkDocuments[i].entities);
+    }
+
+    return reader.readFromEntitiesEnd(
+        maybeSplit->sectionEndOffset, maybeSplit->sectionEndLineOffset);
+}
+
+}   // namespace
 
 namespace odxf {
 
-tl::expected<void, Error> read(IReadStream& stream, const std::filesystem::path& filePath)
+tl::expected<void, Error>
+read(IReadStream& stream, const std::filesystem::path& filePath, ReadStats* stats)
 {
-    Reader reader{ stream };
+    if (stats == nullptr) {
+        StreamSink sink{ stream };
+        Reader reader{ sink };
+
+        return reader.readAll(filePath);
+    }
+
+    *stats = ReadStats{};
+    const auto begin{ std::chrono::steady_clock::now() };
+
+    StreamSink sink{ stream };
+    Reader reader{ sink };
+    reader.setStats(stats);
+
+    tl::expected<void, Error> result{ reader.readAll(filePath) };
+
+    reader.finishStats();
+    finishStats(*stats, result, begin);
+
+    return result;
+}
+
+void writeRequestedSidecar(
+    std::string_view content, const Document& document, const ReadOptions& options)
+{
+    if (options.sidecarPath.empty()) {
+        return;
+    }
+
+    // the document does not depend on its index
+    tl::expected<void, Error> written{ writeSidecarIndex(
+        content, document, options.sidecarPath, resolveThreadCount(options.threadCount)) };
+    if (!written) {
+        reportSidecarError(std::move(written.error()), options);
+    }
+}
+
+void reportSidecarError(Error error, const ReadOptions& options)
+{
+    if (options.sidecarError != nullptr) {
+        *options.sidecarError = std::move(error);
+    }
+}
+
+tl::expected<Document, Error> readDocumentContent(
+    std::string_view content,
+    const ReadOptions& options,
+    std::chrono::steady_clock::time_point begin)
+{
+    ReadStats* const stats{ options.stats };
+    if (stats != nullptr) {
+        stats->peakBufferedBytes = content.size();
+    }
+    if (options.sidecarError != nullptr) {
+        options.sidecarError->reset();
+    }
+
+    Document document;
+    if (options.prescan) {
+        OPENDXF_TRACE_SCOPE("prescan");
+        reserve(document, prescanContent(content));
+    }
+
+    const unsigned int threadCount{ resolveThreadCount(options.threadCount) };
+
+    DocumentSink sink{ document };
+    Reader reader{ sink };
+    reader.setStats(stats);
+
+    tl::expected<void, Error> result{
+        threadCount > 1 ? readParallel(reader, document, content, threadCount, stats)
+                        : reader.readContent(content)
+    };
+
+    if (stats != nullptr) {
+        reader.finishStats();
+        finishStats(*stats, result, begin);
+    }
+
+    if (result) {
+        writeRequestedSidecar(content, document, options);
+    }
+
+    return result.map([&document] { return std::move(document); });
+}
+
+tl::expected<Document, Error>
+readDocument(const std::filesystem::path& filePath, const ReadOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("readDocument");
+
+    ReadStats* const stats{ options.stats };
+    const auto begin{ stats != nullptr ? std::chrono::steady_clock::now()
+                                       : std::chrono::steady_clock::time_point{} };
+    if (stats != nullptr) {
+        *stats = ReadStats{};
+    }
+
+    const tl::expected<std::string, Error> maybeContent{ readFileContent(filePath) };
+    if (!maybeContent) {
+        return tl::make_unexpected(maybeContent.error());
+    }
+
+    if (stats != nullptr) {
+        stats->loadDuration = std::chrono::steady_clock::now() - begin;
+    }
 
-    return reader.readAll(filePath);
+    return readDocumentContent(*maybeContent, options, begin);
 }
 
 }   // namespace odxf
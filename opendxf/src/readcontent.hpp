@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/document.hpp"
+#include "opendxf/error.hpp"
+#include "opendxf/read.hpp"
+
+#include <tl/expected.hpp>
+
+#include <chrono>
+#include <string_view>
+
+namespace odxf {
+
+// readDocument() for a file already loaded into memory. The statistics, if requested,
+// must have been reset by the caller, their durations are measured from begin.
+tl::expected<Document, Error> readDocumentContent(
+    std::string_view content,
+    const ReadOptions& options,
+    std::chrono::steady_clock::time_point begin);
+
+// Writes the sidecar index requested by ReadOptions::sidecarPath, if any, for the
+// document read from the content. A failure is only reported through the options.
+void writeRequestedSidecar(
+    std::string_view content, const Document& document, const ReadOptions& options);
+
+// Reports a failure to write the sidecar index through ReadOptions::sidecarError.
+void reportSidecarError(Error error, const ReadOptions& options);
+
+}   // namespace odxf
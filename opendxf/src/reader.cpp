@@ -3,46 +3,75 @@
 
 #include "reader.hpp"
 
-#include "opendxf/ireadstream.hpp"
-#include "opendxf/layer.hpp"
+#include "pathstring.hpp"
+#include "readersink.hpp"
+#include "tracescope.hpp"
 
 #include <fmt/format.h>
 
-#include <charconv>
+#include <algorithm>
 
 namespace {
 
-template <typename T>
-std::optional<T> parseAs(const std::string& value)
+// bytes readAll appends to its window at once
+constexpr std::size_t windowSize{ std::size_t{ 1 } << 20 };
+
+}   // namespace
+
+namespace odxf {
+
+Reader::Reader(ReaderSink& sink)
+    : m_sink{ sink }
 {
-    const char* first{ value.c_str() };
-    if (!value.empty()) {
-        while (*first == ' ') {
-            ++first;
-        }
+}
+
+tl::expected<void, Error> Reader::readAll(const std::filesystem::path& filePath)
+{
+    OPENDXF_TRACE_SCOPE("readAll");
+
+    m_stream = std::ifstream{ filePath, std::ios::binary };
+    if (!m_stream.is_open()) {
+        return tl::make_unexpected(Error{
+            .type = Error::Type::FileOpenError,
+            .what = fmt::format("unable to open file {}", pathToString(filePath)),
+        });
     }
 
-    T result;
-    const auto [_, errorCode]{ std::from_chars(first, first + value.size(), result) };
+    m_buffer.clear();
+    setContent({}, 0);
+
+    tl::expected<void, Error> result{ readSections() };
 
-    return errorCode == std::errc() ? result : std::optional<T>{};
+    m_stream.close();
+
+    return result;
 }
 
-}   // namespace
+tl::expected<void, Error> Reader::readContent(std::string_view content)
+{
+    setContent(content, 0);
 
-namespace odxf {
+    return readSections();
+}
 
-Reader::Reader(IReadStream& stream)
-    : m_stream{ stream }
+tl::expected<void, Error> Reader::readUntilEntities(std::string_view content)
 {
+    setContent(content, 0);
+
+    return readSectionsUntilEntities();
 }
 
-tl::expected<void, Error> Reader::readAll(const std::filesystem::path& filePath)
+tl::expected<void, Error> Reader::readSections()
 {
-    if (!open(filePath)) {
-        return makeError();
+    if (tl::expected<void, Error> maybeError = readSectionsUntilEntities(); !maybeError) {
+        return maybeError;
     }
 
+    return readRemaining();
+}
+
+tl::expected<void, Error> Reader::readSectionsUntilEntities()
+{
     if (tl::expected<void, Error> maybeError = readHeader(); !maybeError) {
         return maybeError;
     }
@@ -55,41 +84,160 @@ tl::expected<void, Error> Reader::readAll(const std::filesystem::path& filePath)
         return maybeError;
     }
 
-    if (tl::expected<void, Error> maybeError = readEntities(); !maybeError) {
+    return readEntitiesBegin();
+}
+
+tl::expected<void, Error> Reader::readRemaining()
+{
+    if (tl::expected<void, Error> maybeError = readEntityRecords(); !maybeError) {
         return maybeError;
     }
 
+    return readEof();
+}
+
+tl::expected<void, Error> Reader::readFromEntitiesEnd(std::size_t offset, int lineOffset)
+{
+    m_scanner.seek(offset);
+    m_currentLine = lineOffset;
+
     if (!readNext()) {
         return makeError();
     }
 
-    if (isEOF()) {
-        return {};
+    if (!isSectionEnd()) {
+        return tl::make_unexpected(Error{
+            .lineNumber = m_currentLine,
+            .what = "expected section end",
+        });
     }
 
-    return tl::make_unexpected(Error{ .lineNumber = m_currentLine, .what = "EOF missing" });
+    return readEof();
 }
 
-bool Reader::open(const std::filesystem::path& filePath)
+tl::expected<void, Error> Reader::readEntityChunk(std::string_view content, int lineOffset)
 {
-    m_fileStream.open(filePath);
+    OPENDXF_TRACE_SCOPE("readEntityChunk");
 
-    if (!m_fileStream.is_open()) {
-        m_error = Error{
-            .type = Error::Type::FileOpenError,
-            .what = fmt::format(
-                "unable to open file {}",
-                reinterpret_cast<const char*>(filePath.u8string().c_str())),
-        };
+    setContent(content, lineOffset);
+    m_isChunk = true;
 
-        return false;
+    if (!readNext()) {
+        return makeError();
     }
 
-    return true;
+    return readEntityRecords();
+}
+
+std::size_t Reader::position() const { return m_windowOffset + m_scanner.position(); }
+
+int Reader::currentLine() const { return m_currentLine; }
+
+void Reader::setStats(ReadStats* stats)
+{
+    m_stats = stats;
+    m_section = Section::None;
+    m_parsedCounts = {};
+}
+
+void Reader::finishStats()
+{
+    if (m_stats == nullptr) {
+        return;
+    }
+
+    beginSection(Section::None);
+
+    const auto addCount{ [this](std::string_view name, std::uint64_t count) {
+        if (count != 0) {
+            m_stats->parsedEntities[std::string{ name }] += count;
+        }
+    } };
+    addCount("LINE", m_parsedCounts.lines);
+    addCount("CIRCLE", m_parsedCounts.circles);
+    addCount("ARC", m_parsedCounts.arcs);
+    addCount("LWPOLYLINE", m_parsedCounts.lwPolylines);
+    m_parsedCounts = {};
+}
+
+void Reader::beginSection(Section section)
+{
+    if (m_stats == nullptr) {
+        return;
+    }
+
+    const SectionStart now{
+        .position = position(),
+        .line = m_currentLine,
+        .time = std::chrono::steady_clock::now(),
+    };
+
+    SectionStats* sectionStats{ nullptr };
+    switch (m_section) {
+    case Section::None: break;
+    case Section::Header: sectionStats = &m_stats->header; break;
+    case Section::Tables: sectionStats = &m_stats->tables; break;
+    case Section::Blocks: sectionStats = &m_stats->blocks; break;
+    case Section::Entities: sectionStats = &m_stats->entities; break;
+    }
+
+    if (sectionStats != nullptr) {
+        sectionStats->bytes += now.position - m_sectionStart.position;
+        // every group code takes two lines
+        sectionStats->groupCodes += static_cast<std::uint64_t>(now.line - m_sectionStart.line) / 2;
+        sectionStats->duration += now.time - m_sectionStart.time;
+    }
+
+    m_section = section;
+    m_sectionStart = now;
+}
+
+void Reader::countSkipped()
+{
+    // only the first record of an entity carries its name
+    if (m_stats == nullptr || m_data.groupCode != 0) {
+        return;
+    }
+
+    const auto iter{ m_stats->skippedEntities.find(m_data.value) };
+    if (iter != m_stats->skippedEntities.end()) {
+        ++iter->second;
+    } else {
+        m_stats->skippedEntities.emplace(std::string{ m_data.value }, 1);
+    }
+}
+
+void Reader::setContent(std::string_view content, int lineOffset)
+{
+    m_content = content;
+    m_scanner = LineScanner{ content };
+    m_isChunk = false;
+    m_currentLine = lineOffset;
+    m_error.reset();
+    m_windowOffset = 0;
+    m_windowLineEnd = std::string_view::npos;
+}
+
+tl::expected<void, Error> Reader::readEof()
+{
+    beginSection(Section::None);
+
+    if (!readNext()) {
+        return makeError();
+    }
+
+    if (isEOF()) {
+        return {};
+    }
+
+    return tl::make_unexpected(Error{ .lineNumber = m_currentLine, .what = "EOF missing" });
 }
 
 tl::expected<void, Error> Reader::readHeader()
 {
+    OPENDXF_TRACE_SCOPE("readHeader");
+    beginSection(Section::Header);
+
     if (!readNext()) {
         return makeError();
     }
@@ -113,7 +261,7 @@ tl::expected<void, Error> Reader::readHeader()
         return makeError();
     }
 
-    Header header;
+    Header& header{ m_sink.beginHeader() };
     while (!isSectionEnd()) {
         if (hasError()) {
             return tl::make_unexpected(m_error.value());
@@ -128,7 +276,7 @@ tl::expected<void, Error> Reader::readHeader()
         header.entries.emplace(headerEntry);
     }
 
-    m_stream.header(header);
+    m_sink.endHeader();
 
     return {};
 }
@@ -152,7 +300,7 @@ tl::expected<HeaderEntry, Error> Reader::readHeaderEntry()
     case 1:
     case 2:
     case 3: {
-        HeaderValue value{ m_data.value };
+        HeaderValue value{ std::string{ m_data.value } };
 
         if (!readNext()) {
             return tl::make_unexpected(m_error.value());
@@ -166,7 +314,7 @@ tl::expected<HeaderEntry, Error> Reader::readHeaderEntry()
             return tl::make_unexpected(Error{ .lineNumber = m_currentLine });
         }
 
-        HeaderValue value{ m_data.value };
+        HeaderValue value{ std::string{ m_data.value } };
 
         if (!readNext()) {
             return tl::make_unexpected(m_error.value());
@@ -180,7 +328,7 @@ tl::expected<HeaderEntry, Error> Reader::readHeaderEntry()
             return tl::make_unexpected(Error{ .lineNumber = m_currentLine });
         }
 
-        HeaderValue value{ m_data.value };
+        HeaderValue value{ std::string{ m_data.value } };
 
         if (!readNext()) {
             return tl::make_unexpected(m_error.value());
@@ -194,7 +342,7 @@ tl::expected<HeaderEntry, Error> Reader::readHeaderEntry()
             return tl::make_unexpected(Error{ .lineNumber = m_currentLine });
         }
 
-        HeaderValue value{ m_data.value };
+        HeaderValue value{ std::string{ m_data.value } };
 
         if (!readNext()) {
             return tl::make_unexpected(m_error.value());
@@ -208,7 +356,7 @@ tl::expected<HeaderEntry, Error> Reader::readHeaderEntry()
             return tl::make_unexpected(Error{ .lineNumber = m_currentLine });
         }
 
-        HeaderValue value{ m_data.value };
+        HeaderValue value{ std::string{ m_data.value } };
 
         if (!readNext()) {
             return tl::make_unexpected(m_error.value());
@@ -442,6 +590,9 @@ tl::expected<std::variant<Coordinate2d, Coordinate3d>, Error> Reader::readHeader
 
 tl::expected<void, Error> Reader::readTables()
 {
+    OPENDXF_TRACE_SCOPE("readTables");
+    beginSection(Section::Tables);
+
     if (!readNext()) {
         return makeError();
     }
@@ -464,12 +615,18 @@ tl::expected<void, Error> Reader::readTables()
         });
     }
 
+    m_lineTypeNames.clear();
     while (!isSectionEnd()) {
         if (hasError()) {
             return makeError();
         }
 
-        if (isLayer()) {
+        if (isLineType()) {
+            tl::expected<void, Error> maybeResult{ readLineType() };
+            if (!maybeResult) {
+                return maybeResult;
+            }
+        } else if (isLayer()) {
             tl::expected<void, Error> maybeResult{ readLayer() };
             if (!maybeResult) {
                 return maybeResult;
@@ -486,13 +643,59 @@ tl::expected<void, Error> Reader::readTables()
     return {};
 }
 
+tl::expected<void, Error> Reader::readLineType()
+{
+    if (!readNext()) {
+        return tl::make_unexpected(m_error.value());
+    }
+
+    LineType& lineType{ m_sink.beginLineType() };
+    while (m_data.groupCode != 0) {
+        switch (m_data.groupCode) {
+        case 2: {
+            lineType.name = m_data.value;
+
+            break;
+        }
+
+        case 3: {
+            lineType.displayName = m_data.value;
+
+            break;
+        }
+
+        case 70: {
+            const std::optional<int> maybeFlags{ parseAs<int>(m_data.value) };
+            if (maybeFlags.has_value()) {
+                lineType.flags = *maybeFlags;
+            } else {
+                return tl::make_unexpected(Error{
+                    .lineNumber = m_currentLine,
+                });
+            }
+
+            break;
+        }
+        }
+
+        if (!readNext()) {
+            return makeError();
+        }
+    }
+
+    m_lineTypeNames.push_back(lineType.name);
+    m_sink.endLineType();
+
+    return tl::expected<void, Error>();
+}
+
 tl::expected<void, Error> Reader::readLayer()
 {
     if (!readNext()) {
         return tl::make_unexpected(m_error.value());
     }
 
-    Layer layer;
+    Layer& layer{ m_sink.beginLayer() };
     while (m_data.groupCode != 0) {
         switch (m_data.groupCode) {
         case 2: {
@@ -513,6 +716,25 @@ tl::expected<void, Error> Reader::readLayer()
 
             break;
         }
+
+        case 62: {
+            const std::optional<int> maybeColor{ parseAs<int>(m_data.value) };
+            if (maybeColor.has_value()) {
+                layer.color = *maybeColor;
+            } else {
+                return tl::make_unexpected(Error{
+                    .lineNumber = m_currentLine,
+                });
+            }
+
+            break;
+        }
+
+        case 6: {
+            layer.lineType = lineTypeIndex(m_data.value);
+
+            break;
+        }
         }
 
         if (!readNext()) {
@@ -520,13 +742,30 @@ tl::expected<void, Error> Reader::readLayer()
         }
     }
 
-    m_stream.layer(layer);
+    m_sink.endLayer();
 
     return tl::expected<void, Error>();
 }
 
+int Reader::lineTypeIndex(std::string_view name)
+{
+    const auto iter{ std::find(m_lineTypeNames.begin(), m_lineTypeNames.end(), name) };
+    if (iter != m_lineTypeNames.end()) {
+        return static_cast<int>(iter - m_lineTypeNames.begin());
+    }
+
+    m_sink.beginLineType().name = name;
+    m_sink.endLineType();
+    m_lineTypeNames.emplace_back(name);
+
+    return static_cast<int>(m_lineTypeNames.size() - 1);
+}
+
 tl::expected<void, Error> Reader::readBlocks()
 {
+    OPENDXF_TRACE_SCOPE("readBlocks");
+    beginSection(Section::Blocks);
+
     if (!readNext()) {
         return makeError();
     }
@@ -558,8 +797,10 @@ tl::expected<void, Error> Reader::readBlocks()
     return {};
 }
 
-tl::expected<void, Error> Reader::readEntities()
+tl::expected<void, Error> Reader::readEntitiesBegin()
 {
+    beginSection(Section::Entities);
+
     if (!readNext()) {
         return makeError();
     }
@@ -582,7 +823,18 @@ tl::expected<void, Error> Reader::readEntities()
         });
     }
 
-    while (!isSectionEnd()) {
+    return {};
+}
+
+tl::expected<void, Error> Reader::readEntityRecords()
+{
+    OPENDXF_TRACE_SCOPE("readEntities");
+
+    if (!m_isChunk && !readNext()) {
+        return makeError();
+    }
+
+    while (!isSectionEnd() && !isChunkEnd()) {
         if (hasError()) {
             return makeError();
         }
@@ -592,23 +844,28 @@ tl::expected<void, Error> Reader::readEntities()
             if (!maybeResult) {
                 return maybeResult;
             }
+            ++m_parsedCounts.lines;
 
         } else if (isCircle()) {
             tl::expected<void, Error> maybeResult{ readCircle() };
             if (!maybeResult) {
                 return maybeResult;
             }
+            ++m_parsedCounts.circles;
         } else if (isArc()) {
             tl::expected<void, Error> maybeResult{ readArc() };
             if (!maybeResult) {
                 return maybeResult;
             }
+            ++m_parsedCounts.arcs;
         } else if (isLWPolyline()) {
             tl::expected<void, Error> maybeResult{ readLWPolyline() };
             if (!maybeResult) {
                 return maybeResult;
             }
+            ++m_parsedCounts.lwPolylines;
         } else {
+            countSkipped();
             readNext();
         }
 
@@ -626,7 +883,7 @@ tl::expected<void, Error> Reader::readLine()
         return tl::make_unexpected(m_error.value());
     }
 
-    Line line;
+    Line& line{ m_sink.beginLine() };
 
     while (m_data.groupCode != 0) {
         switch (m_data.groupCode) {
@@ -694,7 +951,7 @@ tl::expected<void, Error> Reader::readLine()
         }
     }
 
-    m_stream.line(line);
+    m_sink.endLine();
 
     return {};
 }
@@ -705,7 +962,7 @@ tl::expected<void, Error> Reader::readCircle()
         return tl::make_unexpected(m_error.value());
     }
 
-    Circle circle;
+    Circle& circle{ m_sink.beginCircle() };
 
     while (m_data.groupCode != 0) {
         switch (m_data.groupCode) {
@@ -760,7 +1017,7 @@ tl::expected<void, Error> Reader::readCircle()
         }
     }
 
-    m_stream.circle(circle);
+    m_sink.endCircle();
 
     return tl::expected<void, Error>();
 }
@@ -771,7 +1028,7 @@ tl::expected<void, Error> Reader::readArc()
         return tl::make_unexpected(m_error.value());
     }
 
-    Arc arc;
+    Arc& arc{ m_sink.beginArc() };
 
     while (m_data.groupCode != 0) {
         switch (m_data.groupCode) {
@@ -852,7 +1109,7 @@ tl::expected<void, Error> Reader::readArc()
         }
     }
 
-    m_stream.arc(arc);
+    m_sink.endArc();
 
     return tl::expected<void, Error>();
 }
@@ -863,7 +1120,7 @@ tl::expected<void, Error> Reader::readLWPolyline()
         return tl::make_unexpected(m_error.value());
     }
 
-    LWPolyline lwPolyline;
+    LWPolyline& lwPolyline{ m_sink.beginLWPolyline() };
 
     Vertex vertex;
     int numXY{ 0 };
@@ -965,7 +1222,7 @@ tl::expected<void, Error> Reader::readLWPolyline()
         lwPolyline.vertices.push_back(vertex);
     }
 
-    m_stream.lwPolyline(lwPolyline);
+    m_sink.endLWPolyline();
 
     return tl::expected<void, Error>();
 }
@@ -984,7 +1241,8 @@ bool Reader::readNextSingle()
 {
     m_currentLine++;
 
-    if (!std::getline(m_fileStream, m_data.value)) {
+    std::string_view groupCode;
+    if (!nextLine(groupCode)) {
         m_error = Error{
             .lineNumber = m_currentLine,
             .what = "unable to read line",
@@ -993,14 +1251,12 @@ bool Reader::readNextSingle()
         return false;
     }
 
-    const char* first{ m_data.value.c_str() };
-    if (!m_data.value.empty()) {
-        while (*first == ' ') {
-            ++first;
-        }
+    const char* first{ groupCode.data() };
+    const char* last{ groupCode.data() + groupCode.size() };
+    while (first != last && *first == ' ') {
+        ++first;
     }
-    const auto [_, errorCode]{ std::from_chars(
-        first, first + m_data.value.size(), m_data.groupCode) };
+    const auto [_, errorCode]{ std::from_chars(first, last, m_data.groupCode) };
     if (errorCode != std::errc()) {
         m_error = Error{
             .lineNumber = m_currentLine,
@@ -1011,7 +1267,7 @@ bool Reader::readNextSingle()
     }
 
     m_currentLine++;
-    if (!std::getline(m_fileStream, m_data.value)) {
+    if (!nextLine(m_data.value)) {
         m_error = Error{
             .lineNumber = m_currentLine,
             .what = "unable to read line",
@@ -1023,10 +1279,56 @@ bool Reader::readNextSingle()
     return true;
 }
 
+bool Reader::nextLine(std::string_view& line)
+{
+    // the window ends within a line unless the stream is exhausted
+    if (m_stream.is_open()
+        && (m_windowLineEnd == std::string_view::npos || m_scanner.position() > m_windowLineEnd)) {
+        refillWindow();
+    }
+
+    return m_scanner.next(line);
+}
+
+void Reader::refillWindow()
+{
+    const auto loadBegin{ m_stats != nullptr ? std::chrono::steady_clock::now()
+                                              : std::chrono::steady_clock::time_point{} };
+
+    const std::size_t consumed{ m_scanner.position() };
+    m_buffer.erase(0, consumed);
+    m_windowOffset += consumed;
+
+    // the unread bytes hold no newline character, i.e. the window grows only for a line
+    // longer than the window
+    do {
+        const std::size_t size{ m_buffer.size() };
+        m_buffer.resize(size + windowSize);
+        m_stream.read(m_buffer.data() + size, static_cast<std::streamsize>(windowSize));
+        m_buffer.resize(size + static_cast<std::size_t>(m_stream.gcount()));
+        m_windowLineEnd = m_buffer.rfind('\n');
+    } while (m_windowLineEnd == std::string::npos && m_stream.good());
+
+    if (!m_stream.good()) {
+        m_stream.close();
+    }
+
+    m_content = m_buffer;
+    m_scanner = LineScanner{ m_content };
+
+    if (m_stats != nullptr) {
+        m_stats->loadDuration += std::chrono::steady_clock::now() - loadBegin;
+        m_stats->peakBufferedBytes =
+            std::max<std::uint64_t>(m_stats->peakBufferedBytes, m_buffer.size());
+    }
+}
+
 bool Reader::hasError() const { return m_error.has_value(); }
 
 tl::expected<void, Error> Reader::makeError() const { return tl::make_unexpected(m_error.value()); }
 
+bool Reader::isChunkEnd() const { return m_isChunk && m_scanner.position() >= m_content.size(); }
+
 bool Reader::isSectionBegin() const { return m_data.groupCode == 0 && m_data.value == "SECTION"; }
 
 bool Reader::isSectionEnd() const { return m_data.groupCode == 0 && m_data.value == "ENDSEC"; }
@@ -1045,11 +1347,13 @@ bool Reader::isTableEnd() const { return m_data.groupCode == 0 && m_data.value =
 
 bool Reader::isLayerBegin() const { return m_data.groupCode == 2 && m_data.value == "LAYER"; }
 
+bool Reader::isLineType() const { return m_data.groupCode == 0 && m_data.value == "LTYPE"; }
+
 bool Reader::isLayer() const { return m_data.groupCode == 0 && m_data.value == "LAYER"; }
 
 bool Reader::isLine() const { return m_data.groupCode == 0 && m_data.value == "LINE"; }
 
-bool odxf::Reader::isCircle() const { return m_data.groupCode == 0 && m_data.value == "CIRCLE"; }
+bool Reader::isCircle() const { return m_data.groupCode == 0 && m_data.value == "CIRCLE"; }
 
 bool Reader::isArc() const { return m_data.groupCode == 0 && m_data.value == "ARC"; }
 
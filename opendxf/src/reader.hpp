@@ -4,58 +4,118 @@
 #pragma once
 
 #include "opendxf/coordinate.hpp"
-#include "opendxf/entities.hpp"
 #include "opendxf/error.hpp"
 #include "opendxf/header.hpp"
+#include "opendxf/readstats.hpp"
+
+#include "linescanner.hpp"
 
 #include <tl/expected.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
 namespace odxf {
 
-class IReadStream;
+class ReaderSink;
 
 class Reader
 {
 public:
-    Reader(IReadStream& stream);
+    Reader(ReaderSink& sink);
 
     Reader(const Reader&) = delete;
     Reader(Reader&&) = delete;
     Reader& operator=(const Reader&) = delete;
     Reader& operator=(Reader&&) = delete;
 
+    // Streams the file through a window of a bounded size, which only grows to hold a
+    // single line longer than the window.
     tl::expected<void, Error> readAll(const std::filesystem::path& filePath);
+    tl::expected<void, Error> readContent(std::string_view content);
+
+    // Reads all sections preceding the entity records, i.e. up to and including the
+    // name of the ENTITIES section. position() then points to the first entity.
+    tl::expected<void, Error> readUntilEntities(std::string_view content);
+
+    // Reads the entity records following readUntilEntities and the end of the file.
+    tl::expected<void, Error> readRemaining();
+
+    // Continues after the entities were read elsewhere. The offset must point to the
+    // group code 0 record ending the ENTITIES section.
+    tl::expected<void, Error> readFromEntitiesEnd(std::size_t offset, int lineOffset);
+
+    // Reads the entities of a chunk produced by splitEntities.
+    tl::expected<void, Error> readEntityChunk(std::string_view content, int lineOffset);
+
+    std::size_t position() const;
+    int currentLine() const;
+
+    // Collects statistics into stats until finishStats() is called. Without stats the
+    // reader only does a null check per section and skipped entity.
+    void setStats(ReadStats* stats);
+    // Closes the current section and adds the entity counts to the statistics.
+    void finishStats();
 
 private:
-    bool open(const std::filesystem::path& filePath);
+    enum class Section
+    {
+        None,
+        Header,
+        Tables,
+        Blocks,
+        Entities
+    };
+
+    // Ends the statistics of the current section and starts the next one.
+    void beginSection(Section section);
+    void countSkipped();
+
+    void setContent(std::string_view content, int lineOffset);
+
+    tl::expected<void, Error> readSections();
+    tl::expected<void, Error> readSectionsUntilEntities();
 
     tl::expected<void, Error> readHeader();
     tl::expected<HeaderEntry, Error> readHeaderEntry();
     tl::expected<std::variant<Coordinate2d, Coordinate3d>, Error> readHeaderCoordinate();
 
     tl::expected<void, Error> readTables();
+    tl::expected<void, Error> readLineType();
     tl::expected<void, Error> readLayer();
+    // Index of the line type of the name. A line type without a record in the LTYPE
+    // table is added, so that every layer references a line type.
+    int lineTypeIndex(std::string_view name);
 
     tl::expected<void, Error> readBlocks();
 
-    tl::expected<void, Error> readEntities();
+    tl::expected<void, Error> readEntitiesBegin();
+    tl::expected<void, Error> readEntityRecords();
     tl::expected<void, Error> readLine();
     tl::expected<void, Error> readCircle();
     tl::expected<void, Error> readArc();
     tl::expected<void, Error> readLWPolyline();
 
+    tl::expected<void, Error> readEof();
+
     bool readNext();
     bool readNextSingle();
+    bool nextLine(std::string_view& line);
+    // Moves the unread bytes of the window to its front and appends the next bytes of the
+    // stream, at least up to the next newline character.
+    void refillWindow();
 
     bool hasError() const;
     tl::expected<void, Error> makeError() const;
+    bool isChunkEnd() const;
     bool isSectionBegin() const;
     bool isSectionEnd() const;
     bool isHeaderBegin() const;
@@ -65,6 +125,7 @@ private:
     bool isTableBegin() const;
     bool isTableEnd() const;
     bool isLayerBegin() const;
+    bool isLineType() const;
     bool isLayer() const;
 
     bool isLine() const;
@@ -77,15 +138,46 @@ private:
     struct Data
     {
         int groupCode;
-        std::string value;
+        std::string_view value;
     };
 
-    IReadStream& m_stream;
-    std::ifstream m_fileStream;
+    ReaderSink& m_sink;
+    std::string m_buffer;
+    std::string_view m_content;
+    LineScanner m_scanner{ {} };
+    bool m_isChunk{ false };
     Data m_data;
     int m_currentLine{ 0 };
     std::optional<Error> m_error;
-    std::vector<std::string> m_layerNames;
+    // names of the line types read so far, by index
+    std::vector<std::string> m_lineTypeNames;
+
+    // window of the file streamed by readAll
+    std::ifstream m_stream;
+    // offset of the window in the file
+    std::size_t m_windowOffset{ 0 };
+    // position of the last newline character in the window, if any
+    std::size_t m_windowLineEnd{ std::string_view::npos };
+
+    struct SectionStart
+    {
+        std::size_t position{ 0 };
+        int line{ 0 };
+        std::chrono::steady_clock::time_point time;
+    };
+
+    struct ParsedCounts
+    {
+        std::uint64_t lines{ 0 };
+        std::uint64_t circles{ 0 };
+        std::uint64_t arcs{ 0 };
+        std::uint64_t lwPolylines{ 0 };
+    };
+
+    ReadStats* m_stats{ nullptr };
+    Section m_section{ Section::None };
+    SectionStart m_sectionStart;
+    ParsedCounts m_parsedCounts;
 };
 
 }   // namespace odxf
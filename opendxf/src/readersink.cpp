@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "readersink.hpp"
+
+#include "opendxf/ireadstream.hpp"
+
+#include <utility>
+
+namespace {
+
+// Resets an entity to its default state but keeps the heap buffer of its layer name.
+template <typename T>
+void resetEntity(T& entity)
+{
+    std::string layer{ std::move(entity.layer) };
+    layer.clear();
+
+    entity = T{};
+    entity.layer = std::move(layer);
+}
+
+}   // namespace
+
+namespace odxf {
+
+StreamSink::StreamSink(IReadStream& stream)
+    : m_stream{ stream }
+{
+}
+
+Header& StreamSink::beginHeader()
+{
+    m_header.entries.clear();
+
+    return m_header;
+}
+
+void StreamSink::endHeader() { m_stream.header(m_header); }
+
+LineType& StreamSink::beginLineType()
+{
+    std::string name{ std::move(m_lineType.name) };
+    std::string displayName{ std::move(m_lineType.displayName) };
+    name.clear();
+    displayName.clear();
+
+    m_lineType = LineType{};
+    m_lineType.name = std::move(name);
+    m_lineType.displayName = std::move(displayName);
+
+    return m_lineType;
+}
+
+void StreamSink::endLineType() { m_stream.lineType(m_lineType); }
+
+Layer& StreamSink::beginLayer()
+{
+    std::string name{ std::move(m_layer.name) };
+    name.clear();
+
+    m_layer = Layer{};
+    m_layer.name = std::move(name);
+
+    return m_layer;
+}
+
+void StreamSink::endLayer() { m_stream.layer(m_layer); }
+
+Arc& StreamSink::beginArc()
+{
+    resetEntity(m_arc);
+
+    return m_arc;
+}
+
+void StreamSink::endArc() { m_stream.arc(m_arc); }
+
+Circle& StreamSink::beginCircle()
+{
+    resetEntity(m_circle);
+
+    return m_circle;
+}
+
+void StreamSink::endCircle() { m_stream.circle(m_circle); }
+
+Line& StreamSink::beginLine()
+{
+    resetEntity(m_line);
+
+    return m_line;
+}
+
+void StreamSink::endLine() { m_stream.line(m_line); }
+
+LWPolyline& StreamSink::beginLWPolyline()
+{
+    Vertices vertices{ std::move(m_lwPolyline.vertices) };
+    vertices.clear();
+
+    resetEntity(m_lwPolyline);
+    m_lwPolyline.vertices = std::move(vertices);
+
+    return m_lwPolyline;
+}
+
+void StreamSink::endLWPolyline() { m_stream.lwPolyline(m_lwPolyline); }
+
+DocumentSink::DocumentSink(Document& document)
+    : m_document{ document }
+{
+}
+
+Header& DocumentSink::beginHeader() { return m_document.header; }
+
+void DocumentSink::endHeader() {}
+
+LineType& DocumentSink::beginLineType() { return m_document.tables.lineTypes.emplace_back(); }
+
+void DocumentSink::endLineType() {}
+
+Layer& DocumentSink::beginLayer() { return m_document.tables.layers.emplace_back(); }
+
+void DocumentSink::endLayer() {}
+
+Arc& DocumentSink::beginArc() { return m_document.entities.arcs.emplace_back(); }
+
+void DocumentSink::endArc() {}
+
+Circle& DocumentSink::beginCircle() { return m_document.entities.circles.emplace_back(); }
+
+void DocumentSink::endCircle() {}
+
+Line& DocumentSink::beginLine() { return m_document.entities.lines.emplace_back(); }
+
+void DocumentSink::endLine() {}
+
+LWPolyline& DocumentSink::beginLWPolyline()
+{
+    return m_document.entities.lwPolylines.emplace_back();
+}
+
+void DocumentSink::endLWPolyline() {}
+
+}   // namespace odxf
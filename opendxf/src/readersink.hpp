@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/document.hpp"
+#include "opendxf/entities.hpp"
+#include "opendxf/header.hpp"
+#include "opendxf/layer.hpp"
+#include "opendxf/tables.hpp"
+
+namespace odxf {
+
+class IReadStream;
+
+// Destination of the records parsed by the Reader. The Reader fills the object
+// returned by a begin* call in place and signals completion with the matching end* call.
+class ReaderSink
+{
+public:
+    ReaderSink() = default;
+    virtual ~ReaderSink() = default;
+
+    virtual Header& beginHeader() = 0;
+    virtual void endHeader() = 0;
+
+    virtual LineType& beginLineType() = 0;
+    virtual void endLineType() = 0;
+
+    virtual Layer& beginLayer() = 0;
+    virtual void endLayer() = 0;
+
+    virtual Arc& beginArc() = 0;
+    virtual void endArc() = 0;
+
+    virtual Circle& beginCircle() = 0;
+    virtual void endCircle() = 0;
+
+    virtual Line& beginLine() = 0;
+    virtual void endLine() = 0;
+
+    virtual LWPolyline& beginLWPolyline() = 0;
+    virtual void endLWPolyline() = 0;
+
+protected:
+    ReaderSink(const ReaderSink&) = default;
+    ReaderSink(ReaderSink&&) = default;
+    ReaderSink& operator=(const ReaderSink&) = default;
+    ReaderSink& operator=(ReaderSink&&) = default;
+};
+
+// Forwards every record to an IReadStream. A single scratch object per record type
+// is reused, so strings and vertex buffers keep their capacity across records.
+class StreamSink final : public ReaderSink
+{
+public:
+    explicit StreamSink(IReadStream& stream);
+
+    Header& beginHeader() override;
+    void endHeader() override;
+
+    LineType& beginLineType() override;
+    void endLineType() override;
+
+    Layer& beginLayer() override;
+    void endLayer() override;
+
+    Arc& beginArc() override;
+    void endArc() override;
+
+    Circle& beginCircle() override;
+    void endCircle() override;
+
+    Line& beginLine() override;
+    void endLine() override;
+
+    LWPolyline& beginLWPolyline() override;
+    void endLWPolyline() override;
+
+private:
+    IReadStream& m_stream;
+
+    Header m_header;
+    LineType m_lineType;
+    Layer m_layer;
+    Arc m_arc;
+    Circle m_circle;
+    Line m_line;
+    LWPolyline m_lwPolyline;
+};
+
+// Constructs every record in place inside the containers of a Document.
+class DocumentSink final : public ReaderSink
+{
+public:
+    explicit DocumentSink(Document& document);
+
+    Header& beginHeader() override;
+    void endHeader() override;
+
+    LineType& beginLineType() override;
+    void endLineType() override;
+
+    Layer& beginLayer() override;
+    void endLayer() override;
+
+    Arc& beginArc() override;
+    void endArc() override;
+
+    Circle& beginCircle() override;
+    void endCircle() override;
+
+    Line& beginLine() override;
+    void endLine() override;
+
+    LWPolyline& beginLWPolyline() override;
+    void endLWPolyline() override;
+
+private:
+    Document& m_document;
+};
+
+}   // namespace odxf
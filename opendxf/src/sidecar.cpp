@@ -0,0 +1,631 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/sidecar.hpp"
+
+#include "opendxf/extents.hpp"
+#include "opendxf/outputsink.hpp"
+
+#include "binaryformat.hpp"
+#include "filebuffer.hpp"
+#include "hash.hpp"
+#include "moveappend.hpp"
+#include "parallel.hpp"
+#include "pathstring.hpp"
+#include "prescanner.hpp"
+#include "reader.hpp"
+#include "readersink.hpp"
+#include "sidecarwriter.hpp"
+#include "tracescope.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using odxf::Box2d;
+using odxf::EntityType;
+using odxf::alignUp;
+using odxf::byteOrderMark;
+using odxf::Error;
+using odxf::makeInvalidFile;
+using odxf::moveAppend;
+using odxf::pathToString;
+
+constexpr std::array<char, 8> fileMagic{ 'O', 'D', 'X', 'F', 'S', 'I', 'D', 'X' };
+constexpr std::uint32_t fileVersion{ 2 };
+
+// The content hash combines the hashes of blocks of this size, which are computed in
+// parallel when writing the index and while streaming the file when opening it.
+constexpr std::size_t hashBlockSize{ 1 << 20 };
+
+// Selected entities closer than this are read at once, reading the gap between them
+// costs about as much as another seek.
+constexpr std::uint64_t maxReadGap{ 64 << 10 };
+// Byte ranges read at once are at most this large, so large selections are parsed by
+// several threads.
+constexpr std::uint64_t maxReadSize{ 4 << 20 };
+
+// The file starts with the header, followed by the lengths of the layer names, their
+// characters and the records, each section aligned to 8 bytes.
+struct FileHeader final
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    // size and hashes of the DXF file, the prefix being the content up to the entities
+    std::uint64_t contentSize;
+    std::uint64_t contentHash;
+    std::uint64_t prefixHash;
+    // offsets of the first entity and of the group code 0 record ending the section
+    std::uint64_t entitiesOffset;
+    std::uint64_t entitiesEndOffset;
+    std::int32_t entitiesLineOffset;
+    std::uint32_t layerCount;
+    std::uint64_t layerCharacterCount;
+    std::uint64_t recordCount;
+};
+
+struct StoredRecord final
+{
+    std::uint64_t offset;
+    std::uint32_t size;
+    std::int32_t lineOffset;
+    // min x, min y, max x, max y
+    std::array<double, 4> box;
+    std::uint32_t layer;
+    std::uint8_t type;
+    std::array<std::uint8_t, 3> padding;
+};
+
+static_assert(sizeof(FileHeader) == 80 && std::is_trivially_copyable_v<FileHeader>);
+static_assert(sizeof(StoredRecord) == 56 && std::is_trivially_copyable_v<StoredRecord>);
+
+Error makeOpenError(const std::filesystem::path& filePath)
+{
+    return Error{
+        .type = Error::Type::FileOpenError,
+        .what = fmt::format("unable to open file {}", pathToString(filePath)),
+    };
+}
+
+bool isParsedType(std::uint8_t type)
+{
+    switch (static_cast<EntityType>(type)) {
+    case EntityType::Arc:
+    case EntityType::Circle:
+    case EntityType::Line:
+    case EntityType::LWPolyline:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Calls the function with the index-th entity of one of the parsed types.
+template <typename Function>
+auto withEntity(
+    const odxf::Entities& entities, EntityType type, std::size_t index, Function&& function)
+{
+    switch (type) {
+    case EntityType::Arc:
+        return function(entities.arcs[index]);
+    case EntityType::Circle:
+        return function(entities.circles[index]);
+    case EntityType::LWPolyline:
+        return function(entities.lwPolylines[index]);
+    default:
+        return function(entities.lines[index]);
+    }
+}
+
+std::size_t entityCount(const odxf::Entities& entities, EntityType type)
+{
+    switch (type) {
+    case EntityType::Arc:
+        return entities.arcs.size();
+    case EntityType::Circle:
+        return entities.circles.size();
+    case EntityType::Line:
+        return entities.lines.size();
+    case EntityType::LWPolyline:
+        return entities.lwPolylines.size();
+    default:
+        return 0;
+    }
+}
+
+std::uint64_t combinedHash(const std::vector<std::uint64_t>& blockHashes)
+{
+    return odxf::hash64(std::string_view{ reinterpret_cast<const char*>(blockHashes.data()),
+                                          blockHashes.size() * sizeof(std::uint64_t) });
+}
+
+std::uint64_t contentHash(std::string_view content, unsigned int threadCount)
+{
+    const std::size_t blockCount{ (content.size() + hashBlockSize - 1) / hashBlockSize };
+    std::vector<std::uint64_t> blockHashes(blockCount);
+    odxf::parallelFor(blockCount, threadCount, [&](std::size_t index) {
+        blockHashes[index] = odxf::hash64(content.substr(index * hashBlockSize, hashBlockSize));
+    });
+
+    return combinedHash(blockHashes);
+}
+
+// contentHash() of a file of the given size, read from its beginning.
+std::optional<std::uint64_t> streamHash(std::ifstream& stream, std::uint64_t size)
+{
+    std::vector<std::uint64_t> blockHashes;
+    std::string block(hashBlockSize, '\0');
+
+    stream.seekg(0);
+    for (std::uint64_t offset{ 0 }; offset < size; offset += hashBlockSize) {
+        const auto count{ static_cast<std::size_t>(std::min<std::uint64_t>(
+            hashBlockSize, size - offset)) };
+        if (!stream.read(block.data(), static_cast<std::streamsize>(count))) {
+            return std::nullopt;
+        }
+        blockHashes.push_back(odxf::hash64(std::string_view{ block.data(), count }));
+    }
+
+    return combinedHash(blockHashes);
+}
+
+template <typename T>
+void appendValue(std::string& output, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void padOutput(std::string& output)
+{
+    output.resize(alignUp(output.size()), '\0');
+}
+
+template <typename T>
+T loadValue(const std::string& input, std::uint64_t offset)
+{
+    T value;
+    std::memcpy(&value, input.data() + offset, sizeof(T));
+
+    return value;
+}
+
+tl::expected<void, Error> writeFile(const std::filesystem::path& filePath, std::string_view output)
+{
+    odxf::FileSink sink{ filePath };
+    if (tl::expected<void, Error> result = sink.openError(); !result) {
+        return result;
+    }
+    if (tl::expected<void, Error> result = sink.write(output); !result) {
+        return result;
+    }
+
+    return sink.close();
+}
+
+// A byte range of the DXF file holding the records [first, last) of a selection.
+struct ReadSpan final
+{
+    std::uint64_t begin{ 0 };
+    std::uint64_t end{ 0 };
+    std::size_t first{ 0 };
+    std::size_t last{ 0 };
+};
+
+}   // namespace
+
+namespace odxf {
+
+tl::expected<void, Error> writeSidecarIndex(
+    std::string_view content,
+    const Document& document,
+    const std::filesystem::path& indexPath,
+    unsigned int threadCount)
+{
+    OPENDXF_TRACE_SCOPE("writeSidecarIndex");
+
+    // the sections preceding the entities are read again to find the first entity
+    Document prefixDocument;
+    DocumentSink prefixSink{ prefixDocument };
+    Reader prefixReader{ prefixSink };
+    if (tl::expected<void, Error> result = prefixReader.readUntilEntities(content); !result) {
+        return result;
+    }
+
+    const std::size_t entitiesOffset{ prefixReader.position() };
+    const int entitiesLineOffset{ prefixReader.currentLine() };
+    const std::optional<std::vector<EntityRecord>> maybeRecords{
+        scanEntityRecords(content, entitiesOffset, entitiesLineOffset)
+    };
+    if (!maybeRecords) {
+        return tl::make_unexpected(makeInvalidFile("unsupported layout of the ENTITIES section"));
+    }
+    const std::vector<EntityRecord>& entityRecords{ *maybeRecords };
+
+    // The entities of each type are stored in the order of their records.
+    const Entities& entities{ document.entities };
+    const auto mismatch{ [] {
+        return tl::make_unexpected(
+            makeInvalidFile("the entities of the document do not match the file"));
+    } };
+
+    std::array<std::size_t, entityTypeCount> nextIndices{};
+    std::vector<StoredRecord> records;
+    std::vector<std::size_t> entityIndices;
+    records.reserve(entityRecords.size() - 1);
+    entityIndices.reserve(entityRecords.size() - 1);
+
+    std::unordered_map<std::string_view, std::uint32_t> layerIds;
+    std::vector<std::string_view> layers;
+    for (std::size_t i{ 0 }; i + 1 < entityRecords.size(); ++i) {
+        const std::optional<EntityType> type{ parsedEntityType(entityRecords[i].type) };
+        if (!type) {
+            continue;
+        }
+
+        std::size_t& index{ nextIndices[static_cast<std::size_t>(*type)] };
+        if (index == entityCount(entities, *type)) {
+            return mismatch();
+        }
+
+        // the entity followed by the group code 0 record of the next one
+        const std::uint64_t size{ entityRecords[i + 1].typeEnd - entityRecords[i].begin };
+        if (size > std::numeric_limits<std::uint32_t>::max()) {
+            return tl::make_unexpected(makeInvalidFile(
+                fmt::format("entity at line {} is too large", entityRecords[i].lineOffset)));
+        }
+
+        const std::string_view layer{ withEntity(
+            entities, *type, index, [](const Entity& entity) -> std::string_view {
+                return entity.layer;
+            }) };
+        const auto [layerId, isNewLayer]{ layerIds.try_emplace(
+            layer, static_cast<std::uint32_t>(layers.size())) };
+        if (isNewLayer) {
+            layers.push_back(layer);
+        }
+
+        records.push_back(StoredRecord{
+            .offset = entityRecords[i].begin,
+            .size = static_cast<std::uint32_t>(size),
+            .lineOffset = entityRecords[i].lineOffset,
+            .box = {},
+            .layer = layerId->second,
+            .type = static_cast<std::uint8_t>(*type),
+            .padding = {},
+        });
+        entityIndices.push_back(index++);
+    }
+
+    for (EntityType type :
+         { EntityType::Arc, EntityType::Circle, EntityType::Line, EntityType::LWPolyline }) {
+        if (nextIndices[static_cast<std::size_t>(type)] != entityCount(entities, type)) {
+            return mismatch();
+        }
+    }
+
+    {
+        OPENDXF_TRACE_SCOPE("boundSidecarRecords");
+
+        const unsigned int chunkCount{ resolveThreadCount(threadCount) };
+        parallelFor(chunkCount, chunkCount, [&](std::size_t index) {
+            const ChunkRange range{ chunkRange(records.size(), chunkCount, index) };
+            for (std::size_t i{ range.begin }; i < range.end; ++i) {
+                StoredRecord& record{ records[i] };
+                const Extents extents{ withEntity(
+                    entities,
+                    static_cast<EntityType>(record.type),
+                    entityIndices[i],
+                    [](const auto& entity) { return odxf::extents(entity); }) };
+                record.box = { extents.min.x, extents.min.y, extents.max.x, extents.max.y };
+            }
+        });
+    }
+
+    std::uint64_t layerCharacterCount{ 0 };
+    for (std::string_view layer : layers) {
+        layerCharacterCount += layer.size();
+    }
+
+    const FileHeader header{
+        .magic = fileMagic,
+        .version = fileVersion,
+        .byteOrder = byteOrderMark,
+        .contentSize = content.size(),
+        .contentHash = contentHash(content, threadCount),
+        .prefixHash = hash64(content.substr(0, entitiesOffset)),
+        .entitiesOffset = entitiesOffset,
+        .entitiesEndOffset = entityRecords.back().begin,
+        .entitiesLineOffset = entitiesLineOffset,
+        .layerCount = static_cast<std::uint32_t>(layers.size()),
+        .layerCharacterCount = layerCharacterCount,
+        .recordCount = records.size(),
+    };
+
+    std::string output;
+    output.reserve(alignUp(sizeof(FileHeader) + layers.size() * sizeof(std::uint32_t))
+                   + alignUp(layerCharacterCount) + records.size() * sizeof(StoredRecord));
+    appendValue(output, header);
+    for (std::string_view layer : layers) {
+        appendValue(output, static_cast<std::uint32_t>(layer.size()));
+    }
+    padOutput(output);
+    for (std::string_view layer : layers) {
+        output.append(layer);
+    }
+    padOutput(output);
+    output.append(
+        reinterpret_cast<const char*>(records.data()), records.size() * sizeof(StoredRecord));
+
+    // renamed when complete, so that readers never open a partial index
+    std::filesystem::path temporaryPath{ indexPath };
+    temporaryPath += fmt::format(".{:08x}.tmp", std::random_device{}());
+
+    std::error_code error;
+    if (tl::expected<void, Error> result = writeFile(temporaryPath, output); !result) {
+        std::filesystem::remove(temporaryPath, error);
+        return result;
+    }
+
+    std::filesystem::rename(temporaryPath, indexPath, error);
+    if (error) {
+        const std::string message{ error.message() };
+        std::filesystem::remove(temporaryPath, error);
+        return tl::make_unexpected(Error{
+            .type = Error::Type::FileWriteError,
+            .what = fmt::format("unable to write file {}: {}", pathToString(indexPath), message),
+        });
+    }
+
+    return {};
+}
+
+tl::expected<SidecarIndex, Error> SidecarIndex::open(
+    const std::filesystem::path& dxfPath,
+    const std::filesystem::path& indexPath,
+    const SidecarOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("openSidecarIndex");
+
+    const tl::expected<std::string, Error> maybeInput{ readFileContent(indexPath) };
+    if (!maybeInput) {
+        return tl::make_unexpected(maybeInput.error());
+    }
+    const std::string& input{ *maybeInput };
+    const std::string indexName{ pathToString(indexPath) };
+
+    if (input.size() < sizeof(FileHeader)) {
+        return tl::make_unexpected(
+            makeInvalidFile(fmt::format("{} is no sidecar index", indexName)));
+    }
+    const FileHeader header{ loadValue<FileHeader>(input, 0) };
+
+    if (header.magic != fileMagic) {
+        return tl::make_unexpected(
+            makeInvalidFile(fmt::format("{} is no sidecar index", indexName)));
+    }
+    if (header.byteOrder != byteOrderMark) {
+        return tl::make_unexpected(makeInvalidFile(
+            fmt::format("sidecar index {} was written with a different byte order", indexName)));
+    }
+    if (header.version != fileVersion) {
+        return tl::make_unexpected(makeInvalidFile(fmt::format(
+            "sidecar index {} has version {}, expected {}",
+            indexName,
+            header.version,
+            fileVersion)));
+    }
+
+    const std::uint64_t charactersOffset{ alignUp(
+        sizeof(FileHeader) + std::uint64_t{ header.layerCount } * sizeof(std::uint32_t)) };
+    const bool fits{ header.layerCharacterCount <= input.size()
+                     && header.recordCount <= input.size() / sizeof(StoredRecord) };
+    const std::uint64_t recordsOffset{ alignUp(charactersOffset + header.layerCharacterCount) };
+    if (!fits || recordsOffset + header.recordCount * sizeof(StoredRecord) != input.size()) {
+        return tl::make_unexpected(
+            makeInvalidFile(fmt::format("sidecar index {} is truncated", indexName)));
+    }
+
+    SidecarIndex result;
+    result.m_dxfPath = dxfPath;
+    result.m_options = options;
+
+    std::uint64_t characterOffset{ charactersOffset };
+    result.m_layers.reserve(header.layerCount);
+    for (std::uint32_t i{ 0 }; i < header.layerCount; ++i) {
+        const auto length{ loadValue<std::uint32_t>(
+            input, sizeof(FileHeader) + i * sizeof(std::uint32_t)) };
+        if (length > charactersOffset + header.layerCharacterCount - characterOffset) {
+            return tl::make_unexpected(makeInvalidFile(
+                fmt::format("sidecar index {} has an invalid layer table", indexName)));
+        }
+
+        result.m_layers.emplace_back(input.data() + characterOffset, length);
+        characterOffset += length;
+    }
+
+    result.m_records.reserve(header.recordCount);
+    for (std::uint64_t i{ 0 }; i < header.recordCount; ++i) {
+        const auto stored{ loadValue<StoredRecord>(
+            input, recordsOffset + i * sizeof(StoredRecord)) };
+        const bool isValid{ isParsedType(stored.type) && stored.layer < header.layerCount
+                            && stored.offset >= header.entitiesOffset
+                            && stored.offset < header.entitiesEndOffset
+                            && header.entitiesEndOffset <= header.contentSize
+                            && stored.size <= header.contentSize - stored.offset };
+        if (!isValid) {
+            return tl::make_unexpected(
+                makeInvalidFile(fmt::format("sidecar index {} has invalid records", indexName)));
+        }
+
+        result.m_records.push_back(Record{
+            .offset = stored.offset,
+            .size = stored.size,
+            .lineOffset = stored.lineOffset,
+            .box = Box2d{ .min = { stored.box[0], stored.box[1] },
+                          .max = { stored.box[2], stored.box[3] } },
+            .layer = stored.layer,
+            .type = static_cast<EntityType>(stored.type),
+        });
+    }
+
+    // The DXF file must be the one the index was written for.
+    const auto outdated{ [&] {
+        return tl::make_unexpected(makeInvalidFile(fmt::format(
+            "sidecar index {} does not match {}", indexName, pathToString(dxfPath))));
+    } };
+
+    std::error_code errorCode;
+    const std::uintmax_t fileSize{ std::filesystem::file_size(dxfPath, errorCode) };
+    std::ifstream stream{ dxfPath, std::ios::binary };
+    if (errorCode || !stream.is_open()) {
+        return tl::make_unexpected(makeOpenError(dxfPath));
+    }
+    if (fileSize != header.contentSize || header.entitiesOffset > fileSize) {
+        return outdated();
+    }
+
+    std::string prefix(static_cast<std::size_t>(header.entitiesOffset), '\0');
+    if (!stream.read(prefix.data(), static_cast<std::streamsize>(prefix.size()))) {
+        return outdated();
+    }
+    if (hash64(prefix) != header.prefixHash) {
+        return outdated();
+    }
+
+    if (options.verifyContent) {
+        OPENDXF_TRACE_SCOPE("verifySidecarContent");
+
+        const std::optional<std::uint64_t> hash{ streamHash(stream, fileSize) };
+        if (!hash || *hash != header.contentHash) {
+            return outdated();
+        }
+    }
+
+    DocumentSink sink{ result.m_document };
+    Reader reader{ sink };
+    if (tl::expected<void, Error> readResult = reader.readUntilEntities(prefix); !readResult) {
+        return tl::make_unexpected(readResult.error());
+    }
+
+    return result;
+}
+
+tl::expected<Entities, Error> SidecarIndex::read(const SidecarQuery& query) const
+{
+    OPENDXF_TRACE_SCOPE("readSidecarEntities");
+
+    std::vector<bool> isLayerSelected(m_layers.size(), query.layers.empty());
+    for (const std::string& name : query.layers) {
+        const auto iter{ std::find(m_layers.begin(), m_layers.end(), name) };
+        if (iter != m_layers.end()) {
+            isLayerSelected[static_cast<std::size_t>(iter - m_layers.begin())] = true;
+        }
+    }
+
+    const auto isSelected{ [&](const Record& record) {
+        if (!isLayerSelected[record.layer]) {
+            return false;
+        }
+        if (!query.window) {
+            return true;
+        }
+
+        const Box2d& window{ *query.window };
+        return record.box.min.x <= window.max.x && window.min.x <= record.box.max.x
+               && record.box.min.y <= window.max.y && window.min.y <= record.box.max.y;
+    } };
+
+    // the records are in the order of the file, close ones are read together
+    std::vector<std::size_t> selected;
+    std::vector<ReadSpan> spans;
+    for (std::size_t i{ 0 }; i < m_records.size(); ++i) {
+        const Record& record{ m_records[i] };
+        if (!isSelected(record)) {
+            continue;
+        }
+
+        const std::uint64_t end{ record.offset + record.size };
+        if (!spans.empty() && record.offset <= spans.back().end + maxReadGap
+            && end - spans.back().begin <= maxReadSize) {
+            spans.back().end = end;
+        } else {
+            spans.push_back(ReadSpan{
+                .begin = record.offset,
+                .end = end,
+                .first = selected.size(),
+            });
+        }
+
+        selected.push_back(i);
+        spans.back().last = selected.size();
+    }
+
+    std::vector<std::string> buffers(spans.size());
+    {
+        OPENDXF_TRACE_SCOPE("readSidecarSpans");
+
+        std::ifstream stream{ m_dxfPath, std::ios::binary };
+        if (!stream.is_open()) {
+            return tl::make_unexpected(makeOpenError(m_dxfPath));
+        }
+
+        for (std::size_t i{ 0 }; i < spans.size(); ++i) {
+            buffers[i].resize(static_cast<std::size_t>(spans[i].end - spans[i].begin));
+            stream.seekg(static_cast<std::streamoff>(spans[i].begin));
+            if (!stream.read(buffers[i].data(), static_cast<std::streamsize>(buffers[i].size()))) {
+                return tl::make_unexpected(Error{
+                    .type = Error::Type::FileOpenError,
+                    .what = fmt::format("unable to read file {}", pathToString(m_dxfPath)),
+                });
+            }
+        }
+    }
+
+    std::vector<Document> spanDocuments(spans.size());
+    std::vector<tl::expected<void, Error>> spanResults(spans.size());
+    parallelFor(spans.size(), m_options.threadCount, [&](std::size_t index) {
+        const ReadSpan& span{ spans[index] };
+        const std::string_view buffer{ buffers[index] };
+
+        DocumentSink sink{ spanDocuments[index] };
+        Reader reader{ sink };
+        for (std::size_t i{ span.first }; i < span.last && spanResults[index]; ++i) {
+            const Record& record{ m_records[selected[i]] };
+            spanResults[index] = reader.readEntityChunk(
+                buffer.substr(record.offset - span.begin, record.size), record.lineOffset);
+        }
+    });
+
+    Entities result;
+    for (std::size_t i{ 0 }; i < spans.size(); ++i) {
+        if (!spanResults[i]) {
+            return tl::make_unexpected(spanResults[i].error());
+        }
+
+        moveAppend(result, spanDocuments[i].entities);
+    }
+
+    return result;
+}
+
+tl::expected<Entities, Error> SidecarIndex::read(const Box2d& window) const
+{
+    return read(SidecarQuery{ .window = window });
+}
+
+}   // namespace odxf
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/document.hpp"
+#include "opendxf/error.hpp"
+
+#include <tl/expected.hpp>
+
+#include <filesystem>
+#include <string_view>
+
+namespace odxf {
+
+// Writes the sidecar index of a DXF file's content, the document having been read from it.
+tl::expected<void, Error> writeSidecarIndex(
+    std::string_view content,
+    const Document& document,
+    const std::filesystem::path& indexPath,
+    unsigned int threadCount);
+
+}   // namespace odxf
@@ -0,0 +1,1392 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/snapshot.hpp"
+
+#include "opendxf/outputsink.hpp"
+
+#include "binaryformat.hpp"
+#include "pathstring.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define OPENDXF_HAS_MMAP 1
+#endif
+
+namespace {
+
+using odxf::alignUp;
+using odxf::byteOrderMark;
+using odxf::sectionAlignment;
+
+constexpr std::array<char, 8> fileMagic{ 'O', 'D', 'X', 'F', 'S', 'N', 'A', 'P' };
+constexpr std::uint32_t fileVersion{ 1 };
+
+struct FileHeader final
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t sectionCount;
+};
+
+struct SectionEntry final
+{
+    std::uint32_t id;
+    std::uint32_t elementSize;
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+struct HeaderRecord final
+{
+    std::uint32_t key;
+    // index of the alternative of odxf::HeaderValue
+    std::uint32_t type;
+    std::int32_t integer;
+    std::uint32_t string;
+    std::array<double, 3> values;
+};
+
+struct LineTypeRecord final
+{
+    std::uint32_t name;
+    std::uint32_t displayName;
+    std::int32_t flags;
+    std::uint32_t padding;
+};
+
+struct LayerRecord final
+{
+    std::uint32_t name;
+    std::int32_t color;
+    std::int32_t flags;
+    std::int32_t lineType;
+};
+
+static_assert(sizeof(FileHeader) == 24 && std::is_trivially_copyable_v<FileHeader>);
+static_assert(sizeof(SectionEntry) == 24 && std::is_trivially_copyable_v<SectionEntry>);
+static_assert(sizeof(HeaderRecord) == 40 && std::is_trivially_copyable_v<HeaderRecord>);
+static_assert(sizeof(LineTypeRecord) == 16 && std::is_trivially_copyable_v<LineTypeRecord>);
+static_assert(sizeof(LayerRecord) == 16 && std::is_trivially_copyable_v<LayerRecord>);
+
+namespace section {
+
+constexpr std::uint32_t stringOffsets{ 1 };
+constexpr std::uint32_t stringCharacters{ 2 };
+constexpr std::uint32_t headerEntries{ 3 };
+constexpr std::uint32_t lineTypes{ 4 };
+constexpr std::uint32_t layers{ 5 };
+
+// The columns of entity type t have the ids 0x100 * t + column.
+constexpr std::uint32_t layerColumn{ 0 };
+constexpr std::uint32_t colorColumn{ 1 };
+constexpr std::uint32_t flagsColumn{ 2 };
+constexpr std::uint32_t firstValueColumn{ 3 };
+constexpr std::uint32_t vertexOffsetsColumn{ 0x80 };
+constexpr std::uint32_t vertexXColumn{ 0x81 };
+constexpr std::uint32_t vertexYColumn{ 0x82 };
+constexpr std::uint32_t vertexBulgeColumn{ 0x83 };
+constexpr std::uint32_t vertexFlagsColumn{ 0x84 };
+
+constexpr std::uint32_t entityColumn(std::uint32_t entityType, std::uint32_t column)
+{
+    return 0x100 * entityType + column;
+}
+
+}   // namespace section
+
+// bits of the flags column
+constexpr std::uint8_t hasExtrusion{ 1 };
+constexpr std::uint8_t hasThickness{ 2 };
+constexpr std::uint8_t hasElevation{ 4 };
+constexpr std::uint8_t isClosed{ 8 };
+constexpr std::uint8_t hasBulge{ 1 };
+
+constexpr std::uint32_t noString{ 0xffffffff };
+
+// Stores the members of an entity, except layer and color, as doubles plus flags.
+template <typename T>
+struct EntityColumns;
+
+class ValueWriter final
+{
+public:
+    explicit ValueWriter(double* values)
+        : m_values{ values }
+    {
+    }
+
+    void put(double value) { *m_values++ = value; }
+
+    void put(const odxf::Coordinate3d& coordinate)
+    {
+        put(coordinate.x);
+        put(coordinate.y);
+        put(coordinate.z);
+    }
+
+    void put(const odxf::Vector3d& vector)
+    {
+        put(vector.x);
+        put(vector.y);
+        put(vector.z);
+    }
+
+    void put(const std::optional<odxf::Vector3d>& vector, std::uint8_t& flags)
+    {
+        put(vector.value_or(odxf::Vector3d{}));
+        flags |= vector ? hasExtrusion : std::uint8_t{ 0 };
+    }
+
+    void put(const std::optional<double>& value, std::uint8_t bit, std::uint8_t& flags)
+    {
+        put(value.value_or(0.0));
+        flags |= value ? bit : std::uint8_t{ 0 };
+    }
+
+private:
+    double* m_values;
+};
+
+class ValueReader final
+{
+public:
+    explicit ValueReader(const double* values)
+        : m_values{ values }
+    {
+    }
+
+    void get(double& value) { value = *m_values++; }
+
+    void get(odxf::Coordinate3d& coordinate)
+    {
+        get(coordinate.x);
+        get(coordinate.y);
+        get(coordinate.z);
+    }
+
+    void get(odxf::Vector3d& vector)
+    {
+        get(vector.x);
+        get(vector.y);
+        get(vector.z);
+    }
+
+    void get(std::optional<odxf::Vector3d>& vector, std::uint8_t flags)
+    {
+        odxf::Vector3d value;
+        get(value);
+        if ((flags & hasExtrusion) != 0) {
+            vector = value;
+        }
+    }
+
+    void get(std::optional<double>& value, std::uint8_t bit, std::uint8_t flags)
+    {
+        double stored{ 0.0 };
+        get(stored);
+        if ((flags & bit) != 0) {
+            value = stored;
+        }
+    }
+
+private:
+    const double* m_values;
+};
+
+template <>
+struct EntityColumns<odxf::Arc>
+{
+    static constexpr std::uint32_t type{ 1 };
+    static constexpr std::size_t valueCount{ 10 };
+
+    static void store(const odxf::Arc& arc, ValueWriter& writer, std::uint8_t& flags)
+    {
+        writer.put(arc.center);
+        writer.put(arc.radius);
+        writer.put(arc.startAngle);
+        writer.put(arc.endAngle);
+        writer.put(arc.extrusion, flags);
+        writer.put(arc.thickness, hasThickness, flags);
+    }
+
+    static void load(odxf::Arc& arc, ValueReader& reader, std::uint8_t flags)
+    {
+        reader.get(arc.center);
+        reader.get(arc.radius);
+        reader.get(arc.startAngle);
+        reader.get(arc.endAngle);
+        reader.get(arc.extrusion, flags);
+        reader.get(arc.thickness, hasThickness, flags);
+    }
+};
+
+template <>
+struct EntityColumns<odxf::Circle>
+{
+    static constexpr std::uint32_t type{ 2 };
+    static constexpr std::size_t valueCount{ 8 };
+
+    static void store(const odxf::Circle& circle, ValueWriter& writer, std::uint8_t& flags)
+    {
+        writer.put(circle.center);
+        writer.put(circle.radius);
+        writer.put(circle.extrusion, flags);
+        writer.put(circle.thickness, hasThickness, flags);
+    }
+
+    static void load(odxf::Circle& circle, ValueReader& reader, std::uint8_t flags)
+    {
+        reader.get(circle.center);
+        reader.get(circle.radius);
+        reader.get(circle.extrusion, flags);
+        reader.get(circle.thickness, hasThickness, flags);
+    }
+};
+
+template <>
+struct EntityColumns<odxf::Ellipse>
+{
+    static constexpr std::uint32_t type{ 3 };
+    static constexpr std::size_t valueCount{ 12 };
+
+    static void store(const odxf::Ellipse& ellipse, ValueWriter& writer, std::uint8_t& flags)
+    {
+        writer.put(ellipse.center);
+        writer.put(ellipse.endPointMajor);
+        writer.put(ellipse.axisRatio);
+        writer.put(ellipse.startParameter);
+        writer.put(ellipse.endParameter);
+        writer.put(ellipse.extrusion, flags);
+    }
+
+    static void load(odxf::Ellipse& ellipse, ValueReader& reader, std::uint8_t flags)
+    {
+        reader.get(ellipse.center);
+        reader.get(ellipse.endPointMajor);
+        reader.get(ellipse.axisRatio);
+        reader.get(ellipse.startParameter);
+        reader.get(ellipse.endParameter);
+        reader.get(ellipse.extrusion, flags);
+    }
+};
+
+template <>
+struct EntityColumns<odxf::Line>
+{
+    static constexpr std::uint32_t type{ 4 };
+    static constexpr std::size_t valueCount{ 10 };
+
+    static void store(const odxf::Line& line, ValueWriter& writer, std::uint8_t& flags)
+    {
+        writer.put(line.start);
+        writer.put(line.end);
+        writer.put(line.extrusion, flags);
+        writer.put(line.thickness, hasThickness, flags);
+    }
+
+    static void load(odxf::Line& line, ValueReader& reader, std::uint8_t flags)
+    {
+        reader.get(line.start);
+        reader.get(line.end);
+        reader.get(line.extrusion, flags);
+        reader.get(line.thickness, hasThickness, flags);
+    }
+};
+
+template <>
+struct EntityColumns<odxf::Point>
+{
+    static constexpr std::uint32_t type{ 5 };
+    static constexpr std::size_t valueCount{ 7 };
+
+    static void store(const odxf::Point& point, ValueWriter& writer, std::uint8_t& flags)
+    {
+        writer.put(point.coordinate);
+        writer.put(point.extrusion, flags);
+        writer.put(point.thickness, hasThickness, flags);
+    }
+
+    static void load(odxf::Point& point, ValueReader& reader, std::uint8_t flags)
+    {
+        reader.get(point.coordinate);
+        reader.get(point.extrusion, flags);
+        reader.get(point.thickness, hasThickness, flags);
+    }
+};
+
+template <>
+struct EntityColumns<odxf::LWPolyline>
+{
+    static constexpr std::uint32_t type{ 6 };
+    static constexpr std::size_t valueCount{ 1 };
+
+    static void
+    store(const odxf::LWPolyline& lwPolyline, ValueWriter& writer, std::uint8_t& flags)
+    {
+        writer.put(lwPolyline.elevation, hasElevation, flags);
+        flags |= lwPolyline.isClosed ? isClosed : std::uint8_t{ 0 };
+    }
+
+    static void load(odxf::LWPolyline& lwPolyline, ValueReader& reader, std::uint8_t flags)
+    {
+        reader.get(lwPolyline.elevation, hasElevation, flags);
+        lwPolyline.isClosed = (flags & isClosed) != 0;
+    }
+};
+
+template <>
+struct EntityColumns<odxf::Ray>
+{
+    static constexpr std::uint32_t type{ 7 };
+    static constexpr std::size_t valueCount{ 6 };
+
+    static void store(const odxf::Ray& ray, ValueWriter& writer, std::uint8_t& /* flags */)
+    {
+        writer.put(ray.startPoint);
+        writer.put(ray.direction);
+    }
+
+    static void load(odxf::Ray& ray, ValueReader& reader, std::uint8_t /* flags */)
+    {
+        reader.get(ray.startPoint);
+        reader.get(ray.direction);
+    }
+};
+
+// indexed by the types of the entity columns, which start at 1
+constexpr std::size_t entityTableCount{ 8 };
+constexpr std::size_t maxValueCount{ 12 };
+
+// Collects the output in blocks and passes them on to the sink.
+class BlockOutput final
+{
+public:
+    explicit BlockOutput(odxf::IOutputSink& sink)
+        : m_sink{ sink }
+    {
+        m_block.reserve(blockSize);
+    }
+
+    template <typename T>
+    void append(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(&value, sizeof(T));
+    }
+
+    // Large data, e.g. a whole column, is passed on in blocks as well.
+    void append(const void* data, std::size_t size)
+    {
+        const char* bytes{ static_cast<const char*>(data) };
+        m_written += size;
+        while (size > 0) {
+            const std::size_t chunk{ std::min(size, blockSize - m_block.size()) };
+            m_block.append(bytes, chunk);
+            bytes += chunk;
+            size -= chunk;
+            if (m_block.size() >= blockSize) {
+                flush();
+            }
+        }
+    }
+
+    void padTo(std::uint64_t offset)
+    {
+        static constexpr std::array<char, sectionAlignment> zeros{};
+        append(zeros.data(), static_cast<std::size_t>(offset - m_written));
+    }
+
+    std::uint64_t written() const { return m_written; }
+
+    tl::expected<void, odxf::Error> finish()
+    {
+        flush();
+        if (m_error) {
+            return tl::make_unexpected(*m_error);
+        }
+
+        return m_sink.close();
+    }
+
+private:
+    static constexpr std::size_t blockSize{ 1 << 20 };
+
+    void flush()
+    {
+        if (!m_error && !m_block.empty()) {
+            if (tl::expected<void, odxf::Error> result = m_sink.write(m_block); !result) {
+                m_error = std::move(result.error());
+            }
+        }
+        m_block.clear();
+    }
+
+    odxf::IOutputSink& m_sink;
+    std::string m_block;
+    std::uint64_t m_written{ 0 };
+    std::optional<odxf::Error> m_error;
+};
+
+class SnapshotWriter final
+{
+public:
+    explicit SnapshotWriter(const odxf::Document& document)
+        : m_document{ document }
+    {
+        collectStrings();
+
+        addSection(
+            section::stringOffsets,
+            sizeof(std::uint64_t),
+            m_strings.size() + 1,
+            [this](BlockOutput& output) {
+                std::uint64_t offset{ 0 };
+                output.append(offset);
+                for (std::string_view text : m_strings) {
+                    offset += text.size();
+                    output.append(offset);
+                }
+            });
+        addSection(section::stringCharacters, 1, m_characterCount, [this](BlockOutput& output) {
+            for (std::string_view text : m_strings) {
+                output.append(text.data(), text.size());
+            }
+        });
+
+        addHeaderSection();
+        addTableSections();
+
+        const odxf::Entities& entities{ document.entities };
+        addEntitySections(entities.arcs);
+        addEntitySections(entities.circles);
+        addEntitySections(entities.ellipses);
+        addEntitySections(entities.lines);
+        addEntitySections(entities.points);
+        addEntitySections(entities.lwPolylines);
+        addEntitySections(entities.rays);
+    }
+
+    tl::expected<void, odxf::Error> write(odxf::IOutputSink& sink)
+    {
+        const std::uint64_t tableEnd{ sizeof(FileHeader)
+                                      + m_sections.size() * sizeof(SectionEntry) };
+
+        std::vector<SectionEntry> entries;
+        entries.reserve(m_sections.size());
+        std::uint64_t offset{ alignUp(tableEnd) };
+        for (const PlannedSection& planned : m_sections) {
+            entries.push_back(SectionEntry{
+                .id = planned.id,
+                .elementSize = planned.elementSize,
+                .offset = offset,
+                .count = planned.count,
+            });
+            offset = alignUp(offset + planned.elementSize * planned.count);
+        }
+
+        if (tl::expected<void, odxf::Error> result = sink.reserve(offset); !result) {
+            return result;
+        }
+
+        BlockOutput output{ sink };
+        output.append(FileHeader{
+            .magic = fileMagic,
+            .version = fileVersion,
+            .byteOrder = byteOrderMark,
+            .sectionCount = m_sections.size(),
+        });
+        for (const SectionEntry& entry : entries) {
+            output.append(entry);
+        }
+
+        for (std::size_t i{ 0 }; i < m_sections.size(); ++i) {
+            output.padTo(entries[i].offset);
+            m_sections[i].write(output);
+        }
+        output.padTo(offset);
+
+        return output.finish();
+    }
+
+private:
+    struct PlannedSection final
+    {
+        std::uint32_t id;
+        std::uint32_t elementSize;
+        std::uint64_t count;
+        std::function<void(BlockOutput&)> write;
+    };
+
+    struct StoredEntities final
+    {
+        std::vector<std::uint8_t> flags;
+        std::vector<double> values;
+    };
+
+    void addSection(
+        std::uint32_t id,
+        std::size_t elementSize,
+        std::size_t count,
+        std::function<void(BlockOutput&)> write)
+    {
+        m_sections.push_back(PlannedSection{
+            .id = id,
+            .elementSize = static_cast<std::uint32_t>(elementSize),
+            .count = count,
+            .write = std::move(write),
+        });
+    }
+
+    void collectStrings()
+    {
+        for (const auto& [key, value] : m_document.header.entries) {
+            intern(key);
+            if (const std::string* text = std::get_if<std::string>(&value)) {
+                intern(*text);
+            }
+        }
+
+        for (const odxf::LineType& lineType : m_document.tables.lineTypes) {
+            intern(lineType.name);
+            intern(lineType.displayName);
+        }
+
+        for (const odxf::Layer& layer : m_document.tables.layers) {
+            intern(layer.name);
+        }
+
+        const auto internLayers{ [this](const auto& entities) {
+            for (const auto& entity : entities) {
+                intern(entity.layer);
+            }
+        } };
+        const odxf::Entities& entities{ m_document.entities };
+        internLayers(entities.arcs);
+        internLayers(entities.circles);
+        internLayers(entities.ellipses);
+        internLayers(entities.lines);
+        internLayers(entities.points);
+        internLayers(entities.lwPolylines);
+        internLayers(entities.rays);
+    }
+
+    std::uint32_t intern(std::string_view text)
+    {
+        const auto [iter, isNew]{
+            m_stringIndices.try_emplace(text, static_cast<std::uint32_t>(m_strings.size()))
+        };
+        if (isNew) {
+            m_strings.push_back(text);
+            m_characterCount += text.size();
+        }
+
+        return iter->second;
+    }
+
+    std::uint32_t stringIndex(std::string_view text) const { return m_stringIndices.at(text); }
+
+    void addHeaderSection()
+    {
+        const auto& entries{ m_document.header.entries };
+        addSection(
+            section::headerEntries,
+            sizeof(HeaderRecord),
+            entries.size(),
+            [this](BlockOutput& output) {
+                for (const auto& [key, value] : m_document.header.entries) {
+                    HeaderRecord record{
+                        .key = stringIndex(key),
+                        .type = static_cast<std::uint32_t>(value.index()),
+                        .integer = 0,
+                        .string = noString,
+                        .values = {},
+                    };
+                    std::visit(
+                        [&](const auto& alternative) {
+                            using T = std::decay_t<decltype(alternative)>;
+                            if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int>) {
+                                record.integer = static_cast<std::int32_t>(alternative);
+                            } else if constexpr (std::is_same_v<T, double>) {
+                                record.values[0] = alternative;
+                            } else if constexpr (std::is_same_v<T, std::string>) {
+                                record.string = stringIndex(alternative);
+                            } else if constexpr (std::is_same_v<T, odxf::Coordinate2d>) {
+                                record.values = { alternative.x, alternative.y, 0.0 };
+                            } else {
+                                record.values = { alternative.x, alternative.y, alternative.z };
+                            }
+                        },
+                        value);
+                    output.append(record);
+                }
+            });
+    }
+
+    void addTableSections()
+    {
+        const odxf::Tables& tables{ m_document.tables };
+
+        addSection(
+            section::lineTypes,
+            sizeof(LineTypeRecord),
+            tables.lineTypes.size(),
+            [this](BlockOutput& output) {
+                for (const odxf::LineType& lineType : m_document.tables.lineTypes) {
+                    output.append(LineTypeRecord{
+                        .name = stringIndex(lineType.name),
+                        .displayName = stringIndex(lineType.displayName),
+                        .flags = lineType.flags,
+                        .padding = 0,
+                    });
+                }
+            });
+
+        addSection(
+            section::layers,
+            sizeof(LayerRecord),
+            tables.layers.size(),
+            [this](BlockOutput& output) {
+                for (const odxf::Layer& layer : m_document.tables.layers) {
+                    output.append(LayerRecord{
+                        .name = stringIndex(layer.name),
+                        .color = layer.color,
+                        .flags = static_cast<std::int32_t>(layer.flags),
+                        .lineType = layer.lineType,
+                    });
+                }
+            });
+    }
+
+    template <typename T>
+    void addEntitySections(const std::vector<T>& entities)
+    {
+        using Columns = EntityColumns<T>;
+        const auto columnId{ [](std::uint32_t column) {
+            return section::entityColumn(Columns::type, column);
+        } };
+
+        addSection(
+            columnId(section::layerColumn),
+            sizeof(std::uint32_t),
+            entities.size(),
+            [this, &entities](BlockOutput& output) {
+                for (const T& entity : entities) {
+                    output.append(stringIndex(entity.layer));
+                }
+            });
+        addSection(
+            columnId(section::colorColumn),
+            sizeof(std::int32_t),
+            entities.size(),
+            [&entities](BlockOutput& output) {
+                for (const T& entity : entities) {
+                    output.append(static_cast<std::int32_t>(entity.color));
+                }
+            });
+
+        // Every entity is stored once when the flags column is written, its values are kept
+        // column by column until the last value column is written.
+        const auto stored{ std::make_shared<StoredEntities>() };
+        addSection(
+            columnId(section::flagsColumn),
+            1,
+            entities.size(),
+            [&entities, stored](BlockOutput& output) {
+                const std::size_t count{ entities.size() };
+                stored->flags.assign(count, 0);
+                stored->values.resize(count * Columns::valueCount);
+                std::array<double, Columns::valueCount> values;
+                for (std::size_t i{ 0 }; i < count; ++i) {
+                    ValueWriter writer{ values.data() };
+                    Columns::store(entities[i], writer, stored->flags[i]);
+                    for (std::size_t column{ 0 }; column < Columns::valueCount; ++column) {
+                        stored->values[column * count + i] = values[column];
+                    }
+                }
+                output.append(stored->flags.data(), count);
+                stored->flags = {};
+            });
+
+        for (std::size_t column{ 0 }; column < Columns::valueCount; ++column) {
+            addSection(
+                columnId(section::firstValueColumn + static_cast<std::uint32_t>(column)),
+                sizeof(double),
+                entities.size(),
+                [column, count = entities.size(), stored](BlockOutput& output) {
+                    output.append(stored->values.data() + column * count, count * sizeof(double));
+                    if (column + 1 == Columns::valueCount) {
+                        stored->values = {};
+                    }
+                });
+        }
+
+        if constexpr (std::is_same_v<T, odxf::LWPolyline>) {
+            addVertexSections(entities);
+        }
+    }
+
+    void addVertexSections(const odxf::LWPolylines& lwPolylines)
+    {
+        const auto columnId{ [](std::uint32_t column) {
+            return section::entityColumn(EntityColumns<odxf::LWPolyline>::type, column);
+        } };
+
+        std::size_t vertexCount{ 0 };
+        for (const odxf::LWPolyline& lwPolyline : lwPolylines) {
+            vertexCount += lwPolyline.vertices.size();
+        }
+
+        addSection(
+            columnId(section::vertexOffsetsColumn),
+            sizeof(std::uint64_t),
+            lwPolylines.size() + 1,
+            [&lwPolylines](BlockOutput& output) {
+                std::uint64_t offset{ 0 };
+                output.append(offset);
+                for (const odxf::LWPolyline& lwPolyline : lwPolylines) {
+                    offset += lwPolyline.vertices.size();
+                    output.append(offset);
+                }
+            });
+
+        const auto addVertexColumn{ [&](std::uint32_t column, std::size_t elementSize, auto get) {
+            addSection(
+                columnId(column),
+                elementSize,
+                vertexCount,
+                [&lwPolylines, get](BlockOutput& output) {
+                    for (const odxf::LWPolyline& lwPolyline : lwPolylines) {
+                        for (const odxf::Vertex& vertex : lwPolyline.vertices) {
+                            output.append(get(vertex));
+                        }
+                    }
+                });
+        } };
+        addVertexColumn(section::vertexXColumn, sizeof(double), [](const odxf::Vertex& vertex) {
+            return vertex.position.x;
+        });
+        addVertexColumn(section::vertexYColumn, sizeof(double), [](const odxf::Vertex& vertex) {
+            return vertex.position.y;
+        });
+        addVertexColumn(section::vertexBulgeColumn, sizeof(double), [](const odxf::Vertex& vertex) {
+            return vertex.bulge.value_or(0.0);
+        });
+        addVertexColumn(section::vertexFlagsColumn, 1, [](const odxf::Vertex& vertex) {
+            return vertex.bulge ? hasBulge : std::uint8_t{ 0 };
+        });
+    }
+
+    const odxf::Document& m_document;
+    std::vector<std::string_view> m_strings;
+    std::unordered_map<std::string_view, std::uint32_t> m_stringIndices;
+    std::size_t m_characterCount{ 0 };
+    std::vector<PlannedSection> m_sections;
+};
+
+// Read-only contents of a snapshot file, mapped into memory where supported.
+class FileMapping final
+{
+public:
+    FileMapping() = default;
+    ~FileMapping()
+    {
+#ifdef OPENDXF_HAS_MMAP
+        if (m_mapped != nullptr) {
+            ::munmap(m_mapped, m_size);
+        }
+#endif
+    }
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    tl::expected<void, odxf::Error> open(const std::filesystem::path& filePath)
+    {
+        const auto openError{ [&filePath] {
+            return tl::make_unexpected(odxf::Error{
+                .type = odxf::Error::Type::FileOpenError,
+                .what = fmt::format("unable to open file {}", odxf::pathToString(filePath)),
+            });
+        } };
+
+#ifdef OPENDXF_HAS_MMAP
+        const int fileDescriptor{ ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (fileDescriptor < 0) {
+            return openError();
+        }
+
+        struct stat status{};
+        if (::fstat(fileDescriptor, &status) != 0) {
+            ::close(fileDescriptor);
+
+            return openError();
+        }
+
+        m_size = static_cast<std::size_t>(status.st_size);
+        if (m_size != 0) {
+            void* mapped{ ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) };
+            if (mapped == MAP_FAILED) {
+                ::close(fileDescriptor);
+
+                return openError();
+            }
+            m_mapped = mapped;
+            m_data = static_cast<const std::byte*>(mapped);
+        }
+        ::close(fileDescriptor);
+#else
+        std::ifstream stream{ filePath, std::ios::binary | std::ios::ate };
+        if (!stream.is_open()) {
+            return openError();
+        }
+
+        m_size = static_cast<std::size_t>(stream.tellg());
+        // 64 bit elements keep the sections aligned as in a mapping
+        m_buffer.resize((m_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+        stream.seekg(0);
+        char* buffer{ reinterpret_cast<char*>(m_buffer.data()) };
+        if (!stream.read(buffer, static_cast<std::streamsize>(m_size))) {
+            return openError();
+        }
+        m_data = reinterpret_cast<const std::byte*>(m_buffer.data());
+#endif
+
+        return {};
+    }
+
+    const std::byte* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const std::byte* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+#ifdef OPENDXF_HAS_MMAP
+    void* m_mapped{ nullptr };
+#else
+    std::vector<std::uint64_t> m_buffer;
+#endif
+};
+
+template <typename T>
+struct Column final
+{
+    const T* data{ nullptr };
+    std::size_t count{ 0 };
+};
+
+}   // namespace
+
+namespace odxf {
+
+struct Snapshot::Impl final
+{
+    struct EntityTable final
+    {
+        std::size_t count{ 0 };
+        const std::uint32_t* layers{ nullptr };
+        const std::int32_t* colors{ nullptr };
+        const std::uint8_t* flags{ nullptr };
+        std::array<const double*, maxValueCount> values{};
+    };
+
+    tl::expected<void, Error> load(const std::filesystem::path& filePath);
+
+    template <typename T>
+    tl::expected<Column<T>, Error> column(std::uint32_t id) const;
+
+    template <typename T>
+    tl::expected<void, Error> loadEntityTable();
+
+    tl::expected<void, Error> loadVertices();
+
+    std::string_view string(std::uint32_t index) const
+    {
+        if (index + std::size_t{ 1 } >= stringOffsets.count) {
+            return {};
+        }
+
+        const std::uint64_t begin{ stringOffsets.data[index] };
+        const std::uint64_t end{ stringOffsets.data[index + 1] };
+
+        return std::string_view{ stringCharacters.data + begin, end - begin };
+    }
+
+    template <typename T>
+    T entity(std::size_t index) const;
+
+    template <typename T>
+    EntityView<T> view() const
+    {
+        return EntityView<T>{ *this, 0, entityTables[EntityColumns<T>::type].count };
+    }
+
+    FileMapping mapping;
+    std::unordered_map<std::uint32_t, SectionEntry> sections;
+
+    Column<std::uint64_t> stringOffsets;
+    Column<char> stringCharacters;
+    Column<HeaderRecord> headerRecords;
+    Column<LineTypeRecord> lineTypeRecords;
+    Column<LayerRecord> layerRecords;
+
+    std::array<EntityTable, entityTableCount> entityTables;
+
+    Column<std::uint64_t> vertexOffsets;
+    Column<double> vertexX;
+    Column<double> vertexY;
+    Column<double> vertexBulge;
+    Column<std::uint8_t> vertexFlags;
+};
+
+template <typename T>
+tl::expected<Column<T>, Error> Snapshot::Impl::column(std::uint32_t id) const
+{
+    const auto iter{ sections.find(id) };
+    if (iter == sections.end()) {
+        return tl::make_unexpected(Error{
+            .type = Error::Type::InvalidFile,
+            .what = fmt::format("snapshot section {:#x} is missing", id),
+        });
+    }
+
+    const SectionEntry& entry{ iter->second };
+    if (entry.elementSize != sizeof(T)) {
+        return tl::make_unexpected(Error{
+            .type = Error::Type::InvalidFile,
+            .what = fmt::format("snapshot section {:#x} has an invalid element size", id),
+        });
+    }
+
+    return Column<T>{
+        .data = reinterpret_cast<const T*>(mapping.data() + entry.offset),
+        .count = static_cast<std::size_t>(entry.count),
+    };
+}
+
+template <typename T>
+tl::expected<void, Error> Snapshot::Impl::loadEntityTable()
+{
+    using Columns = EntityColumns<T>;
+    const auto columnId{ [](std::uint32_t column) {
+        return section::entityColumn(Columns::type, column);
+    } };
+
+    const tl::expected<Column<std::uint32_t>, Error> layers{
+        column<std::uint32_t>(columnId(section::layerColumn))
+    };
+    if (!layers) {
+        return tl::make_unexpected(layers.error());
+    }
+
+    EntityTable& table{ entityTables[Columns::type] };
+    table.count = layers->count;
+    table.layers = layers->data;
+
+    const auto checkCount{ [&table](const auto& maybeColumn) -> tl::expected<void, Error> {
+        if (!maybeColumn) {
+            return tl::make_unexpected(maybeColumn.error());
+        }
+        if (maybeColumn->count != table.count) {
+            return tl::make_unexpected(makeInvalidFile("snapshot columns of different lengths"));
+        }
+
+        return {};
+    } };
+
+    const tl::expected<Column<std::int32_t>, Error> colors{
+        column<std::int32_t>(columnId(section::colorColumn))
+    };
+    if (tl::expected<void, Error> result = checkCount(colors); !result) {
+        return result;
+    }
+    table.colors = colors->data;
+
+    const tl::expected<Column<std::uint8_t>, Error> flags{
+        column<std::uint8_t>(columnId(section::flagsColumn))
+    };
+    if (tl::expected<void, Error> result = checkCount(flags); !result) {
+        return result;
+    }
+    table.flags = flags->data;
+
+    for (std::uint32_t i{ 0 }; i < Columns::valueCount; ++i) {
+        const tl::expected<Column<double>, Error> values{
+            column<double>(columnId(section::firstValueColumn + i))
+        };
+        if (tl::expected<void, Error> result = checkCount(values); !result) {
+            return result;
+        }
+        table.values[i] = values->data;
+    }
+
+    return {};
+}
+
+tl::expected<void, Error> Snapshot::Impl::loadVertices()
+{
+    const auto columnId{ [](std::uint32_t column) {
+        return section::entityColumn(EntityColumns<LWPolyline>::type, column);
+    } };
+
+    tl::expected<Column<std::uint64_t>, Error> offsets{
+        column<std::uint64_t>(columnId(section::vertexOffsetsColumn))
+    };
+    tl::expected<Column<double>, Error> x{ column<double>(columnId(section::vertexXColumn)) };
+    tl::expected<Column<double>, Error> y{ column<double>(columnId(section::vertexYColumn)) };
+    tl::expected<Column<double>, Error> bulge{
+        column<double>(columnId(section::vertexBulgeColumn))
+    };
+    tl::expected<Column<std::uint8_t>, Error> flags{
+        column<std::uint8_t>(columnId(section::vertexFlagsColumn))
+    };
+    if (!offsets || !x || !y || !bulge || !flags) {
+        return tl::make_unexpected(makeInvalidFile("snapshot vertex columns are missing"));
+    }
+
+    const std::size_t vertexCount{ x->count };
+    if (y->count != vertexCount || bulge->count != vertexCount || flags->count != vertexCount
+        || offsets->count != entityTables[EntityColumns<LWPolyline>::type].count + 1) {
+        return tl::make_unexpected(makeInvalidFile("snapshot vertex columns of different lengths"));
+    }
+
+    // validated once, so that accessing a single lw polyline needs no checks
+    const std::uint64_t* first{ offsets->data };
+    const std::uint64_t* last{ offsets->data + offsets->count };
+    if (*first != 0 || *(last - 1) != vertexCount || !std::is_sorted(first, last)) {
+        return tl::make_unexpected(makeInvalidFile("snapshot vertex offsets are invalid"));
+    }
+
+    vertexOffsets = *offsets;
+    vertexX = *x;
+    vertexY = *y;
+    vertexBulge = *bulge;
+    vertexFlags = *flags;
+
+    return {};
+}
+
+tl::expected<void, Error> Snapshot::Impl::load(const std::filesystem::path& filePath)
+{
+    if (tl::expected<void, Error> result = mapping.open(filePath); !result) {
+        return result;
+    }
+
+    const std::string fileName{ pathToString(filePath) };
+
+    FileHeader header;
+    if (mapping.size() < sizeof(FileHeader)) {
+        return tl::make_unexpected(makeInvalidFile(fmt::format("{} is no snapshot", fileName)));
+    }
+    std::memcpy(&header, mapping.data(), sizeof(FileHeader));
+
+    if (header.magic != fileMagic) {
+        return tl::make_unexpected(makeInvalidFile(fmt::format("{} is no snapshot", fileName)));
+    }
+    if (header.byteOrder != byteOrderMark) {
+        return tl::make_unexpected(makeInvalidFile(
+            fmt::format("snapshot {} was written with a different byte order", fileName)));
+    }
+    if (header.version != fileVersion) {
+        return tl::make_unexpected(makeInvalidFile(fmt::format(
+            "snapshot {} has version {}, expected {}", fileName, header.version, fileVersion)));
+    }
+
+    const std::uint64_t tableSize{ header.sectionCount * sizeof(SectionEntry) };
+    if (header.sectionCount > mapping.size() / sizeof(SectionEntry)
+        || sizeof(FileHeader) + tableSize > mapping.size()) {
+        return tl::make_unexpected(
+            makeInvalidFile(fmt::format("snapshot {} is truncated", fileName)));
+    }
+
+    for (std::uint64_t i{ 0 }; i < header.sectionCount; ++i) {
+        SectionEntry entry;
+        std::memcpy(
+            &entry,
+            mapping.data() + sizeof(FileHeader) + i * sizeof(SectionEntry),
+            sizeof(SectionEntry));
+
+        const bool fits{ entry.elementSize != 0 && entry.offset <= mapping.size()
+                         && entry.count <= (mapping.size() - entry.offset) / entry.elementSize };
+        if (!fits || entry.offset % sectionAlignment != 0) {
+            return tl::make_unexpected(
+                makeInvalidFile(fmt::format("snapshot {} is truncated", fileName)));
+        }
+
+        sections.emplace(entry.id, entry);
+    }
+
+    tl::expected<Column<std::uint64_t>, Error> offsets{
+        column<std::uint64_t>(section::stringOffsets)
+    };
+    tl::expected<Column<char>, Error> characters{ column<char>(section::stringCharacters) };
+    tl::expected<Column<HeaderRecord>, Error> headerEntries{
+        column<HeaderRecord>(section::headerEntries)
+    };
+    tl::expected<Column<LineTypeRecord>, Error> lineTypes{
+        column<LineTypeRecord>(section::lineTypes)
+    };
+    tl::expected<Column<LayerRecord>, Error> layers{ column<LayerRecord>(section::layers) };
+    if (!offsets || !characters || !headerEntries || !lineTypes || !layers) {
+        return tl::make_unexpected(
+            makeInvalidFile(fmt::format("snapshot {} misses sections", fileName)));
+    }
+
+    const std::uint64_t* first{ offsets->data };
+    const std::uint64_t* last{ offsets->data + offsets->count };
+    if (offsets->count == 0 || *first != 0 || *(last - 1) > characters->count
+        || !std::is_sorted(first, last)) {
+        return tl::make_unexpected(
+            makeInvalidFile(fmt::format("snapshot {} has an invalid string table", fileName)));
+    }
+
+    stringOffsets = *offsets;
+    stringCharacters = *characters;
+    headerRecords = *headerEntries;
+    lineTypeRecords = *lineTypes;
+    layerRecords = *layers;
+
+    for (const tl::expected<void, Error>& result :
+         { loadEntityTable<Arc>(),
+           loadEntityTable<Circle>(),
+           loadEntityTable<Ellipse>(),
+           loadEntityTable<Line>(),
+           loadEntityTable<Point>(),
+           loadEntityTable<LWPolyline>(),
+           loadEntityTable<Ray>() }) {
+        if (!result) {
+            return result;
+        }
+    }
+
+    return loadVertices();
+}
+
+template <typename T>
+T Snapshot::Impl::entity(std::size_t index) const
+{
+    using Columns = EntityColumns<T>;
+    const EntityTable& table{ entityTables[Columns::type] };
+
+    std::array<double, Columns::valueCount> values;
+    for (std::size_t i{ 0 }; i < Columns::valueCount; ++i) {
+        values[i] = table.values[i][index];
+    }
+
+    T result;
+    result.layer = string(table.layers[index]);
+    result.color = table.colors[index];
+
+    ValueReader reader{ values.data() };
+    Columns::load(result, reader, table.flags[index]);
+
+    if constexpr (std::is_same_v<T, LWPolyline>) {
+        const auto begin{ static_cast<std::size_t>(vertexOffsets.data[index]) };
+        const auto end{ static_cast<std::size_t>(vertexOffsets.data[index + 1]) };
+
+        result.vertices.reserve(end - begin);
+        for (std::size_t i{ begin }; i < end; ++i) {
+            Vertex& vertex{ result.vertices.emplace_back() };
+            vertex.position = Coordinate2d{ vertexX.data[i], vertexY.data[i] };
+            if ((vertexFlags.data[i] & hasBulge) != 0) {
+                vertex.bulge = vertexBulge.data[i];
+            }
+        }
+    }
+
+    return result;
+}
+
+template <typename T>
+T EntityView<T>::operator[](std::size_t index) const
+{
+    return m_snapshot->template entity<T>(m_begin + index);
+}
+
+template <typename T>
+std::string_view EntityView<T>::layer(std::size_t index) const
+{
+    const Snapshot::Impl::EntityTable& table{
+        m_snapshot->entityTables[EntityColumns<T>::type]
+    };
+
+    return m_snapshot->string(table.layers[m_begin + index]);
+}
+
+template <typename T>
+int EntityView<T>::color(std::size_t index) const
+{
+    return m_snapshot->entityTables[EntityColumns<T>::type].colors[m_begin + index];
+}
+
+template <typename T>
+EntityView<T> EntityView<T>::subrange(std::size_t begin, std::size_t end) const
+{
+    end = std::min(end, size());
+    begin = std::min(begin, end);
+
+    return EntityView{ *m_snapshot, m_begin + begin, m_begin + end };
+}
+
+template class EntityView<Arc>;
+template class EntityView<Circle>;
+template class EntityView<Ellipse>;
+template class EntityView<Line>;
+template class EntityView<Point>;
+template class EntityView<LWPolyline>;
+template class EntityView<Ray>;
+
+tl::expected<void, Error> writeSnapshot(const Document& document, IOutputSink& sink)
+{
+    SnapshotWriter writer{ document };
+
+    return writer.write(sink);
+}
+
+tl::expected<void, Error>
+writeSnapshot(const Document& document, const std::filesystem::path& filePath)
+{
+    FileSink sink{ filePath };
+    if (tl::expected<void, Error> result = sink.openError(); !result) {
+        return result;
+    }
+
+    return writeSnapshot(document, sink);
+}
+
+tl::expected<Snapshot, Error> Snapshot::open(const std::filesystem::path& filePath)
+{
+    auto impl{ std::make_unique<Impl>() };
+    if (tl::expected<void, Error> result = impl->load(filePath); !result) {
+        return tl::make_unexpected(result.error());
+    }
+
+    return Snapshot{ std::move(impl) };
+}
+
+Snapshot::Snapshot(std::unique_ptr<Impl> impl)
+    : m_impl{ std::move(impl) }
+{
+}
+
+Snapshot::~Snapshot() = default;
+
+Snapshot::Snapshot(Snapshot&&) noexcept = default;
+
+Snapshot& Snapshot::operator=(Snapshot&&) noexcept = default;
+
+Header Snapshot::header() const
+{
+    Header header;
+    header.entries.reserve(m_impl->headerRecords.count);
+
+    for (std::size_t i{ 0 }; i < m_impl->headerRecords.count; ++i) {
+        const HeaderRecord& record{ m_impl->headerRecords.data[i] };
+        const auto& [x, y, z]{ record.values };
+
+        HeaderValue value;
+        switch (record.type) {
+        case 0: value = record.integer != 0; break;
+        case 1: value = static_cast<int>(record.integer); break;
+        case 2: value = x; break;
+        case 3: value = std::string{ m_impl->string(record.string) }; break;
+        case 4: value = Coordinate2d{ x, y }; break;
+        case 5: value = Coordinate3d{ x, y, z }; break;
+        default: continue;
+        }
+
+        header.entries.try_emplace(std::string{ m_impl->string(record.key) }, std::move(value));
+    }
+
+    return header;
+}
+
+Tables Snapshot::tables() const
+{
+    Tables tables;
+
+    tables.lineTypes.reserve(m_impl->lineTypeRecords.count);
+    for (std::size_t i{ 0 }; i < m_impl->lineTypeRecords.count; ++i) {
+        const LineTypeRecord& record{ m_impl->lineTypeRecords.data[i] };
+        tables.lineTypes.push_back(LineType{
+            .name = std::string{ m_impl->string(record.name) },
+            .displayName = std::string{ m_impl->string(record.displayName) },
+            .flags = record.flags,
+        });
+    }
+
+    tables.layers.reserve(m_impl->layerRecords.count);
+    for (std::size_t i{ 0 }; i < m_impl->layerRecords.count; ++i) {
+        const LayerRecord& record{ m_impl->layerRecords.data[i] };
+        tables.layers.push_back(Layer{
+            .name = std::string{ m_impl->string(record.name) },
+            .color = record.color,
+            .flags = static_cast<Layer::Flags>(record.flags),
+            .lineType = record.lineType,
+        });
+    }
+
+    return tables;
+}
+
+EntityView<Arc> Snapshot::arcs() const { return m_impl->view<Arc>(); }
+
+EntityView<Circle> Snapshot::circles() const { return m_impl->view<Circle>(); }
+
+EntityView<Ellipse> Snapshot::ellipses() const { return m_impl->view<Ellipse>(); }
+
+EntityView<Line> Snapshot::lines() const { return m_impl->view<Line>(); }
+
+EntityView<Point> Snapshot::points() const { return m_impl->view<Point>(); }
+
+EntityView<LWPolyline> Snapshot::lwPolylines() const { return m_impl->view<LWPolyline>(); }
+
+EntityView<Ray> Snapshot::rays() const { return m_impl->view<Ray>(); }
+
+Document Snapshot::toDocument() const
+{
+    Document document{
+        .header = header(),
+        .tables = tables(),
+    };
+
+    const auto copyEntities{ [](const auto& view, auto& entities) {
+        entities.reserve(view.size());
+        for (std::size_t i{ 0 }; i < view.size(); ++i) {
+            entities.push_back(view[i]);
+        }
+    } };
+
+    Entities& entities{ document.entities };
+    copyEntities(arcs(), entities.arcs);
+    copyEntities(circles(), entities.circles);
+    copyEntities(ellipses(), entities.ellipses);
+    copyEntities(lines(), entities.lines);
+    copyEntities(points(), entities.points);
+    copyEntities(lwPolylines(), entities.lwPolylines);
+    copyEntities(rays(), entities.rays);
+
+    return document;
+}
+
+}   // namespace odxf
@@ -0,0 +1,664 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/spatialindex.hpp"
+#include "opendxf/extents.hpp"
+
+#include "geometry.hpp"
+#include "parallel.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using odxf::Box2d;
+using odxf::Coordinate2d;
+using odxf::Curve;
+using odxf::EntityRef;
+using odxf::EntityType;
+using odxf::fullTurn;
+
+// samples of an elliptical curve, the closest one is refined by a golden section search
+constexpr std::size_t curveSamples{ 64 };
+constexpr std::size_t refineIterations{ 48 };
+
+Coordinate2d operator-(const Coordinate2d& lhs, const Coordinate2d& rhs)
+{
+    return Coordinate2d{ lhs.x - rhs.x, lhs.y - rhs.y };
+}
+
+double dot(const Coordinate2d& lhs, const Coordinate2d& rhs)
+{
+    return lhs.x * rhs.x + lhs.y * rhs.y;
+}
+
+double cross(const Coordinate2d& lhs, const Coordinate2d& rhs)
+{
+    return lhs.x * rhs.y - lhs.y * rhs.x;
+}
+
+double pointDistance(const Coordinate2d& lhs, const Coordinate2d& rhs)
+{
+    const Coordinate2d offset{ lhs - rhs };
+
+    return std::sqrt(dot(offset, offset));
+}
+
+// EntityRef holds 32 bit indices, SpatialIndex::build checks the entity counts.
+std::uint32_t entityIndex(std::size_t index)
+{
+    assert(index <= std::numeric_limits<std::uint32_t>::max());
+
+    return static_cast<std::uint32_t>(index);
+}
+
+bool indexable(const odxf::Entities& entities)
+{
+    constexpr std::size_t maxCount{
+        static_cast<std::size_t>(std::numeric_limits<std::uint32_t>::max()) + 1
+    };
+
+    return std::max({
+               entities.arcs.size(),
+               entities.circles.size(),
+               entities.ellipses.size(),
+               entities.lines.size(),
+               entities.points.size(),
+               entities.lwPolylines.size(),
+               entities.rays.size(),
+           })
+           <= maxCount;
+}
+
+Coordinate2d project(const odxf::Coordinate3d& coordinate)
+{
+    return Coordinate2d{ coordinate.x, coordinate.y };
+}
+
+Coordinate2d project(const odxf::Vector3d& vector)
+{
+    return Coordinate2d{ vector.x, vector.y };
+}
+
+double
+segmentDistance(const Coordinate2d& start, const Coordinate2d& end, const Coordinate2d& point)
+{
+    const Coordinate2d direction{ end - start };
+    const double squaredLength{ dot(direction, direction) };
+    if (squaredLength == 0.0) {
+        return pointDistance(start, point);
+    }
+
+    const double t{ std::clamp(dot(point - start, direction) / squaredLength, 0.0, 1.0) };
+
+    return pointDistance(
+        Coordinate2d{ start.x + t * direction.x, start.y + t * direction.y }, point);
+}
+
+double
+rayDistance(const Coordinate2d& start, const Coordinate2d& direction, const Coordinate2d& point)
+{
+    const double squaredLength{ dot(direction, direction) };
+    if (squaredLength == 0.0) {
+        return pointDistance(start, point);
+    }
+
+    const double t{ std::max(dot(point - start, direction) / squaredLength, 0.0) };
+
+    return pointDistance(
+        Coordinate2d{ start.x + t * direction.x, start.y + t * direction.y }, point);
+}
+
+// The closest point of a circle lies in the direction of the point from the center, or is
+// an end point of the arc if the arc does not pass that direction.
+double circularDistance(const Curve& curve, const Coordinate2d& point)
+{
+    const Coordinate2d offset{ point - project(curve.center) };
+    const Coordinate2d u{ project(curve.u) };
+    const Coordinate2d v{ project(curve.v) };
+    const double radius{ std::sqrt(dot(u, u)) };
+    const auto onCurve{ [&] {
+        const double parameter{ std::atan2(dot(offset, v), dot(offset, u)) };
+        return odxf::sweepAngle(curve.start, parameter, fullTurn) <= curve.sweep;
+    } };
+
+    if (curve.sweep >= fullTurn || onCurve()) {
+        return std::abs(std::sqrt(dot(offset, offset)) - radius);
+    }
+
+    return std::min(
+        pointDistance(project(curve.point(curve.start)), point),
+        pointDistance(project(curve.point(curve.start + curve.sweep)), point));
+}
+
+// The distance to the projection of the curve onto the xy plane.
+double curveDistance(const Curve& curve, const Coordinate2d& point)
+{
+    const Coordinate2d u{ project(curve.u) };
+    const Coordinate2d v{ project(curve.v) };
+    const double uu{ dot(u, u) };
+    const double vv{ dot(v, v) };
+    const double uv{ dot(u, v) };
+    const double scale{ std::max(uu, vv) };
+    if (std::abs(uu - vv) <= 1.0e-12 * scale && std::abs(uv) <= 1.0e-12 * scale) {
+        return circularDistance(curve, point);
+    }
+
+    const double sweep{ std::min(curve.sweep, fullTurn) };
+    const double step{ sweep / static_cast<double>(curveSamples) };
+    const auto distanceAt{ [&](double parameter) {
+        return pointDistance(project(curve.point(parameter)), point);
+    } };
+
+    double closest{ curve.start };
+    double closestDistance{ distanceAt(closest) };
+    for (std::size_t i{ 1 }; i <= curveSamples; ++i) {
+        const double parameter{ curve.start + step * static_cast<double>(i) };
+        const double sampleDistance{ distanceAt(parameter) };
+        if (sampleDistance < closestDistance) {
+            closest = parameter;
+            closestDistance = sampleDistance;
+        }
+    }
+
+    // golden section search between the neighbouring samples, arcs stay within their sweep
+    const bool isClosed{ curve.sweep >= fullTurn };
+    double low{ isClosed ? closest - step : std::max(closest - step, curve.start) };
+    double high{ isClosed ? closest + step : std::min(closest + step, curve.start + sweep) };
+    const double ratio{ (std::sqrt(5.0) - 1.0) / 2.0 };
+    for (std::size_t i{ 0 }; i < refineIterations; ++i) {
+        const double lower{ high - ratio * (high - low) };
+        const double upper{ low + ratio * (high - low) };
+        if (distanceAt(lower) < distanceAt(upper)) {
+            high = upper;
+        } else {
+            low = lower;
+        }
+    }
+
+    return std::min(closestDistance, distanceAt((low + high) / 2.0));
+}
+
+// The distance to the arc of a bulged segment, tested like circularDistance but by the
+// orientation of the point towards the end points instead of comparing angles.
+double bulgeDistance(
+    const Coordinate2d& start, const Coordinate2d& end, double bulge, const Coordinate2d& point)
+{
+    const Coordinate2d center{ odxf::bulgeCenter(start, end, bulge) };
+    const Coordinate2d offset{ point - center };
+    // clockwise arcs are tested as the counterclockwise arc from the end
+    const Coordinate2d first{ (bulge > 0.0 ? start : end) - center };
+    const Coordinate2d last{ (bulge > 0.0 ? end : start) - center };
+
+    // arcs of bulges beyond 1 sweep more than half a turn
+    const bool passes{ std::abs(bulge) <= 1.0
+                           ? cross(first, offset) >= 0.0 && cross(offset, last) >= 0.0
+                           : !(cross(last, offset) > 0.0 && cross(offset, first) > 0.0) };
+    if (passes) {
+        return std::abs(std::sqrt(dot(offset, offset)) - std::sqrt(dot(first, first)));
+    }
+
+    return std::min(pointDistance(start, point), pointDistance(end, point));
+}
+
+double entityDistance(const odxf::Arc& arc, const Coordinate2d& point)
+{
+    return curveDistance(odxf::arcCurve(arc), point);
+}
+
+double entityDistance(const odxf::Circle& circle, const Coordinate2d& point)
+{
+    return curveDistance(
+        odxf::circularCurve(circle.center, circle.radius, circle.extrusion), point);
+}
+
+double entityDistance(const odxf::Ellipse& ellipse, const Coordinate2d& point)
+{
+    return curveDistance(odxf::ellipseCurve(ellipse), point);
+}
+
+double entityDistance(const odxf::Line& line, const Coordinate2d& point)
+{
+    return segmentDistance(project(line.start), project(line.end), point);
+}
+
+double entityDistance(const odxf::LWPolyline& lwPolyline, const Coordinate2d& point)
+{
+    const odxf::Vertices& vertices{ lwPolyline.vertices };
+    if (vertices.empty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double result{ pointDistance(vertices.front().position, point) };
+    const std::size_t segmentCount{ lwPolyline.isClosed ? vertices.size() : vertices.size() - 1 };
+    for (std::size_t i{ 0 }; i < segmentCount; ++i) {
+        const Coordinate2d& start{ vertices[i].position };
+        const Coordinate2d& end{ vertices[(i + 1) % vertices.size()].position };
+        const std::optional<double>& bulge{ vertices[i].bulge };
+        if (!bulge || *bulge == 0.0 || !std::isfinite(*bulge)
+            || (start.x == end.x && start.y == end.y)) {
+            result = std::min(result, segmentDistance(start, end, point));
+        } else {
+            result = std::min(result, bulgeDistance(start, end, *bulge, point));
+        }
+    }
+
+    return result;
+}
+
+double entityDistance(const odxf::Point& entity, const Coordinate2d& point)
+{
+    return pointDistance(project(entity.coordinate), point);
+}
+
+double entityDistance(const odxf::Ray& ray, const Coordinate2d& point)
+{
+    return rayDistance(project(ray.startPoint), project(ray.direction), point);
+}
+
+bool isEmpty(const Box2d& box)
+{
+    return !(box.min.x <= box.max.x && box.min.y <= box.max.y);
+}
+
+bool intersects(const Box2d& lhs, const Box2d& rhs)
+{
+    return lhs.min.x <= rhs.max.x && rhs.min.x <= lhs.max.x && lhs.min.y <= rhs.max.y
+           && rhs.min.y <= lhs.max.y;
+}
+
+double squaredDistance(const Box2d& box, const Coordinate2d& point)
+{
+    const double dx{ std::max({ box.min.x - point.x, 0.0, point.x - box.max.x }) };
+    const double dy{ std::max({ box.min.y - point.y, 0.0, point.y - box.max.y }) };
+
+    return dx * dx + dy * dy;
+}
+
+// Whether the half line from the start in the direction crosses the box, clipping it
+// against the slabs of both axes.
+bool intersects(const Coordinate2d& start, const Coordinate2d& direction, const Box2d& box)
+{
+    const std::array<double, 2> origin{ start.x, start.y };
+    const std::array<double, 2> slope{ direction.x, direction.y };
+    const std::array<double, 2> min{ box.min.x, box.min.y };
+    const std::array<double, 2> max{ box.max.x, box.max.y };
+
+    double enter{ 0.0 };
+    double leave{ std::numeric_limits<double>::infinity() };
+    for (std::size_t axis{ 0 }; axis < origin.size(); ++axis) {
+        if (slope[axis] == 0.0) {
+            if (origin[axis] < min[axis] || origin[axis] > max[axis]) {
+                return false;
+            }
+            continue;
+        }
+
+        const double first{ (min[axis] - origin[axis]) / slope[axis] };
+        const double second{ (max[axis] - origin[axis]) / slope[axis] };
+        enter = std::max(enter, std::min(first, second));
+        leave = std::min(leave, std::max(first, second));
+        if (enter > leave) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct Item final
+{
+    Box2d box;
+    EntityRef entity;
+};
+
+// Bounds the entities in the index-th of chunkCount ranges into the items from the offset on.
+template <typename T>
+void boundChunk(
+    std::vector<Item>& items,
+    std::size_t offset,
+    const std::vector<T>& entities,
+    EntityType type,
+    std::size_t chunkCount,
+    std::size_t index)
+{
+    const odxf::ChunkRange range{ odxf::chunkRange(entities.size(), chunkCount, index) };
+    for (std::size_t i{ range.begin }; i < range.end; ++i) {
+        const odxf::Extents extents{ odxf::extents(entities[i]) };
+        items[offset + i] = Item{
+            .box = Box2d{ .min = project(extents.min), .max = project(extents.max) },
+            .entity = EntityRef{ .type = type, .index = entityIndex(i) },
+        };
+    }
+}
+
+std::vector<Item> boundItems(const odxf::Entities& entities, unsigned int threadCount)
+{
+    const std::array<std::size_t, 6> counts{
+        entities.arcs.size(),  entities.circles.size(), entities.ellipses.size(),
+        entities.lines.size(), entities.points.size(),  entities.lwPolylines.size(),
+    };
+    std::array<std::size_t, 7> offsets{};
+    std::partial_sum(counts.begin(), counts.end(), offsets.begin() + 1);
+
+    std::vector<Item> items(offsets.back());
+    odxf::parallelFor(threadCount, threadCount, [&](std::size_t index) {
+        boundChunk(items, offsets[0], entities.arcs, EntityType::Arc, threadCount, index);
+        boundChunk(items, offsets[1], entities.circles, EntityType::Circle, threadCount, index);
+        boundChunk(items, offsets[2], entities.ellipses, EntityType::Ellipse, threadCount, index);
+        boundChunk(items, offsets[3], entities.lines, EntityType::Line, threadCount, index);
+        boundChunk(items, offsets[4], entities.points, EntityType::Point, threadCount, index);
+        boundChunk(
+            items, offsets[5], entities.lwPolylines, EntityType::LWPolyline, threadCount, index);
+    });
+
+    std::erase_if(items, [](const Item& item) { return isEmpty(item.box); });
+
+    return items;
+}
+
+// Orders the items by sort tile recursive packing. Sorted by the x coordinates of their
+// centers, they are cut into slices of sliceCount leaves, with sliceCount being the square
+// root of the number of leaves, and each slice is sorted by the y coordinates.
+void sortTiles(std::vector<Item>& items, std::size_t nodeCapacity, unsigned int threadCount)
+{
+    const std::size_t leafCount{ (items.size() + nodeCapacity - 1) / nodeCapacity };
+    const auto sliceCount{
+        static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(leafCount))))
+    };
+    const std::size_t sliceSize{ std::max<std::size_t>(sliceCount * nodeCapacity, 1) };
+
+    odxf::parallelSort(
+        items.begin(),
+        items.end(),
+        [](const Item& lhs, const Item& rhs) {
+            return lhs.box.min.x + lhs.box.max.x < rhs.box.min.x + rhs.box.max.x;
+        },
+        threadCount);
+
+    const std::size_t slices{ (items.size() + sliceSize - 1) / sliceSize };
+    odxf::parallelFor(slices, threadCount, [&](std::size_t index) {
+        const auto begin{ items.begin() + static_cast<std::ptrdiff_t>(index * sliceSize) };
+        const auto end{ items.begin()
+                        + static_cast<std::ptrdiff_t>(
+                            std::min((index + 1) * sliceSize, items.size())) };
+        std::sort(begin, end, [](const Item& lhs, const Item& rhs) {
+            return lhs.box.min.y + lhs.box.max.y < rhs.box.min.y + rhs.box.max.y;
+        });
+    });
+}
+
+Box2d merged(const Box2d* boxes, std::size_t count)
+{
+    Box2d result{ boxes[0] };
+    for (std::size_t i{ 1 }; i < count; ++i) {
+        result.min.x = std::min(result.min.x, boxes[i].min.x);
+        result.min.y = std::min(result.min.y, boxes[i].min.y);
+        result.max.x = std::max(result.max.x, boxes[i].max.x);
+        result.max.y = std::max(result.max.y, boxes[i].max.y);
+    }
+
+    return result;
+}
+
+// A node or item of the tree, the items being level 0.
+struct Node final
+{
+    std::size_t level{ 0 };
+    std::size_t index{ 0 };
+};
+
+struct QueuedNode final
+{
+    double squaredDistance{ 0.0 };
+    Node node;
+
+    bool operator>(const QueuedNode& other) const
+    {
+        return squaredDistance > other.squaredDistance;
+    }
+};
+
+}   // namespace
+
+namespace odxf {
+
+double distance(const Entities& entities, EntityRef entity, const Coordinate2d& point)
+{
+    switch (entity.type) {
+    case EntityType::Arc:
+        return entityDistance(entities.arcs[entity.index], point);
+    case EntityType::Circle:
+        return entityDistance(entities.circles[entity.index], point);
+    case EntityType::Ellipse:
+        return entityDistance(entities.ellipses[entity.index], point);
+    case EntityType::Line:
+        return entityDistance(entities.lines[entity.index], point);
+    case EntityType::Point:
+        return entityDistance(entities.points[entity.index], point);
+    case EntityType::LWPolyline:
+        return entityDistance(entities.lwPolylines[entity.index], point);
+    case EntityType::Ray:
+        return entityDistance(entities.rays[entity.index], point);
+    }
+
+    return std::numeric_limits<double>::infinity();
+}
+
+tl::expected<SpatialIndex, Error>
+SpatialIndex::build(const Entities& entities, const SpatialIndexOptions& options)
+{
+    if (!indexable(entities)) {
+        return tl::make_unexpected(Error{
+            .type = Error::Type::TooManyEntities,
+            .what = "more than 2^32 entities of a type",
+        });
+    }
+
+    return SpatialIndex{ entities, options };
+}
+
+SpatialIndex::SpatialIndex(const Entities& entities, const SpatialIndexOptions& options)
+    : m_nodeCapacity{ std::max<std::size_t>(options.nodeCapacity, 2) }
+{
+    OPENDXF_TRACE_SCOPE("SpatialIndex");
+
+    const unsigned int threadCount{ resolveThreadCount(options.threadCount) };
+
+    m_rays.reserve(entities.rays.size());
+    for (std::size_t i{ 0 }; i < entities.rays.size(); ++i) {
+        const Ray& ray{ entities.rays[i] };
+        m_rays.push_back(IndexedRay{
+            .start = project(ray.startPoint),
+            .direction = project(ray.direction),
+            .index = entityIndex(i),
+        });
+    }
+
+    std::vector<Item> items{ boundItems(entities, threadCount) };
+    sortTiles(items, m_nodeCapacity, threadCount);
+
+    m_boxes.resize(items.size());
+    m_items.resize(items.size());
+    for (std::size_t i{ 0 }; i < items.size(); ++i) {
+        m_boxes[i] = items[i].box;
+        m_items[i] = items[i].entity;
+    }
+
+    // every level bounds consecutive groups of nodeCapacity nodes of the level below
+    m_levelOffsets = { 0, items.size() };
+    while (m_levelOffsets.back() - m_levelOffsets[m_levelOffsets.size() - 2] > 1) {
+        const std::size_t childBegin{ m_levelOffsets[m_levelOffsets.size() - 2] };
+        const std::size_t childCount{ m_levelOffsets.back() - childBegin };
+        const std::size_t nodeCount{ (childCount + m_nodeCapacity - 1) / m_nodeCapacity };
+        const std::size_t nodeBegin{ m_boxes.size() };
+
+        m_boxes.resize(nodeBegin + nodeCount);
+        parallelFor(threadCount, threadCount, [&](std::size_t index) {
+            const ChunkRange range{ chunkRange(nodeCount, threadCount, index) };
+            for (std::size_t i{ range.begin }; i < range.end; ++i) {
+                const std::size_t first{ i * m_nodeCapacity };
+                const std::size_t count{ std::min(m_nodeCapacity, childCount - first) };
+                m_boxes[nodeBegin + i] = merged(&m_boxes[childBegin + first], count);
+            }
+        });
+
+        m_levelOffsets.push_back(m_boxes.size());
+    }
+}
+
+void SpatialIndex::query(const Box2d& window, std::vector<EntityRef>& result) const
+{
+    for (const IndexedRay& ray : m_rays) {
+        if (intersects(ray.start, ray.direction, window)) {
+            result.push_back(EntityRef{ .type = EntityType::Ray, .index = ray.index });
+        }
+    }
+
+    if (m_items.empty()) {
+        return;
+    }
+
+    const std::size_t topLevel{ m_levelOffsets.size() - 2 };
+    std::vector<Node> stack;
+    for (std::size_t i{ m_levelOffsets[topLevel] }; i < m_levelOffsets[topLevel + 1]; ++i) {
+        stack.push_back(Node{ .level = topLevel, .index = i });
+    }
+
+    while (!stack.empty()) {
+        const Node node{ stack.back() };
+        stack.pop_back();
+
+        if (!intersects(m_boxes[node.index], window)) {
+            continue;
+        }
+
+        if (node.level == 0) {
+            result.push_back(m_items[node.index]);
+            continue;
+        }
+
+        const std::size_t childBegin{ m_levelOffsets[node.level - 1] };
+        const std::size_t first{ childBegin
+                                 + (node.index - m_levelOffsets[node.level]) * m_nodeCapacity };
+        const std::size_t last{ std::min(first + m_nodeCapacity, m_levelOffsets[node.level]) };
+        for (std::size_t i{ first }; i < last; ++i) {
+            stack.push_back(Node{ .level = node.level - 1, .index = i });
+        }
+    }
+}
+
+std::vector<EntityRef> SpatialIndex::query(const Box2d& window) const
+{
+    std::vector<EntityRef> result;
+    query(window, result);
+
+    return result;
+}
+
+// Best first search, visiting the nodes in the order of their distances to the point until
+// the closest remaining node is farther away than the closest entity found.
+std::optional<EntityRef> SpatialIndex::nearest(
+    const Entities& entities, const Coordinate2d& point, double tolerance) const
+{
+    std::optional<EntityRef> result;
+    double bound{ tolerance };
+    const auto visit{ [&](EntityRef entity) {
+        const double entityDistance{ distance(entities, entity, point) };
+        if (result ? entityDistance < bound : entityDistance <= bound) {
+            result = entity;
+            bound = entityDistance;
+        }
+    } };
+
+    for (const IndexedRay& ray : m_rays) {
+        visit(EntityRef{ .type = EntityType::Ray, .index = ray.index });
+    }
+
+    if (m_items.empty()) {
+        return result;
+    }
+
+    std::priority_queue<QueuedNode, std::vector<QueuedNode>, std::greater<>> queue;
+    const auto push{ [&](const Node& node) {
+        queue.push(QueuedNode{
+            .squaredDistance = squaredDistance(m_boxes[node.index], point),
+            .node = node,
+        });
+    } };
+
+    const std::size_t topLevel{ m_levelOffsets.size() - 2 };
+    for (std::size_t i{ m_levelOffsets[topLevel] }; i < m_levelOffsets[topLevel + 1]; ++i) {
+        push(Node{ .level = topLevel, .index = i });
+    }
+
+    while (!queue.empty() && queue.top().squaredDistance <= bound * bound) {
+        const Node node{ queue.top().node };
+        queue.pop();
+
+        if (node.level == 0) {
+            visit(m_items[node.index]);
+            continue;
+        }
+
+        const std::size_t childBegin{ m_levelOffsets[node.level - 1] };
+        const std::size_t first{ childBegin
+                                 + (node.index - m_levelOffsets[node.level]) * m_nodeCapacity };
+        const std::size_t last{ std::min(first + m_nodeCapacity, m_levelOffsets[node.level]) };
+        for (std::size_t i{ first }; i < last; ++i) {
+            if (node.level > 1) {
+                push(Node{ .level = node.level - 1, .index = i });
+            } else if (squaredDistance(m_boxes[i], point) <= bound * bound) {
+                // the items of a leaf are measured right away instead of being queued
+                visit(m_items[i]);
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<EntityRef>
+SpatialIndex::pick(const Entities& entities, const Coordinate2d& point, double tolerance) const
+{
+    std::vector<EntityRef> candidates;
+    query(
+        Box2d{
+            .min = Coordinate2d{ point.x - tolerance, point.y - tolerance },
+            .max = Coordinate2d{ point.x + tolerance, point.y + tolerance },
+        },
+        candidates);
+
+    std::vector<std::pair<double, EntityRef>> hits;
+    for (const EntityRef& entity : candidates) {
+        const double entityDistance{ distance(entities, entity, point) };
+        if (entityDistance <= tolerance) {
+            hits.emplace_back(entityDistance, entity);
+        }
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    std::vector<EntityRef> result;
+    result.reserve(hits.size());
+    for (const auto& [hitDistance, entity] : hits) {
+        result.push_back(entity);
+    }
+
+    return result;
+}
+
+}   // namespace odxf
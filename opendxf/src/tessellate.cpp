@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/tessellate.hpp"
+
+#include "geometry.hpp"
+#include "parallel.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <optional>
+#include <span>
+
+namespace {
+
+// Closed curves get at least a triangle.
+constexpr std::size_t minClosedSegments{ 3 };
+
+// Number of chords replacing a circular arc. The deviation of a chord spanning the angle
+// step from its arc of radius r is r * (1 - cos(step / 2)).
+std::size_t
+segmentCount(double radius, double sweep, bool isClosed, const odxf::TessellateOptions& options)
+{
+    const std::size_t maxSegments{ std::max<std::size_t>(options.maxSegments, 1) };
+    const std::size_t minSegments{ isClosed ? std::min(minClosedSegments, maxSegments) : 1 };
+
+    if (!std::isfinite(radius) || !std::isfinite(sweep) || radius <= 0.0) {
+        return minSegments;
+    }
+
+    const double tolerance{ options.chordTolerance };
+    if (tolerance <= 0.0) {
+        return maxSegments;
+    }
+
+    const double step{ tolerance < radius ? 2.0 * std::acos(1.0 - tolerance / radius)
+                                          : std::numbers::pi };
+    const double count{ std::ceil(std::abs(sweep) / step) };
+    if (!(count < static_cast<double>(maxSegments))) {
+        return maxSegments;
+    }
+
+    return std::max(static_cast<std::size_t>(count), minSegments);
+}
+
+// Writes the segmentCount + 1 points center + x * cos(t) + y * sin(t) for t from
+// startParameter to startParameter + sweep. The cosines and sines are computed by rotating
+// the previous ones instead of evaluating them per vertex, the last point is computed exactly.
+void writeCurve(
+    const odxf::Coordinate3d& center,
+    const odxf::Vector3d& x,
+    const odxf::Vector3d& y,
+    double startParameter,
+    double sweep,
+    std::size_t segmentCount,
+    bool isClosed,
+    std::span<odxf::Coordinate3d> vertices)
+{
+    const auto point{ [&](double cosine, double sine) {
+        return odxf::Coordinate3d{ center.x + x.x * cosine + y.x * sine,
+                                   center.y + x.y * cosine + y.y * sine,
+                                   center.z + x.z * cosine + y.z * sine };
+    } };
+
+    const double step{ sweep / static_cast<double>(segmentCount) };
+    const double stepCosine{ std::cos(step) };
+    const double stepSine{ std::sin(step) };
+
+    double cosine{ std::cos(startParameter) };
+    double sine{ std::sin(startParameter) };
+    for (std::size_t i{ 0 }; i < segmentCount; ++i) {
+        vertices[i] = point(cosine, sine);
+
+        const double nextCosine{ cosine * stepCosine - sine * stepSine };
+        sine = sine * stepCosine + cosine * stepSine;
+        cosine = nextCosine;
+    }
+
+    vertices[segmentCount] = isClosed
+                                 ? vertices[0]
+                                 : point(std::cos(startParameter + sweep),
+                                         std::sin(startParameter + sweep));
+}
+
+double toRadians(double degrees)
+{
+    return degrees * std::numbers::pi / 180.0;
+}
+
+template <typename Function>
+void forEachSegment(const odxf::LWPolyline& lwPolyline, Function&& function)
+{
+    const odxf::Vertices& vertices{ lwPolyline.vertices };
+    if (vertices.size() < 2) {
+        return;
+    }
+
+    const std::size_t count{ lwPolyline.isClosed ? vertices.size() : vertices.size() - 1 };
+    for (std::size_t i{ 0 }; i < count; ++i) {
+        const odxf::Vertex& start{ vertices[i] };
+        const odxf::Vertex& end{ vertices[(i + 1) % vertices.size()] };
+        function(start.position, end.position, start.bulge);
+    }
+}
+
+template <typename T>
+odxf::Tessellation
+tessellateAll(const std::vector<T>& entities, const odxf::TessellateOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("tessellate");
+
+    odxf::Tessellation result;
+    result.offsets.resize(entities.size() + 1, 0);
+
+    const unsigned int threadCount{ odxf::resolveThreadCount(options.threadCount) };
+    odxf::parallelFor(threadCount, threadCount, [&](std::size_t index) {
+        const odxf::ChunkRange range{ odxf::chunkRange(entities.size(), threadCount, index) };
+        for (std::size_t i{ range.begin }; i < range.end; ++i) {
+            result.offsets[i + 1] = vertexCount(entities[i], options);
+        }
+    });
+
+    std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+    result.vertices.resize(result.offsets.back());
+
+    const std::span<odxf::Coordinate3d> vertices{ result.vertices };
+    odxf::parallelFor(threadCount, threadCount, [&](std::size_t index) {
+        const odxf::ChunkRange range{ odxf::chunkRange(entities.size(), threadCount, index) };
+        for (std::size_t i{ range.begin }; i < range.end; ++i) {
+            tessellate(
+                entities[i],
+                options,
+                vertices.subspan(result.offsets[i], result.offsets[i + 1] - result.offsets[i]));
+        }
+    });
+
+    return result;
+}
+
+}   // namespace
+
+namespace odxf {
+
+std::size_t vertexCount(const Arc& arc, const TessellateOptions& options)
+{
+    const double sweep{ sweepAngle(arc.startAngle, arc.endAngle, 360.0) };
+
+    return segmentCount(arc.radius, toRadians(sweep), sweep == 360.0, options) + 1;
+}
+
+std::size_t vertexCount(const Circle& circle, const TessellateOptions& options)
+{
+    return segmentCount(circle.radius, fullTurn, true, options) + 1;
+}
+
+std::size_t vertexCount(const Ellipse& ellipse, const TessellateOptions& options)
+{
+    // An ellipse is the image of its circumcircle under a contraction, whose chords deviate
+    // at least as much.
+    const Coordinate3d& major{ ellipse.endPointMajor };
+    const double majorRadius{ std::hypot(major.x, major.y, major.z) };
+    const double radius{ majorRadius * std::max(1.0, std::abs(ellipse.axisRatio)) };
+    const double sweep{ sweepAngle(ellipse.startParameter, ellipse.endParameter, fullTurn) };
+
+    return segmentCount(radius, sweep, sweep == fullTurn, options) + 1;
+}
+
+std::size_t vertexCount(const LWPolyline& lwPolyline, const TessellateOptions& options)
+{
+    if (lwPolyline.vertices.empty()) {
+        return 0;
+    }
+
+    std::size_t count{ 1 };
+    forEachSegment(
+        lwPolyline,
+        [&](const Coordinate2d& start, const Coordinate2d& end, std::optional<double> bulge) {
+            const std::optional<BulgeArc> arc{ bulgeArc(start, end, bulge, 0.0) };
+            count += arc ? segmentCount(arc->radius, arc->sweep, false, options) : 1;
+        });
+
+    return count;
+}
+
+void tessellate(const Arc& arc, const TessellateOptions& options, std::span<Coordinate3d> vertices)
+{
+    const double sweep{ sweepAngle(arc.startAngle, arc.endAngle, 360.0) };
+    const bool isClosed{ sweep == 360.0 };
+
+    writeCurve(
+        arc.center,
+        Vector3d{ arc.radius, 0.0, 0.0 },
+        Vector3d{ 0.0, arc.radius, 0.0 },
+        toRadians(arc.startAngle),
+        toRadians(sweep),
+        segmentCount(arc.radius, toRadians(sweep), isClosed, options),
+        isClosed,
+        vertices);
+}
+
+void tessellate(
+    const Circle& circle, const TessellateOptions& options, std::span<Coordinate3d> vertices)
+{
+    writeCurve(
+        circle.center,
+        Vector3d{ circle.radius, 0.0, 0.0 },
+        Vector3d{ 0.0, circle.radius, 0.0 },
+        0.0,
+        fullTurn,
+        segmentCount(circle.radius, fullTurn, true, options),
+        true,
+        vertices);
+}
+
+void tessellate(
+    const Ellipse& ellipse, const TessellateOptions& options, std::span<Coordinate3d> vertices)
+{
+    const double sweep{ sweepAngle(ellipse.startParameter, ellipse.endParameter, fullTurn) };
+    const bool isClosed{ sweep == fullTurn };
+
+    writeCurve(
+        ellipse.center,
+        toVector(ellipse.endPointMajor),
+        ellipseMinorAxis(ellipse),
+        ellipse.startParameter,
+        sweep,
+        vertexCount(ellipse, options) - 1,
+        isClosed,
+        vertices);
+}
+
+void tessellate(
+    const LWPolyline& lwPolyline,
+    const TessellateOptions& options,
+    std::span<Coordinate3d> vertices)
+{
+    if (lwPolyline.vertices.empty()) {
+        return;
+    }
+
+    const double elevation{ lwPolyline.elevation.value_or(0.0) };
+    const Coordinate2d& first{ lwPolyline.vertices.front().position };
+    vertices[0] = Coordinate3d{ first.x, first.y, elevation };
+
+    std::size_t count{ 1 };
+    forEachSegment(
+        lwPolyline,
+        [&](const Coordinate2d& start, const Coordinate2d& end, std::optional<double> bulge) {
+            const std::optional<BulgeArc> arc{ bulgeArc(start, end, bulge, elevation) };
+            if (!arc) {
+                vertices[count++] = Coordinate3d{ end.x, end.y, elevation };
+                return;
+            }
+
+            const std::size_t segments{ segmentCount(arc->radius, arc->sweep, false, options) };
+            writeCurve(
+                arc->center,
+                Vector3d{ arc->radius, 0.0, 0.0 },
+                Vector3d{ 0.0, arc->radius, 0.0 },
+                arc->startAngle,
+                arc->sweep,
+                segments,
+                false,
+                vertices.subspan(count - 1, segments + 1));
+            // the end points are kept exactly
+            vertices[count - 1] = Coordinate3d{ start.x, start.y, elevation };
+            vertices[count + segments - 1] = Coordinate3d{ end.x, end.y, elevation };
+            count += segments;
+        });
+}
+
+Tessellation tessellate(const Arcs& arcs, const TessellateOptions& options)
+{
+    return tessellateAll(arcs, options);
+}
+
+Tessellation tessellate(const Circles& circles, const TessellateOptions& options)
+{
+    return tessellateAll(circles, options);
+}
+
+Tessellation tessellate(const Ellipses& ellipses, const TessellateOptions& options)
+{
+    return tessellateAll(ellipses, options);
+}
+
+Tessellation tessellate(const LWPolylines& lwPolylines, const TessellateOptions& options)
+{
+    return tessellateAll(lwPolylines, options);
+}
+
+}   // namespace odxf
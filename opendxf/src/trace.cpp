@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/trace.hpp"
+
+#include "opendxf/outputsink.hpp"
+
+#include "jsonstring.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <iterator>
+
+namespace {
+
+std::atomic<odxf::ITraceSink*> traceSink{ nullptr };
+
+std::uint32_t currentThreadId()
+{
+    static std::atomic<std::uint32_t> nextThreadId{ 1 };
+    thread_local const std::uint32_t threadId{ nextThreadId++ };
+
+    return threadId;
+}
+
+double toMicroseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>{ duration }.count();
+}
+
+}   // namespace
+
+namespace odxf {
+
+ITraceSink::~ITraceSink() = default;
+
+ChromeTraceSink::ChromeTraceSink(IOutputSink& sink)
+    : m_sink{ sink }
+{
+}
+
+ChromeTraceSink::~ChromeTraceSink() { close(); }
+
+void ChromeTraceSink::event(const TraceEvent& event)
+{
+    const std::scoped_lock lock{ m_mutex };
+    if (m_isClosed || m_error) {
+        return;
+    }
+
+    m_record.clear();
+    m_record.append(m_isFirst ? "{\"traceEvents\":[\n{\"name\":" : ",\n{\"name\":");
+    appendJsonString(m_record, event.name);
+    m_record.append(",\"cat\":");
+    appendJsonString(m_record, event.category);
+    fmt::format_to(
+        std::back_inserter(m_record),
+        ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+        toMicroseconds(event.begin.time_since_epoch()),
+        toMicroseconds(event.end - event.begin),
+        event.threadId);
+    m_isFirst = false;
+
+    if (tl::expected<void, Error> result = m_sink.write(m_record); !result) {
+        m_error = std::move(result.error());
+    }
+}
+
+tl::expected<void, Error> ChromeTraceSink::close()
+{
+    const std::scoped_lock lock{ m_mutex };
+    if (m_isClosed) {
+        return m_error ? tl::expected<void, Error>{ tl::make_unexpected(*m_error) }
+                       : tl::expected<void, Error>{};
+    }
+    m_isClosed = true;
+
+    if (!m_error) {
+        if (tl::expected<void, Error> result =
+                m_sink.write(m_isFirst ? "{\"traceEvents\":[]}\n" : "\n]}\n");
+            !result) {
+            m_error = std::move(result.error());
+        } else if (result = m_sink.close(); !result) {
+            m_error = std::move(result.error());
+        }
+    }
+
+    return m_error ? tl::expected<void, Error>{ tl::make_unexpected(*m_error) }
+                   : tl::expected<void, Error>{};
+}
+
+void setTraceSink(ITraceSink* sink) { traceSink.store(sink, std::memory_order_release); }
+
+bool isTracingEnabled()
+{
+#ifdef OPENDXF_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+TraceScope::TraceScope(std::string_view name, std::string_view category)
+    : m_sink{ traceSink.load(std::memory_order_acquire) }
+    , m_name{ name }
+    , m_category{ category }
+{
+    if (m_sink != nullptr) {
+        m_begin = std::chrono::steady_clock::now();
+    }
+}
+
+TraceScope::~TraceScope()
+{
+    if (m_sink == nullptr) {
+        return;
+    }
+
+    m_sink->event(TraceEvent{
+        .name = m_name,
+        .category = m_category,
+        .begin = m_begin,
+        .end = std::chrono::steady_clock::now(),
+        .threadId = currentThreadId(),
+    });
+}
+
+}   // namespace odxf
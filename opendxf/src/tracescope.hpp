@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+// Trace scopes of the library itself. Without OPENDXF_ENABLE_TRACING they expand to
+// nothing, so the hooks cost nothing in regular builds.
+
+#ifdef OPENDXF_ENABLE_TRACING
+#    include "opendxf/trace.hpp"
+
+#    define OPENDXF_TRACE_CONCAT_IMPL(a, b) a##b
+#    define OPENDXF_TRACE_CONCAT(a, b) OPENDXF_TRACE_CONCAT_IMPL(a, b)
+#    define OPENDXF_TRACE_SCOPE(name)                                                          \
+        const odxf::TraceScope OPENDXF_TRACE_CONCAT(traceScope, __LINE__)                      \
+        {                                                                                      \
+            name, "opendxf"                                                                    \
+        }
+#else
+#    define OPENDXF_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,502 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/transform.hpp"
+#include "opendxf/tessellate.hpp"
+
+#include "geometry.hpp"
+#include "parallel.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using odxf::Coordinate3d;
+using odxf::Curve;
+using odxf::fullTurn;
+using odxf::Ocs;
+using odxf::Vector3d;
+using odxf::zAxis;
+
+// relative deviation below which a plane counts as mapped conformally
+constexpr double conformalTolerance{ 1.0e-9 };
+
+// Extrusions are only set if they were set before or differ from the default.
+std::optional<Vector3d>
+extrusionOf(const Vector3d& extrusion, const std::optional<Vector3d>& previous)
+{
+    if (!previous && extrusion == zAxis) {
+        return std::nullopt;
+    }
+
+    return extrusion;
+}
+
+class Mapping final
+{
+public:
+    explicit Mapping(const odxf::Affine3d& affine)
+        : m_affine{ affine }
+    {
+    }
+
+    Vector3d vector(const Vector3d& vector) const
+    {
+        const std::array<double, 9>& m{ m_affine.linear };
+
+        return Vector3d{ m[0] * vector.x + m[1] * vector.y + m[2] * vector.z,
+                         m[3] * vector.x + m[4] * vector.y + m[5] * vector.z,
+                         m[6] * vector.x + m[7] * vector.y + m[8] * vector.z };
+    }
+
+    Vector3d point(const Vector3d& point) const
+    {
+        return vector(point) + toVector(m_affine.translation);
+    }
+
+    Coordinate3d point(const Coordinate3d& point) const
+    {
+        return toCoordinate(this->point(toVector(point)));
+    }
+
+private:
+    odxf::Affine3d m_affine;
+};
+
+// The image of a plane with the given axes and normal. The new normal points to the side
+// of the previous one, so mirroring the plane reverses its orientation instead of flipping
+// the normal.
+struct PlaneImage final
+{
+    PlaneImage(const Vector3d& xAxis, const Vector3d& yAxis, const Vector3d& previousNormal)
+    {
+        const Vector3d orientedNormal{ normalized(cross(xAxis, yAxis)) };
+        keepsOrientation = dot(orientedNormal, previousNormal) >= 0.0;
+        normal = keepsOrientation ? orientedNormal : -orientedNormal;
+
+        const double xLength{ length(xAxis) };
+        const double yLength{ length(yAxis) };
+        const double scale{ std::max(xLength, yLength) };
+        isConformal = std::abs(xLength - yLength) <= conformalTolerance * scale
+                      && std::abs(dot(xAxis, yAxis)) <= conformalTolerance * scale * scale;
+    }
+
+    Vector3d normal;
+    bool keepsOrientation{ true };
+    bool isConformal{ true };
+};
+
+Curve transformed(const Curve& curve, const Mapping& mapping)
+{
+    return Curve{
+        .center = mapping.point(curve.center),
+        .u = mapping.vector(curve.u),
+        .v = mapping.vector(curve.v),
+        .start = curve.start,
+        .sweep = curve.sweep,
+    };
+}
+
+// The ellipse of a curve, whose conjugate semi-diameters u and v are rotated to the
+// principal axes.
+odxf::Ellipse toEllipse(const Curve& curve, const PlaneImage& plane, bool isClosed)
+{
+    const double uu{ dot(curve.u, curve.u) };
+    const double vv{ dot(curve.v, curve.v) };
+    double rotation{ 0.5 * std::atan2(2.0 * dot(curve.u, curve.v), uu - vv) };
+    Vector3d major{ std::cos(rotation) * curve.u + std::sin(rotation) * curve.v };
+    Vector3d minor{ -std::sin(rotation) * curve.u + std::cos(rotation) * curve.v };
+    if (length(minor) > length(major)) {
+        // the same curve with the parameter shifted by a quarter turn
+        rotation += std::numbers::pi / 2.0;
+        const Vector3d previousMajor{ major };
+        major = minor;
+        minor = -previousMajor;
+    }
+
+    odxf::Ellipse ellipse;
+    ellipse.center = toCoordinate(curve.center);
+    ellipse.endPointMajor = toCoordinate(major);
+    ellipse.axisRatio = length(major) > 0.0 ? length(minor) / length(major) : 1.0;
+
+    if (isClosed) {
+        ellipse.startParameter = 0.0;
+        ellipse.endParameter = fullTurn;
+    } else {
+        // mirrored ellipses run in the opposite direction
+        const double start{ plane.keepsOrientation ? curve.start - rotation
+                                                   : rotation - (curve.start + curve.sweep) };
+        ellipse.startParameter = start - fullTurn * std::floor(start / fullTurn);
+        ellipse.endParameter = ellipse.startParameter + curve.sweep;
+    }
+
+    return ellipse;
+}
+
+std::optional<double> scaledThickness(
+    const std::optional<double>& thickness, const Vector3d& mappedNormal, const Vector3d& normal)
+{
+    if (!thickness) {
+        return std::nullopt;
+    }
+
+    return *thickness * dot(mappedNormal, normal);
+}
+
+// Returns the ellipse replacing the circle if its plane is not mapped conformally.
+std::optional<odxf::Ellipse> transform(odxf::Circle& circle, const Mapping& mapping)
+{
+    const Vector3d previousNormal{ circle.extrusion.value_or(zAxis) };
+    const Ocs ocs{ previousNormal };
+    const Curve curve{ transformed(
+        Curve{
+            .center = ocs.toWorld(circle.center),
+            .u = circle.radius * ocs.x,
+            .v = circle.radius * ocs.y,
+        },
+        mapping) };
+    const PlaneImage plane{ mapping.vector(ocs.x), mapping.vector(ocs.y), ocs.z };
+    const std::optional<double> thickness{
+        scaledThickness(circle.thickness, mapping.vector(ocs.z), plane.normal)
+    };
+
+    if (!plane.isConformal) {
+        odxf::Ellipse ellipse{ toEllipse(curve, plane, true) };
+        static_cast<odxf::Entity&>(ellipse) = std::move(circle);
+        ellipse.extrusion = extrusionOf(plane.normal, circle.extrusion);
+
+        return ellipse;
+    }
+
+    const Ocs mappedOcs{ plane.normal };
+    circle.center = mappedOcs.toObject(curve.center);
+    circle.radius = length(curve.u);
+    circle.extrusion = extrusionOf(plane.normal, circle.extrusion);
+    circle.thickness = thickness;
+
+    return std::nullopt;
+}
+
+// Returns the ellipse replacing the arc if its plane is not mapped conformally.
+std::optional<odxf::Ellipse> transform(odxf::Arc& arc, const Mapping& mapping)
+{
+    const Vector3d previousNormal{ arc.extrusion.value_or(zAxis) };
+    const Ocs ocs{ previousNormal };
+
+    const Curve curve{ transformed(odxf::arcCurve(arc), mapping) };
+    const PlaneImage plane{ mapping.vector(ocs.x), mapping.vector(ocs.y), ocs.z };
+    const std::optional<double> thickness{
+        scaledThickness(arc.thickness, mapping.vector(ocs.z), plane.normal)
+    };
+
+    if (!plane.isConformal) {
+        odxf::Ellipse ellipse{ toEllipse(curve, plane, false) };
+        static_cast<odxf::Entity&>(ellipse) = std::move(arc);
+        ellipse.extrusion = extrusionOf(plane.normal, arc.extrusion);
+
+        return ellipse;
+    }
+
+    const double end{ curve.start + curve.sweep };
+    const Vector3d startDirection{ std::cos(curve.start) * curve.u
+                                   + std::sin(curve.start) * curve.v };
+    const Vector3d endDirection{ std::cos(end) * curve.u + std::sin(end) * curve.v };
+
+    const Ocs mappedOcs{ plane.normal };
+    arc.center = mappedOcs.toObject(curve.center);
+    arc.radius = length(curve.u);
+    arc.startAngle = mappedOcs.angle(plane.keepsOrientation ? startDirection : endDirection);
+    arc.endAngle = mappedOcs.angle(plane.keepsOrientation ? endDirection : startDirection);
+    arc.extrusion = extrusionOf(plane.normal, arc.extrusion);
+    arc.thickness = thickness;
+
+    return std::nullopt;
+}
+
+void transform(odxf::Ellipse& ellipse, const Mapping& mapping)
+{
+    const Vector3d previousNormal{ normalized(ellipse.extrusion.value_or(zAxis)) };
+    const Vector3d major{ toVector(ellipse.endPointMajor) };
+    const Vector3d minor{ odxf::ellipseMinorAxis(ellipse) };
+
+    const Curve curve{ transformed(
+        Curve{
+            .center = toVector(ellipse.center),
+            .u = major,
+            .v = minor,
+            .start = ellipse.startParameter,
+            .sweep = ellipse.endParameter - ellipse.startParameter,
+        },
+        mapping) };
+    const PlaneImage plane{ mapping.vector(major), mapping.vector(minor), previousNormal };
+
+    const bool isClosed{ curve.sweep >= fullTurn || curve.sweep == 0.0 };
+
+    odxf::Ellipse result{ toEllipse(curve, plane, isClosed) };
+    ellipse.center = result.center;
+    ellipse.endPointMajor = result.endPointMajor;
+    ellipse.axisRatio = result.axisRatio;
+    if (!isClosed) {
+        ellipse.startParameter = result.startParameter;
+        ellipse.endParameter = result.endParameter;
+    }
+    ellipse.extrusion = extrusionOf(plane.normal, ellipse.extrusion);
+}
+
+// Maps the direction of thickness of an entity given in world coordinates.
+template <typename T>
+void transformExtrusion(T& entity, const Mapping& mapping)
+{
+    if (!entity.extrusion && !entity.thickness) {
+        return;
+    }
+
+    const Vector3d extrusion{ mapping.vector(normalized(entity.extrusion.value_or(zAxis))) };
+    const double extrusionLength{ length(extrusion) };
+    if (entity.thickness) {
+        *entity.thickness *= extrusionLength;
+    }
+    entity.extrusion = extrusionOf(normalized(extrusion), entity.extrusion);
+}
+
+void transform(odxf::Line& line, const Mapping& mapping)
+{
+    line.start = mapping.point(line.start);
+    line.end = mapping.point(line.end);
+    transformExtrusion(line, mapping);
+}
+
+void transform(odxf::Point& point, const Mapping& mapping)
+{
+    point.coordinate = mapping.point(point.coordinate);
+    transformExtrusion(point, mapping);
+}
+
+void transform(odxf::Ray& ray, const Mapping& mapping)
+{
+    ray.startPoint = mapping.point(ray.startPoint);
+    ray.direction = normalized(mapping.vector(ray.direction));
+}
+
+// Lw polylines have no extrusion, so they stay parallel to the xy plane. Their vertices are
+// mapped and projected onto it, the elevation is the z coordinate of the mapped point
+// (0, 0, elevation).
+void transform(
+    odxf::LWPolyline& lwPolyline, const Mapping& mapping, const odxf::TransformOptions& options)
+{
+    const auto project{ [](const Vector3d& vector) {
+        return Vector3d{ vector.x, vector.y, 0.0 };
+    } };
+    const PlaneImage plane{ project(mapping.vector(Vector3d{ 1.0, 0.0, 0.0 })),
+                            project(mapping.vector(Vector3d{ 0.0, 1.0, 0.0 })),
+                            zAxis };
+
+    const bool hasBulges{ std::any_of(
+        lwPolyline.vertices.begin(), lwPolyline.vertices.end(), [](const odxf::Vertex& vertex) {
+            return vertex.bulge && *vertex.bulge != 0.0;
+        }) };
+    if (hasBulges && !plane.isConformal) {
+        // the bulged segments would become elliptical arcs
+        const odxf::TessellateOptions tessellateOptions{ .chordTolerance = options.chordTolerance };
+        std::vector<Coordinate3d> points(odxf::vertexCount(lwPolyline, tessellateOptions));
+        odxf::tessellate(lwPolyline, tessellateOptions, points);
+        if (lwPolyline.isClosed) {
+            points.pop_back();
+        }
+
+        lwPolyline.vertices.resize(points.size());
+        for (std::size_t i{ 0 }; i < points.size(); ++i) {
+            lwPolyline.vertices[i] = odxf::Vertex{ .position = { points[i].x, points[i].y } };
+        }
+    }
+
+    const double elevation{ lwPolyline.elevation.value_or(0.0) };
+    for (odxf::Vertex& vertex : lwPolyline.vertices) {
+        const Vector3d position{
+            mapping.point(Vector3d{ vertex.position.x, vertex.position.y, elevation })
+        };
+        vertex.position = odxf::Coordinate2d{ position.x, position.y };
+        if (vertex.bulge && !plane.keepsOrientation) {
+            vertex.bulge = -*vertex.bulge;
+        }
+    }
+
+    const double mappedElevation{ mapping.point(Vector3d{ 0.0, 0.0, elevation }).z };
+    if (lwPolyline.elevation || mappedElevation != 0.0) {
+        lwPolyline.elevation = mappedElevation;
+    }
+}
+
+// Transforms the entities in parallel ranges.
+template <typename T, typename Function>
+void transformAll(std::vector<T>& entities, unsigned int threadCount, Function&& function)
+{
+    odxf::parallelFor(threadCount, threadCount, [&](std::size_t index) {
+        const odxf::ChunkRange range{ odxf::chunkRange(entities.size(), threadCount, index) };
+        for (std::size_t i{ range.begin }; i < range.end; ++i) {
+            function(entities[i]);
+        }
+    });
+}
+
+// Transforms circles or arcs in parallel ranges and moves those becoming ellipses to the
+// ellipses.
+template <typename T>
+void transformCircular(
+    std::vector<T>& entities,
+    odxf::Ellipses& ellipses,
+    const Mapping& mapping,
+    unsigned int threadCount)
+{
+    std::vector<std::vector<std::pair<std::size_t, odxf::Ellipse>>> converted(threadCount);
+    odxf::parallelFor(threadCount, threadCount, [&](std::size_t index) {
+        const odxf::ChunkRange range{ odxf::chunkRange(entities.size(), threadCount, index) };
+        for (std::size_t i{ range.begin }; i < range.end; ++i) {
+            std::optional<odxf::Ellipse> ellipse{ transform(entities[i], mapping) };
+            if (ellipse) {
+                converted[index].emplace_back(i, std::move(*ellipse));
+            }
+        }
+    });
+
+    std::vector<std::uint8_t> isConverted(entities.size(), 0);
+    for (std::vector<std::pair<std::size_t, odxf::Ellipse>>& chunk : converted) {
+        for (auto& [index, ellipse] : chunk) {
+            isConverted[index] = 1;
+            ellipses.push_back(std::move(ellipse));
+        }
+    }
+
+    std::size_t count{ 0 };
+    for (std::size_t i{ 0 }; i < entities.size(); ++i) {
+        if (isConverted[i] == 0) {
+            if (count != i) {
+                entities[count] = std::move(entities[i]);
+            }
+            ++count;
+        }
+    }
+    entities.erase(entities.begin() + static_cast<std::ptrdiff_t>(count), entities.end());
+}
+
+}   // namespace
+
+namespace odxf {
+
+Affine2d Affine2d::translate(double x, double y)
+{
+    return Affine2d{ .translation = { x, y } };
+}
+
+Affine2d Affine2d::scale(double factor)
+{
+    return scale(factor, factor);
+}
+
+Affine2d Affine2d::scale(double x, double y)
+{
+    return Affine2d{ .linear = { x, 0.0, 0.0, y } };
+}
+
+Affine2d Affine2d::rotate(double angle)
+{
+    const double radians{ angle * std::numbers::pi / 180.0 };
+    const double cosine{ std::cos(radians) };
+    const double sine{ std::sin(radians) };
+
+    return Affine2d{ .linear = { cosine, -sine, sine, cosine } };
+}
+
+Affine2d operator*(const Affine2d& lhs, const Affine2d& rhs)
+{
+    const std::array<double, 4>& a{ lhs.linear };
+    const std::array<double, 4>& b{ rhs.linear };
+    const Coordinate2d& t{ rhs.translation };
+
+    return Affine2d{
+        .linear = { a[0] * b[0] + a[1] * b[2],
+                    a[0] * b[1] + a[1] * b[3],
+                    a[2] * b[0] + a[3] * b[2],
+                    a[2] * b[1] + a[3] * b[3] },
+        .translation = { a[0] * t.x + a[1] * t.y + lhs.translation.x,
+                         a[2] * t.x + a[3] * t.y + lhs.translation.y },
+    };
+}
+
+Affine3d Affine3d::translate(double x, double y, double z)
+{
+    return Affine3d{ .translation = { x, y, z } };
+}
+
+Affine3d Affine3d::scale(double factor)
+{
+    return scale(factor, factor, factor);
+}
+
+Affine3d Affine3d::scale(double x, double y, double z)
+{
+    return Affine3d{ .linear = { x, 0.0, 0.0, 0.0, y, 0.0, 0.0, 0.0, z } };
+}
+
+Affine3d Affine3d::fromAffine2d(const Affine2d& affine)
+{
+    const std::array<double, 4>& m{ affine.linear };
+
+    return Affine3d{
+        .linear = { m[0], m[1], 0.0, m[2], m[3], 0.0, 0.0, 0.0, 1.0 },
+        .translation = { affine.translation.x, affine.translation.y, 0.0 },
+    };
+}
+
+Affine3d operator*(const Affine3d& lhs, const Affine3d& rhs)
+{
+    const Mapping mapping{ lhs };
+    Affine3d result;
+    for (std::size_t column{ 0 }; column < 3; ++column) {
+        const Vector3d mapped{ mapping.vector(Vector3d{ rhs.linear[column],
+                                                        rhs.linear[3 + column],
+                                                        rhs.linear[6 + column] }) };
+        result.linear[column] = mapped.x;
+        result.linear[3 + column] = mapped.y;
+        result.linear[6 + column] = mapped.z;
+    }
+    result.translation = mapping.point(rhs.translation);
+
+    return result;
+}
+
+void transform(Entities& entities, const Affine2d& affine, const TransformOptions& options)
+{
+    transform(entities, Affine3d::fromAffine2d(affine), options);
+}
+
+void transform(Entities& entities, const Affine3d& affine, const TransformOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("transform");
+
+    const Mapping mapping{ affine };
+    const unsigned int threadCount{ resolveThreadCount(options.threadCount) };
+
+    // existing ellipses first, the converted circles and arcs are appended
+    transformAll(entities.ellipses, threadCount, [&](Ellipse& ellipse) {
+        ::transform(ellipse, mapping);
+    });
+    transformCircular(entities.arcs, entities.ellipses, mapping, threadCount);
+    transformCircular(entities.circles, entities.ellipses, mapping, threadCount);
+
+    transformAll(entities.lines, threadCount, [&](Line& line) { ::transform(line, mapping); });
+    transformAll(entities.points, threadCount, [&](Point& point) { ::transform(point, mapping); });
+    transformAll(entities.rays, threadCount, [&](Ray& ray) { ::transform(ray, mapping); });
+    transformAll(entities.lwPolylines, threadCount, [&](LWPolyline& lwPolyline) {
+        ::transform(lwPolyline, mapping, options);
+    });
+}
+
+}   // namespace odxf
@@ -3,345 +3,184 @@
 
 #include "opendxf/write.hpp"
 
-#include <fstream>
-#include <iomanip>
+#include "opendxf/dxfwriter.hpp"
+#include "opendxf/extents.hpp"
+
+#include "dxfformat.hpp"
+#include "outputbuffer.hpp"
+#include "tracescope.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 namespace {
 
-template <typename... Ts>
-struct overload : Ts...
-{
-    using Ts::operator()...;
-};
+// number of entities per type formatted by estimateDxfSize()
+constexpr std::size_t estimateSampleSize{ 256 };
 
-template <typename... Ts>
-overload(Ts...) -> overload<Ts...>;
+constexpr std::string_view extentsMinKey{ "$EXTMIN" };
+constexpr std::string_view extentsMaxKey{ "$EXTMAX" };
 
-void writeHeader(std::ofstream& stream, const odxf::Header& header)
+// Formats evenly spaced samples of the items and extrapolates their total size.
+template <typename T, typename WriteItem>
+std::uintmax_t
+estimateItemsSize(odxf::OutputBuffer& buffer, const std::vector<T>& items, WriteItem writeItem)
 {
-    stream << "999\nopendxf";
-    stream << "\n0\nSECTION";
-    stream << "\n2\nHEADER";
-
-    for (const auto& [key, value] : header.entries) {
-        stream << "\n9\n" << key;
-        std::visit(
-            overload{ [&stream, &key](bool element) {
-                         stream << "\n290\n";
-                         stream << element;
-                     },
-                      [&stream, &key](int element) {
-                          if (key == "$CECOLOR" || key == "$INTERFERECOLOR") {
-                              stream << "\n62\n";
-                          } else if (
-                              key == "$ENDCAPS" || key == "$JOINSTYLE" || key == "$SORTENTS"
-                              || key == "$INDEXCTL" || key == "$HIDETEXT" || key == "$HALOGAP"
-                              || key == "$OBSLTYPE" || key == "$INTERSECTIONDISPLAY"
-                              || key == "$DIMASSOC" || key == "$LOFTNORMALS"
-                              || key == "$LIGHTGLYPHDISPLAY" || key == "$TILEMODELIGHTSYNCH"
-                              || key == "$SOLIDHIST" || key == "$SHOWHIST" || key == "$DWFFRAME"
-                              || key == "$DGNFRAME" || key == "$CSHADOW") {
-                              stream << "\n280\n";
-                          } else if (key == "$CELWEIGHT") {
-                              stream << "\n370\n";
-                          } else if (key == "$CEPSNTYPE") {
-                              stream << "\n380\n";
-                          } else {
-                              stream << "\n70\n";
-                          }
-                          stream << element;
-                      },
-                      [&stream, &key](double element) {
-                          if (key == "$ANGBASE") {
-                              stream << "\n50\n";
-                          } else {
-                              stream << "\n40\n";
-                          }
-                          stream << element;
-                      },
-                      [&stream, &key](const std::string& element) {
-                          if (key == "$DIMSTYLE") {
-                              stream << "\n2\n";
-                          } else if (key == "$HANDSEED") {
-                              stream << "\n5\n";
-                          } else if (
-                              key == "$CELTYPE" || key == "$DIMLTYPE" || key == "$DIMLTEX1"
-                              || key == "$DIMLTEX2") {
-                              stream << "\n6\n";
-                          } else if (key == "$TEXTSTYLE" || key == "$DIMTXSTY") {
-                              stream << "\n7\n";
-                          } else if (key == "$CLAYER") {
-                              stream << "\n8\n";
-                          } else {
-                              stream << "\n1\n";
-                          }
-                          stream << element;
-                      },
-                      [&stream](const odxf::Coordinate2d& coord) {
-                          stream << "\n10\n";
-                          stream << coord.x;
-                          stream << "\n20\n";
-                          stream << coord.y;
-                      },
-                      [&stream](const odxf::Coordinate3d& coord) {
-                          stream << "\n10\n";
-                          stream << coord.x;
-                          stream << "\n20\n";
-                          stream << coord.y;
-                          stream << "\n30\n";
-                          stream << coord.z;
-                      } },
-            value);
+    if (items.empty()) {
+        return 0;
     }
 
-    stream << "\n0\nENDSEC";
-}
-
-void writeLineType(std::ofstream& stream, const odxf::LineType& lineType)
-{
-    stream << "\n0\nLTYPE";
-    stream << "\n2\n" << lineType.name;
-    stream << "\n70\n" << lineType.flags;
-    stream << "\n3\n" << lineType.displayName;
-    stream << "\n72\n65";
-    stream << "\n73\n0";
-    stream << "\n40\n0";
-}
+    const std::size_t sampleSize{ std::min(items.size(), estimateSampleSize) };
 
-void writeLineTypes(std::ofstream& stream, const std::vector<odxf::LineType>& lineTypes)
-{
-    stream << "\n0\nTABLE";
-    stream << "\n2\nLTYPE";
-    stream << "\n70\n" << lineTypes.size();
-    for (const odxf::LineType& lineType : lineTypes) {
-        writeLineType(stream, lineType);
+    buffer.clear();
+    for (std::size_t i{ 0 }; i < sampleSize; ++i) {
+        writeItem(buffer, items[i * items.size() / sampleSize]);
     }
-    stream << "\n0\nENDTAB";
-}
 
-void writeLayer(std::ofstream& stream, const odxf::Layer& layer, const std::string& lineTypeName)
-{
-    stream << "\n0\nLAYER";
-    stream << "\n2\n" << layer.name;
-    stream << "\n70\n" << layer.flags;
-    stream << "\n62\n" << layer.color;
-    stream << "\n6\n" << lineTypeName;
+    return buffer.content().size() * items.size() / sampleSize;
 }
 
-void writeLayers(
-    std::ofstream& stream,
-    const std::vector<odxf::Layer>& layers,
-    const std::vector<odxf::LineType>& lineTypes)
+// The extents replacing those in the header, if requested and there are entities.
+std::optional<odxf::Extents>
+updatedExtents(const odxf::Document& document, const odxf::WriteOptions& options)
 {
-    stream << "\n0\nTABLE";
-    stream << "\n2\nLAYER";
-    stream << "\n70\n" << layers.size();
-    for (const odxf::Layer& layer : layers) {
-        writeLayer(stream, layer, lineTypes.at(layer.lineType).name);
+    if (!options.updateExtents) {
+        return std::nullopt;
     }
-    stream << "\n0\nENDTAB";
-}
 
-void writeTables(std::ofstream& stream, const odxf::Tables& tables)
-{
-    stream << "\n0\nSECTION";
-    stream << "\n2\nTABLES";
-    writeLineTypes(stream, tables.lineTypes);
-    writeLayers(stream, tables.layers, tables.lineTypes);
-    stream << "\n0\nENDSEC";
-}
+    const odxf::Extents extents{ odxf::computeExtents(
+        document.entities, odxf::ExtentsOptions{ .threadCount = options.threadCount }) };
+    if (extents.isEmpty()) {
+        return std::nullopt;
+    }
 
-void writeBlocks(std::ofstream& stream)
-{
-    stream << "\n0\nSECTION";
-    stream << "\n2\nBLOCKS";
-    stream << "\n0\nENDSEC";
+    return extents;
 }
 
-void writeCoordinate(std::ofstream& stream, const odxf::Coordinate3d& coordinate)
+tl::expected<void, odxf::Error> writeDocument(
+    odxf::DxfWriter& writer, const odxf::Document& document, const odxf::WriteOptions& options)
 {
-    stream << "\n10\n" << std::to_string(coordinate.x);
-    stream << "\n20\n" << std::to_string(coordinate.y);
-    stream << "\n30\n" << std::to_string(coordinate.z);
-}
+    if (tl::expected<void, odxf::Error> maybeError = writer.beginHeader(); !maybeError) {
+        return maybeError;
+    }
 
-void writeThickness(std::ofstream& stream, const std::optional<double>& maybeThickness)
-{
-    if (maybeThickness) {
-        stream << "\n39\n" << *maybeThickness;
+    const std::optional<odxf::Extents> extents{ updatedExtents(document, options) };
+    for (const auto& [key, value] : document.header.entries) {
+        if (extents && (key == extentsMinKey || key == extentsMaxKey)) {
+            continue;
+        }
+
+        if (tl::expected<void, odxf::Error> maybeError = writer.headerVariable(key, value);
+            !maybeError) {
+            return maybeError;
+        }
     }
-}
 
-void writeExtrusion(std::ofstream& stream, const std::optional<odxf::Vector3d>& maybeExtrusion)
-{
-    if (maybeExtrusion) {
-        const odxf::Vector3d& extrusion{ *maybeExtrusion };
-        stream << "\n210\n" << std::to_string(extrusion.x);
-        stream << "\n220\n" << std::to_string(extrusion.y);
-        stream << "\n230\n" << std::to_string(extrusion.z);
+    if (extents) {
+        if (tl::expected<void, odxf::Error> maybeError =
+                writer.headerVariable(odxf::HeaderKey{ extentsMinKey }, extents->min);
+            !maybeError) {
+            return maybeError;
+        }
+
+        if (tl::expected<void, odxf::Error> maybeError =
+                writer.headerVariable(odxf::HeaderKey{ extentsMaxKey }, extents->max);
+            !maybeError) {
+            return maybeError;
+        }
     }
-}
 
-void writePoint(std::ofstream& stream, const odxf::Point& point)
-{
-    stream << "\n0\nLINE\n100\nAcDbPoint";
-    stream << "\n8\n" << point.layer;
-    stream << "\n62\n" << point.color;
-    writeThickness(stream, point.thickness);
-    stream << "\n10\n" << std::to_string(point.coordinate.x);
-    stream << "\n20\n" << std::to_string(point.coordinate.y);
-    stream << "\n30\n" << std::to_string(point.coordinate.z);
-    writeExtrusion(stream, point.extrusion);
-}
+    if (tl::expected<void, odxf::Error> maybeError = writer.beginTables(); !maybeError) {
+        return maybeError;
+    }
 
+    for (const odxf::LineType& lineType : document.tables.lineTypes) {
+        if (tl::expected<void, odxf::Error> maybeError = writer.lineType(lineType); !maybeError) {
+            return maybeError;
+        }
+    }
 
-void writeRay(std::ofstream& stream, const odxf::Ray& ray)
-{
-    stream << "\n0\nLINE\n100\nAcDbRay";
-    stream << "\n8\n" << ray.layer;
-    stream << "\n62\n" << ray.color;
-    stream << "\n10\n" << std::to_string(ray.startPoint.x);
-    stream << "\n20\n" << std::to_string(ray.startPoint.y);
-    stream << "\n30\n" << std::to_string(ray.startPoint.z);
-    stream << "\n11\n" << std::to_string(ray.direction.x);
-    stream << "\n21\n" << std::to_string(ray.direction.y);
-    stream << "\n31\n" << std::to_string(ray.direction.z);
-}
+    for (const odxf::Layer& layer : document.tables.layers) {
+        if (tl::expected<void, odxf::Error> maybeError = writer.layer(layer); !maybeError) {
+            return maybeError;
+        }
+    }
 
-void writeLine(std::ofstream& stream, const odxf::Line& line)
-{
-    stream << "\n0\nLINE\n100\nAcDbLine";
-    stream << "\n8\n" << line.layer;
-    stream << "\n62\n" << line.color;
-    writeThickness(stream, line.thickness);
-    stream << "\n10\n" << std::to_string(line.start.x);
-    stream << "\n20\n" << std::to_string(line.start.y);
-    stream << "\n30\n" << std::to_string(line.start.z);
-    stream << "\n11\n" << std::to_string(line.end.x);
-    stream << "\n21\n" << std::to_string(line.end.y);
-    stream << "\n31\n" << std::to_string(line.end.z);
-    writeExtrusion(stream, line.extrusion);
-}
+    if (tl::expected<void, odxf::Error> maybeError = writer.beginEntities(); !maybeError) {
+        return maybeError;
+    }
 
-void writeCircle(std::ofstream& stream, const odxf::Circle& circle)
-{
-    stream << "\n0\nCIRCLE\n100\nAcDbCircle";
-    stream << "\n8\n" << circle.layer;
-    stream << "\n62\n" << circle.color;
-    writeThickness(stream, circle.thickness);
-    stream << "\n10\n" << std::to_string(circle.center.x);
-    stream << "\n20\n" << std::to_string(circle.center.y);
-    stream << "\n30\n" << std::to_string(circle.center.z);
-    stream << "\n40\n" << std::to_string(circle.radius);
-    writeExtrusion(stream, circle.extrusion);
-}
+    if (tl::expected<void, odxf::Error> maybeError = writer.entities(document.entities);
+        !maybeError) {
+        return maybeError;
+    }
 
-void writeArc(std::ofstream& stream, const odxf::Arc& arc)
-{
-    stream << "\n0\nARC\n100\nAcDbCircle";
-    stream << "\n8\n" << arc.layer;
-    stream << "\n62\n" << arc.color;
-    writeThickness(stream, arc.thickness);
-    stream << "\n10\n" << std::to_string(arc.center.x);
-    stream << "\n20\n" << std::to_string(arc.center.y);
-    stream << "\n30\n" << std::to_string(arc.center.z);
-    stream << "\n40\n" << std::to_string(arc.radius);
-    stream << "\n100\nAcDbArc";
-    stream << "\n50\n" << std::to_string(arc.startAngle);
-    stream << "\n51\n" << std::to_string(arc.endAngle);
-    writeExtrusion(stream, arc.extrusion);
+    return writer.finish();
 }
 
-void writeEllipse(std::ofstream& stream, const odxf::Ellipse& ellipse)
-{
-    stream << "\n0\nARC\n100\nAcDbEllipse";
-    stream << "\n8\n" << ellipse.layer;
-    stream << "\n62\n" << ellipse.color;
-    stream << "\n10\n" << std::to_string(ellipse.center.x);
-    stream << "\n20\n" << std::to_string(ellipse.center.y);
-    stream << "\n30\n" << std::to_string(ellipse.center.z);
-    stream << "\n11\n" << std::to_string(ellipse.endPointMajor.x);
-    stream << "\n21\n" << std::to_string(ellipse.endPointMajor.y);
-    stream << "\n31\n" << std::to_string(ellipse.endPointMajor.z);
-    stream << "\n40\n" << std::to_string(ellipse.axisRatio);
-    stream << "\n41\n" << std::to_string(ellipse.startParameter);
-    stream << "\n42\n" << std::to_string(ellipse.endParameter);
-    writeExtrusion(stream, ellipse.extrusion);
-}
+}   // namespace
 
-void writeLWPolyline(std::ofstream& stream, const odxf::LWPolyline& lwPolyline)
-{
-    stream << "\n0\nLWPOLYLINE\n100\nAcDbPolyline";
-    stream << "\n8\n" << lwPolyline.layer;
-    stream << "\n62\n" << lwPolyline.color;
-    stream << "\n90\n" << lwPolyline.vertices.size();
-    stream << "\n70\n" << lwPolyline.isClosed ? 1 : 0;
-
-    for (const odxf::Vertex& vertex : lwPolyline.vertices) {
-        stream << "\n10\n" << std::to_string(vertex.position.x);
-        stream << "\n20\n" << std::to_string(vertex.position.y);
-        if (vertex.bulge.has_value()) {
-            stream << "\n42\n" << std::to_string(*vertex.bulge);
-        }
-    }
-}
+namespace odxf {
 
-void writeEntities(
-    std::ofstream& stream, const odxf::Entities& entities, const odxf::Tables& tables)
+std::uintmax_t estimateDxfSize(const Document& document, const WriteOptions& options)
 {
-    stream << "\n0\nSECTION\n2\nENTITIES";
+    // section and table markers
+    constexpr std::uintmax_t framingSize{ 256 };
 
-    for (const odxf::Point& point : entities.points) {
-        writePoint(stream, point);
-    }
+    OutputBuffer buffer{ options.numberFormat };
 
-    for (const odxf::Ray& ray : entities.rays) {
-        writeRay(stream, ray);
+    for (const auto& [key, value] : document.header.entries) {
+        writeHeaderVariable(buffer, key, value);
     }
 
-    for (const odxf::Line& line : entities.lines) {
-        writeLine(stream, line);
+    const std::vector<LineType>& lineTypes{ document.tables.lineTypes };
+    for (const LineType& lineType : lineTypes) {
+        writeLineType(buffer, lineType);
     }
 
-    for (const odxf::Circle& circle : entities.circles) {
-        writeCircle(stream, circle);
+    for (const Layer& layer : document.tables.layers) {
+        const auto lineTypeIndex{ static_cast<std::size_t>(layer.lineType) };
+        const std::string_view lineTypeName{
+            layer.lineType >= 0 && lineTypeIndex < lineTypes.size() ? lineTypes[lineTypeIndex].name
+                                                                     : std::string_view{}
+        };
+        writeLayer(buffer, layer, lineTypeName);
     }
 
-    for (const odxf::Arc& arc : entities.arcs) {
-        writeArc(stream, arc);
-    }
+    std::uintmax_t size{ framingSize + buffer.content().size() };
 
-    for (const odxf::Ellipse& ellipse : entities.ellipses) {
-        writeEllipse(stream, ellipse);
-    }
+    const Entities& entities{ document.entities };
+    size += estimateItemsSize(buffer, entities.points, writePoint);
+    size += estimateItemsSize(buffer, entities.rays, writeRay);
+    size += estimateItemsSize(buffer, entities.lines, writeLine);
+    size += estimateItemsSize(buffer, entities.circles, writeCircle);
+    size += estimateItemsSize(buffer, entities.arcs, writeArc);
+    size += estimateItemsSize(buffer, entities.ellipses, writeEllipse);
+    size += estimateItemsSize(buffer, entities.lwPolylines, writeLWPolyline);
 
-    for (const odxf::LWPolyline& lwPolyline : entities.lwPolylines) {
-        writeLWPolyline(stream, lwPolyline);
-    }
-
-    stream << "\n0\nENDSEC";
+    return size;
 }
 
-void writeEof(std::ofstream& stream) { stream << "\n0\nEOF"; }
+tl::expected<void, Error> writeDxf(
+    const Document& document, const std::filesystem::path& file_path, const WriteOptions& options)
+{
+    OPENDXF_TRACE_SCOPE("writeDxf");
 
-}   // namespace
+    DxfWriter writer{ file_path, options };
 
-namespace odxf {
+    return writeDocument(writer, document, options);
+}
 
-void writeDxf(const Document& document, const std::filesystem::path& file_path)
+tl::expected<void, Error>
+writeDxf(const Document& document, IOutputSink& sink, const WriteOptions& options)
 {
-    std::ofstream stream{ file_path };
-    if (!stream.is_open()) {
-        return;
-    }
+    OPENDXF_TRACE_SCOPE("writeDxf");
 
-    stream << std::setprecision(16);
+    DxfWriter writer{ sink, options };
 
-    writeHeader(stream, document.header);
-    writeTables(stream, document.tables);
-    writeBlocks(stream);
-    writeEntities(stream, document.entities, document.tables);
-    writeEof(stream);
+    return writeDocument(writer, document, options);
 }
 
 }   // namespace odxf
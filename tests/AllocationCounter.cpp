@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{ 0 };
+
+void* allocate(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const auto align{ static_cast<std::size_t>(alignment) };
+    // aligned_alloc requires the size to be a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+}   // namespace
+
+std::uint64_t allocationCount() { return allocations.load(std::memory_order_relaxed); }
+
+void* operator new(std::size_t size)
+{
+    if (void* pointer = allocate(size)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = allocateAligned(size, alignment)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
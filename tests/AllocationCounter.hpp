@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include <cstdint>
+
+// Number of heap allocations through the global operator new of this program so far.
+// Linking AllocationCounter.cpp replaces the global allocation functions.
+std::uint64_t allocationCount();
+
+// Counts the allocations of all threads from its construction on.
+class AllocationCounter final
+{
+public:
+    AllocationCounter()
+        : m_start{ allocationCount() }
+    {
+    }
+
+    std::uint64_t count() const { return allocationCount() - m_start; }
+
+private:
+    std::uint64_t m_start;
+};
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "DocumentUtils.hpp"
+
+#include "opendxf/outputsink.hpp"
+#include "opendxf/write.hpp"
+
+#include <stdexcept>
+
+odxf::Document singleTypeDocument(std::size_t count, double odxf::EntityMix::*type)
+{
+    odxf::GeneratorOptions options{
+        .entityCount = count,
+        .mix{ .lines = 0.0, .circles = 0.0, .arcs = 0.0, .lwPolylines = 0.0 },
+        .vertexCounts{ .distribution = odxf::VertexCounts::Distribution::Fixed, .min = 10 },
+    };
+    options.mix.*type = 1.0;
+
+    return odxf::generateDocument(options);
+}
+
+std::string formatDxf(const odxf::Document& document)
+{
+    odxf::MemorySink sink;
+    if (!odxf::writeDxf(document, sink)) {
+        throw std::runtime_error{ "unable to format document" };
+    }
+
+    return sink.takeContent();
+}
+
+std::size_t entityCount(const odxf::Document& document)
+{
+    const odxf::Entities& entities{ document.entities };
+
+    return entities.arcs.size() + entities.circles.size() + entities.ellipses.size()
+         + entities.lines.size() + entities.points.size() + entities.lwPolylines.size()
+         + entities.rays.size();
+}
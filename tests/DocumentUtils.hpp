@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#pragma once
+
+#include "opendxf/document.hpp"
+#include "opendxf/generator.hpp"
+
+#include <cstddef>
+#include <string>
+
+// Shared by the tests and the benchmarks.
+
+// Document with count entities of the type selected by the EntityMix member, lw
+// polylines having 10 vertices each.
+odxf::Document singleTypeDocument(std::size_t count, double odxf::EntityMix::*type);
+
+// The content of the document written as DXF, throws if writing fails.
+std::string formatDxf(const odxf::Document& document);
+
+// The number of entities of all types.
+std::size_t entityCount(const odxf::Document& document);
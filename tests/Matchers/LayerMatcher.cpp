@@ -9,7 +9,9 @@ testing::Matcher<odxf::Layer> IsLayer(const odxf::Layer& expected)
 {
     return testing::AllOf(
         testing::Field("name", &odxf::Layer::name, expected.name),
-        testing::Field("flags", &odxf::Layer::flags, expected.flags));
+        testing::Field("color", &odxf::Layer::color, expected.color),
+        testing::Field("flags", &odxf::Layer::flags, expected.flags),
+        testing::Field("lineType", &odxf::Layer::lineType, expected.lineType));
 }
 
 }   // namespace
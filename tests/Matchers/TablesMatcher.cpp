@@ -5,8 +5,32 @@
 
 #include "LayerMatcher.hpp"
 
+namespace {
+
+testing::Matcher<odxf::LineType> IsLineType(const odxf::LineType& expected)
+{
+    return testing::AllOf(
+        testing::Field("name", &odxf::LineType::name, expected.name),
+        testing::Field("displayName", &odxf::LineType::displayName, expected.displayName),
+        testing::Field("flags", &odxf::LineType::flags, expected.flags));
+}
+
+testing::Matcher<odxf::LineTypes> AreLineTypes(const odxf::LineTypes& expected)
+{
+    std::vector<testing::Matcher<odxf::LineType>> elementMatchers;
+    elementMatchers.reserve(expected.size());
+    for (const odxf::LineType& expectedLineType : expected) {
+        elementMatchers.push_back(IsLineType(expectedLineType));
+    }
+
+    return testing::ElementsAreArray(elementMatchers);
+}
+
+}   // namespace
+
 testing::Matcher<odxf::Tables> AreTables(const odxf::Tables& expected)
 {
     return testing::AllOf(
+        testing::Field("lineTypes", &odxf::Tables::lineTypes, AreLineTypes(expected.lineTypes)),
         testing::Field("layers", &odxf::Tables::layers, AreLayers(expected.layers)));
 }
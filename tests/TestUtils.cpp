@@ -8,6 +8,26 @@
 #include "opendxf/header.hpp"
 #include "opendxf/layer.hpp"
 
+#include <fmt/core.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+TemporaryFile::TemporaryFile(std::string_view name)
+    : m_path{ std::filesystem::path{ testing::TempDir() } / name }
+{
+}
+
+TemporaryFile::~TemporaryFile()
+{
+    std::error_code error;
+    std::filesystem::remove(m_path, error);
+}
+
 odxf::Document createExampleDocument()
 {
     using namespace odxf;
@@ -147,3 +167,28 @@ odxf::Document createExampleDocument()
 
     return expectedDocument;
 }
+
+std::string readFile(const std::filesystem::path& filePath)
+{
+    std::ifstream stream{ filePath, std::ios::binary };
+    if (!stream.is_open()) {
+        throw std::runtime_error{ fmt::format(
+            "unable to open file '{}'",
+            reinterpret_cast<const char*>(filePath.u8string().c_str())) };
+    }
+
+    return std::string{ std::istreambuf_iterator<char>{ stream }, {} };
+}
+
+std::vector<std::string> readLines(const std::filesystem::path& filePath)
+{
+    std::istringstream stream{ readFile(filePath) };
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
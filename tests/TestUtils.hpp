@@ -5,9 +5,22 @@
 
 #include "opendxf/document.hpp"
 #include "opendxf/entities.hpp"
+#include "opendxf/generator.hpp"
 #include "opendxf/header.hpp"
 #include "opendxf/ireadstream.hpp"
 #include "opendxf/layer.hpp"
+#include "opendxf/tables.hpp"
+
+#include "DocumentUtils.hpp"
+
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
 
 class ReadStream final : public odxf::IReadStream
 {
@@ -16,6 +29,10 @@ public:
 
 private:
     void header(const odxf::Header& header) override { m_document.header = header; }
+    void lineType(const odxf::LineType& lineType) override
+    {
+        m_document.tables.lineTypes.push_back(lineType);
+    }
     void layer(const odxf::Layer& layer) override { m_document.tables.layers.push_back(layer); }
 
     void arc(const odxf::Arc& arc) override { m_document.entities.arcs.push_back(arc); }
@@ -32,4 +49,32 @@ private:
     odxf::Document m_document;
 };
 
+// A file under testing::TempDir(), removed when the object is destroyed.
+class TemporaryFile final
+{
+public:
+    explicit TemporaryFile(std::string_view name);
+    ~TemporaryFile();
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    const std::filesystem::path& path() const { return m_path; }
+
+private:
+    std::filesystem::path m_path;
+};
+
 odxf::Document createExampleDocument();
+
+// The content of the file, throws if it cannot be opened.
+std::string readFile(const std::filesystem::path& filePath);
+
+// The lines of the file without their newline characters.
+std::vector<std::string> readLines(const std::filesystem::path& filePath);
+
+// Matches a coordinate within a distance of 1e-9 of the expected one.
+MATCHER_P(IsNear, expected, "")
+{
+    return std::hypot(arg.x - expected.x, arg.y - expected.y, arg.z - expected.z) < 1.0e-9;
+}
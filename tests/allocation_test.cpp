@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+#include "opendxf/ireadstream.hpp"
+#include "opendxf/outputsink.hpp"
+#include "opendxf/write.hpp"
+
+#include "AllocationCounter.hpp"
+#include "TestUtils.hpp"
+
+#include "linescanner.hpp"
+#include "reader.hpp"
+#include "readersink.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Every test compares the allocations for count and 2 * count entities, so the fixed
+// costs of a read or write cancel out and only per-entity allocations remain.
+
+namespace {
+
+constexpr std::size_t testEntityCount{ 2000 };
+
+class NullReadStream final : public odxf::IReadStream
+{};
+
+// Entities of a single type, each on a layer whose name exceeds the small string
+// buffer so that reusing its heap buffer is covered.
+odxf::Document longLayerNameDocument(std::size_t count, double odxf::EntityMix::*type)
+{
+    odxf::Document document{ singleTypeDocument(count, type) };
+    for (odxf::Layer& layer : document.tables.layers) {
+        layer.name.insert(0, "A layer name beyond the small string buffer, ");
+    }
+
+    const auto renameLayers{ [](auto& entities) {
+        for (auto& entity : entities) {
+            entity.layer.insert(0, "A layer name beyond the small string buffer, ");
+        }
+    } };
+    renameLayers(document.entities.lines);
+    renameLayers(document.entities.circles);
+    renameLayers(document.entities.arcs);
+    renameLayers(document.entities.lwPolylines);
+
+    return document;
+}
+
+std::uint64_t streamReadAllocations(const std::string& content)
+{
+    NullReadStream stream;
+    const AllocationCounter counter;
+
+    odxf::StreamSink sink{ stream };
+    odxf::Reader reader{ sink };
+    EXPECT_TRUE(reader.readContent(content));
+
+    return counter.count();
+}
+
+std::uint64_t writeAllocations(const odxf::Document& document)
+{
+    odxf::CallbackSink sink{ [](std::string_view) { return true; } };
+    const AllocationCounter counter;
+
+    EXPECT_TRUE(odxf::writeDxf(document, sink));
+
+    return counter.count();
+}
+
+struct EntityTypeParam final
+{
+    std::string name;
+    double odxf::EntityMix::*type;
+};
+
+std::string paramName(const testing::TestParamInfo<EntityTypeParam>& info)
+{
+    return info.param.name;
+}
+
+}   // namespace
+
+TEST(allocation, counter)
+{
+    // Arrange
+    const AllocationCounter counter;
+
+    // Act
+    std::string text(100, 'x');
+    const volatile char* data{ text.data() };
+
+    // Assert
+    EXPECT_EQ(data[0], 'x');
+    EXPECT_EQ(counter.count(), 1U);
+}
+
+TEST(allocation, tokenizer)
+{
+    // Arrange
+    const std::string content{
+        formatDxf(longLayerNameDocument(testEntityCount, &odxf::EntityMix::lines))
+    };
+
+    // Act
+    const AllocationCounter counter;
+
+    odxf::LineScanner scanner{ content };
+    std::string_view groupCode;
+    std::string_view value;
+    std::size_t groupCodeCount{ 0 };
+    while (scanner.next(groupCode) && scanner.next(value)) {
+        groupCodeCount += odxf::parseAs<int>(odxf::trimGroupCode(groupCode)).has_value() ? 1 : 0;
+    }
+
+    const std::uint64_t allocations{ counter.count() };
+
+    // Assert
+    EXPECT_GT(groupCodeCount, testEntityCount);
+    EXPECT_EQ(allocations, 0U);
+}
+
+struct StreamReadFixture : testing::TestWithParam<EntityTypeParam>
+{};
+
+TEST_P(StreamReadFixture, steadyState)
+{
+    // Arrange
+    const std::string content{ formatDxf(longLayerNameDocument(testEntityCount, GetParam().type)) };
+    const std::string doubleContent{
+        formatDxf(longLayerNameDocument(2 * testEntityCount, GetParam().type))
+    };
+
+    // Act
+    const std::uint64_t allocations{ streamReadAllocations(content) };
+    const std::uint64_t doubleAllocations{ streamReadAllocations(doubleContent) };
+
+    // Assert
+    EXPECT_EQ(doubleAllocations, allocations);
+}
+
+// clang-format off
+INSTANTIATE_TEST_SUITE_P(
+    AllocationTest,
+    StreamReadFixture,
+    testing::Values(
+        EntityTypeParam{ .name = "line", .type = &odxf::EntityMix::lines },
+        EntityTypeParam{ .name = "circle", .type = &odxf::EntityMix::circles },
+        EntityTypeParam{ .name = "arc", .type = &odxf::EntityMix::arcs },
+        EntityTypeParam{ .name = "lwPolyline", .type = &odxf::EntityMix::lwPolylines }
+    ),
+    paramName
+);
+// clang-format on
+
+struct WriteFixture : testing::TestWithParam<EntityTypeParam>
+{};
+
+TEST_P(WriteFixture, steadyState)
+{
+    // Arrange
+    const odxf::Document document{ longLayerNameDocument(testEntityCount, GetParam().type) };
+    const odxf::Document doubleDocument{
+        longLayerNameDocument(2 * testEntityCount, GetParam().type)
+    };
+
+    // Act
+    const std::uint64_t allocations{ writeAllocations(document) };
+    const std::uint64_t doubleAllocations{ writeAllocations(doubleDocument) };
+
+    // Assert
+    EXPECT_EQ(doubleAllocations, allocations);
+}
+
+// clang-format off
+INSTANTIATE_TEST_SUITE_P(
+    AllocationTest,
+    WriteFixture,
+    testing::Values(
+        EntityTypeParam{ .name = "line", .type = &odxf::EntityMix::lines },
+        EntityTypeParam{ .name = "circle", .type = &odxf::EntityMix::circles },
+        EntityTypeParam{ .name = "arc", .type = &odxf::EntityMix::arcs },
+        EntityTypeParam{ .name = "lwPolyline", .type = &odxf::EntityMix::lwPolylines }
+    ),
+    paramName
+);
+// clang-format on
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/deduplicate.hpp"
+#include "opendxf/generator.hpp"
+
+#include "Matchers/EntitiesMatcher.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+odxf::Line createLine(double startX, double startY, double endX, double endY)
+{
+    return odxf::Line{ .start = { startX, startY, 0.0 }, .end = { endX, endY, 0.0 } };
+}
+
+class DeduplicateFixture : public testing::TestWithParam<unsigned int>
+{
+protected:
+    odxf::DeduplicateReport deduplicate(
+        odxf::Entities& entities, double tolerance = 0.0, bool mergeCollinearLines = false) const
+    {
+        return odxf::deduplicate(
+            entities,
+            odxf::DeduplicateOptions{ .tolerance = tolerance,
+                                      .mergeCollinearLines = mergeCollinearLines,
+                                      .threadCount = GetParam() });
+    }
+};
+
+}   // namespace
+
+TEST_P(DeduplicateFixture, exactDuplicates)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(createLine(0.0, 0.0, 1.0, 1.0));
+    entities.lines.push_back(createLine(1.0, 1.0, 0.0, 0.0));
+    entities.lines.push_back(createLine(0.0, 0.0, 1.0, 2.0));
+    entities.lines.push_back(createLine(0.0, 0.0, 1.0, 1.0));
+    entities.lines.back().layer = "other";
+    entities.lines.push_back(createLine(0.0, 0.0, 1.0, 1.0));
+    entities.lines.back().color = 1;
+    entities.lines.push_back(createLine(0.0, 0.0, 1.0, 1.0));
+
+    entities.circles.assign(3, odxf::Circle{ .radius = 1.0 });
+    entities.circles[1].thickness = 2.0;
+    entities.arcs.assign(2, odxf::Arc{ .radius = 1.0, .endAngle = 90.0 });
+
+    odxf::Entities expected{ entities };
+    expected.lines.erase(expected.lines.begin() + 5);
+    expected.lines.erase(expected.lines.begin() + 1);
+    expected.circles.pop_back();
+    expected.arcs.pop_back();
+
+    // Act
+    const odxf::DeduplicateReport report{ deduplicate(entities) };
+
+    // Assert
+    EXPECT_THAT(report.removedLines, testing::ElementsAre(1U, 5U));
+    EXPECT_THAT(report.removedCircles, testing::ElementsAre(2U));
+    EXPECT_THAT(report.removedArcs, testing::ElementsAre(1U));
+    EXPECT_THAT(report.mergedLines, testing::IsEmpty());
+    EXPECT_THAT(entities, AreEntities(expected));
+}
+
+TEST_P(DeduplicateFixture, tolerance)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.circles.push_back(odxf::Circle{ .center = { 10.0, 20.0, 0.0 }, .radius = 5.0 });
+    entities.circles.push_back(
+        odxf::Circle{ .center = { 10.0 + 1.0e-9, 20.0, 0.0 }, .radius = 5.0 - 1.0e-9 });
+    odxf::Entities exact{ entities };
+
+    // Act
+    const odxf::DeduplicateReport exactReport{ deduplicate(exact) };
+    const odxf::DeduplicateReport tolerantReport{ deduplicate(entities, 1.0e-3) };
+
+    // Assert
+    EXPECT_THAT(exactReport.removedCircles, testing::IsEmpty());
+    EXPECT_EQ(exact.circles.size(), 2U);
+    EXPECT_THAT(tolerantReport.removedCircles, testing::ElementsAre(1U));
+    EXPECT_EQ(entities.circles.size(), 1U);
+}
+
+TEST_P(DeduplicateFixture, toleranceAcrossCells)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.circles.push_back(odxf::Circle{ .center = { 0.0049, 0.0049, 0.0 }, .radius = 1.0 });
+    entities.circles.push_back(odxf::Circle{ .center = { 0.0051, 0.0051, 0.0 }, .radius = 1.0 });
+    entities.circles.push_back(odxf::Circle{ .center = { 0.0251, 0.0051, 0.0 }, .radius = 1.0 });
+    entities.lines.push_back(createLine(0.0049, 0.0, 1.0, 1.0));
+    entities.lines.push_back(createLine(1.0, 1.0049, 0.0051, 0.0));
+    entities.lines.push_back(createLine(0.0, 0.0, 1.0, 1.0));
+    entities.lines.back().layer = "other";
+
+    // Act
+    const odxf::DeduplicateReport report{ deduplicate(entities, 0.01) };
+
+    // Assert
+    EXPECT_THAT(report.removedCircles, testing::ElementsAre(1U));
+    EXPECT_THAT(report.removedLines, testing::ElementsAre(1U));
+    EXPECT_EQ(entities.circles.size(), 2U);
+    EXPECT_EQ(entities.lines.size(), 2U);
+}
+
+TEST_P(DeduplicateFixture, mergeCollinearLines)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(createLine(5.0, 0.0, 15.0, 0.0));
+    entities.lines.push_back(createLine(10.0, 1.0, 20.0, 1.0));
+    entities.lines.push_back(createLine(12.0, 0.0, 0.0, 0.0));
+    entities.lines.push_back(createLine(30.0, 0.0, 40.0, 0.0));
+    entities.lines.push_back(createLine(20.0, 0.0, 15.0, 0.0));
+    entities.lines.push_back(createLine(0.0, 0.0, 0.0, 10.0));
+    entities.lines.push_back(createLine(3.0, 3.0, 3.0, 3.0));
+
+    odxf::Entities expected;
+    expected.lines.push_back(createLine(0.0, 0.0, 20.0, 0.0));
+    expected.lines.push_back(createLine(10.0, 1.0, 20.0, 1.0));
+    expected.lines.push_back(createLine(30.0, 0.0, 40.0, 0.0));
+    expected.lines.push_back(createLine(0.0, 0.0, 0.0, 10.0));
+    expected.lines.push_back(createLine(3.0, 3.0, 3.0, 3.0));
+
+    // Act
+    const odxf::DeduplicateReport report{ deduplicate(entities, 1.0e-6, true) };
+
+    // Assert
+    EXPECT_THAT(report.removedLines, testing::IsEmpty());
+    EXPECT_THAT(report.mergedLines, testing::ElementsAre(2U, 4U));
+    EXPECT_THAT(entities, AreEntities(expected));
+}
+
+TEST_P(DeduplicateFixture, mergeKeepsDirection)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(createLine(2.0, 2.0, 1.0, 1.0));
+    entities.lines.push_back(createLine(0.0, 0.0, 1.5, 1.5));
+
+    // Act
+    const odxf::DeduplicateReport report{ deduplicate(entities, 1.0e-9, true) };
+
+    // Assert
+    EXPECT_THAT(report.mergedLines, testing::ElementsAre(1U));
+    ASSERT_EQ(entities.lines.size(), 1U);
+    EXPECT_DOUBLE_EQ(entities.lines.front().start.x, 2.0);
+    EXPECT_DOUBLE_EQ(entities.lines.front().end.x, 0.0);
+}
+
+TEST_P(DeduplicateFixture, mergeAngularTolerance)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(createLine(0.0, 0.0, 10.0, 0.0));
+    entities.lines.push_back(createLine(5.0, 0.0, 15.0, 1.0e-4));
+    odxf::Entities exact{ entities };
+
+    // Act
+    const odxf::DeduplicateReport exactReport{ deduplicate(exact, 1.0e-3, true) };
+    const odxf::DeduplicateReport tolerantReport{ odxf::deduplicate(
+        entities,
+        odxf::DeduplicateOptions{ .tolerance = 1.0e-3,
+                                  .mergeCollinearLines = true,
+                                  .angularTolerance = 1.0e-4,
+                                  .threadCount = GetParam() }) };
+
+    // Assert
+    EXPECT_THAT(exactReport.mergedLines, testing::IsEmpty());
+    EXPECT_EQ(exact.lines.size(), 2U);
+    EXPECT_THAT(tolerantReport.mergedLines, testing::ElementsAre(1U));
+    EXPECT_EQ(entities.lines.size(), 1U);
+}
+
+TEST_P(DeduplicateFixture, mergedIndicesAfterDuplicates)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(createLine(0.0, 0.0, 10.0, 0.0));
+    entities.lines.push_back(createLine(0.0, 0.0, 10.0, 0.0));
+    entities.lines.push_back(createLine(0.0, 5.0, 10.0, 5.0));
+    entities.lines.push_back(createLine(5.0, 0.0, 15.0, 0.0));
+
+    // Act
+    const odxf::DeduplicateReport report{ deduplicate(entities, 1.0e-9, true) };
+
+    // Assert
+    EXPECT_THAT(report.removedLines, testing::ElementsAre(1U));
+    EXPECT_THAT(report.mergedLines, testing::ElementsAre(3U));
+    ASSERT_EQ(entities.lines.size(), 2U);
+    EXPECT_DOUBLE_EQ(entities.lines.front().end.x, 15.0);
+}
+
+TEST_P(DeduplicateFixture, generatedDocument)
+{
+    // Arrange
+    const odxf::Document document{ odxf::generateDocument(
+        odxf::GeneratorOptions{ .entityCount = 3000 }) };
+    odxf::Entities entities{ document.entities };
+    entities.lines.insert(
+        entities.lines.end(), document.entities.lines.begin(), document.entities.lines.end());
+    entities.circles.insert(
+        entities.circles.end(), document.entities.circles.begin(), document.entities.circles.end());
+    entities.arcs.insert(entities.arcs.begin(), document.entities.arcs.front());
+
+    // Act
+    const odxf::DeduplicateReport report{ deduplicate(entities) };
+
+    // Assert
+    EXPECT_EQ(report.removedLines.size(), document.entities.lines.size());
+    EXPECT_EQ(report.removedCircles.size(), document.entities.circles.size());
+    EXPECT_THAT(report.removedArcs, testing::ElementsAre(1U));
+    EXPECT_THAT(entities, AreEntities(document.entities));
+}
+
+INSTANTIATE_TEST_SUITE_P(DeduplicateTest, DeduplicateFixture, testing::Values(1U, 4U));
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/diff.hpp"
+#include "opendxf/generator.hpp"
+
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class DiffFixture : public testing::TestWithParam<unsigned int>
+{
+protected:
+    DiffFixture()
+        : document{ odxf::generateDocument(odxf::GeneratorOptions{
+            .entityCount = 2000,
+            .mix = odxf::EntityMix{
+                .points = 1.0,
+                .rays = 1.0,
+                .lines = 1.0,
+                .circles = 1.0,
+                .arcs = 1.0,
+                .ellipses = 1.0,
+                .lwPolylines = 1.0,
+            },
+        }) }
+    {
+        document.header = createExampleDocument().header;
+    }
+
+    odxf::DocumentDiff diff(const odxf::Document& other, double tolerance = 0.0) const
+    {
+        return odxf::diff(
+            document,
+            other,
+            odxf::DiffOptions{ .tolerance = tolerance, .threadCount = GetParam() });
+    }
+
+    odxf::Document document;
+};
+
+}   // namespace
+
+TEST_P(DiffFixture, equal)
+{
+    // Arrange
+    const odxf::Document other{ document };
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_TRUE(result.empty());
+}
+
+TEST_P(DiffFixture, reordered)
+{
+    // Arrange
+    odxf::Document other{ document };
+    std::mt19937 random{ 42 };
+    std::shuffle(other.entities.lines.begin(), other.entities.lines.end(), random);
+    std::shuffle(other.entities.lwPolylines.begin(), other.entities.lwPolylines.end(), random);
+    std::reverse(other.tables.layers.begin(), other.tables.layers.end());
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_TRUE(result.empty());
+}
+
+TEST_P(DiffFixture, duplicates)
+{
+    // Arrange
+    odxf::Document other{ document };
+    auto& circles{ document.entities.circles };
+    circles.resize(3);
+    circles[1] = circles[0];
+    circles[2].layer = circles[0].layer;
+    other.entities.circles.assign(3, circles[0]);
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_TRUE(result.circles.removed.empty());
+    EXPECT_TRUE(result.circles.added.empty());
+    // the third circle became a copy of the first one
+    ASSERT_EQ(result.circles.changed.size(), 1U);
+    EXPECT_EQ(result.circles.changed.front(), (std::pair<std::size_t, std::size_t>{ 2, 2 }));
+}
+
+TEST_P(DiffFixture, tolerance)
+{
+    // Arrange
+    odxf::Document other{ document };
+    for (odxf::Line& line : other.entities.lines) {
+        line.start.x += 1.0e-9;
+    }
+    other.entities.arcs.front().radius += 1.0;
+
+    // Act
+    const odxf::DocumentDiff exact{ diff(other) };
+    const odxf::DocumentDiff tolerant{ diff(other, 1.0e-3) };
+
+    // Assert
+    EXPECT_EQ(exact.lines.changed.size(), other.entities.lines.size());
+
+    EXPECT_TRUE(tolerant.lines.empty());
+    ASSERT_EQ(tolerant.arcs.changed.size(), 1U);
+    EXPECT_EQ(tolerant.arcs.changed.front(), (std::pair<std::size_t, std::size_t>{ 0, 0 }));
+}
+
+TEST_P(DiffFixture, addedRemovedChanged)
+{
+    // Arrange
+    odxf::Document other{ document };
+    other.entities.points.push_back(odxf::Point{ .coordinate = { 1.0, 2.0, 3.0 } });
+    other.entities.rays.erase(other.entities.rays.begin() + 5);
+    other.entities.ellipses[7].layer = "moved";
+    other.entities.lwPolylines[3].vertices.pop_back();
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_THAT(result.points.added, testing::ElementsAre(other.entities.points.size() - 1));
+    EXPECT_THAT(result.rays.removed, testing::ElementsAre(5U));
+    EXPECT_THAT(result.ellipses.removed, testing::ElementsAre(7U));
+    EXPECT_THAT(result.ellipses.added, testing::ElementsAre(7U));
+    ASSERT_EQ(result.lwPolylines.changed.size(), 1U);
+    EXPECT_EQ(result.lwPolylines.changed.front(), (std::pair<std::size_t, std::size_t>{ 3, 3 }));
+
+    EXPECT_TRUE(result.lines.empty());
+    EXPECT_TRUE(result.circles.empty());
+    EXPECT_TRUE(result.arcs.empty());
+}
+
+TEST_P(DiffFixture, headerAndLayers)
+{
+    // Arrange
+    odxf::Document other{ document };
+    auto& entries{ other.header.entries };
+    const std::string removedKey{ entries.begin()->first };
+    entries.erase(entries.begin());
+    entries["$ADDED"] = 1;
+    const std::string changedKey{ entries.begin()->first };
+    entries.begin()->second = std::string{ "changed" };
+
+    other.tables.layers.pop_back();
+    other.tables.layers.front().color += 1;
+    other.tables.layers.push_back(odxf::Layer{ .name = "new" });
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_THAT(result.addedHeaderEntries, testing::ElementsAre("$ADDED"));
+    EXPECT_THAT(result.removedHeaderEntries, testing::ElementsAre(removedKey));
+    if (changedKey != "$ADDED") {
+        EXPECT_THAT(result.changedHeaderEntries, testing::ElementsAre(changedKey));
+    }
+
+    EXPECT_THAT(result.addedLayers, testing::ElementsAre("new"));
+    EXPECT_THAT(result.removedLayers, testing::ElementsAre(document.tables.layers.back().name));
+    EXPECT_THAT(result.changedLayers, testing::ElementsAre(document.tables.layers.front().name));
+}
+
+TEST_P(DiffFixture, lineTypes)
+{
+    // Arrange
+    document.tables.lineTypes = {
+        odxf::LineType{ .name = "CONTINUOUS", .displayName = "Solid line" },
+        odxf::LineType{ .name = "DASHED", .displayName = "Dashed" },
+        odxf::LineType{ .name = "HIDDEN", .displayName = "Hidden" },
+    };
+
+    odxf::Document other{ document };
+    other.tables.lineTypes.erase(other.tables.lineTypes.begin() + 2);
+    other.tables.lineTypes[1].displayName = "Dashed __ __";
+    other.tables.lineTypes.push_back(odxf::LineType{ .name = "CENTER" });
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_THAT(result.addedLineTypes, testing::ElementsAre("CENTER"));
+    EXPECT_THAT(result.removedLineTypes, testing::ElementsAre("HIDDEN"));
+    EXPECT_THAT(result.changedLineTypes, testing::ElementsAre("DASHED"));
+}
+
+TEST_P(DiffFixture, layersCompareLineTypesByName)
+{
+    // Arrange
+    document.tables.lineTypes = {
+        odxf::LineType{ .name = "CONTINUOUS" },
+        odxf::LineType{ .name = "DASHED" },
+    };
+    document.tables.layers = {
+        odxf::Layer{ .name = "reordered", .lineType = 1 },
+        odxf::Layer{ .name = "retyped", .lineType = 1 },
+    };
+
+    odxf::Document other{ document };
+    std::swap(other.tables.lineTypes[0], other.tables.lineTypes[1]);
+    other.tables.layers[0].lineType = 0;
+
+    // Act
+    const odxf::DocumentDiff result{ diff(other) };
+
+    // Assert
+    EXPECT_TRUE(result.changedLineTypes.empty());
+    EXPECT_THAT(result.changedLayers, testing::ElementsAre("retyped"));
+}
+
+INSTANTIATE_TEST_SUITE_P(DiffTest, DiffFixture, testing::Values(1U, 4U));
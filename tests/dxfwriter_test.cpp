@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/dxfwriter.hpp"
+#include "opendxf/read.hpp"
+
+#include "Matchers/DocumentMatcher.hpp"
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <ranges>
+
+TEST(dxfWriter, example)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+
+    const TemporaryFile file{ "test_dxfwriter.dxf" };
+
+    // Act
+    {
+        odxf::DxfWriter writer{ file.path() };
+
+        ASSERT_TRUE(writer.beginHeader());
+        for (const auto& [key, value] : document.header.entries) {
+            ASSERT_TRUE(writer.headerVariable(key, value));
+        }
+
+        ASSERT_TRUE(writer.beginTables());
+        for (const odxf::LineType& lineType : document.tables.lineTypes) {
+            ASSERT_TRUE(writer.lineType(lineType));
+        }
+        for (const odxf::Layer& layer : document.tables.layers) {
+            ASSERT_TRUE(writer.layer(layer));
+        }
+
+        ASSERT_TRUE(writer.beginEntities());
+        for (const odxf::Line& line : document.entities.lines) {
+            ASSERT_TRUE(writer.line(line));
+        }
+        for (const odxf::Circle& circle : document.entities.circles) {
+            ASSERT_TRUE(writer.circle(circle));
+        }
+        for (const odxf::Arc& arc : document.entities.arcs) {
+            ASSERT_TRUE(writer.arc(arc));
+        }
+        for (const odxf::LWPolyline& lwPolyline : document.entities.lwPolylines) {
+            ASSERT_TRUE(writer.lwPolyline(lwPolyline, lwPolyline.isClosed, lwPolyline.vertices));
+        }
+
+        ASSERT_TRUE(writer.finish());
+    }
+
+    // Assert
+    const tl::expected<odxf::Document, odxf::Error> result{ odxf::readDocument(file.path()) };
+    ASSERT_TRUE(result.has_value());
+    EXPECT_THAT(*result, IsDocument(document));
+}
+
+TEST(dxfWriter, generatedVertices)
+{
+    // Arrange
+    const TemporaryFile file{ "test_dxfwriter_generated.dxf" };
+
+    const auto vertices{ std::views::iota(0, 1000) | std::views::transform([](int i) {
+                             return odxf::Vertex{ .position{ static_cast<double>(i), 0.5 } };
+                         }) };
+
+    // Act
+    {
+        odxf::DxfWriter writer{ file.path() };
+
+        ASSERT_TRUE(writer.beginEntities());
+        ASSERT_TRUE(writer.lwPolyline(odxf::Entity{ .layer = "generated" }, true, vertices));
+        ASSERT_TRUE(writer.finish());
+    }
+
+    // Assert
+    const tl::expected<odxf::Document, odxf::Error> result{ odxf::readDocument(file.path()) };
+    ASSERT_TRUE(result.has_value());
+
+    ASSERT_EQ(result->entities.lwPolylines.size(), 1);
+    const odxf::LWPolyline& lwPolyline{ result->entities.lwPolylines.front() };
+    EXPECT_TRUE(lwPolyline.isClosed);
+    ASSERT_EQ(lwPolyline.vertices.size(), 1000);
+    EXPECT_EQ(lwPolyline.vertices.back().position.x, 999.0);
+}
+
+TEST(dxfWriter, sectionOrder)
+{
+    // Arrange
+    const TemporaryFile file{ "test_dxfwriter_order.dxf" };
+    odxf::DxfWriter writer{ file.path() };
+
+    // Act & Assert
+    const tl::expected<void, odxf::Error> lineBeforeEntities{ writer.line(odxf::Line{}) };
+    ASSERT_FALSE(lineBeforeEntities.has_value());
+    EXPECT_EQ(lineBeforeEntities.error().type, odxf::Error::Type::InvalidOrder);
+
+    ASSERT_TRUE(writer.beginTables());
+
+    const tl::expected<void, odxf::Error> headerAfterTables{ writer.beginHeader() };
+    ASSERT_FALSE(headerAfterTables.has_value());
+    EXPECT_EQ(headerAfterTables.error().type, odxf::Error::Type::InvalidOrder);
+
+    const tl::expected<void, odxf::Error> layerWithoutLineType{
+        writer.layer(odxf::Layer{ .name = "no line type" })
+    };
+    ASSERT_FALSE(layerWithoutLineType.has_value());
+    EXPECT_EQ(layerWithoutLineType.error().type, odxf::Error::Type::InvalidReference);
+
+    ASSERT_TRUE(writer.beginEntities());
+    ASSERT_TRUE(writer.beginLWPolyline(odxf::Entity{}, false));
+    EXPECT_FALSE(writer.finish().has_value());
+    ASSERT_TRUE(writer.endLWPolyline());
+    ASSERT_TRUE(writer.finish());
+    EXPECT_FALSE(writer.line(odxf::Line{}).has_value());
+}
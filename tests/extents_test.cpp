@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/extents.hpp"
+#include "opendxf/generator.hpp"
+#include "opendxf/tessellate.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <span>
+
+namespace {
+
+constexpr double maxError{ 1.0e-9 };
+
+MATCHER_P2(IsExtents, min, max, "")
+{
+    return std::abs(arg.min.x - min.x) < maxError && std::abs(arg.min.y - min.y) < maxError
+           && std::abs(arg.min.z - min.z) < maxError && std::abs(arg.max.x - max.x) < maxError
+           && std::abs(arg.max.y - max.y) < maxError && std::abs(arg.max.z - max.z) < maxError;
+}
+
+// The extents of the vertices approximating an entity.
+odxf::Extents vertexExtents(std::span<const odxf::Coordinate3d> vertices)
+{
+    odxf::Extents result;
+    for (const odxf::Coordinate3d& vertex : vertices) {
+        result.add(vertex);
+    }
+
+    return result;
+}
+
+}   // namespace
+
+TEST(extents, arc)
+{
+    // Arrange
+    const odxf::Arc arc{
+        .center = { 1.0, 1.0, 0.0 },
+        .radius = 2.0,
+        .startAngle = 45.0,
+        .endAngle = 135.0,
+    };
+    const odxf::Arc wrapping{ .radius = 1.0, .startAngle = 350.0, .endAngle = 100.0 };
+
+    // Act
+    const odxf::Extents extents{ odxf::extents(arc) };
+    const odxf::Extents wrappingExtents{ odxf::extents(wrapping) };
+
+    // Assert
+    const double offset{ std::numbers::sqrt2 };
+    EXPECT_THAT(
+        extents,
+        IsExtents(
+            odxf::Coordinate3d{ 1.0 - offset, 1.0 + offset, 0.0 },
+            odxf::Coordinate3d{ 1.0 + offset, 3.0, 0.0 }));
+
+    const double start{ 350.0 * std::numbers::pi / 180.0 };
+    const double end{ 100.0 * std::numbers::pi / 180.0 };
+    EXPECT_THAT(
+        wrappingExtents,
+        IsExtents(
+            odxf::Coordinate3d{ std::cos(end), std::sin(start), 0.0 },
+            odxf::Coordinate3d{ 1.0, 1.0, 0.0 }));
+}
+
+TEST(extents, tiltedCircle)
+{
+    // Arrange
+    odxf::Circle circle{ .center = { 0.0, 0.0, 5.0 }, .radius = 2.0 };
+    circle.extrusion = odxf::Vector3d{ 1.0, 0.0, 0.0 };
+
+    // Act
+    const odxf::Extents extents{ odxf::extents(circle) };
+
+    // Assert
+    // the object coordinate system has the axes y and z
+    EXPECT_THAT(
+        extents,
+        IsExtents(odxf::Coordinate3d{ 5.0, -2.0, -2.0 }, odxf::Coordinate3d{ 5.0, 2.0, 2.0 }));
+}
+
+TEST(extents, ellipse)
+{
+    // Arrange
+    const odxf::Ellipse ellipse{
+        .center = { 1.0, 1.0, 0.0 },
+        .endPointMajor = { 0.0, 4.0, 0.0 },
+        .axisRatio = 0.5,
+        .startParameter = 0.0,
+        .endParameter = std::numbers::pi,
+    };
+
+    // Act
+    const odxf::Extents extents{ odxf::extents(ellipse) };
+
+    // Assert
+    // the minor axis points to -x
+    EXPECT_THAT(
+        extents,
+        IsExtents(odxf::Coordinate3d{ -1.0, -3.0, 0.0 }, odxf::Coordinate3d{ 1.0, 5.0, 0.0 }));
+}
+
+TEST(extents, lwPolyline)
+{
+    // Arrange
+    const odxf::LWPolyline counterclockwise{
+        .elevation = 2.0,
+        .isClosed = true,
+        .vertices = {
+            odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = 1.0 },
+            odxf::Vertex{ .position = { 2.0, 0.0 } },
+            odxf::Vertex{ .position = { 2.0, 2.0 }, .bulge = 0.0 },
+        },
+    };
+    const odxf::LWPolyline clockwise{
+        .vertices = {
+            odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = -1.0 },
+            odxf::Vertex{ .position = { 2.0, 0.0 }, .bulge = 1.0 },
+        },
+    };
+    const odxf::LWPolyline major{
+        .vertices = {
+            odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = 2.0 },
+            odxf::Vertex{ .position = { 2.0, 0.0 } },
+        },
+    };
+
+    // Act
+    const odxf::Extents counterclockwiseExtents{ odxf::extents(counterclockwise) };
+    const odxf::Extents clockwiseExtents{ odxf::extents(clockwise) };
+    const odxf::Extents majorExtents{ odxf::extents(major) };
+
+    // Assert
+    // the half circles below and above the first segment, the bulge of the last vertex of
+    // an open polyline has no segment
+    EXPECT_THAT(
+        counterclockwiseExtents,
+        IsExtents(odxf::Coordinate3d{ 0.0, -1.0, 2.0 }, odxf::Coordinate3d{ 2.0, 2.0, 2.0 }));
+    EXPECT_THAT(
+        clockwiseExtents,
+        IsExtents(odxf::Coordinate3d{ 0.0, 0.0, 0.0 }, odxf::Coordinate3d{ 2.0, 1.0, 0.0 }));
+    // the major arc of the circle around (1, -0.75) with radius 1.25
+    EXPECT_THAT(
+        majorExtents,
+        IsExtents(odxf::Coordinate3d{ -0.25, -2.0, 0.0 }, odxf::Coordinate3d{ 2.25, 0.0, 0.0 }));
+}
+
+TEST(extents, empty)
+{
+    // Arrange
+    const odxf::Entities entities;
+
+    // Act
+    const odxf::Extents extents{ odxf::computeExtents(entities) };
+
+    // Assert
+    EXPECT_TRUE(extents.isEmpty());
+}
+
+class ExtentsFixture : public testing::TestWithParam<unsigned int>
+{
+};
+
+TEST_P(ExtentsFixture, computeExtents)
+{
+    // Arrange
+    const odxf::Document document{ odxf::generateDocument(odxf::GeneratorOptions{
+        .entityCount = 3000,
+        .mix = odxf::EntityMix{
+            .points = 1.0,
+            .rays = 1.0,
+            .lines = 1.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .ellipses = 1.0,
+            .lwPolylines = 1.0,
+        },
+        .bulgeFraction = 0.5,
+    }) };
+    const odxf::Entities& entities{ document.entities };
+
+    // Act
+    const odxf::Extents extents{
+        odxf::computeExtents(entities, odxf::ExtentsOptions{ .threadCount = GetParam() })
+    };
+
+    // Assert
+    odxf::Extents expected;
+    const auto addAll{ [&](const auto& items) {
+        for (const auto& item : items) {
+            expected.add(odxf::extents(item));
+        }
+    } };
+    addAll(entities.points);
+    addAll(entities.rays);
+    addAll(entities.lines);
+    addAll(entities.circles);
+    addAll(entities.arcs);
+    addAll(entities.ellipses);
+    addAll(entities.lwPolylines);
+    EXPECT_THAT(extents, IsExtents(expected.min, expected.max));
+
+    // the extents of the curves are those of fine tessellations, up to the chord tolerance
+    const odxf::TessellateOptions options{ .chordTolerance = 1.0e-4, .maxSegments = 1 << 16 };
+    // rounding errors of the vertices, which are computed incrementally
+    constexpr double rounding{ 1.0e-6 };
+    const auto expectTight{ [&](const auto& items) {
+        const odxf::Tessellation tessellation{ odxf::tessellate(items, options) };
+        for (std::size_t i{ 0 }; i < items.size(); ++i) {
+            const odxf::Extents curve{ odxf::extents(items[i]) };
+            const odxf::Extents vertices{ vertexExtents(tessellation[i]) };
+            EXPECT_LE(curve.min.x, vertices.min.x + rounding);
+            EXPECT_LE(curve.min.y, vertices.min.y + rounding);
+            EXPECT_GE(curve.max.x, vertices.max.x - rounding);
+            EXPECT_GE(curve.max.y, vertices.max.y - rounding);
+            EXPECT_GE(curve.min.x, vertices.min.x - options.chordTolerance);
+            EXPECT_GE(curve.min.y, vertices.min.y - options.chordTolerance);
+            EXPECT_LE(curve.max.x, vertices.max.x + options.chordTolerance);
+            EXPECT_LE(curve.max.y, vertices.max.y + options.chordTolerance);
+        }
+    } };
+    expectTight(entities.arcs);
+    expectTight(entities.circles);
+    expectTight(entities.ellipses);
+    expectTight(entities.lwPolylines);
+}
+
+INSTANTIATE_TEST_SUITE_P(ExtentsTest, ExtentsFixture, testing::Values(1U, 4U));
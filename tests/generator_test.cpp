@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+#include "opendxf/read.hpp"
+#include "opendxf/write.hpp"
+
+#include "TestUtils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+TEST(generator, deterministic)
+{
+    // Arrange
+    const odxf::GeneratorOptions options{ .seed = 42, .entityCount = 1000 };
+    const odxf::GeneratorOptions otherSeedOptions{ .seed = 43, .entityCount = 1000 };
+
+    // Act
+    const std::string first{ formatDxf(odxf::generateDocument(options)) };
+    const std::string second{ formatDxf(odxf::generateDocument(options)) };
+    const std::string otherSeed{ formatDxf(odxf::generateDocument(otherSeedOptions)) };
+
+    // Assert
+    EXPECT_FALSE(first.empty());
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, otherSeed);
+}
+
+TEST(generator, entityMix)
+{
+    // Arrange
+    const odxf::GeneratorOptions options{
+        .entityCount = 1001,
+        .mix{
+            .points = 1.0,
+            .rays = 1.0,
+            .lines = 2.0,
+            .circles = 0.0,
+            .arcs = 0.0,
+            .ellipses = 1.0,
+            .lwPolylines = 2.0,
+        },
+        .layerCount = 3,
+        .vertexCounts{
+            .distribution = odxf::VertexCounts::Distribution::Uniform,
+            .min = 3,
+            .max = 5,
+        },
+    };
+
+    // Act
+    const odxf::Document document{ odxf::generateDocument(options) };
+
+    // Assert
+    const odxf::Entities& entities{ document.entities };
+    EXPECT_EQ(entities.points.size(), 143U);
+    EXPECT_EQ(entities.rays.size(), 143U);
+    EXPECT_EQ(entities.lines.size(), 286U);
+    EXPECT_EQ(entities.circles.size(), 0U);
+    EXPECT_EQ(entities.arcs.size(), 0U);
+    EXPECT_EQ(entities.ellipses.size(), 143U);
+    EXPECT_EQ(entities.lwPolylines.size(), 286U);
+
+    EXPECT_EQ(document.tables.layers.size(), 3U);
+    for (const odxf::Line& line : entities.lines) {
+        EXPECT_TRUE(line.layer == "Layer 0" || line.layer == "Layer 1" || line.layer == "Layer 2");
+    }
+    for (const odxf::LWPolyline& lwPolyline : entities.lwPolylines) {
+        EXPECT_GE(lwPolyline.vertices.size(), 3U);
+        EXPECT_LE(lwPolyline.vertices.size(), 5U);
+    }
+}
+
+TEST(generator, geometricVertexCounts)
+{
+    // Arrange
+    const odxf::GeneratorOptions options{
+        .entityCount = 2000,
+        .mix{ .lines = 0.0, .circles = 0.0, .arcs = 0.0, .lwPolylines = 1.0 },
+        .vertexCounts{
+            .distribution = odxf::VertexCounts::Distribution::Geometric,
+            .min = 2,
+            .max = 1000,
+            .mean = 10.0,
+        },
+    };
+
+    // Act
+    const odxf::Document document{ odxf::generateDocument(options) };
+
+    // Assert
+    std::size_t vertexCount{ 0 };
+    for (const odxf::LWPolyline& lwPolyline : document.entities.lwPolylines) {
+        EXPECT_GE(lwPolyline.vertices.size(), 2U);
+        EXPECT_LE(lwPolyline.vertices.size(), 1000U);
+        vertexCount += lwPolyline.vertices.size();
+    }
+
+    const double mean{ static_cast<double>(vertexCount) / 2000.0 };
+    EXPECT_NEAR(mean, 10.0, 1.0);
+}
+
+TEST(generator, streamMatchesDocument)
+{
+    // Arrange
+    const odxf::GeneratorOptions options{
+        .entityCount = 5000,
+        .mix{ .points = 1.0, .rays = 1.0, .ellipses = 1.0 },
+    };
+    odxf::MemorySink sink;
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::generateDxf(options, sink) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(sink.content(), formatDxf(odxf::generateDocument(options)));
+}
+
+TEST(generator, paddedReadsBack)
+{
+    // Arrange
+    const odxf::GeneratorOptions options{
+        .entityCount = 2000,
+        .padding = odxf::Padding::GroupCodes,
+    };
+    const std::filesystem::path filePath{ "test_generated_padded.dxf" };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::generateDxf(options, filePath) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+
+    const tl::expected<odxf::Document, odxf::Error> document{ odxf::readDocument(filePath) };
+    ASSERT_TRUE(document.has_value());
+
+    const odxf::Document expectedDocument{ odxf::generateDocument(options) };
+    EXPECT_EQ(document->entities.lines.size(), expectedDocument.entities.lines.size());
+    EXPECT_EQ(document->entities.arcs.size(), expectedDocument.entities.arcs.size());
+    EXPECT_EQ(document->entities.lwPolylines.size(), expectedDocument.entities.lwPolylines.size());
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(generator, entityCountForSize)
+{
+    // Arrange
+    odxf::GeneratorOptions options;
+    const std::uintmax_t targetSize{ 4U << 20 };
+
+    // Act
+    options.entityCount = odxf::entityCountForSize(options, targetSize);
+
+    // Assert
+    std::uintmax_t size{ 0 };
+    odxf::CallbackSink sink{ [&size](std::string_view block) {
+        size += block.size();
+        return true;
+    } };
+    ASSERT_TRUE(odxf::generateDxf(options, sink));
+    EXPECT_NEAR(static_cast<double>(size), static_cast<double>(targetSize), 0.05 * targetSize);
+}
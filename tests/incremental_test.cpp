@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+#include "opendxf/incremental.hpp"
+#include "opendxf/read.hpp"
+#include "opendxf/write.hpp"
+
+#include "Matchers/DocumentMatcher.hpp"
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace {
+
+class IncrementalFixture : public testing::TestWithParam<unsigned int>
+{
+protected:
+    IncrementalFixture()
+        : reader{ odxf::IncrementalOptions{ .threadCount = GetParam() } }
+        , document{ odxf::generateDocument(odxf::GeneratorOptions{ .entityCount = 2000 }) }
+    {
+    }
+
+    // reads the content of the current document and applies the delta to the previous one
+    odxf::DocumentDelta update()
+    {
+        tl::expected<odxf::DocumentDelta, odxf::Error> delta{
+            reader.readContent(formatDxf(document))
+        };
+        EXPECT_TRUE(delta.has_value());
+        if (!delta) {
+            return {};
+        }
+
+        odxf::DocumentDelta copy{ *delta };
+        odxf::applyDelta(appliedDocument, std::move(*delta));
+
+        return copy;
+    }
+
+    odxf::IncrementalReader reader;
+    odxf::Document document;
+    odxf::Document appliedDocument;
+};
+
+}   // namespace
+
+TEST_P(IncrementalFixture, firstRead)
+{
+    // Act
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    ASSERT_TRUE(delta.header.has_value());
+    ASSERT_TRUE(delta.tables.has_value());
+    EXPECT_EQ(delta.counts().added, 2000U);
+    EXPECT_EQ(delta.counts().removed, 0U);
+    EXPECT_THAT(appliedDocument, IsDocument(document));
+}
+
+TEST_P(IncrementalFixture, unchanged)
+{
+    // Arrange
+    update();
+
+    // Act
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    EXPECT_TRUE(delta.empty());
+    EXPECT_EQ(delta.parsedBytes, 0U);
+}
+
+TEST_P(IncrementalFixture, modifiedEntity)
+{
+    // Arrange
+    update();
+    const std::string content{ formatDxf(document) };
+
+    // Act
+    document.entities.lines[500].start.x += 1.0;
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    EXPECT_FALSE(delta.header.has_value());
+    EXPECT_FALSE(delta.tables.has_value());
+
+    ASSERT_EQ(delta.lines.size(), 1U);
+    EXPECT_EQ(delta.lines.front().index, 500U);
+    EXPECT_EQ(delta.lines.front().removedCount, 1U);
+    EXPECT_EQ(delta.counts().modified, 1U);
+    EXPECT_EQ(delta.counts().added, 0U);
+    EXPECT_EQ(delta.counts().removed, 0U);
+
+    // only the changed entity is parsed
+    EXPECT_LT(delta.parsedBytes, content.size() / 500);
+    EXPECT_THAT(appliedDocument, IsDocument(document));
+}
+
+TEST_P(IncrementalFixture, addedAndRemovedEntities)
+{
+    // Arrange
+    update();
+
+    // Act
+    document.entities.circles.insert(
+        document.entities.circles.begin() + 10, odxf::Circle{ .radius = 5.0 });
+    document.entities.arcs.erase(document.entities.arcs.begin() + 20);
+    document.entities.lwPolylines.pop_back();
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    EXPECT_EQ(delta.counts().added, 1U);
+    EXPECT_EQ(delta.counts().removed, 2U);
+    EXPECT_THAT(appliedDocument, IsDocument(document));
+}
+
+TEST_P(IncrementalFixture, manyChanges)
+{
+    // Arrange
+    update();
+
+    // Act
+    for (std::size_t i{ 0 }; i < document.entities.lines.size(); i += 97) {
+        document.entities.lines[i].end.y -= 2.0;
+    }
+    document.entities.lines.resize(document.entities.lines.size() / 2);
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    EXPECT_FALSE(delta.empty());
+    EXPECT_THAT(appliedDocument, IsDocument(document));
+}
+
+TEST_P(IncrementalFixture, changedHeader)
+{
+    // Arrange
+    update();
+
+    // Act
+    document.header.entries["$ACADVER"] = std::string{ "AC1027" };
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    ASSERT_TRUE(delta.header.has_value());
+    EXPECT_EQ(delta.counts().added + delta.counts().removed + delta.counts().modified, 0U);
+    EXPECT_THAT(appliedDocument, IsDocument(document));
+}
+
+TEST_P(IncrementalFixture, unparsedTypes)
+{
+    // Arrange
+    // points, ellipses and rays are hashed but not parsed by the reader
+    document = odxf::generateDocument(odxf::GeneratorOptions{
+        .entityCount = 2000,
+        .mix = odxf::EntityMix{
+            .points = 1.0,
+            .rays = 1.0,
+            .lines = 1.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .ellipses = 1.0,
+            .lwPolylines = 1.0,
+        },
+    });
+    update();
+
+    // Act
+    document.entities.points[3].coordinate.x += 1.0;
+    document.entities.ellipses.erase(document.entities.ellipses.begin() + 5);
+    document.entities.rays.pop_back();
+    const odxf::DocumentDelta unparsedDelta{ update() };
+
+    document.entities.points.erase(document.entities.points.begin());
+    document.entities.lines[7].start.y += 1.0;
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    EXPECT_TRUE(unparsedDelta.empty());
+    EXPECT_EQ(delta.counts().modified, 1U);
+    EXPECT_EQ(delta.counts().added, 0U);
+    EXPECT_EQ(delta.counts().removed, 0U);
+
+    odxf::Document expected{ document };
+    expected.entities.points.clear();
+    expected.entities.ellipses.clear();
+    expected.entities.rays.clear();
+    EXPECT_THAT(appliedDocument, IsDocument(expected));
+}
+
+TEST_P(IncrementalFixture, parseErrorKeepsState)
+{
+    // Arrange
+    update();
+    std::string content{ formatDxf(document) };
+    // an invalid x coordinate of the last line
+    const std::size_t position{ content.find("\n10\n", content.rfind("\nLINE\n")) };
+    content.insert(position + 4, "x");
+
+    // Act
+    const tl::expected<odxf::DocumentDelta, odxf::Error> failed{ reader.readContent(content) };
+    document.entities.circles.front().radius = 123.0;
+    const odxf::DocumentDelta delta{ update() };
+
+    // Assert
+    EXPECT_FALSE(failed.has_value());
+    EXPECT_EQ(delta.counts().modified, 1U);
+    EXPECT_THAT(appliedDocument, IsDocument(document));
+}
+
+TEST_P(IncrementalFixture, readFile)
+{
+    // Arrange
+    const std::filesystem::path filePath{ "test_incremental.dxf" };
+    ASSERT_TRUE(odxf::writeDxf(document, filePath).has_value());
+
+    // Act
+    const tl::expected<odxf::DocumentDelta, odxf::Error> delta{ reader.read(filePath) };
+
+    // Assert
+    ASSERT_TRUE(delta.has_value());
+    const tl::expected<odxf::Document, odxf::Error> expected{ odxf::readDocument(filePath) };
+    ASSERT_TRUE(expected.has_value());
+
+    odxf::applyDelta(appliedDocument, odxf::DocumentDelta{ *delta });
+    EXPECT_THAT(appliedDocument, IsDocument(*expected));
+
+    std::filesystem::remove(filePath);
+}
+
+INSTANTIATE_TEST_SUITE_P(IncrementalTest, IncrementalFixture, testing::Values(1U, 4U));
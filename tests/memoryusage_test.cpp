@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/memoryusage.hpp"
+
+#include "TestUtils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+namespace {
+
+const std::string longName(64, 'n');
+
+odxf::Document createDocumentWithSlack()
+{
+    odxf::Document document;
+    document.header = createExampleDocument().header;
+
+    document.tables.layers.reserve(100);
+    document.tables.layers.push_back(odxf::Layer{ .name = longName });
+
+    document.entities.lines.reserve(1000);
+    for (int i{ 0 }; i < 10; ++i) {
+        odxf::Line line;
+        line.layer = longName;
+        line.layer.reserve(256);
+        document.entities.lines.push_back(line);
+    }
+
+    odxf::LWPolyline lwPolyline;
+    lwPolyline.vertices.reserve(100);
+    lwPolyline.vertices.resize(3);
+    document.entities.lwPolylines.push_back(std::move(lwPolyline));
+
+    return document;
+}
+
+}   // namespace
+
+TEST(memoryUsage, breakdown)
+{
+    // Arrange
+    const odxf::Document document{ createDocumentWithSlack() };
+
+    // Act
+    const odxf::DocumentMemoryUsage usage{ odxf::memoryUsage(document) };
+
+    // Assert
+    EXPECT_EQ(usage.lines.used, 10 * sizeof(odxf::Line));
+    EXPECT_EQ(usage.lines.reserved, 1000 * sizeof(odxf::Line));
+    EXPECT_EQ(usage.layers.reserved, 100 * sizeof(odxf::Layer));
+    EXPECT_EQ(usage.lwPolylines.used, sizeof(odxf::LWPolyline));
+    EXPECT_EQ(usage.vertices.used, 3 * sizeof(odxf::Vertex));
+    EXPECT_EQ(usage.vertices.reserved, 100 * sizeof(odxf::Vertex));
+
+    // the long layer names plus the long header keys and values
+    EXPECT_GE(usage.strings.used, 11 * (longName.size() + 1));
+    EXPECT_GT(usage.header.used, 0U);
+    EXPECT_GE(usage.header.reserved, usage.header.used);
+
+    const odxf::MemoryUsage total{ usage.total() };
+    EXPECT_LT(total.used, total.reserved);
+}
+
+TEST(memoryUsage, empty)
+{
+    // Arrange
+    const odxf::Document document;
+
+    // Act
+    const odxf::MemoryUsage total{ odxf::memoryUsage(document).total() };
+
+    // Assert
+    EXPECT_EQ(total.used, 0U);
+}
+
+TEST(memoryUsage, shrinkToFit)
+{
+    // Arrange
+    odxf::Document document{ createDocumentWithSlack() };
+    const odxf::MemoryUsage before{ odxf::memoryUsage(document).total() };
+
+    // Act
+    odxf::shrinkToFit(document);
+
+    // Assert
+    const odxf::DocumentMemoryUsage usage{ odxf::memoryUsage(document) };
+    EXPECT_EQ(usage.total().used, before.used);
+    EXPECT_LT(usage.total().reserved, before.reserved);
+
+    EXPECT_EQ(usage.lines.reserved, usage.lines.used);
+    EXPECT_EQ(usage.layers.reserved, usage.layers.used);
+    EXPECT_EQ(usage.lwPolylines.reserved, usage.lwPolylines.used);
+    EXPECT_EQ(usage.vertices.reserved, usage.vertices.used);
+    EXPECT_EQ(usage.strings.reserved, usage.strings.used);
+
+    ASSERT_EQ(document.entities.lines.size(), 10U);
+    EXPECT_EQ(document.entities.lines.back().layer, longName);
+    EXPECT_EQ(document.entities.lwPolylines.front().vertices.size(), 3U);
+}
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/outputsink.hpp"
+#include "opendxf/write.hpp"
+
+#include "groupcodepaddingsink.hpp"
+
+#include "TestUtils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+TEST(outputSink, memoryMatchesFile)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    const std::filesystem::path filePath{ "test_sink_file.dxf" };
+    odxf::MemorySink sink;
+
+    // Act
+    const tl::expected<void, odxf::Error> fileResult{ odxf::writeDxf(document, filePath) };
+    const tl::expected<void, odxf::Error> sinkResult{ odxf::writeDxf(document, sink) };
+
+    // Assert
+    ASSERT_TRUE(fileResult.has_value());
+    ASSERT_TRUE(sinkResult.has_value());
+    EXPECT_FALSE(sink.content().empty());
+    EXPECT_EQ(sink.content(), readFile(filePath));
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(outputSink, ostream)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    odxf::MemorySink memorySink;
+    std::ostringstream stream;
+    odxf::OStreamSink sink{ stream };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(document, sink) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(odxf::writeDxf(document, memorySink));
+    EXPECT_EQ(stream.str(), memorySink.content());
+}
+
+TEST(outputSink, callbackAbort)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    int callCount{ 0 };
+    odxf::CallbackSink sink{ [&callCount](std::string_view) {
+        ++callCount;
+        return false;
+    } };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(document, sink) };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().type, odxf::Error::Type::FileWriteError);
+    EXPECT_EQ(callCount, 1);
+}
+
+TEST(outputSink, fileDescriptor)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    const std::filesystem::path filePath{ "test_sink_fd.dxf" };
+    const int fileDescriptor{ ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+    ASSERT_GE(fileDescriptor, 0);
+
+    odxf::FileDescriptorSink sink{ fileDescriptor };
+    odxf::MemorySink memorySink;
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(document, sink) };
+    ::close(fileDescriptor);
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(odxf::writeDxf(document, memorySink));
+    EXPECT_EQ(readFile(filePath), memorySink.content());
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(outputSink, invalidFileDescriptor)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    odxf::FileDescriptorSink sink{ -1 };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(document, sink) };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().type, odxf::Error::Type::FileWriteError);
+}
+
+TEST(outputSink, missingDirectory)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    const std::filesystem::path filePath{ "missing_directory/test.dxf" };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(document, filePath) };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().type, odxf::Error::Type::FileOpenError);
+    EXPECT_FALSE(std::filesystem::exists(filePath));
+}
+
+TEST(outputSink, asyncCallbackAbort)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    odxf::CallbackSink sink{ [](std::string_view) { return false; } };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{
+        odxf::writeDxf(document, sink, odxf::WriteOptions{ .asyncOutput = true })
+    };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().type, odxf::Error::Type::FileWriteError);
+}
+
+TEST(outputSink, fileReserve)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    const std::filesystem::path filePath{ "test_sink_reserve.dxf" };
+    odxf::MemorySink memorySink;
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(
+        document, filePath, odxf::WriteOptions{ .preallocateSize = 1U << 20 }) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(odxf::writeDxf(document, memorySink));
+    EXPECT_EQ(std::filesystem::file_size(filePath), memorySink.content().size());
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(outputSink, fileReserveFailedWrite)
+{
+    // Arrange
+    // the layer references a line type which does not exist
+    odxf::Document document{ createExampleDocument() };
+    document.tables.lineTypes.clear();
+    const std::filesystem::path filePath{ std::filesystem::path{ testing::TempDir() }
+                                          / "test_sink_reserve_failed.dxf" };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeDxf(
+        document, filePath, odxf::WriteOptions{ .preallocateSize = 1U << 20 }) };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_LT(std::filesystem::file_size(filePath), 1U << 20);
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(outputSink, groupCodePadding)
+{
+    // Arrange
+    odxf::MemorySink memorySink;
+    odxf::GroupCodePaddingSink sink{ memorySink };
+
+    // Act
+    const bool written{ sink.write("0\nSECTION\n2\nENT") && sink.write("ITIES\n1")
+                        && sink.write("0\n1.5\n100\nAcDb\n9") && sink.close() };
+
+    // Assert
+    ASSERT_TRUE(written);
+    EXPECT_EQ(memorySink.content(), "  0\nSECTION\n  2\nENTITIES\n 10\n1.5\n100\nAcDb\n  9");
+}
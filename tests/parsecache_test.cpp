@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/parsecache.hpp"
+#include "opendxf/read.hpp"
+#include "opendxf/sidecar.hpp"
+#include "opendxf/write.hpp"
+
+#include "Matchers/DocumentMatcher.hpp"
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+namespace {
+
+class ParseCacheFixture : public testing::TestWithParam<odxf::ParseCacheOptions::Key>
+{
+protected:
+    void SetUp() override { std::filesystem::remove_all(cacheDirectory); }
+    void TearDown() override { std::filesystem::remove_all(cacheDirectory); }
+
+    odxf::ParseCacheOptions options() const
+    {
+        return odxf::ParseCacheOptions{
+            .directory = cacheDirectory,
+            .key = GetParam(),
+        };
+    }
+
+    const std::filesystem::path cacheDirectory{ "test_parse_cache" };
+    const std::filesystem::path filePath{ TEST_DATA_DIR "/example.dxf" };
+};
+
+std::size_t entryCount(const std::filesystem::path& directory)
+{
+    std::size_t count{ 0 };
+    for (const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator{ directory }) {
+        count += entry.path().extension() == ".odxfsnap" ? 1 : 0;
+    }
+
+    return count;
+}
+
+}   // namespace
+
+TEST_P(ParseCacheFixture, readDocument)
+{
+    // Arrange
+    odxf::ParseCache cache{ options() };
+    const tl::expected<odxf::Document, odxf::Error> expectedDocument{
+        odxf::readDocument(filePath)
+    };
+    ASSERT_TRUE(expectedDocument.has_value());
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> miss{ cache.readDocument(filePath) };
+    const tl::expected<odxf::Document, odxf::Error> hit{ cache.readDocument(filePath) };
+
+    // Assert
+    ASSERT_TRUE(miss.has_value());
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_THAT(*miss, IsDocument(*expectedDocument));
+    EXPECT_THAT(*hit, IsDocument(*expectedDocument));
+
+    const odxf::ParseCacheStats stats{ cache.stats() };
+    EXPECT_EQ(stats.misses, 1U);
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.stores, 1U);
+    EXPECT_EQ(stats.storeFailures, 0U);
+    EXPECT_EQ(entryCount(cacheDirectory), 1U);
+}
+
+TEST_P(ParseCacheFixture, sidecarIndex)
+{
+    // Arrange
+    odxf::ParseCache cache{ options() };
+    const std::filesystem::path missIndexPath{ std::filesystem::path{ testing::TempDir() }
+                                               / "test_parse_cache_miss.odxfidx" };
+    const std::filesystem::path hitIndexPath{ std::filesystem::path{ testing::TempDir() }
+                                              / "test_parse_cache_hit.odxfidx" };
+    std::optional<odxf::Error> sidecarError{ odxf::Error{} };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> miss{ cache.readDocument(
+        filePath, odxf::ReadOptions{ .sidecarPath = missIndexPath }) };
+    const tl::expected<odxf::Document, odxf::Error> hit{ cache.readDocument(
+        filePath,
+        odxf::ReadOptions{ .sidecarPath = hitIndexPath, .sidecarError = &sidecarError }) };
+    std::optional<odxf::Error> unwritableError;
+    const tl::expected<odxf::Document, odxf::Error> unwritable{ cache.readDocument(
+        filePath,
+        odxf::ReadOptions{
+            .sidecarPath = cacheDirectory / "missing_directory" / "hit.odxfidx",
+            .sidecarError = &unwritableError,
+        }) };
+
+    // Assert
+    ASSERT_TRUE(miss.has_value());
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_TRUE(unwritable.has_value());
+    EXPECT_EQ(cache.stats().hits, 2U);
+
+    EXPECT_TRUE(odxf::SidecarIndex::open(filePath, missIndexPath).has_value());
+    EXPECT_TRUE(odxf::SidecarIndex::open(filePath, hitIndexPath).has_value());
+    EXPECT_FALSE(sidecarError.has_value());
+    ASSERT_TRUE(unwritableError.has_value());
+    EXPECT_EQ(unwritableError->type, odxf::Error::Type::FileOpenError);
+
+    std::filesystem::remove(missIndexPath);
+    std::filesystem::remove(hitIndexPath);
+}
+
+TEST_P(ParseCacheFixture, readStream)
+{
+    // Arrange
+    odxf::ParseCache cache{ options() };
+    ReadStream expectedStream;
+    ASSERT_TRUE(odxf::read(expectedStream, filePath).has_value());
+
+    // Act
+    ReadStream missStream;
+    const tl::expected<void, odxf::Error> miss{ cache.read(missStream, filePath) };
+    ReadStream hitStream;
+    const tl::expected<void, odxf::Error> hit{ cache.read(hitStream, filePath) };
+
+    // Assert
+    ASSERT_TRUE(miss.has_value());
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_THAT(missStream.document(), IsDocument(expectedStream.document()));
+    EXPECT_THAT(hitStream.document(), IsDocument(expectedStream.document()));
+    EXPECT_EQ(cache.stats().hits, 1U);
+}
+
+TEST_P(ParseCacheFixture, changedFile)
+{
+    // Arrange
+    const std::filesystem::path changingPath{ "test_parse_cache_changing.dxf" };
+    odxf::Document document{ createExampleDocument() };
+    ASSERT_TRUE(odxf::writeDxf(document, changingPath).has_value());
+
+    odxf::ParseCache cache{ options() };
+    ASSERT_TRUE(cache.readDocument(changingPath).has_value());
+
+    // Act
+    document.entities.lines.push_back(odxf::Line{});
+    std::filesystem::remove(changingPath);
+    ASSERT_TRUE(odxf::writeDxf(document, changingPath).has_value());
+    const tl::expected<odxf::Document, odxf::Error> result{ cache.readDocument(changingPath) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->entities.lines.size(), document.entities.lines.size());
+    EXPECT_EQ(cache.stats().misses, 2U);
+    EXPECT_EQ(cache.stats().hits, 0U);
+
+    std::filesystem::remove(changingPath);
+}
+
+TEST_P(ParseCacheFixture, eviction)
+{
+    // Arrange
+    const std::filesystem::path otherPath{ "test_parse_cache_other.dxf" };
+    odxf::Document document{ createExampleDocument() };
+    document.entities.lines.resize(10);
+    ASSERT_TRUE(odxf::writeDxf(document, otherPath).has_value());
+
+    // room for the larger of the two entries only
+    std::uintmax_t largestEntry{ 0 };
+    {
+        odxf::ParseCache measuringCache{ options() };
+        ASSERT_TRUE(measuringCache.readDocument(filePath).has_value());
+        ASSERT_TRUE(measuringCache.readDocument(otherPath).has_value());
+        for (const std::filesystem::directory_entry& entry :
+             std::filesystem::directory_iterator{ cacheDirectory }) {
+            largestEntry = std::max(largestEntry, entry.file_size());
+        }
+        measuringCache.clear();
+    }
+
+    odxf::ParseCacheOptions cacheOptions{ options() };
+    cacheOptions.maxSize = largestEntry;
+    odxf::ParseCache cache{ cacheOptions };
+
+    // Act
+    ASSERT_TRUE(cache.readDocument(filePath).has_value());
+    ASSERT_TRUE(cache.readDocument(otherPath).has_value());
+
+    // Assert
+    EXPECT_EQ(cache.stats().evictions, 1U);
+    EXPECT_EQ(entryCount(cacheDirectory), 1U);
+
+    // the entry of the other file survived
+    ASSERT_TRUE(cache.readDocument(otherPath).has_value());
+    EXPECT_EQ(cache.stats().hits, 1U);
+
+    std::filesystem::remove(otherPath);
+}
+
+TEST_P(ParseCacheFixture, missingFile)
+{
+    // Arrange
+    odxf::ParseCache cache{ options() };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> result{
+        cache.readDocument("does_not_exist.dxf")
+    };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().type, odxf::Error::Type::FileOpenError);
+    EXPECT_EQ(cache.stats().misses, 0U);
+}
+
+TEST_P(ParseCacheFixture, clear)
+{
+    // Arrange
+    odxf::ParseCache cache{ options() };
+    ASSERT_TRUE(cache.readDocument(filePath).has_value());
+
+    // Act
+    cache.clear();
+
+    // Assert
+    EXPECT_EQ(entryCount(cacheDirectory), 0U);
+    ASSERT_TRUE(cache.readDocument(filePath).has_value());
+    EXPECT_EQ(cache.stats().misses, 2U);
+}
+
+TEST_P(ParseCacheFixture, staleTemporaryFiles)
+{
+    // Arrange
+    const std::filesystem::path stalePath{ cacheDirectory / "stale.odxfsnap.0000abcd.tmp" };
+    const std::filesystem::path freshPath{ cacheDirectory / "fresh.odxfsnap.0000abcd.tmp" };
+    std::filesystem::create_directories(cacheDirectory);
+    std::ofstream{ stalePath } << "partial";
+    std::ofstream{ freshPath } << "partial";
+    std::filesystem::last_write_time(
+        stalePath, std::filesystem::file_time_type::clock::now() - std::chrono::hours{ 2 });
+
+    odxf::ParseCache cache{ options() };
+
+    // Act
+    ASSERT_TRUE(cache.readDocument(filePath).has_value());
+
+    // Assert
+    EXPECT_FALSE(std::filesystem::exists(stalePath));
+    EXPECT_TRUE(std::filesystem::exists(freshPath));
+    EXPECT_EQ(cache.stats().evictions, 0U);
+
+    // an entry may still be stored through the fresh one
+    cache.clear();
+    EXPECT_TRUE(std::filesystem::exists(freshPath));
+}
+
+// clang-format off
+INSTANTIATE_TEST_SUITE_P(
+    parseCache,
+    ParseCacheFixture,
+    testing::Values(
+        odxf::ParseCacheOptions::Key::ContentHash,
+        odxf::ParseCacheOptions::Key::FileMetadata));
+// clang-format on
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/prescan.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+TEST(prescan, example)
+{
+    // Arrange
+    const auto filePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+    ASSERT_TRUE(std::filesystem::is_regular_file(filePath));
+
+    // Act
+    const tl::expected<odxf::DocumentCounts, odxf::Error> result{ odxf::prescan(filePath) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+
+    const odxf::DocumentCounts& counts{ *result };
+    EXPECT_EQ(counts.headerEntries, 41);
+    EXPECT_EQ(counts.lineTypes, 1);
+    EXPECT_EQ(counts.layers, 3);
+
+    const odxf::EntityCounts& entities{ counts.entities };
+    EXPECT_EQ(entities.arcs, 1);
+    EXPECT_EQ(entities.circles, 1);
+    EXPECT_EQ(entities.ellipses, 0);
+    EXPECT_EQ(entities.lines, 2);
+    EXPECT_EQ(entities.points, 0);
+    EXPECT_EQ(entities.lwPolylines, 3);
+    EXPECT_EQ(entities.rays, 0);
+    EXPECT_EQ(entities.other, 0);
+    EXPECT_EQ(entities.lwPolylineVertices, 8);
+}
+
+TEST(prescan, padded)
+{
+    // Arrange
+    const auto filePath{ std::filesystem::path{ TEST_DATA_DIR } / "padded.dxf" };
+    ASSERT_TRUE(std::filesystem::is_regular_file(filePath));
+
+    // Act
+    const tl::expected<odxf::DocumentCounts, odxf::Error> result{ odxf::prescan(filePath) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_GT(result->headerEntries, 0);
+}
+
+TEST(prescan, missingFile)
+{
+    // Arrange
+    const auto filePath{ std::filesystem::path{ TEST_DATA_DIR } / "does_not_exist.dxf" };
+
+    // Act
+    const tl::expected<odxf::DocumentCounts, odxf::Error> result{ odxf::prescan(filePath) };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().type, odxf::Error::Type::FileOpenError);
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 // Copyright (c) 2024 Marco Langer
 
+#include "opendxf/generator.hpp"
 #include "opendxf/opendxf.hpp"
 
 #include "Matchers/DocumentMatcher.hpp"
@@ -12,6 +13,8 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <fstream>
+#include <string>
 
 TEST(read, example)
 {
@@ -56,6 +59,260 @@ TEST(read, padded)
     }
 }
 
+struct ReadDocumentFixture : testing::TestWithParam<unsigned int>
+{};
+
+TEST_P(ReadDocumentFixture, example)
+{
+    // Arrange
+    const auto filePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+    ASSERT_TRUE(std::filesystem::is_regular_file(filePath));
+
+    const odxf::ReadOptions options{ .threadCount = GetParam() };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> result{
+        odxf::readDocument(filePath, options)
+    };
+
+    // Assert
+    if (!result) {
+        const odxf::Error& error{ result.error() };
+        FAIL() << fmt::format("Line ({}): {}", error.lineNumber.value_or(-1), error.what);
+    }
+
+    const odxf::Document expectedDocument{ createExampleDocument() };
+
+    EXPECT_THAT(*result, IsDocument(expectedDocument));
+
+    const odxf::Entities& entities{ result->entities };
+    EXPECT_EQ(entities.lines.capacity(), entities.lines.size());
+    EXPECT_EQ(entities.lwPolylines.capacity(), entities.lwPolylines.size());
+    for (const odxf::LWPolyline& lwPolyline : entities.lwPolylines) {
+        EXPECT_EQ(lwPolyline.vertices.capacity(), lwPolyline.vertices.size());
+    }
+    EXPECT_EQ(result->tables.lineTypes.capacity(), result->tables.lineTypes.size());
+    EXPECT_EQ(result->tables.layers.capacity(), result->tables.layers.size());
+}
+
+TEST_P(ReadDocumentFixture, manyEntities)
+{
+    // Arrange
+    odxf::Document document{ createExampleDocument() };
+    for (int i{ 0 }; i < 1000; ++i) {
+        const double offset{ static_cast<double>(i) };
+        document.entities.lines.push_back(odxf::Line{
+            .start = { offset, 0.0, 0.0 },
+            .end = { offset, 1.0, 0.0 },
+        });
+        document.entities.circles.push_back(odxf::Circle{
+            .center = { offset, offset, 0.0 },
+            .radius = 1.0 + offset,
+        });
+    }
+
+    const TemporaryFile file{ "read_many_entities.dxf" };
+    ASSERT_TRUE(odxf::writeDxf(document, file.path()));
+
+    const odxf::ReadOptions options{ .threadCount = GetParam() };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> result{
+        odxf::readDocument(file.path(), options)
+    };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_THAT(*result, IsDocument(document));
+}
+
+TEST_P(ReadDocumentFixture, entityParseError)
+{
+    // Arrange
+    const auto sourcePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+    ASSERT_TRUE(std::filesystem::is_regular_file(sourcePath));
+
+    std::string content{ readFile(sourcePath) };
+    const std::size_t position{ content.find("200.000000") };
+    ASSERT_NE(position, std::string::npos);
+    content.replace(position, 10, "invalid");
+
+    const TemporaryFile file{ "read_entity_parse_error.dxf" };
+    std::ofstream{ file.path() } << content;
+
+    ReadStream istream;
+    const tl::expected<void, odxf::Error> expectedResult{ odxf::read(istream, file.path()) };
+    ASSERT_FALSE(expectedResult.has_value());
+
+    const odxf::ReadOptions options{ .threadCount = GetParam() };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> result{
+        odxf::readDocument(file.path(), options)
+    };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().lineNumber, expectedResult.error().lineNumber);
+}
+
+TEST_P(ReadDocumentFixture, entityParseErrorStats)
+{
+    // Arrange
+    const auto sourcePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+
+    std::string content{ readFile(sourcePath) };
+    const std::size_t position{ content.find("200.000000") };
+    ASSERT_NE(position, std::string::npos);
+    content.replace(position, 10, "invalid");
+
+    const TemporaryFile file{ "read_entity_parse_error_stats.dxf" };
+    std::ofstream{ file.path() } << content;
+
+    odxf::ReadStats stats;
+    const odxf::ReadOptions options{ .threadCount = GetParam(), .stats = &stats };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> result{
+        odxf::readDocument(file.path(), options)
+    };
+
+    // Assert
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(stats.parseFailures, 1U);
+}
+
+TEST_P(ReadDocumentFixture, stats)
+{
+    // Arrange
+    const odxf::GeneratorOptions generatorOptions{
+        .entityCount = 2000,
+        .mix{
+            .points = 1.0,
+            .rays = 1.0,
+            .lines = 1.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .ellipses = 1.0,
+            .lwPolylines = 1.0,
+        },
+    };
+
+    const TemporaryFile file{ "read_stats.dxf" };
+    ASSERT_TRUE(odxf::generateDxf(generatorOptions, file.path()));
+
+    const odxf::Document generated{ odxf::generateDocument(generatorOptions) };
+    const odxf::Entities& entities{ generated.entities };
+
+    odxf::ReadStats stats;
+    const odxf::ReadOptions options{ .threadCount = GetParam(), .stats = &stats };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> result{
+        odxf::readDocument(file.path(), options)
+    };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+
+    EXPECT_EQ(stats.parseFailures, 0U);
+    EXPECT_EQ(stats.peakBufferedBytes, std::filesystem::file_size(file.path()));
+    EXPECT_LE(stats.loadDuration, stats.totalDuration);
+
+    const std::uint64_t sectionBytes{
+        stats.header.bytes + stats.tables.bytes + stats.blocks.bytes + stats.entities.bytes
+    };
+    EXPECT_LE(sectionBytes, stats.peakBufferedBytes);
+    EXPECT_GT(sectionBytes, stats.peakBufferedBytes * 9 / 10);
+    EXPECT_GT(stats.header.groupCodes, 0U);
+    EXPECT_GT(stats.entities.groupCodes, stats.tables.groupCodes);
+
+    EXPECT_THAT(
+        stats.parsedEntities,
+        testing::UnorderedElementsAre(
+            testing::Pair("LINE", entities.lines.size()),
+            testing::Pair("CIRCLE", entities.circles.size()),
+            testing::Pair("ARC", entities.arcs.size()),
+            testing::Pair("LWPOLYLINE", entities.lwPolylines.size())));
+    EXPECT_THAT(
+        stats.skippedEntities,
+        testing::UnorderedElementsAre(
+            testing::Pair("POINT", entities.points.size()),
+            testing::Pair("RAY", entities.rays.size()),
+            testing::Pair("ELLIPSE", entities.ellipses.size())));
+}
+
+TEST(read, stats)
+{
+    // Arrange
+    const auto filePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+
+    ReadStream istream;
+    odxf::ReadStats stats;
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::read(istream, filePath, &stats) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(stats.peakBufferedBytes, std::filesystem::file_size(filePath));
+    EXPECT_THAT(
+        stats.parsedEntities,
+        testing::UnorderedElementsAre(
+            testing::Pair("LINE", 2U),
+            testing::Pair("CIRCLE", 1U),
+            testing::Pair("ARC", 1U),
+            testing::Pair("LWPOLYLINE", 3U)));
+    EXPECT_EQ(stats.parseFailures, 0U);
+}
+
+TEST(read, window)
+{
+    // Arrange
+    // a file of several windows
+    const odxf::GeneratorOptions generatorOptions{
+        .entityCount = 20000,
+        .mix{
+            .points = 1.0,
+            .lines = 1.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .lwPolylines = 1.0,
+        },
+    };
+
+    const TemporaryFile file{ "read_window.dxf" };
+    ASSERT_TRUE(odxf::generateDxf(generatorOptions, file.path()));
+    const std::uintmax_t fileSize{ std::filesystem::file_size(file.path()) };
+
+    const tl::expected<odxf::Document, odxf::Error> expectedDocument{
+        odxf::readDocument(file.path())
+    };
+    ASSERT_TRUE(expectedDocument.has_value());
+
+    ReadStream istream;
+    odxf::ReadStats stats;
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::read(istream, file.path(), &stats) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_THAT(istream.document(), IsDocument(*expectedDocument));
+
+    EXPECT_GT(stats.peakBufferedBytes, 0U);
+    EXPECT_LT(stats.peakBufferedBytes, fileSize / 2);
+
+    const std::uint64_t sectionBytes{
+        stats.header.bytes + stats.tables.bytes + stats.blocks.bytes + stats.entities.bytes
+    };
+    EXPECT_LE(sectionBytes, fileSize);
+    EXPECT_GT(sectionBytes, fileSize * 9 / 10);
+
+}
+
+INSTANTIATE_TEST_SUITE_P(ReadDocumentTest, ReadDocumentFixture, testing::Values(1U, 2U, 7U));
+
 struct ParseErrorParam final
 {
     std::string filename;
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/extents.hpp"
+#include "opendxf/generator.hpp"
+#include "opendxf/read.hpp"
+#include "opendxf/sidecar.hpp"
+#include "opendxf/write.hpp"
+
+#include "Matchers/EntitiesMatcher.hpp"
+#include "Matchers/HeaderMatcher.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool intersects(const odxf::Extents& extents, const odxf::Box2d& window)
+{
+    return extents.min.x <= window.max.x && window.min.x <= extents.max.x
+           && extents.min.y <= window.max.y && window.min.y <= extents.max.y;
+}
+
+// The entities of the query, selected from all entities of the file.
+odxf::Entities select(const odxf::Entities& entities, const odxf::SidecarQuery& query)
+{
+    const auto isSelected{ [&](const auto& entity) {
+        const bool isOnLayer{ query.layers.empty()
+                              || std::find(query.layers.begin(), query.layers.end(), entity.layer)
+                                     != query.layers.end() };
+
+        return isOnLayer && (!query.window || intersects(odxf::extents(entity), *query.window));
+    } };
+    const auto selectAll{ [&](const auto& all, auto& result) {
+        std::copy_if(all.begin(), all.end(), std::back_inserter(result), isSelected);
+    } };
+
+    odxf::Entities result;
+    selectAll(entities.arcs, result.arcs);
+    selectAll(entities.circles, result.circles);
+    selectAll(entities.lines, result.lines);
+    selectAll(entities.lwPolylines, result.lwPolylines);
+
+    return result;
+}
+
+class SidecarFixture : public testing::TestWithParam<unsigned int>
+{
+protected:
+    SidecarFixture()
+    {
+        const odxf::Document document{ odxf::generateDocument(odxf::GeneratorOptions{
+            .entityCount = 3000,
+            .layerCount = 5,
+            .bulgeFraction = 0.3,
+            .extent = 1000.0,
+        }) };
+        EXPECT_TRUE(odxf::writeDxf(document, dxfPath).has_value());
+
+        tl::expected<odxf::Document, odxf::Error> read{ odxf::readDocument(
+            dxfPath,
+            odxf::ReadOptions{ .threadCount = GetParam(), .sidecarPath = indexPath }) };
+        EXPECT_TRUE(read.has_value());
+        if (read) {
+            fileDocument = std::move(*read);
+        }
+    }
+
+    ~SidecarFixture() override
+    {
+        std::filesystem::remove(dxfPath);
+        std::filesystem::remove(indexPath);
+    }
+
+    odxf::SidecarOptions options() const
+    {
+        return odxf::SidecarOptions{ .threadCount = GetParam() };
+    }
+
+    const std::filesystem::path dxfPath{ std::filesystem::path{ testing::TempDir() }
+                                         / "test_sidecar.dxf" };
+    const std::filesystem::path indexPath{ std::filesystem::path{ testing::TempDir() }
+                                           / "test_sidecar.odxfidx" };
+    odxf::Document fileDocument;
+};
+
+}   // namespace
+
+TEST_P(SidecarFixture, open)
+{
+    // Act
+    const tl::expected<odxf::SidecarIndex, odxf::Error> index{
+        odxf::SidecarIndex::open(dxfPath, indexPath, options())
+    };
+
+    // Assert
+    ASSERT_TRUE(index.has_value());
+    const odxf::Entities& entities{ fileDocument.entities };
+    EXPECT_EQ(
+        index->size(),
+        entities.arcs.size() + entities.circles.size() + entities.lines.size()
+            + entities.lwPolylines.size());
+    std::set<std::string> layers;
+    const auto addLayers{ [&](const auto& all) {
+        for (const auto& entity : all) {
+            layers.insert(entity.layer);
+        }
+    } };
+    addLayers(entities.arcs);
+    addLayers(entities.circles);
+    addLayers(entities.lines);
+    addLayers(entities.lwPolylines);
+    EXPECT_THAT(index->layers(), testing::UnorderedElementsAreArray(layers));
+    EXPECT_THAT(index->header(), IsHeader(fileDocument.header));
+}
+
+TEST_P(SidecarFixture, queries)
+{
+    // Arrange
+    const tl::expected<odxf::SidecarIndex, odxf::Error> index{
+        odxf::SidecarIndex::open(dxfPath, indexPath, options())
+    };
+    ASSERT_TRUE(index.has_value());
+
+    const std::vector<odxf::SidecarQuery> queries{
+        odxf::SidecarQuery{},
+        odxf::SidecarQuery{ .window = odxf::Box2d{ .min = { 200.0, 300.0 },
+                                                   .max = { 260.0, 330.0 } } },
+        odxf::SidecarQuery{ .window = odxf::Box2d{ .min = { -50.0, -50.0 },
+                                                   .max = { 500.0, 1050.0 } } },
+        odxf::SidecarQuery{ .layers = { "Layer 1", "Layer 3" } },
+        odxf::SidecarQuery{
+            .window = odxf::Box2d{ .min = { 400.0, 400.0 }, .max = { 600.0, 600.0 } },
+            .layers = { "Layer 2", "no such layer" },
+        },
+        odxf::SidecarQuery{ .window = odxf::Box2d{ .min = { 5000.0, 5000.0 },
+                                                   .max = { 5001.0, 5001.0 } } },
+    };
+
+    for (const odxf::SidecarQuery& query : queries) {
+        // Act
+        const tl::expected<odxf::Entities, odxf::Error> entities{ index->read(query) };
+
+        // Assert
+        ASSERT_TRUE(entities.has_value());
+        EXPECT_THAT(*entities, AreEntities(select(fileDocument.entities, query)));
+    }
+}
+
+TEST_P(SidecarFixture, outdatedFile)
+{
+    // Arrange
+    // an edit of an entity keeping the size of the file
+    std::string content;
+    {
+        std::ifstream stream{ dxfPath, std::ios::binary };
+        content.assign(std::istreambuf_iterator<char>{ stream }, {});
+    }
+    const std::size_t position{ content.rfind("LINE") };
+    ASSERT_NE(position, std::string::npos);
+    content.replace(position, 4, "ARC ");
+    {
+        std::ofstream stream{ dxfPath, std::ios::binary };
+        stream << content;
+    }
+
+    // Act
+    const tl::expected<odxf::SidecarIndex, odxf::Error> verified{
+        odxf::SidecarIndex::open(dxfPath, indexPath, options())
+    };
+    const tl::expected<odxf::SidecarIndex, odxf::Error> unverified{ odxf::SidecarIndex::open(
+        dxfPath, indexPath, odxf::SidecarOptions{ .verifyContent = false }) };
+
+    // Assert
+    ASSERT_FALSE(verified.has_value());
+    EXPECT_EQ(verified.error().type, odxf::Error::Type::InvalidFile);
+    // the sections before the entities did not change
+    EXPECT_TRUE(unverified.has_value());
+}
+
+TEST_P(SidecarFixture, invalidIndex)
+{
+    // Arrange
+    {
+        std::ofstream stream{ indexPath, std::ios::binary };
+        stream << "no sidecar index";
+    }
+
+    // Act
+    const tl::expected<odxf::SidecarIndex, odxf::Error> index{
+        odxf::SidecarIndex::open(dxfPath, indexPath, options())
+    };
+    const tl::expected<odxf::SidecarIndex, odxf::Error> missing{
+        odxf::SidecarIndex::open(dxfPath, "missing.odxfidx", options())
+    };
+
+    // Assert
+    ASSERT_FALSE(index.has_value());
+    EXPECT_EQ(index.error().type, odxf::Error::Type::InvalidFile);
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().type, odxf::Error::Type::FileOpenError);
+}
+
+TEST_P(SidecarFixture, unwritableIndex)
+{
+    // Arrange
+    std::optional<odxf::Error> sidecarError;
+    const odxf::ReadOptions readOptions{
+        .threadCount = GetParam(),
+        .sidecarPath = std::filesystem::path{ "missing_directory" } / "test_sidecar.odxfidx",
+        .sidecarError = &sidecarError,
+    };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> document{
+        odxf::readDocument(dxfPath, readOptions)
+    };
+
+    // Assert
+    ASSERT_TRUE(document.has_value());
+    EXPECT_THAT(document->entities, AreEntities(fileDocument.entities));
+    ASSERT_TRUE(sidecarError.has_value());
+    EXPECT_EQ(sidecarError->type, odxf::Error::Type::FileOpenError);
+}
+
+TEST_P(SidecarFixture, rewrittenIndex)
+{
+    // Arrange
+    const odxf::ReadOptions readOptions{ .threadCount = GetParam(), .sidecarPath = indexPath };
+
+    // Act
+    const tl::expected<odxf::Document, odxf::Error> document{
+        odxf::readDocument(dxfPath, readOptions)
+    };
+    const tl::expected<odxf::SidecarIndex, odxf::Error> index{
+        odxf::SidecarIndex::open(dxfPath, indexPath, options())
+    };
+
+    // Assert
+    ASSERT_TRUE(document.has_value());
+    EXPECT_TRUE(index.has_value());
+    const std::filesystem::path directory{ std::filesystem::absolute(indexPath).parent_path() };
+    for (const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator{ directory }) {
+        const std::string fileName{ entry.path().filename().string() };
+        EXPECT_FALSE(fileName.starts_with(indexPath.string()) && fileName.ends_with(".tmp"))
+            << fileName;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SidecarTest, SidecarFixture, testing::Values(1U, 4U));
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+#include "opendxf/outputsink.hpp"
+#include "opendxf/snapshot.hpp"
+
+#include "Matchers/DocumentMatcher.hpp"
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+odxf::Document createSnapshotDocument()
+{
+    odxf::Document document{ odxf::generateDocument(odxf::GeneratorOptions{
+        .entityCount = 500,
+        .mix = odxf::EntityMix{
+            .points = 1.0,
+            .rays = 1.0,
+            .lines = 1.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .ellipses = 1.0,
+            .lwPolylines = 1.0,
+        },
+    }) };
+
+    const odxf::Document exampleDocument{ createExampleDocument() };
+    document.header = exampleDocument.header;
+    document.tables = exampleDocument.tables;
+
+    document.entities.points.front().extrusion = odxf::Vector3d{ 0.0, 0.0, -1.0 };
+    document.entities.points.front().thickness = 2.5;
+    document.entities.ellipses.front().extrusion = odxf::Vector3d{ 0.0, 1.0, 0.0 };
+    document.entities.lwPolylines.front().elevation = 4.0;
+    document.entities.lwPolylines.front().isClosed = true;
+
+    return document;
+}
+
+void writeFile(const std::filesystem::path& filePath, const std::string& content)
+{
+    std::ofstream stream{ filePath, std::ios::binary };
+    stream << content;
+}
+
+}   // namespace
+
+TEST(snapshot, roundTrip)
+{
+    // Arrange
+    const odxf::Document document{ createSnapshotDocument() };
+    const std::filesystem::path filePath{ "test_snapshot.odxfsnap" };
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeSnapshot(document, filePath) };
+    const tl::expected<odxf::Snapshot, odxf::Error> snapshot{ odxf::Snapshot::open(filePath) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(snapshot.has_value());
+
+    const odxf::Document snapshotDocument{ snapshot->toDocument() };
+    EXPECT_THAT(snapshotDocument, IsDocument(document));
+
+    const odxf::Entities& entities{ snapshotDocument.entities };
+    ASSERT_EQ(entities.points.size(), document.entities.points.size());
+    ASSERT_EQ(entities.rays.size(), document.entities.rays.size());
+    ASSERT_EQ(entities.ellipses.size(), document.entities.ellipses.size());
+
+    const odxf::Point& point{ entities.points.front() };
+    ASSERT_TRUE(point.extrusion.has_value());
+    EXPECT_EQ(point.extrusion->z, -1.0);
+    EXPECT_EQ(point.thickness, 2.5);
+    EXPECT_FALSE(entities.points.back().extrusion.has_value());
+
+    EXPECT_EQ(entities.rays.back().direction.x, document.entities.rays.back().direction.x);
+    EXPECT_EQ(
+        entities.ellipses.back().axisRatio, document.entities.ellipses.back().axisRatio);
+    EXPECT_EQ(entities.lwPolylines.front().elevation, 4.0);
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(snapshot, entityViews)
+{
+    // Arrange
+    const odxf::Document document{ createSnapshotDocument() };
+    const std::filesystem::path filePath{ "test_snapshot_views.odxfsnap" };
+    ASSERT_TRUE(odxf::writeSnapshot(document, filePath).has_value());
+
+    // Act
+    const tl::expected<odxf::Snapshot, odxf::Error> snapshot{ odxf::Snapshot::open(filePath) };
+
+    // Assert
+    ASSERT_TRUE(snapshot.has_value());
+
+    const odxf::EntityView<odxf::Line> lines{ snapshot->lines() };
+    ASSERT_EQ(lines.size(), document.entities.lines.size());
+    EXPECT_EQ(lines.layer(3), document.entities.lines[3].layer);
+    EXPECT_EQ(lines.color(3), document.entities.lines[3].color);
+
+    const odxf::EntityView<odxf::Line> range{ lines.subrange(10, 20) };
+    ASSERT_EQ(range.size(), 10U);
+    EXPECT_EQ(range[0].start.x, document.entities.lines[10].start.x);
+    EXPECT_EQ(range.layer(9), document.entities.lines[19].layer);
+    EXPECT_TRUE(lines.subrange(20, 10).empty());
+    EXPECT_EQ(lines.subrange(5, 100000).size(), lines.size() - 5);
+
+    const odxf::EntityView<odxf::LWPolyline> lwPolylines{ snapshot->lwPolylines() };
+    ASSERT_EQ(lwPolylines.size(), document.entities.lwPolylines.size());
+    EXPECT_EQ(
+        lwPolylines[7].vertices.size(), document.entities.lwPolylines[7].vertices.size());
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(snapshot, writeToSink)
+{
+    // Arrange
+    const odxf::Document document{ createExampleDocument() };
+    const std::filesystem::path filePath{ "test_snapshot_sink.odxfsnap" };
+    ASSERT_TRUE(odxf::writeSnapshot(document, filePath).has_value());
+    odxf::MemorySink sink;
+
+    // Act
+    const tl::expected<void, odxf::Error> result{ odxf::writeSnapshot(document, sink) };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(sink.content(), readFile(filePath));
+    EXPECT_EQ(sink.content().size() % 8, 0U);
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(snapshot, openFailures)
+{
+    // Arrange
+    const std::filesystem::path filePath{ "test_snapshot_invalid.odxfsnap" };
+    ASSERT_TRUE(odxf::writeSnapshot(createExampleDocument(), filePath).has_value());
+    const std::string content{ readFile(filePath) };
+
+    std::string badMagic{ content };
+    badMagic[0] = 'X';
+
+    std::string badVersion{ content };
+    const std::uint32_t version{ 99 };
+    std::memcpy(badVersion.data() + 8, &version, sizeof(version));
+
+    std::string badByteOrder{ content };
+    const std::uint32_t byteOrder{ 0x04030201 };
+    std::memcpy(badByteOrder.data() + 12, &byteOrder, sizeof(byteOrder));
+
+    const std::string truncated{ content.substr(0, content.size() / 2) };
+
+    // Act & Assert
+    for (const std::string& invalidContent : { badMagic, badVersion, badByteOrder, truncated }) {
+        writeFile(filePath, invalidContent);
+
+        const tl::expected<odxf::Snapshot, odxf::Error> snapshot{
+            odxf::Snapshot::open(filePath)
+        };
+        ASSERT_FALSE(snapshot.has_value());
+        EXPECT_EQ(snapshot.error().type, odxf::Error::Type::InvalidFile);
+    }
+
+    const tl::expected<odxf::Snapshot, odxf::Error> missing{
+        odxf::Snapshot::open("does_not_exist.odxfsnap")
+    };
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().type, odxf::Error::Type::FileOpenError);
+
+    std::filesystem::remove(filePath);
+}
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/extents.hpp"
+#include "opendxf/generator.hpp"
+#include "opendxf/spatialindex.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double maxError{ 1.0e-9 };
+
+// All entities of the document, in the order of the entity types.
+std::vector<odxf::EntityRef> allEntities(const odxf::Entities& entities)
+{
+    std::vector<odxf::EntityRef> result;
+    const auto addAll{ [&](odxf::EntityType type, std::size_t count) {
+        for (std::size_t i{ 0 }; i < count; ++i) {
+            result.push_back(
+                odxf::EntityRef{ .type = type, .index = static_cast<std::uint32_t>(i) });
+        }
+    } };
+    addAll(odxf::EntityType::Arc, entities.arcs.size());
+    addAll(odxf::EntityType::Circle, entities.circles.size());
+    addAll(odxf::EntityType::Ellipse, entities.ellipses.size());
+    addAll(odxf::EntityType::Line, entities.lines.size());
+    addAll(odxf::EntityType::Point, entities.points.size());
+    addAll(odxf::EntityType::LWPolyline, entities.lwPolylines.size());
+    addAll(odxf::EntityType::Ray, entities.rays.size());
+
+    return result;
+}
+
+// The extents of all entities but rays.
+std::optional<odxf::Extents> extentsOf(const odxf::Entities& entities, odxf::EntityRef entity)
+{
+    switch (entity.type) {
+    case odxf::EntityType::Arc:
+        return odxf::extents(entities.arcs[entity.index]);
+    case odxf::EntityType::Circle:
+        return odxf::extents(entities.circles[entity.index]);
+    case odxf::EntityType::Ellipse:
+        return odxf::extents(entities.ellipses[entity.index]);
+    case odxf::EntityType::Line:
+        return odxf::extents(entities.lines[entity.index]);
+    case odxf::EntityType::Point:
+        return odxf::extents(entities.points[entity.index]);
+    case odxf::EntityType::LWPolyline:
+        return odxf::extents(entities.lwPolylines[entity.index]);
+    case odxf::EntityType::Ray:
+        return std::nullopt;
+    }
+
+    return std::nullopt;
+}
+
+void sort(std::vector<odxf::EntityRef>& entities)
+{
+    std::sort(entities.begin(), entities.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.type != rhs.type ? lhs.type < rhs.type : lhs.index < rhs.index;
+    });
+}
+
+}   // namespace
+
+TEST(spatialIndex, distance)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(odxf::Line{ .start = { 0.0, 0.0, 5.0 }, .end = { 4.0, 0.0, 5.0 } });
+    entities.arcs.push_back(odxf::Arc{ .radius = 2.0, .startAngle = 0.0, .endAngle = 90.0 });
+    entities.ellipses.push_back(odxf::Ellipse{
+        .endPointMajor = { 2.0, 0.0, 0.0 },
+        .axisRatio = 0.5,
+        .startParameter = 0.0,
+        .endParameter = 2.0 * std::numbers::pi,
+    });
+    entities.circles.push_back(odxf::Circle{ .center = { 0.0, 0.0, 3.0 }, .radius = 1.0 });
+    // seen edge on, the circle is the segment from (3, -1) to (3, 1)
+    entities.circles.back().extrusion = odxf::Vector3d{ 1.0, 0.0, 0.0 };
+    entities.lwPolylines.push_back(odxf::LWPolyline{
+        .vertices = { odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = 1.0 },
+                      odxf::Vertex{ .position = { 2.0, 0.0 } } },
+    });
+    entities.rays.push_back(
+        odxf::Ray{ .startPoint = { 1.0, 1.0, 0.0 }, .direction = { 0.0, 1.0, 0.0 } });
+
+    const auto distance{ [&](odxf::EntityType type, double x, double y) {
+        return odxf::distance(entities, odxf::EntityRef{ .type = type }, { x, y });
+    } };
+
+    // Act & Assert
+    EXPECT_NEAR(distance(odxf::EntityType::Line, 2.0, 3.0), 3.0, maxError);
+    EXPECT_NEAR(distance(odxf::EntityType::Line, 7.0, 4.0), 5.0, maxError);
+
+    EXPECT_NEAR(
+        distance(odxf::EntityType::Arc, 3.0, 3.0), std::hypot(3.0, 3.0) - 2.0, maxError);
+    EXPECT_NEAR(distance(odxf::EntityType::Arc, 0.0, -1.0), std::hypot(2.0, 1.0), maxError);
+
+    EXPECT_NEAR(distance(odxf::EntityType::Ellipse, 0.0, 0.0), 1.0, 1.0e-6);
+    EXPECT_NEAR(distance(odxf::EntityType::Ellipse, 3.0, 0.0), 1.0, 1.0e-6);
+
+    EXPECT_NEAR(distance(odxf::EntityType::Circle, 3.0, 0.5), 0.0, 1.0e-6);
+    EXPECT_NEAR(distance(odxf::EntityType::Circle, 4.0, 3.0), std::hypot(1.0, 2.0), 1.0e-6);
+
+    // the half circle below the chord, the points above it are closest to its end points
+    EXPECT_NEAR(distance(odxf::EntityType::LWPolyline, 1.0, -3.0), 2.0, maxError);
+    EXPECT_NEAR(distance(odxf::EntityType::LWPolyline, 1.0, 1.0), std::numbers::sqrt2, maxError);
+
+    EXPECT_NEAR(distance(odxf::EntityType::Ray, 2.0, 5.0), 1.0, maxError);
+    EXPECT_NEAR(distance(odxf::EntityType::Ray, 1.0, -2.0), 3.0, maxError);
+}
+
+TEST(spatialIndex, empty)
+{
+    // Arrange
+    const odxf::Entities entities;
+
+    // Act
+    const tl::expected<odxf::SpatialIndex, odxf::Error> index{
+        odxf::SpatialIndex::build(entities)
+    };
+
+    // Assert
+    ASSERT_TRUE(index.has_value());
+    EXPECT_TRUE(index->empty());
+    EXPECT_TRUE(index->query(odxf::Box2d{ .max = { 1.0, 1.0 } }).empty());
+    EXPECT_FALSE(index->nearest(entities, { 0.0, 0.0 }).has_value());
+    EXPECT_TRUE(index->pick(entities, { 0.0, 0.0 }, 1.0).empty());
+}
+
+TEST(spatialIndex, rays)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.rays.push_back(
+        odxf::Ray{ .startPoint = { 0.0, 0.0, 0.0 }, .direction = { 1.0, 1.0, 0.0 } });
+    entities.rays.push_back(
+        odxf::Ray{ .startPoint = { 5.0, 0.0, 0.0 }, .direction = { 0.0, -1.0, 0.0 } });
+    entities.points.push_back(odxf::Point{ .coordinate = { 10.0, 10.0, 0.0 } });
+
+    // Act
+    const tl::expected<odxf::SpatialIndex, odxf::Error> built{
+        odxf::SpatialIndex::build(entities)
+    };
+
+    // Assert
+    ASSERT_TRUE(built.has_value());
+    const odxf::SpatialIndex& index{ *built };
+    EXPECT_EQ(index.size(), 3U);
+    const auto query{ [&](double minX, double minY, double maxX, double maxY) {
+        std::vector<odxf::EntityRef> found{
+            index.query(odxf::Box2d{ .min = { minX, minY }, .max = { maxX, maxY } })
+        };
+        sort(found);
+        return found;
+    } };
+    const odxf::EntityRef first{ .type = odxf::EntityType::Ray, .index = 0 };
+    const odxf::EntityRef second{ .type = odxf::EntityType::Ray, .index = 1 };
+    const odxf::EntityRef point{ .type = odxf::EntityType::Point, .index = 0 };
+
+    EXPECT_THAT(query(99.0, 98.0, 101.0, 99.5), testing::ElementsAre(first));
+    EXPECT_THAT(query(4.0, -100.0, 6.0, -99.0), testing::ElementsAre(second));
+    EXPECT_THAT(query(9.0, 9.0, 11.0, 11.0), testing::ElementsAre(point, first));
+    EXPECT_TRUE(query(-2.0, -2.0, -1.0, -1.0).empty());
+    EXPECT_TRUE(query(4.0, 1.0, 6.0, 2.0).empty());
+}
+
+class SpatialIndexFixture : public testing::TestWithParam<unsigned int>
+{
+protected:
+    SpatialIndexFixture()
+        : m_document{ odxf::generateDocument(odxf::GeneratorOptions{
+              .entityCount = 5000,
+              .mix = odxf::EntityMix{
+                  .points = 1.0,
+                  .rays = 0.02,
+                  .lines = 1.0,
+                  .circles = 1.0,
+                  .arcs = 1.0,
+                  .ellipses = 1.0,
+                  .lwPolylines = 1.0,
+              },
+              .bulgeFraction = 0.3,
+              .extent = 1000.0,
+          }) }
+        , m_index{ *odxf::SpatialIndex::build(
+              m_document.entities,
+              odxf::SpatialIndexOptions{ .nodeCapacity = 8, .threadCount = GetParam() }) }
+    {
+    }
+
+    const odxf::Entities& entities() const { return m_document.entities; }
+
+    odxf::Document m_document;
+    odxf::SpatialIndex m_index;
+    std::mt19937 m_random{ 42 };
+};
+
+TEST_P(SpatialIndexFixture, query)
+{
+    // Arrange
+    std::uniform_real_distribution<double> coordinate{ -100.0, 1100.0 };
+
+    for (int i{ 0 }; i < 50; ++i) {
+        const double x{ coordinate(m_random) };
+        const double y{ coordinate(m_random) };
+        const odxf::Box2d window{ .min = { x, y }, .max = { x + 80.0, y + 50.0 } };
+
+        // Act
+        std::vector<odxf::EntityRef> found{ m_index.query(window) };
+
+        // Assert
+        // rays are covered by a test of their own
+        std::erase_if(found, [](const odxf::EntityRef& entity) {
+            return entity.type == odxf::EntityType::Ray;
+        });
+
+        std::vector<odxf::EntityRef> expected;
+        for (const odxf::EntityRef& entity : allEntities(entities())) {
+            const std::optional<odxf::Extents> extents{ extentsOf(entities(), entity) };
+            if (extents && extents->min.x <= window.max.x && extents->max.x >= window.min.x
+                && extents->min.y <= window.max.y && extents->max.y >= window.min.y) {
+                expected.push_back(entity);
+            }
+        }
+
+        sort(found);
+        sort(expected);
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST_P(SpatialIndexFixture, nearestAndPick)
+{
+    // Arrange
+    std::uniform_real_distribution<double> coordinate{ 0.0, 1000.0 };
+    const std::vector<odxf::EntityRef> all{ allEntities(entities()) };
+
+    for (int i{ 0 }; i < 50; ++i) {
+        const odxf::Coordinate2d point{ coordinate(m_random), coordinate(m_random) };
+        const double tolerance{ 15.0 };
+
+        // Act
+        const std::optional<odxf::EntityRef> nearest{ m_index.nearest(entities(), point) };
+        const std::vector<odxf::EntityRef> picked{ m_index.pick(entities(), point, tolerance) };
+
+        // Assert
+        double closest{ std::numeric_limits<double>::infinity() };
+        std::vector<odxf::EntityRef> expected;
+        for (const odxf::EntityRef& entity : all) {
+            const double entityDistance{ odxf::distance(entities(), entity, point) };
+            closest = std::min(closest, entityDistance);
+            if (entityDistance <= tolerance) {
+                expected.push_back(entity);
+            }
+        }
+
+        ASSERT_TRUE(nearest.has_value());
+        EXPECT_DOUBLE_EQ(odxf::distance(entities(), *nearest, point), closest);
+
+        for (std::size_t j{ 1 }; j < picked.size(); ++j) {
+            EXPECT_LE(
+                odxf::distance(entities(), picked[j - 1], point),
+                odxf::distance(entities(), picked[j], point));
+        }
+        std::vector<odxf::EntityRef> sortedPicked{ picked };
+        sort(sortedPicked);
+        EXPECT_EQ(sortedPicked, expected);
+
+        const std::optional<odxf::EntityRef> withinTolerance{
+            m_index.nearest(entities(), point, tolerance)
+        };
+        EXPECT_EQ(withinTolerance.has_value(), !picked.empty());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SpatialIndexTest, SpatialIndexFixture, testing::Values(1U, 4U));
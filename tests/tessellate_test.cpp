@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+#include "opendxf/tessellate.hpp"
+
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace {
+
+constexpr double maxError{ 1.0e-9 };
+
+double distance(const odxf::Coordinate3d& lhs, const odxf::Coordinate3d& rhs)
+{
+    return std::hypot(lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z);
+}
+
+odxf::Coordinate3d midpoint(const odxf::Coordinate3d& lhs, const odxf::Coordinate3d& rhs)
+{
+    return odxf::Coordinate3d{
+        (lhs.x + rhs.x) / 2.0, (lhs.y + rhs.y) / 2.0, (lhs.z + rhs.z) / 2.0
+    };
+}
+
+std::vector<odxf::Coordinate3d>
+tessellate(const auto& entity, const odxf::TessellateOptions& options)
+{
+    std::vector<odxf::Coordinate3d> vertices(odxf::vertexCount(entity, options));
+    odxf::tessellate(entity, options, vertices);
+
+    return vertices;
+}
+
+}   // namespace
+
+TEST(tessellate, circle)
+{
+    // Arrange
+    const odxf::Circle circle{ .center = { 1.0, 2.0, 3.0 }, .radius = 10.0 };
+    const odxf::TessellateOptions options{ .chordTolerance = 0.01 };
+
+    // Act
+    const std::vector<odxf::Coordinate3d> vertices{ tessellate(circle, options) };
+
+    // Assert
+    ASSERT_GE(vertices.size(), 4U);
+    EXPECT_THAT(vertices.front(), IsNear(odxf::Coordinate3d{ 11.0, 2.0, 3.0 }));
+    EXPECT_THAT(vertices.back(), IsNear(vertices.front()));
+
+    for (std::size_t i{ 0 }; i + 1 < vertices.size(); ++i) {
+        EXPECT_NEAR(distance(vertices[i], circle.center), circle.radius, maxError);
+        const odxf::Coordinate3d chordCenter{ midpoint(vertices[i], vertices[i + 1]) };
+        EXPECT_GE(distance(chordCenter, circle.center), circle.radius - options.chordTolerance);
+    }
+
+    // one fewer segment would exceed the tolerance
+    const double step{ 2.0 * std::numbers::pi / static_cast<double>(vertices.size() - 2) };
+    EXPECT_GT(circle.radius * (1.0 - std::cos(step / 2.0)), options.chordTolerance);
+}
+
+TEST(tessellate, arc)
+{
+    // Arrange
+    const odxf::Arc arc{ .radius = 2.0, .startAngle = 350.0, .endAngle = 100.0 };
+
+    // Act
+    const std::vector<odxf::Coordinate3d> vertices{ tessellate(arc, {}) };
+
+    // Assert
+    const double start{ 350.0 * std::numbers::pi / 180.0 };
+    const double end{ 100.0 * std::numbers::pi / 180.0 };
+    EXPECT_THAT(
+        vertices.front(),
+        IsNear(odxf::Coordinate3d{ 2.0 * std::cos(start), 2.0 * std::sin(start), 0.0 }));
+    EXPECT_THAT(
+        vertices.back(),
+        IsNear(odxf::Coordinate3d{ 2.0 * std::cos(end), 2.0 * std::sin(end), 0.0 }));
+
+    // counterclockwise through 0 degrees
+    for (const odxf::Coordinate3d& vertex : vertices) {
+        EXPECT_NEAR(distance(vertex, arc.center), arc.radius, maxError);
+        EXPECT_FALSE(vertex.x < 0.0 && vertex.y < 0.0);
+    }
+}
+
+TEST(tessellate, ellipse)
+{
+    // Arrange
+    const odxf::Ellipse ellipse{
+        .center = { 1.0, 1.0, 0.0 },
+        .endPointMajor = { 0.0, 4.0, 0.0 },
+        .axisRatio = 0.5,
+        .startParameter = 0.0,
+        .endParameter = std::numbers::pi,
+    };
+
+    // Act
+    const std::vector<odxf::Coordinate3d> vertices{ tessellate(ellipse, {}) };
+
+    // Assert
+    EXPECT_THAT(vertices.front(), IsNear(odxf::Coordinate3d{ 1.0, 5.0, 0.0 }));
+    EXPECT_THAT(vertices.back(), IsNear(odxf::Coordinate3d{ 1.0, -3.0, 0.0 }));
+    for (const odxf::Coordinate3d& vertex : vertices) {
+        // the minor axis points to -x
+        const double u{ (vertex.y - 1.0) / 4.0 };
+        const double v{ (vertex.x - 1.0) / -2.0 };
+        EXPECT_NEAR(u * u + v * v, 1.0, maxError);
+        EXPECT_GE(v, -maxError);
+    }
+}
+
+TEST(tessellate, lwPolyline)
+{
+    // Arrange
+    const odxf::LWPolyline lwPolyline{
+        .elevation = 2.0,
+        .isClosed = true,
+        .vertices = {
+            odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = 1.0 },
+            odxf::Vertex{ .position = { 2.0, 0.0 } },
+            odxf::Vertex{ .position = { 2.0, 2.0 }, .bulge = 0.0 },
+        },
+    };
+
+    // Act
+    const std::vector<odxf::Coordinate3d> vertices{ tessellate(lwPolyline, {}) };
+
+    // Assert
+    ASSERT_GT(vertices.size(), 5U);
+    EXPECT_THAT(vertices.front(), IsNear(odxf::Coordinate3d{ 0.0, 0.0, 2.0 }));
+    EXPECT_THAT(vertices.back(), IsNear(odxf::Coordinate3d{ 0.0, 0.0, 2.0 }));
+    EXPECT_THAT(vertices[vertices.size() - 2], IsNear(odxf::Coordinate3d{ 2.0, 2.0, 2.0 }));
+    EXPECT_THAT(vertices[vertices.size() - 3], IsNear(odxf::Coordinate3d{ 2.0, 0.0, 2.0 }));
+
+    // a counterclockwise half circle below the first segment
+    const odxf::Coordinate3d center{ 1.0, 0.0, 2.0 };
+    for (std::size_t i{ 0 }; i < vertices.size() - 2; ++i) {
+        EXPECT_NEAR(distance(vertices[i], center), 1.0, maxError);
+        EXPECT_LE(vertices[i].y, maxError);
+    }
+}
+
+TEST(tessellate, segmentLimits)
+{
+    // Arrange
+    const odxf::Circle circle{ .radius = 1.0e6 };
+    const odxf::Circle degenerate{ .radius = 0.0 };
+    const odxf::TessellateOptions options{ .chordTolerance = 0.0, .maxSegments = 100 };
+
+    // Act & Assert
+    EXPECT_EQ(odxf::vertexCount(circle, options), 101U);
+    EXPECT_EQ(odxf::vertexCount(degenerate, options), 4U);
+    EXPECT_EQ(odxf::vertexCount(odxf::Circle{ .radius = 1.0 }, { .chordTolerance = 5.0 }), 4U);
+    EXPECT_EQ(odxf::vertexCount(odxf::LWPolyline{}, options), 0U);
+}
+
+class TessellateFixture : public testing::TestWithParam<unsigned int>
+{
+};
+
+TEST_P(TessellateFixture, batch)
+{
+    // Arrange
+    const odxf::Document document{ odxf::generateDocument(odxf::GeneratorOptions{
+        .entityCount = 2000,
+        .mix = odxf::EntityMix{
+            .lines = 0.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .ellipses = 1.0,
+            .lwPolylines = 1.0,
+        },
+        .bulgeFraction = 0.5,
+    }) };
+    const odxf::TessellateOptions options{ .chordTolerance = 0.1, .threadCount = GetParam() };
+
+    // Act
+    const odxf::Tessellation arcs{ odxf::tessellate(document.entities.arcs, options) };
+    const odxf::Tessellation circles{ odxf::tessellate(document.entities.circles, options) };
+    const odxf::Tessellation ellipses{ odxf::tessellate(document.entities.ellipses, options) };
+    const odxf::Tessellation lwPolylines{
+        odxf::tessellate(document.entities.lwPolylines, options)
+    };
+
+    // Assert
+    const auto expectEqual{ [&](const odxf::Tessellation& tessellation, const auto& entities) {
+        ASSERT_EQ(tessellation.size(), entities.size());
+        EXPECT_EQ(tessellation.vertices.size(), tessellation.offsets.back());
+        for (std::size_t i{ 0 }; i < entities.size(); ++i) {
+            const std::vector<odxf::Coordinate3d> expected{ tessellate(entities[i], options) };
+            ASSERT_EQ(tessellation[i].size(), expected.size());
+            for (std::size_t j{ 0 }; j < expected.size(); ++j) {
+                EXPECT_EQ(tessellation[i][j].x, expected[j].x);
+                EXPECT_EQ(tessellation[i][j].y, expected[j].y);
+                EXPECT_EQ(tessellation[i][j].z, expected[j].z);
+            }
+        }
+    } };
+
+    expectEqual(arcs, document.entities.arcs);
+    expectEqual(circles, document.entities.circles);
+    expectEqual(ellipses, document.entities.ellipses);
+    expectEqual(lwPolylines, document.entities.lwPolylines);
+}
+
+INSTANTIATE_TEST_SUITE_P(TessellateTest, TessellateFixture, testing::Values(1U, 4U));
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/outputsink.hpp"
+#include "opendxf/read.hpp"
+#include "opendxf/trace.hpp"
+#include "opendxf/write.hpp"
+
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace {
+
+// Installs a sink for the lifetime of the test.
+class ScopedTraceSink final
+{
+public:
+    explicit ScopedTraceSink(odxf::ITraceSink& sink) { odxf::setTraceSink(&sink); }
+    ~ScopedTraceSink() { odxf::setTraceSink(nullptr); }
+
+    ScopedTraceSink(const ScopedTraceSink&) = delete;
+    ScopedTraceSink& operator=(const ScopedTraceSink&) = delete;
+};
+
+}   // namespace
+
+TEST(trace, userScopes)
+{
+    // Arrange
+    odxf::MemorySink output;
+    odxf::ChromeTraceSink traceSink{ output };
+
+    // Act
+    {
+        const ScopedTraceSink scopedSink{ traceSink };
+        const odxf::TraceScope outer{ "outer" };
+        const odxf::TraceScope inner{ "inner \"quoted\"", "custom" };
+    }
+    const tl::expected<void, odxf::Error> result{ traceSink.close() };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+
+    const std::string& json{ output.content() };
+    EXPECT_THAT(json, testing::StartsWith("{\"traceEvents\":[\n"));
+    EXPECT_THAT(json, testing::EndsWith("\n]}\n"));
+    EXPECT_THAT(json, testing::HasSubstr("{\"name\":\"outer\",\"cat\":\"user\",\"ph\":\"X\""));
+    EXPECT_THAT(json, testing::HasSubstr("{\"name\":\"inner \\\"quoted\\\"\",\"cat\":\"custom\""));
+    EXPECT_THAT(json, testing::ContainsRegex("\"pid\":1,\"tid\":[0-9]+\\}"));
+}
+
+TEST(trace, withoutSink)
+{
+    // Arrange
+    odxf::MemorySink output;
+    odxf::ChromeTraceSink traceSink{ output };
+
+    // Act
+    {
+        const odxf::TraceScope scope{ "untraced" };
+    }
+    const tl::expected<void, odxf::Error> result{ traceSink.close() };
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(output.content(), "{\"traceEvents\":[]}\n");
+}
+
+TEST(trace, libraryScopes)
+{
+    if (!odxf::isTracingEnabled()) {
+        GTEST_SKIP() << "built without OPENDXF_ENABLE_TRACING";
+    }
+
+    // Arrange
+    const auto filePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+
+    odxf::MemorySink output;
+    odxf::ChromeTraceSink traceSink{ output };
+
+    // Act
+    {
+        const ScopedTraceSink scopedSink{ traceSink };
+
+        const tl::expected<odxf::Document, odxf::Error> document{
+            odxf::readDocument(filePath, odxf::ReadOptions{ .threadCount = 2 })
+        };
+        ASSERT_TRUE(document.has_value());
+
+        odxf::MemorySink dxfOutput;
+        ASSERT_TRUE(odxf::writeDxf(createExampleDocument(), dxfOutput));
+    }
+    ASSERT_TRUE(traceSink.close());
+
+    // Assert
+    const std::string& json{ output.content() };
+    for (const char* name : { "readDocument",
+                              "loadFile",
+                              "readHeader",
+                              "readTables",
+                              "readBlocks",
+                              "readEntities",
+                              "writeDxf",
+                              "writeTables",
+                              "writeEntities",
+                              "finish" }) {
+        EXPECT_THAT(json, testing::HasSubstr(std::string{ "\"name\":\"" } + name + '"'));
+    }
+}
@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/generator.hpp"
+#include "opendxf/tessellate.hpp"
+#include "opendxf/transform.hpp"
+
+#include "Matchers/EntitiesMatcher.hpp"
+#include "TestUtils.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr double maxError{ 1.0e-9 };
+
+odxf::Coordinate3d apply(const odxf::Affine2d& affine, const odxf::Coordinate3d& coordinate)
+{
+    odxf::Entities entities;
+    entities.points.push_back(odxf::Point{ .coordinate = coordinate });
+    odxf::transform(entities, affine);
+
+    return entities.points.front().coordinate;
+}
+
+std::vector<odxf::Coordinate3d> tessellate(const auto& entity)
+{
+    const odxf::TessellateOptions options{ .chordTolerance = 1.0e-3 };
+    std::vector<odxf::Coordinate3d> vertices(odxf::vertexCount(entity, options));
+    odxf::tessellate(entity, options, vertices);
+
+    return vertices;
+}
+
+}   // namespace
+
+TEST(transform, affine)
+{
+    // Arrange
+    const odxf::Affine2d rotation{ odxf::Affine2d::rotate(90.0) };
+    const odxf::Affine2d translation{ odxf::Affine2d::translate(1.0, 2.0) };
+    const odxf::Coordinate3d point{ 1.0, 0.0, 5.0 };
+
+    // Act
+    const odxf::Coordinate3d composed{ apply(translation * rotation, point) };
+    const odxf::Coordinate3d sequential{ apply(translation, apply(rotation, point)) };
+
+    // Assert
+    EXPECT_THAT(composed, IsNear(odxf::Coordinate3d{ 1.0, 3.0, 5.0 }));
+    EXPECT_THAT(sequential, IsNear(composed));
+}
+
+TEST(transform, linesPointsRays)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.lines.push_back(odxf::Line{ .start = { 1.0, 1.0, 1.0 }, .end = { 2.0, 1.0, 1.0 } });
+    entities.lines.back().thickness = 2.0;
+    entities.rays.push_back(
+        odxf::Ray{ .startPoint = { 0.0, 0.0, 0.0 }, .direction = { 1.0, 0.0, 0.0 } });
+    const odxf::Affine3d affine{ odxf::Affine3d::translate(0.0, 0.0, 1.0)
+                                 * odxf::Affine3d::scale(2.0, 3.0, 4.0) };
+
+    // Act
+    odxf::transform(entities, affine);
+
+    // Assert
+    const odxf::Line& line{ entities.lines.front() };
+    EXPECT_THAT(line.start, IsNear(odxf::Coordinate3d{ 2.0, 3.0, 5.0 }));
+    EXPECT_THAT(line.end, IsNear(odxf::Coordinate3d{ 4.0, 3.0, 5.0 }));
+    EXPECT_DOUBLE_EQ(line.thickness.value_or(0.0), 8.0);
+    EXPECT_FALSE(line.extrusion.has_value());
+
+    const odxf::Ray& ray{ entities.rays.front() };
+    EXPECT_THAT(ray.startPoint, IsNear(odxf::Coordinate3d{ 0.0, 0.0, 1.0 }));
+    EXPECT_DOUBLE_EQ(ray.direction.x, 1.0);
+}
+
+TEST(transform, conformal)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.circles.push_back(odxf::Circle{ .center = { 1.0, 0.0, 0.0 }, .radius = 1.0 });
+    entities.arcs.push_back(odxf::Arc{ .radius = 1.0, .startAngle = 0.0, .endAngle = 90.0 });
+    const odxf::Affine2d affine{ odxf::Affine2d::rotate(90.0) * odxf::Affine2d::scale(2.0) };
+
+    // Act
+    odxf::transform(entities, affine);
+
+    // Assert
+    ASSERT_EQ(entities.circles.size(), 1U);
+    EXPECT_THAT(entities.circles.front().center, IsNear(odxf::Coordinate3d{ 0.0, 2.0, 0.0 }));
+    EXPECT_NEAR(entities.circles.front().radius, 2.0, maxError);
+
+    ASSERT_EQ(entities.arcs.size(), 1U);
+    EXPECT_NEAR(entities.arcs.front().radius, 2.0, maxError);
+    EXPECT_NEAR(entities.arcs.front().startAngle, 90.0, maxError);
+    EXPECT_NEAR(entities.arcs.front().endAngle, 180.0, maxError);
+    EXPECT_TRUE(entities.ellipses.empty());
+}
+
+TEST(transform, mirror)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.arcs.push_back(odxf::Arc{ .radius = 1.0, .startAngle = 0.0, .endAngle = 90.0 });
+    entities.lwPolylines.push_back(odxf::LWPolyline{
+        .vertices = { odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = 0.5 },
+                      odxf::Vertex{ .position = { 1.0, 0.0 } } },
+    });
+    const std::vector<odxf::Coordinate3d> before{ tessellate(entities.lwPolylines.front()) };
+
+    // Act
+    odxf::transform(entities, odxf::Affine2d::scale(-1.0, 1.0));
+
+    // Assert
+    const odxf::Arc& arc{ entities.arcs.front() };
+    EXPECT_FALSE(arc.extrusion.has_value());
+    EXPECT_NEAR(arc.startAngle, 90.0, maxError);
+    EXPECT_NEAR(arc.endAngle, 180.0, maxError);
+
+    const odxf::LWPolyline& lwPolyline{ entities.lwPolylines.front() };
+    EXPECT_DOUBLE_EQ(lwPolyline.vertices.front().bulge.value_or(0.0), -0.5);
+    const std::vector<odxf::Coordinate3d> after{ tessellate(lwPolyline) };
+    ASSERT_EQ(after.size(), before.size());
+    for (std::size_t i{ 0 }; i < before.size(); ++i) {
+        EXPECT_THAT(after[i], IsNear(odxf::Coordinate3d{ -before[i].x, before[i].y, 0.0 }));
+    }
+}
+
+TEST(transform, nonConformal)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.circles.push_back(odxf::Circle{ .radius = 1.0 });
+    entities.circles.back().layer = "circles";
+    entities.arcs.push_back(odxf::Arc{
+        .center = { 1.0, 1.0, 0.0 },
+        .radius = 1.0,
+        .startAngle = 30.0,
+        .endAngle = 120.0,
+    });
+    entities.ellipses.push_back(odxf::Ellipse{
+        .endPointMajor = { 1.0, 1.0, 0.0 },
+        .axisRatio = 0.5,
+        .startParameter = 1.0,
+        .endParameter = 4.0,
+    });
+    entities.lwPolylines.push_back(odxf::LWPolyline{
+        .vertices = { odxf::Vertex{ .position = { 0.0, 0.0 }, .bulge = 1.0 },
+                      odxf::Vertex{ .position = { 2.0, 0.0 } } },
+    });
+
+    const odxf::Affine2d affine{ odxf::Affine2d::scale(-3.0, 1.0) };
+    const std::vector<odxf::Coordinate3d> arc{ tessellate(entities.arcs.front()) };
+    const std::vector<odxf::Coordinate3d> ellipse{ tessellate(entities.ellipses.front()) };
+
+    // Act
+    odxf::transform(entities, affine);
+
+    // Assert
+    EXPECT_TRUE(entities.circles.empty());
+    EXPECT_TRUE(entities.arcs.empty());
+    ASSERT_EQ(entities.ellipses.size(), 3U);
+
+    // the transformed ellipse first, the converted entities in order of their types
+    const std::vector<odxf::Coordinate3d> transformedEllipse{ tessellate(entities.ellipses[0]) };
+    EXPECT_THAT(transformedEllipse.front(), IsNear(apply(affine, ellipse.back())));
+    EXPECT_THAT(transformedEllipse.back(), IsNear(apply(affine, ellipse.front())));
+
+    const std::vector<odxf::Coordinate3d> transformedArc{ tessellate(entities.ellipses[1]) };
+    EXPECT_THAT(transformedArc.front(), IsNear(apply(affine, arc.back())));
+    EXPECT_THAT(transformedArc.back(), IsNear(apply(affine, arc.front())));
+
+    const odxf::Ellipse& circle{ entities.ellipses[2] };
+    EXPECT_EQ(circle.layer, "circles");
+    EXPECT_NEAR(std::abs(circle.endPointMajor.x), 3.0, maxError);
+    EXPECT_NEAR(circle.axisRatio, 1.0 / 3.0, maxError);
+
+    // the bulge is replaced by chords within the default tolerance
+    const odxf::LWPolyline& lwPolyline{ entities.lwPolylines.front() };
+    ASSERT_GT(lwPolyline.vertices.size(), 2U);
+    for (const odxf::Vertex& vertex : lwPolyline.vertices) {
+        EXPECT_FALSE(vertex.bulge.has_value());
+        const double x{ (vertex.position.x + 3.0) / 3.0 };
+        EXPECT_NEAR(x * x + vertex.position.y * vertex.position.y, 1.0, maxError);
+    }
+}
+
+TEST(transform, tilted)
+{
+    // Arrange
+    odxf::Entities entities;
+    entities.circles.push_back(odxf::Circle{ .center = { 0.0, 0.0, 1.0 }, .radius = 2.0 });
+    // rotation by 90 degrees around the x axis
+    const odxf::Affine3d affine{ .linear = { 1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 1.0, 0.0 } };
+
+    // Act
+    odxf::transform(entities, affine);
+
+    // Assert
+    ASSERT_EQ(entities.circles.size(), 1U);
+    const odxf::Circle& circle{ entities.circles.front() };
+    ASSERT_TRUE(circle.extrusion.has_value());
+    EXPECT_NEAR(circle.extrusion->y, -1.0, maxError);
+    EXPECT_NEAR(circle.radius, 2.0, maxError);
+    // the center is given in the object coordinate system of the extrusion
+    EXPECT_NEAR(circle.center.z, 1.0, maxError);
+}
+
+class TransformFixture : public testing::TestWithParam<unsigned int>
+{
+};
+
+TEST_P(TransformFixture, roundTrip)
+{
+    // Arrange
+    const odxf::Document document{ odxf::generateDocument(odxf::GeneratorOptions{
+        .entityCount = 3000,
+        .mix = odxf::EntityMix{
+            .points = 1.0,
+            .rays = 1.0,
+            .lines = 1.0,
+            .circles = 1.0,
+            .arcs = 1.0,
+            .ellipses = 1.0,
+            .lwPolylines = 1.0,
+        },
+    }) };
+    odxf::Entities entities{ document.entities };
+    const odxf::Affine2d affine{ odxf::Affine2d::translate(100.0, -50.0)
+                                 * odxf::Affine2d::rotate(30.0)
+                                 * odxf::Affine2d::scale(-2.0, 2.0) };
+    const odxf::Affine2d inverse{ odxf::Affine2d::scale(-0.5, 0.5) * odxf::Affine2d::rotate(-30.0)
+                                  * odxf::Affine2d::translate(-100.0, 50.0) };
+    const odxf::TransformOptions options{ .threadCount = GetParam() };
+
+    // Act
+    odxf::transform(entities, affine, options);
+    odxf::transform(entities, inverse, options);
+
+    // Assert
+    EXPECT_THAT(entities, AreEntities(document.entities, 1.0e-6));
+    ASSERT_EQ(entities.ellipses.size(), document.entities.ellipses.size());
+    for (std::size_t i{ 0 }; i < entities.ellipses.size(); ++i) {
+        EXPECT_THAT(
+            tessellate(entities.ellipses[i]).front(),
+            IsNear(tessellate(document.entities.ellipses[i]).front()));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TransformTest, TransformFixture, testing::Values(1U, 4U));
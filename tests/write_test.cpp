@@ -7,34 +7,35 @@
 #include "Matchers/DocumentMatcher.hpp"
 #include "TestUtils.hpp"
 
-#include <fmt/core.h>
-
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace {
 
-std::vector<std::string> readFile(const std::filesystem::path& filePath)
+odxf::Document createLargeDocument()
 {
-    std::ifstream stream{ filePath };
-    if (!stream.is_open()) {
-        throw std::runtime_error{ fmt::format(
-            "unable to open file '{}'",
-            reinterpret_cast<const char*>(filePath.u8string().c_str())) };
-    }
-
-    std::vector<std::string> fileContent;
-    std::string line;
-    while (std::getline(stream, line)) {
-        fileContent.push_back(line);
+    odxf::Document document{ createExampleDocument() };
+    for (int i{ 0 }; i < 40000; ++i) {
+        const double offset{ static_cast<double>(i) / 7.0 };
+        document.entities.lines.push_back(odxf::Line{
+            .start = { offset, 0.0, 0.0 },
+            .end = { offset, 1.0, 0.0 },
+        });
+        document.entities.arcs.push_back(odxf::Arc{
+            .center = { offset, offset, 0.0 },
+            .radius = 1.0 + offset,
+            .endAngle = 90.0,
+        });
     }
+    document.entities.points.push_back(odxf::Point{ .coordinate = { 1.0, 2.0, 3.0 } });
 
-    return fileContent;
+    return document;
 }
 
 }   // namespace
@@ -44,18 +45,18 @@ TEST(write, example)
     // Arrange
     const odxf::Document document{ createExampleDocument() };
 
-    const std::filesystem::path filePath{ "test.dxf" };
-    std::filesystem::remove(filePath);
-    ASSERT_FALSE(std::filesystem::exists(filePath));
+    const TemporaryFile file{ "test.dxf" };
+    std::filesystem::remove(file.path());
+    ASSERT_FALSE(std::filesystem::exists(file.path()));
 
     // Act
-    odxf::writeDxf(document, filePath);
+    ASSERT_TRUE(odxf::writeDxf(document, file.path()));
 
     // Assert
-    ASSERT_TRUE(std::filesystem::is_regular_file(filePath));
+    ASSERT_TRUE(std::filesystem::is_regular_file(file.path()));
 
     ReadStream istream;
-    const tl::expected<void, odxf::Error> result{ odxf::read(istream, filePath) };
+    const tl::expected<void, odxf::Error> result{ odxf::read(istream, file.path()) };
 
     ASSERT_TRUE(result.has_value());
 
@@ -63,3 +64,251 @@ TEST(write, example)
 
     EXPECT_THAT(readDocument, IsDocument(document));
 }
+
+TEST(write, readDocumentRoundTrip)
+{
+    // Arrange
+    const auto examplePath{ std::filesystem::path{ TEST_DATA_DIR } / "example.dxf" };
+    const tl::expected<odxf::Document, odxf::Error> document{ odxf::readDocument(examplePath) };
+    ASSERT_TRUE(document.has_value());
+
+    const TemporaryFile file{ "test_read_round_trip.dxf" };
+
+    // Act
+    const tl::expected<void, odxf::Error> written{ odxf::writeDxf(*document, file.path()) };
+
+    // Assert
+    ASSERT_TRUE(written.has_value()) << written.error().what;
+
+    const tl::expected<odxf::Document, odxf::Error> result{ odxf::readDocument(file.path()) };
+    ASSERT_TRUE(result.has_value());
+    EXPECT_THAT(*result, IsDocument(*document));
+    EXPECT_THAT(*result, IsDocument(createExampleDocument()));
+
+}
+
+TEST(write, shortestRoundTrip)
+{
+    // Arrange
+    odxf::Document document;
+    document.tables.lineTypes.push_back(odxf::LineType{ .name = "CONTINUOUS" });
+    document.entities.lines.push_back(odxf::Line{
+        .start = { 0.1 + 0.2, 1.0 / 3.0, 0.0 },
+        .end = { 5432109.876543211, -7.0e-12, 0.0 },
+    });
+    document.header.entries.try_emplace("$TEXTSIZE", 2.0 / 3.0);
+
+    const TemporaryFile file{ "test_shortest.dxf" };
+
+    // Act
+    ASSERT_TRUE(odxf::writeDxf(document, file.path()));
+
+    // Assert
+    const tl::expected<odxf::Document, odxf::Error> result{ odxf::readDocument(file.path()) };
+    ASSERT_TRUE(result.has_value());
+
+    ASSERT_EQ(result->entities.lines.size(), 1);
+    const odxf::Line& line{ result->entities.lines.front() };
+    EXPECT_EQ(line.start.x, 0.1 + 0.2);
+    EXPECT_EQ(line.start.y, 1.0 / 3.0);
+    EXPECT_EQ(line.end.x, 5432109.876543211);
+    EXPECT_EQ(line.end.y, -7.0e-12);
+    EXPECT_THAT(
+        result->header.entries,
+        testing::Contains(testing::Pair("$TEXTSIZE", testing::VariantWith<double>(2.0 / 3.0))));
+}
+
+TEST(write, entityTypeNames)
+{
+    // Arrange
+    odxf::Document document{ createExampleDocument() };
+    document.entities = odxf::Entities{};
+    document.entities.points.push_back(odxf::Point{ .coordinate = { 1.0, 2.0, 3.0 } });
+    document.entities.rays.push_back(
+        odxf::Ray{ .startPoint = { 0.0, 0.0, 0.0 }, .direction = { 0.0, 1.0, 0.0 } });
+    document.entities.ellipses.push_back(odxf::Ellipse{
+        .center = { 5.0, 5.0, 0.0 },
+        .endPointMajor = { 2.0, 0.0, 0.0 },
+        .axisRatio = 0.5,
+    });
+
+    const TemporaryFile file{ "test_entity_type_names.dxf" };
+
+    // Act
+    ASSERT_TRUE(odxf::writeDxf(document, file.path()));
+
+    // Assert
+    const std::vector<std::string> lines{ readLines(file.path()) };
+    std::vector<std::string> typeNames;
+    // the group codes and values of the ENTITIES section alternate after its name
+    const auto entities{ std::find(lines.begin(), lines.end(), "ENTITIES") };
+    ASSERT_NE(entities, lines.end());
+    for (std::size_t i{ static_cast<std::size_t>(entities - lines.begin()) + 1 };
+         i + 1 < lines.size();
+         i += 2) {
+        if (lines[i] == "0") {
+            typeNames.push_back(lines[i + 1]);
+        }
+    }
+    EXPECT_THAT(typeNames, testing::ElementsAre("POINT", "RAY", "ELLIPSE", "ENDSEC", "EOF"));
+
+    // the reader recognizes the entities, though it does not parse them
+    odxf::ReadStats stats;
+    const tl::expected<odxf::Document, odxf::Error> result{
+        odxf::readDocument(file.path(), odxf::ReadOptions{ .stats = &stats })
+    };
+    ASSERT_TRUE(result.has_value());
+    EXPECT_THAT(
+        stats.skippedEntities,
+        testing::UnorderedElementsAre(
+            testing::Pair("ELLIPSE", 1U), testing::Pair("POINT", 1U), testing::Pair("RAY", 1U)));
+}
+
+struct NumberFormatParam final
+{
+    odxf::NumberFormat numberFormat;
+    std::vector<std::string> expectedLines;
+};
+
+struct NumberFormatFixture : testing::TestWithParam<NumberFormatParam>
+{};
+
+TEST_P(NumberFormatFixture, Format)
+{
+    // Arrange
+    const auto& [numberFormat, expectedLines]{ GetParam() };
+
+    odxf::Document document;
+    document.tables.lineTypes.push_back(odxf::LineType{ .name = "CONTINUOUS" });
+    document.entities.circles.push_back(odxf::Circle{
+        .center = { 0.5, -1.0 / 3.0, -1.0e-7 },
+        .radius = 12.0,
+    });
+
+    const TemporaryFile file{ "test_number_format.dxf" };
+
+    // Act
+    ASSERT_TRUE(
+        odxf::writeDxf(
+            document, file.path(), odxf::WriteOptions{ .numberFormat = numberFormat }));
+
+    // Assert
+    const std::vector<std::string> fileContent{ readLines(file.path()) };
+    EXPECT_THAT(fileContent, testing::IsSupersetOf(expectedLines));
+}
+
+// clang-format off
+INSTANTIATE_TEST_SUITE_P(
+    NumberFormatTest,
+    NumberFormatFixture,
+    testing::Values(
+        NumberFormatParam{
+            .numberFormat{ .type = odxf::NumberFormat::Type::Shortest },
+            .expectedLines{ "0.5", "-0.3333333333333333", "-1e-07", "12" },
+        },
+        NumberFormatParam{
+            .numberFormat{ .type = odxf::NumberFormat::Type::Fixed, .decimals = 3 },
+            .expectedLines{ "0.500", "-0.333", "-0.000", "12.000" },
+        },
+        NumberFormatParam{
+            .numberFormat{ .type = odxf::NumberFormat::Type::Tolerance, .tolerance = 1.0e-4 },
+            .expectedLines{ "0.5", "-0.3333", "0", "12" },
+        }
+    )
+);
+// clang-format on
+
+TEST(write, parallelMatchesSequential)
+{
+    // Arrange
+    const odxf::Document document{ createLargeDocument() };
+
+    const TemporaryFile sequentialFile{ "test_sequential.dxf" };
+    const TemporaryFile parallelFile{ "test_parallel.dxf" };
+
+    // Act
+    ASSERT_TRUE(odxf::writeDxf(document, sequentialFile.path()));
+    ASSERT_TRUE(
+        odxf::writeDxf(document, parallelFile.path(), odxf::WriteOptions{ .threadCount = 3 }));
+
+    // Assert
+    EXPECT_EQ(readFile(parallelFile.path()), readFile(sequentialFile.path()));
+}
+
+TEST(write, asyncMatchesSequential)
+{
+    // Arrange
+    const odxf::Document document{ createLargeDocument() };
+
+    const TemporaryFile sequentialFile{ "test_sequential_sync.dxf" };
+    const TemporaryFile asyncFile{ "test_async.dxf" };
+    const TemporaryFile asyncParallelFile{ "test_async_parallel.dxf" };
+
+    const odxf::WriteOptions asyncOptions{
+        .asyncOutput = true,
+        .preallocateSize = odxf::estimateDxfSize(document),
+    };
+    const odxf::WriteOptions asyncParallelOptions{
+        .threadCount = 3,
+        .asyncOutput = true,
+        .preallocateSize = odxf::estimateDxfSize(document),
+    };
+
+    // Act
+    ASSERT_TRUE(odxf::writeDxf(document, sequentialFile.path()));
+    ASSERT_TRUE(odxf::writeDxf(document, asyncFile.path(), asyncOptions));
+    ASSERT_TRUE(odxf::writeDxf(document, asyncParallelFile.path(), asyncParallelOptions));
+
+    // Assert
+    EXPECT_EQ(
+        std::filesystem::file_size(asyncFile.path()),
+        std::filesystem::file_size(sequentialFile.path()));
+    EXPECT_EQ(readFile(asyncFile.path()), readFile(sequentialFile.path()));
+    EXPECT_EQ(readFile(asyncParallelFile.path()), readFile(sequentialFile.path()));
+}
+
+TEST(write, estimateDxfSize)
+{
+    // Arrange
+    const odxf::Document document{ createLargeDocument() };
+    const TemporaryFile file{ "test_estimate.dxf" };
+
+    // Act
+    const std::uintmax_t estimatedSize{ odxf::estimateDxfSize(document) };
+    ASSERT_TRUE(odxf::writeDxf(document, file.path()));
+
+    // Assert
+    const auto fileSize{ static_cast<double>(std::filesystem::file_size(file.path())) };
+    EXPECT_NEAR(static_cast<double>(estimatedSize), fileSize, 0.05 * fileSize);
+}
+
+TEST(write, updateExtents)
+{
+    // Arrange
+    odxf::Document document{ createExampleDocument() };
+    document.entities = odxf::Entities{};
+    document.entities.circles.push_back(
+        odxf::Circle{ .center = { 1.0, 2.0, 3.0 }, .radius = 2.0 });
+    document.entities.lines.push_back(
+        odxf::Line{ .start = { 0.0, 0.0, 0.0 }, .end = { 5.0, 1.0, 0.0 } });
+    const TemporaryFile file{ "test_extents.dxf" };
+
+    // Act
+    ASSERT_TRUE(
+        odxf::writeDxf(document, file.path(), odxf::WriteOptions{ .updateExtents = true }));
+
+    // Assert
+    const tl::expected<odxf::Document, odxf::Error> result{ odxf::readDocument(file.path()) };
+    ASSERT_TRUE(result.has_value());
+    const auto& entries{ result->header.entries };
+    ASSERT_TRUE(entries.contains("$EXTMIN"));
+    ASSERT_TRUE(entries.contains("$EXTMAX"));
+    const odxf::Coordinate3d min{ std::get<odxf::Coordinate3d>(entries.at("$EXTMIN")) };
+    const odxf::Coordinate3d max{ std::get<odxf::Coordinate3d>(entries.at("$EXTMAX")) };
+    EXPECT_DOUBLE_EQ(min.x, -1.0);
+    EXPECT_DOUBLE_EQ(min.y, 0.0);
+    EXPECT_DOUBLE_EQ(min.z, 0.0);
+    EXPECT_DOUBLE_EQ(max.x, 5.0);
+    EXPECT_DOUBLE_EQ(max.y, 4.0);
+    EXPECT_DOUBLE_EQ(max.z, 3.0);
+}
@@ -0,0 +1,513 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 Marco Langer
+
+#include "opendxf/opendxf.hpp"
+
+#include "jsonstring.hpp"
+#include "parsenumber.hpp"
+#include "pathstring.hpp"
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <tl/expected.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if __has_include(<sys/resource.h>)
+#    include <sys/resource.h>
+#    define OPENDXF_HAS_RUSAGE 1
+#endif
+
+namespace {
+
+using odxf::appendJsonString;
+using odxf::parseNumber;
+using odxf::pathToString;
+
+constexpr std::string_view usage{
+    R"(usage: odxf-stat [options] <dxf file>
+
+options:
+  --mode <mode>      stream:   report every record through an IReadStream
+                     document: read into a Document (default)
+                     parallel: read into a Document, parsing the entities on all threads
+  --threads <n>      number of threads for parallel mode, default one per hardware thread
+  --no-prescan       do not count the records before reading into a Document
+  --json             print the report as JSON
+)"
+};
+
+enum class Mode
+{
+    Stream,
+    Document,
+    Parallel
+};
+
+struct Arguments final
+{
+    Mode mode{ Mode::Document };
+    unsigned int threadCount{ 0 };
+    bool prescan{ true };
+    bool json{ false };
+    std::filesystem::path filePath;
+};
+
+std::string_view modeName(Mode mode)
+{
+    switch (mode) {
+    case Mode::Stream: return "stream";
+    case Mode::Document: return "document";
+    case Mode::Parallel: return "parallel";
+    }
+
+    return {};
+}
+
+tl::expected<Arguments, std::string> parseArguments(int argc, char** argv)
+{
+    Arguments arguments;
+
+    for (int i{ 1 }; i < argc; ++i) {
+        const std::string_view argument{ argv[i] };
+
+        if (argument == "--json") {
+            arguments.json = true;
+
+            continue;
+        }
+
+        if (argument == "--no-prescan") {
+            arguments.prescan = false;
+
+            continue;
+        }
+
+        if (!argument.starts_with("--")) {
+            if (!arguments.filePath.empty()) {
+                return tl::make_unexpected("more than one input file");
+            }
+            arguments.filePath = reinterpret_cast<const char8_t*>(argv[i]);
+
+            continue;
+        }
+
+        if (i + 1 == argc) {
+            return tl::make_unexpected(fmt::format("missing value for {}", argument));
+        }
+
+        const std::string_view value{ argv[++i] };
+        const auto invalidValue{ [&] {
+            return tl::make_unexpected(fmt::format("invalid value '{}' for {}", value, argument));
+        } };
+
+        if (argument == "--mode") {
+            if (value == "stream") {
+                arguments.mode = Mode::Stream;
+            } else if (value == "document") {
+                arguments.mode = Mode::Document;
+            } else if (value == "parallel") {
+                arguments.mode = Mode::Parallel;
+            } else {
+                return invalidValue();
+            }
+        } else if (argument == "--threads") {
+            const std::optional<unsigned int> threadCount{ parseNumber<unsigned int>(value) };
+            if (!threadCount) {
+                return invalidValue();
+            }
+            arguments.threadCount = *threadCount;
+        } else {
+            return tl::make_unexpected(fmt::format("unknown option {}", argument));
+        }
+    }
+
+    if (arguments.filePath.empty()) {
+        return tl::make_unexpected("missing input file");
+    }
+
+    return arguments;
+}
+
+struct Summary final
+{
+    std::uint64_t count{ 0 };
+    odxf::Extents extents;
+};
+
+using Summaries = std::map<std::string, Summary, std::less<>>;
+
+class DocumentSummary final
+{
+public:
+    template <typename T>
+    void add(std::string_view type, const T& entity)
+    {
+        const odxf::Extents entityExtents{ odxf::extents(entity) };
+
+        summary(m_types, type).count += 1;
+        summary(m_types, type).extents.add(entityExtents);
+        summary(m_layers, entity.layer).count += 1;
+        summary(m_layers, entity.layer).extents.add(entityExtents);
+        m_total.count += 1;
+        m_total.extents.add(entityExtents);
+    }
+
+    void add(const odxf::Entities& entities)
+    {
+        for (const odxf::Line& line : entities.lines) {
+            add("LINE", line);
+        }
+        for (const odxf::Circle& circle : entities.circles) {
+            add("CIRCLE", circle);
+        }
+        for (const odxf::Arc& arc : entities.arcs) {
+            add("ARC", arc);
+        }
+        for (const odxf::LWPolyline& lwPolyline : entities.lwPolylines) {
+            add("LWPOLYLINE", lwPolyline);
+        }
+    }
+
+    void addLayerName(std::string_view name) { summary(m_layers, name); }
+
+    const Summaries& types() const { return m_types; }
+    const Summaries& layers() const { return m_layers; }
+    const Summary& total() const { return m_total; }
+
+private:
+    static Summary& summary(Summaries& summaries, std::string_view name)
+    {
+        const auto iter{ summaries.find(name) };
+        if (iter != summaries.end()) {
+            return iter->second;
+        }
+
+        return summaries.emplace(std::string{ name }, Summary{}).first->second;
+    }
+
+    Summaries m_types;
+    Summaries m_layers;
+    Summary m_total;
+};
+
+class SummaryStream final : public odxf::IReadStream
+{
+public:
+    explicit SummaryStream(DocumentSummary& summary)
+        : m_summary{ summary }
+    {
+    }
+
+private:
+    void layer(const odxf::Layer& layer) override { m_summary.addLayerName(layer.name); }
+    void arc(const odxf::Arc& arc) override { m_summary.add("ARC", arc); }
+    void circle(const odxf::Circle& circle) override { m_summary.add("CIRCLE", circle); }
+    void line(const odxf::Line& line) override { m_summary.add("LINE", line); }
+    void lwPolyline(const odxf::LWPolyline& lwPolyline) override
+    {
+        m_summary.add("LWPOLYLINE", lwPolyline);
+    }
+
+    DocumentSummary& m_summary;
+};
+
+// Peak resident set size of this process in bytes, if the platform reports it.
+std::optional<std::uint64_t> peakResidentSetSize()
+{
+#ifdef OPENDXF_HAS_RUSAGE
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return std::nullopt;
+    }
+
+#    ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#    else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#    endif
+#else
+    return std::nullopt;
+#endif
+}
+
+struct Report final
+{
+    const Arguments& arguments;
+    std::uintmax_t fileSize{ 0 };
+    odxf::ReadStats stats;
+    DocumentSummary summary;
+    std::optional<std::uint64_t> peakRss;
+    std::optional<odxf::MemoryUsage> documentMemory;
+};
+
+double seconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double>{ duration }.count();
+}
+
+double perSecond(double amount, std::chrono::nanoseconds duration)
+{
+    return duration.count() > 0 ? amount / seconds(duration) : 0.0;
+}
+
+std::string formatExtents(const odxf::Extents& extents)
+{
+    if (extents.isEmpty()) {
+        return "-";
+    }
+
+    return fmt::format(
+        "({:.6g}, {:.6g}, {:.6g}) - ({:.6g}, {:.6g}, {:.6g})",
+        extents.min.x,
+        extents.min.y,
+        extents.min.z,
+        extents.max.x,
+        extents.max.y,
+        extents.max.z);
+}
+
+void printText(const Report& report)
+{
+    const odxf::ReadStats& stats{ report.stats };
+    const double megabytes{ static_cast<double>(report.fileSize) / 1.0e6 };
+
+    fmt::print("file        {}\n", pathToString(report.arguments.filePath));
+    fmt::print("size        {:.2f} MB\n", megabytes);
+    fmt::print("mode        {}\n", modeName(report.arguments.mode));
+    fmt::print("load time   {:.3f} s\n", seconds(stats.loadDuration));
+    fmt::print("parse time  {:.3f} s\n", seconds(stats.totalDuration - stats.loadDuration));
+    fmt::print("total time  {:.3f} s\n", seconds(stats.totalDuration));
+    fmt::print(
+        "throughput  {:.1f} MB/s, {:.0f} entities/s\n",
+        perSecond(megabytes, stats.totalDuration),
+        perSecond(static_cast<double>(report.summary.total().count), stats.totalDuration));
+    if (report.peakRss) {
+        fmt::print("peak RSS    {:.1f} MB\n", static_cast<double>(*report.peakRss) / 1.0e6);
+    }
+    if (report.documentMemory) {
+        fmt::print(
+            "document    {:.1f} MB used, {:.1f} MB reserved\n",
+            static_cast<double>(report.documentMemory->used) / 1.0e6,
+            static_cast<double>(report.documentMemory->reserved) / 1.0e6);
+    }
+    fmt::print("extents     {}\n", formatExtents(report.summary.total().extents));
+
+    fmt::print("\n{:<10} {:>14} {:>14} {:>10}\n", "section", "bytes", "group codes", "time [s]");
+    const auto printSection{ [](std::string_view name, const odxf::SectionStats& section) {
+        fmt::print(
+            "{:<10} {:>14} {:>14} {:>10.3f}\n",
+            name,
+            section.bytes,
+            section.groupCodes,
+            seconds(section.duration));
+    } };
+    printSection("HEADER", stats.header);
+    printSection("TABLES", stats.tables);
+    printSection("BLOCKS", stats.blocks);
+    printSection("ENTITIES", stats.entities);
+
+    const auto printSummaries{ [](std::string_view title, const Summaries& summaries) {
+        fmt::print("\n{:<24} {:>12}  {}\n", title, "count", "extents");
+        for (const auto& [name, summary] : summaries) {
+            fmt::print("{:<24} {:>12}  {}\n", name, summary.count, formatExtents(summary.extents));
+        }
+    } };
+    printSummaries("type", report.summary.types());
+
+    if (!stats.skippedEntities.empty()) {
+        fmt::print("\n{:<24} {:>12}\n", "skipped type", "count");
+        for (const auto& [name, count] : stats.skippedEntities) {
+            fmt::print("{:<24} {:>12}\n", name, count);
+        }
+    }
+
+    printSummaries("layer", report.summary.layers());
+}
+
+void appendJsonExtents(std::string& target, const odxf::Extents& extents)
+{
+    if (extents.isEmpty()) {
+        target.append("null");
+
+        return;
+    }
+
+    fmt::format_to(
+        std::back_inserter(target),
+        R"({{"min":[{},{},{}],"max":[{},{},{}]}})",
+        extents.min.x,
+        extents.min.y,
+        extents.min.z,
+        extents.max.x,
+        extents.max.y,
+        extents.max.z);
+}
+
+void appendJsonSummaries(std::string& target, const Summaries& summaries)
+{
+    target.push_back('{');
+    for (auto iter{ summaries.begin() }; iter != summaries.end(); ++iter) {
+        if (iter != summaries.begin()) {
+            target.push_back(',');
+        }
+        appendJsonString(target, iter->first);
+        fmt::format_to(
+            std::back_inserter(target), R"(:{{"count":{},"extents":)", iter->second.count);
+        appendJsonExtents(target, iter->second.extents);
+        target.push_back('}');
+    }
+    target.push_back('}');
+}
+
+void printJson(const Report& report)
+{
+    const odxf::ReadStats& stats{ report.stats };
+    const double megabytes{ static_cast<double>(report.fileSize) / 1.0e6 };
+
+    std::string json{ R"({"file":)" };
+    appendJsonString(json, pathToString(report.arguments.filePath));
+    fmt::format_to(
+        std::back_inserter(json),
+        R"(,"size":{},"mode":"{}","loadSeconds":{},"parseSeconds":{},"totalSeconds":{})",
+        report.fileSize,
+        modeName(report.arguments.mode),
+        seconds(stats.loadDuration),
+        seconds(stats.totalDuration - stats.loadDuration),
+        seconds(stats.totalDuration));
+    fmt::format_to(
+        std::back_inserter(json),
+        R"(,"megabytesPerSecond":{},"entitiesPerSecond":{},"peakRssBytes":{})",
+        perSecond(megabytes, stats.totalDuration),
+        perSecond(static_cast<double>(report.summary.total().count), stats.totalDuration),
+        report.peakRss ? fmt::format("{}", *report.peakRss) : std::string{ "null" });
+    if (report.documentMemory) {
+        fmt::format_to(
+            std::back_inserter(json),
+            R"(,"documentMemory":{{"usedBytes":{},"reservedBytes":{}}})",
+            report.documentMemory->used,
+            report.documentMemory->reserved);
+    }
+
+    json.append(R"(,"entities":)");
+    fmt::format_to(
+        std::back_inserter(json), R"({{"count":{},"extents":)", report.summary.total().count);
+    appendJsonExtents(json, report.summary.total().extents);
+    json.push_back('}');
+
+    json.append(R"(,"sections":{)");
+    const auto appendSection{
+        [&](std::string_view name, const odxf::SectionStats& section, bool isLast) {
+            fmt::format_to(
+                std::back_inserter(json),
+                R"("{}":{{"bytes":{},"groupCodes":{},"seconds":{}}}{})",
+                name,
+                section.bytes,
+                section.groupCodes,
+                seconds(section.duration),
+                isLast ? "" : ",");
+        }
+    };
+    appendSection("header", stats.header, false);
+    appendSection("tables", stats.tables, false);
+    appendSection("blocks", stats.blocks, false);
+    appendSection("entities", stats.entities, true);
+    json.push_back('}');
+
+    json.append(R"(,"types":)");
+    appendJsonSummaries(json, report.summary.types());
+
+    json.append(R"(,"skippedTypes":{)");
+    for (auto iter{ stats.skippedEntities.begin() }; iter != stats.skippedEntities.end(); ++iter) {
+        if (iter != stats.skippedEntities.begin()) {
+            json.push_back(',');
+        }
+        appendJsonString(json, iter->first);
+        fmt::format_to(std::back_inserter(json), ":{}", iter->second);
+    }
+    json.push_back('}');
+
+    json.append(R"(,"layers":)");
+    appendJsonSummaries(json, report.summary.layers());
+    json.append("}\n");
+
+    fmt::print("{}", json);
+}
+
+}   // namespace
+
+int main(int argc, char** argv)
+{
+    const tl::expected<Arguments, std::string> arguments{ parseArguments(argc, argv) };
+    if (!arguments) {
+        fmt::print(stderr, "error: {}\n\n{}", arguments.error(), usage);
+
+        return EXIT_FAILURE;
+    }
+
+    std::error_code errorCode;
+    Report report{ .arguments = *arguments };
+    report.fileSize = std::filesystem::file_size(arguments->filePath, errorCode);
+    if (errorCode) {
+        fmt::print(stderr, "error: {}\n", errorCode.message());
+
+        return EXIT_FAILURE;
+    }
+
+    tl::expected<void, odxf::Error> result;
+    if (arguments->mode == Mode::Stream) {
+        SummaryStream stream{ report.summary };
+        result = odxf::read(stream, arguments->filePath, &report.stats);
+    } else {
+        const odxf::ReadOptions options{
+            .prescan = arguments->prescan,
+            .threadCount = arguments->mode == Mode::Parallel ? arguments->threadCount : 1,
+            .stats = &report.stats,
+        };
+
+        tl::expected<odxf::Document, odxf::Error> document{
+            odxf::readDocument(arguments->filePath, options)
+        };
+        if (document) {
+            for (const odxf::Layer& layer : document->tables.layers) {
+                report.summary.addLayerName(layer.name);
+            }
+            report.summary.add(document->entities);
+            report.documentMemory = odxf::memoryUsage(*document).total();
+        }
+
+        result = document.map([](const odxf::Document&) {});
+    }
+
+    if (!result) {
+        const odxf::Error& error{ result.error() };
+        if (error.lineNumber) {
+            fmt::print(stderr, "error: line {}: {}\n", *error.lineNumber, error.what);
+        } else {
+            fmt::print(stderr, "error: {}\n", error.what);
+        }
+
+        return EXIT_FAILURE;
+    }
+
+    report.peakRss = peakResidentSetSize();
+
+    if (arguments->json) {
+        printJson(report);
+    } else {
+        printText(report);
+    }
+
+    return EXIT_SUCCESS;
+}